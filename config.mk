@@ -0,0 +1,42 @@
+# Automatically generated by ./configure
+# Command line: 
+CONFIGURE_STATUS := started
+CONFIGURE_ERROR := 
+CONFIGURE_COMMAND_LINE :=  
+CONFIGURE_MAGIC_NUMBER := 2
+# Bash
+FETCH_LIST := 
+FETCH_VERSIONS := 
+LIB_SEARCH_PATHS := 
+# Use ccache
+USE_CCACHE := 0
+# C++ Compiler
+COMPILER := GCC
+CXX := /usr/bin/c++
+# Host System
+MACHINE := x86_64-linux-gnu
+# Build System
+# Cross-compiling
+CROSS_COMPILING := 0
+# Host Operating System
+OS := Linux
+PTHREAD_LIBS := -pthread
+RT_LIBS := -lrt
+M_LIBS := -lm
+# Build Architecture
+GCC_ARCH := x86_64
+GCC_ARCH_REDUCED := x86_64
+# C++11
+CXX11_LIBS += 
+HAS_CXX11 := 1
+# Protobuf compiler
+PROTOC := /usr/bin/protoc
+PROTOC_BIN_DEP := 
+# python
+PYTHON := /root/.pyenv/shims/python
+PYTHON_BIN_DEP := 
+# Node.js package manager
+NPM := /usr/bin/npm
+NPM_BIN_DEP := 
+# coffee
+CONFIGURE_ERROR := missing COFFEE. Install it, specify the full path with COFFEE= or run ./configure with --allow-fetch
@@ -126,6 +126,19 @@ public:
                                a));
     }
 
+    void submit_discard(fd_t fd, size_t count, int64_t offset,
+                        void *account, linux_iocallback_t *cb) {
+        threadnum_t calling_thread = get_thread_id();
+
+        action_t *a = new action_t(calling_thread, cb);
+        a->make_discard(fd, count, offset);
+        a->account = static_cast<accounting_diskmgr_t::account_t *>(account);
+
+        do_on_thread(home_thread(),
+                     std::bind(&linux_disk_manager_t::submit_action_to_stack_stats, this,
+                               a));
+    }
+
 #ifndef USE_WRITEV
 #error "USE_WRITEV not defined.  Did you include pool.hpp?"
 #elif USE_WRITEV
@@ -297,6 +310,43 @@ void linux_file_t::write_async(int64_t offset, size_t length, const void *buf,
                           ds_op);
 }
 
+void linux_file_t::discard_async(int64_t offset, size_t length,
+                                 file_account_t *account, linux_iocallback_t *callback) {
+    assert_thread();
+    rassert(diskmgr != nullptr,
+            "No diskmgr has been constructed (are we running without an event queue?)");
+    rassert(divides(DEVICE_BLOCK_SIZE, offset));
+    rassert(divides(DEVICE_BLOCK_SIZE, length));
+    rassert(offset + static_cast<int64_t>(length) <= file_size);
+
+    /* Like a resize, a discard can outlive whoever requested it, so we keep the file
+    alive until it's done. */
+    struct discard_callback_t : public linux_iocallback_t {
+        void on_io_complete() {
+            linux_iocallback_t *local_cb = cb;
+            delete this;
+            local_cb->on_io_complete();
+        }
+
+        void on_io_failure(int errsv, int64_t _offset, int64_t _length) {
+            linux_iocallback_t *local_cb = cb;
+            delete this;
+            local_cb->on_io_failure(errsv, _offset, _length);
+        }
+
+        linux_iocallback_t *cb;
+        auto_drainer_t::lock_t lock;
+    };
+    discard_callback_t *discard_callback = new discard_callback_t();
+    discard_callback->cb = callback;
+    discard_callback->lock = file_size_ops_drainer.lock();
+    diskmgr->submit_discard(fd.get(), length, offset,
+                            account == DEFAULT_DISK_ACCOUNT
+                            ? default_account->get_account()
+                            : account->get_account(),
+                            discard_callback);
+}
+
 void linux_file_t::writev_async(int64_t offset, size_t length,
                                 scoped_array_t<iovec> &&bufs,
                                 file_account_t *account, linux_iocallback_t *callback) {
@@ -83,6 +83,9 @@ public:
     void writev_async(int64_t offset, size_t length, scoped_array_t<iovec> &&bufs,
                       file_account_t *account, linux_iocallback_t *cb);
 
+    void discard_async(int64_t offset, size_t length,
+                       file_account_t *account, linux_iocallback_t *cb);
+
     bool coop_lock_and_check();
 
     void *create_account(int priority, int outstanding_requests_limit);
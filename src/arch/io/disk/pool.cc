@@ -3,6 +3,9 @@
 
 #include <fcntl.h>
 #include <limits.h>
+#ifdef __linux__
+#include <linux/falloc.h>
+#endif
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -181,6 +184,24 @@ void pool_diskmgr_t::action_t::run() {
             io_result = -get_errno();
             return;
         }
+#endif
+    } break;
+    case ACTION_DISCARD: {
+#ifdef __linux__
+        int res;
+        do {
+            res = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                            offset, buf_and_count.iov_len);
+        } while (res == -1 && get_errno() == EINTR);
+        if (res == 0) {
+            io_result = buf_and_count.iov_len;
+        } else {
+            io_result = -get_errno();
+            return;
+        }
+#else
+        // Discarding is only a hint, so it's fine to do nothing.
+        io_result = buf_and_count.iov_len;
 #endif
     } break;
     case ACTION_READ:
@@ -52,6 +52,19 @@ struct pool_diskmgr_action_t
         size_change = _new_size - _old_size;
     }
 
+    /* Tells the file system that the data in the given range is no longer needed, by
+    punching a hole into the file where that's supported. Subsequent reads of the
+    range return zeroes or the old data. */
+    void make_discard(fd_t _fd, size_t _count, int64_t _offset) {
+        type = ACTION_DISCARD;
+        ds_op = datasync_op::no_datasyncs;
+        fd = _fd;
+        buf_and_count.iov_base = nullptr;
+        buf_and_count.iov_len = _count;
+        offset = _offset;
+        size_change = 0;
+    }
+
 #ifndef USE_WRITEV
 #error "USE_WRITEV not defined... but we are in pool.hpp.  Where is it?"
 #elif USE_WRITEV
@@ -80,6 +93,7 @@ struct pool_diskmgr_action_t
     bool get_is_write() const { return type == ACTION_WRITE; }
     bool get_is_resize() const { return type == ACTION_RESIZE; }
     bool get_is_read() const { return type == ACTION_READ; }
+    bool get_is_discard() const { return type == ACTION_DISCARD; }
     fd_t get_fd() const { return fd; }
     void get_bufs(iovec **iovecs_out, size_t *iovecs_len_out) {
         if (buf_and_count.iov_base != nullptr) {
@@ -105,13 +119,13 @@ private:
     friend class pool_diskmgr_t;
     pool_diskmgr_t *parent;
 
-    enum action_type_t {ACTION_READ, ACTION_WRITE, ACTION_RESIZE};
+    enum action_type_t {ACTION_READ, ACTION_WRITE, ACTION_RESIZE, ACTION_DISCARD};
     action_type_t type;
     datasync_op ds_op;
     fd_t fd;
 
-    // Either type is ACTION_RESIZE, or buf_and_count.iov_base is used, or iovecs
-    // is used (for writev).  If iovecs is used, then buf_and_count.iov_len is the
+    // Either type is ACTION_RESIZE or ACTION_DISCARD, or buf_and_count.iov_base is
+    // used, or iovecs is used (for writev).  If iovecs is used, then buf_and_count.iov_len is the
     // sum of the iovecs' iov_len fields.  Currently readv is not supported, but if
     // you need it, it should be easy to add.
     scoped_array_t<iovec> iovecs;
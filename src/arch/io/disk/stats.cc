@@ -8,10 +8,12 @@ stats_diskmgr_t::stats_diskmgr_t(perfmon_collection_t *stats, const std::string
                      &write_sampler, (name + "_write").c_str()) { }
 
 
+// Discards don't transfer any data, so we leave them out rather than have them skew
+// the write statistics.
 void stats_diskmgr_t::submit(action_t *a) {
     if (a->get_is_read()) {
         read_sampler.begin(&a->start_time);
-    } else {
+    } else if (!a->get_is_discard()) {
         write_sampler.begin(&a->start_time);
     }
     submit_fun(a);
@@ -21,7 +23,7 @@ void stats_diskmgr_t::done(conflict_resolving_diskmgr_action_t *p) {
     action_t *a = static_cast<action_t *>(p);
     if (a->get_is_read()) {
         read_sampler.end(&a->start_time);
-    } else {
+    } else if (!a->get_is_discard()) {
         write_sampler.end(&a->start_time);
     }
     done_fun(a);
@@ -28,11 +28,12 @@ stats_diskmgr_2_t::stats_diskmgr_2_t(
                      &write_sampler, (name + "_write").c_str()) { }
 
 
+// Like in `stats_diskmgr_t`, discards aren't counted as writes.
 void stats_diskmgr_2_t::done(pool_diskmgr_t::action_t *p) {
     action_t *a = static_cast<action_t *>(p);
     if (a->get_is_read()) {
         read_sampler.end(&a->start_time);
-    } else {
+    } else if (!a->get_is_discard()) {
         write_sampler.end(&a->start_time);
     }
     done_fun(a);
@@ -42,7 +43,7 @@ pool_diskmgr_t::action_t *stats_diskmgr_2_t::produce_next_value() {
     action_t *a = source->pop();
     if (a->get_is_read()) {
         read_sampler.begin(&a->start_time);
-    } else {
+    } else if (!a->get_is_discard()) {
         write_sampler.begin(&a->start_time);
     }
     return a;
@@ -4,6 +4,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -18,6 +19,7 @@
 #include <netinet/tcp.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #endif
 
 #include "arch/runtime/runtime.hpp"
@@ -26,16 +28,13 @@
 #include "arch/types.hpp"
 #include "concurrency/auto_drainer.hpp"
 #include "concurrency/exponential_backoff.hpp"
+#include "concurrency/pmap.hpp"
 #include "concurrency/wait_any.hpp"
 #include "containers/printf_buffer.hpp"
 #include "logger.hpp"
 #include "perfmon/perfmon.hpp"
 #include "errors.hpp"
 
-#ifdef _WIN32
-#include "concurrency/pmap.hpp"
-#endif
-
 #ifdef TRACE_WINSOCK
 #define winsock_debugf(...) debugf("winsock: " __VA_ARGS__)
 #else
@@ -210,6 +209,7 @@ linux_tcp_conn_t::linux_tcp_conn_t(const ip_address_t &peer,
         event_watcher(new event_watcher_t(sock.get(), this)),
         read_in_progress(false), write_in_progress(false),
         read_buffer(IO_BUFFER_SIZE),
+        read_chunk_size(IO_BUFFER_SIZE),
         write_handler(this),
         write_queue_limiter(WRITE_QUEUE_MAX_SIZE),
         write_coro_pool(1, &write_queue, &write_handler),
@@ -251,6 +251,7 @@ linux_tcp_conn_t::linux_tcp_conn_t(fd_t s) :
        event_watcher(new event_watcher_t(sock.get(), this)),
        read_in_progress(false), write_in_progress(false),
        read_buffer(IO_BUFFER_SIZE),
+       read_chunk_size(IO_BUFFER_SIZE),
        write_handler(this),
        write_queue_limiter(WRITE_QUEUE_MAX_SIZE),
        write_coro_pool(1, &write_queue, &write_handler),
@@ -455,10 +456,16 @@ void linux_tcp_conn_t::read_more_buffered(signal_t *closer) THROWS_ONLY(tcp_conn
     read_op_wrapper_t sentry(this, closer);
 
     size_t old_size = read_buffer.size();
-    read_buffer.resize(old_size + IO_BUFFER_SIZE);
-    size_t delta = read_internal(read_buffer.data() + old_size, IO_BUFFER_SIZE);
+    read_buffer.resize(old_size + read_chunk_size);
+    size_t delta = read_internal(read_buffer.data() + old_size, read_chunk_size);
 
     read_buffer.resize(old_size + delta);
+
+    if (delta == read_chunk_size && read_chunk_size < READ_CHUNK_MAX_SIZE) {
+        read_chunk_size *= 2;
+    } else if (delta < read_chunk_size / 2 && read_chunk_size > IO_BUFFER_SIZE) {
+        read_chunk_size /= 2;
+    }
 }
 
 const_charslice linux_tcp_conn_t::peek() const THROWS_ONLY(tcp_conn_read_closed_exc_t) {
@@ -521,19 +528,40 @@ linux_tcp_conn_t::write_handler_t::write_handler_t(linux_tcp_conn_t *_parent) :
 { }
 
 void linux_tcp_conn_t::write_handler_t::coro_pool_callback(write_queue_op_t *operation, UNUSED signal_t *interruptor) {
-    if (operation->buffer != nullptr) {
-        parent->perform_write(operation->buffer, operation->size);
-        if (operation->dealloc != nullptr) {
-            parent->release_write_buffer(operation->dealloc);
-            parent->write_queue_limiter.unlock(operation->size);
+    /* Take whatever else is already waiting in the queue too, so that a response
+    that was buffered in several chunks, or a burst of small messages, goes out with
+    one system call instead of one per operation. */
+    write_queue_op_t *ops[WRITE_GATHER_MAX];
+    const_charslice buffers[WRITE_GATHER_MAX];
+    size_t num_ops = 0;
+    size_t num_buffers = 0;
+    ops[num_ops++] = operation;
+    while (num_ops < WRITE_GATHER_MAX && parent->write_queue.available->get()) {
+        ops[num_ops++] = parent->write_queue.pop();
+    }
+    for (size_t i = 0; i < num_ops; ++i) {
+        if (ops[i]->buffer != nullptr && ops[i]->size > 0) {
+            const char *buffer = static_cast<const char *>(ops[i]->buffer);
+            buffers[num_buffers++] = const_charslice(buffer, buffer + ops[i]->size);
         }
     }
 
-    if (operation->cond != nullptr) {
-        operation->cond->pulse();
+    if (num_buffers > 0) {
+        parent->perform_writev(buffers, num_buffers);
     }
-    if (operation->dealloc != nullptr) {
-        parent->release_write_queue_op(operation);
+
+    for (size_t i = 0; i < num_ops; ++i) {
+        write_queue_op_t *op = ops[i];
+        if (op->buffer != nullptr && op->dealloc != nullptr) {
+            parent->release_write_buffer(op->dealloc);
+            parent->write_queue_limiter.unlock(op->size);
+        }
+        if (op->cond != nullptr) {
+            op->cond->pulse();
+        }
+        if (op->dealloc != nullptr) {
+            parent->release_write_queue_op(op);
+        }
     }
 }
 
@@ -648,6 +676,76 @@ void linux_tcp_conn_t::perform_write(const void *buf, size_t size) {
 #endif
 }
 
+void linux_tcp_conn_t::perform_writev(const const_charslice *buffers, size_t count) {
+    assert_thread();
+
+#ifdef _WIN32
+    for (size_t i = 0; i < count; ++i) {
+        perform_write(buffers[i].beg, buffers[i].end - buffers[i].beg);
+    }
+#else
+    if (write_closed.is_pulsed()) {
+        return;
+    }
+
+    rassert(count <= WRITE_GATHER_MAX);
+    iovec vecs[WRITE_GATHER_MAX];
+    for (size_t i = 0; i < count; ++i) {
+        vecs[i].iov_base = const_cast<char *>(buffers[i].beg);
+        vecs[i].iov_len = buffers[i].end - buffers[i].beg;
+    }
+
+    iovec *next = vecs;
+    while (count > 0) {
+        ssize_t res = ::writev(sock.get(), next, std::min<size_t>(count, IOV_MAX));
+
+        if (res == -1 && (get_errno() == EAGAIN || get_errno() == EWOULDBLOCK)) {
+            linux_event_watcher_t::watch_t watch(event_watcher.get(), poll_event_out);
+            wait_any_t waiter(&watch, &write_closed);
+            waiter.wait_lazily_unordered();
+
+            if (write_closed.is_pulsed()) {
+                break;
+            }
+
+        } else if (res == -1 && (get_errno() == EPIPE || get_errno() == ENOTCONN || get_errno() == EHOSTUNREACH ||
+                                 get_errno() == ENETDOWN || get_errno() == EHOSTDOWN || get_errno() == ECONNRESET)) {
+            on_shutdown_write();
+            break;
+
+        } else if (res == -1) {
+            logERR("Could not write to socket: %s", errno_string(get_errno()).c_str());
+            on_shutdown_write();
+            break;
+
+        } else if (res == 0) {
+            logERR("Didn't expect writev() to return 0.");
+            on_shutdown_write();
+            break;
+
+        } else {
+            if (write_perfmon) {
+                write_perfmon->record(res);
+            }
+            /* Skip the buffers that went out completely, and the written part of
+            the first one that didn't. */
+            size_t written = res;
+            while (count > 0 && written >= next->iov_len) {
+                written -= next->iov_len;
+                ++next;
+                --count;
+            }
+            if (count > 0) {
+                next->iov_base = static_cast<char *>(next->iov_base) + written;
+                next->iov_len -= written;
+            } else {
+                rassert(written == 0);
+            }
+        }
+    }
+#endif
+}
+
 void linux_tcp_conn_t::write(const void *buf, size_t size, signal_t *closer) THROWS_ONLY(tcp_conn_write_closed_exc_t) {
     write_op_wrapper_t sentry(this, closer);
 
@@ -1044,6 +1142,12 @@ size_t linux_secure_tcp_conn_t::read_internal(void *buffer, size_t size)
     }
 }
 
+void linux_secure_tcp_conn_t::perform_writev(const const_charslice *buffers, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        perform_write(buffers[i].beg, buffers[i].end - buffers[i].beg);
+    }
+}
+
 void linux_secure_tcp_conn_t::perform_write(const void *buffer, size_t size) {
     assert_thread();
 
@@ -1263,6 +1367,7 @@ linux_nonthrowing_tcp_listener_t::linux_nonthrowing_tcp_listener_t(
     local_addresses(bind_addresses),
     port(_port),
     bound(false),
+    reuse_port(false),
     socks(),
     last_used_socket_index(0),
     event_watchers(),
@@ -1367,6 +1472,12 @@ int linux_nonthrowing_tcp_listener_t::init_sockets() {
         // to be re-bound quickly (e.g. if you restart the server).
         int res = setsockopt(sock_fd, SOL_SOCKET, SO_REUSEADDR, &sockoptval, sizeof(sockoptval)); 
         guarantee_err(res != -1, "Could not set REUSEADDR option");
+#ifdef SO_REUSEPORT
+        if (reuse_port) {
+            res = setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &sockoptval, sizeof(sockoptval));
+            guarantee_err(res != -1, "Could not set REUSEPORT option");
+        }
+#endif
 #endif
         /* XXX Making our socket NODELAY prevents the problem where responses to
          * pipelined requests are delayed, since the TCP Nagle algorithm will
@@ -1700,6 +1811,58 @@ int linux_tcp_listener_t::get_port() const {
     return listener->get_port();
 }
 
+linux_sharded_tcp_listener_t::linux_sharded_tcp_listener_t(
+        const std::set<ip_address_t> &bind_addresses, int _port, bool reuse_port,
+        const std::function<void(scoped_ptr_t<linux_tcp_conn_descriptor_t> &)> &callback) :
+    listeners(get_num_threads()) {
+#if defined(_WIN32) || !defined(SO_REUSEPORT)
+    reuse_port = false;
+#endif
+    const int home = home_thread().threadnum;
+    listeners[home].init(
+        new linux_nonthrowing_tcp_listener_t(bind_addresses, _port, callback));
+    listeners[home]->reuse_port = reuse_port;
+    if (!listeners[home]->begin_listening()) {
+        throw address_in_use_exc_t("localhost", listeners[home]->get_port());
+    }
+    port = listeners[home]->get_port();
+    if (!reuse_port) {
+        return;
+    }
+
+    // The first listener has settled on a port, and on whether to fall back to IPv4.
+    const std::set<ip_address_t> addresses = listeners[home]->local_addresses;
+    pmap(get_num_threads(), [&](int thread) {
+        if (thread == home) {
+            return;
+        }
+        on_thread_t thread_switcher((threadnum_t(thread)));
+        scoped_ptr_t<linux_nonthrowing_tcp_listener_t> listener(
+            new linux_nonthrowing_tcp_listener_t(addresses, port, callback));
+        listener->reuse_port = true;
+        if (listener->begin_listening()) {
+            listeners[thread] = std::move(listener);
+        } else {
+            // The other threads can still take the connections.
+            logWRN("Could not share port %d with thread %d.", port, thread);
+        }
+    });
+}
+
+linux_sharded_tcp_listener_t::~linux_sharded_tcp_listener_t() {
+    assert_thread();
+    pmap(listeners.size(), [&](int64_t thread) {
+        if (listeners[thread].has()) {
+            on_thread_t thread_switcher((threadnum_t(thread)));
+            listeners[thread].reset();
+        }
+    });
+}
+
+int linux_sharded_tcp_listener_t::get_port() const {
+    return port;
+}
+
 linux_repeated_nonthrowing_tcp_listener_t::linux_repeated_nonthrowing_tcp_listener_t(
     const std::set<ip_address_t> &bind_addresses,
     int port,
@@ -266,8 +266,19 @@ private:
     /* Holds data that we read from the socket but hasn't been consumed yet */
     lazy_erase_vector_t<char> read_buffer;
 
+    /* `read_more_buffered()` asks the kernel for `read_chunk_size` bytes at a time. It
+    doubles whenever a read fills the whole chunk, up to `READ_CHUNK_MAX_SIZE`, and
+    halves when a read comes back less than half full, so that bulk transfers take
+    fewer system calls while connections that only see small messages keep reading
+    small chunks. */
+    static const size_t READ_CHUNK_MAX_SIZE = 64 * KILOBYTE;
+    size_t read_chunk_size;
+
     static const size_t WRITE_QUEUE_MAX_SIZE = 128 * KILOBYTE;
     static const size_t WRITE_CHUNK_SIZE = 8 * KILOBYTE;
+    /* The write coroutine sends up to this many queued writes with one call to
+    `perform_writev()`. */
+    static const size_t WRITE_GATHER_MAX = 64;
 
     /* Structs to avoid over-using dynamic allocation */
     struct write_buffer_t : public intrusive_list_node_t<write_buffer_t> {
@@ -345,6 +356,10 @@ private:
     /* Used to actually perform a write. If the write end of the connection is open, then
     writes `size` bytes from `buffer` to the socket. */
     virtual void perform_write(const void *buffer, size_t size);
+
+    /* Like `perform_write()`, but writes `count` buffers one after the other. On Linux
+    this is a single `writev()` unless the socket is backed up. */
+    virtual void perform_writev(const const_charslice *buffers, size_t count);
 };
 
 #ifdef ENABLE_TLS
@@ -409,6 +424,10 @@ private:
     writes `size` bytes from `buffer` to the socket. */
     virtual void perform_write(const void *buffer, size_t size);
 
+    /* Writes the buffers one at a time, since each `SSL_write()` encrypts its own
+    records anyway. */
+    virtual void perform_writev(const const_charslice *buffers, size_t count);
+
     void shutdown();
     void shutdown_socket();
 
@@ -464,6 +483,7 @@ public:
 protected:
     friend class linux_tcp_listener_t;
     friend class linux_tcp_bound_socket_t;
+    friend class linux_sharded_tcp_listener_t;
 
     void bind_sockets();
 
@@ -502,6 +522,10 @@ private:
     // Inidicates successful binding to a port
     bool bound;
 
+    // Whether to set `SO_REUSEPORT` on the sockets, so that other listeners on other
+    // threads can share the port. Must be set before the sockets are bound.
+    bool reuse_port;
+
     // The sockets to listen for connections on
     scoped_array_t<scoped_fd_t> socks;
 
@@ -539,6 +563,32 @@ private:
     scoped_ptr_t<linux_nonthrowing_tcp_listener_t> listener;
 };
 
+/* Like `linux_tcp_listener_t`, but if `reuse_port` is true, it listens on every thread
+with a separate set of sockets, all bound to the same port with `SO_REUSEPORT`. The
+kernel spreads incoming connections across the sockets, so accepting them isn't limited
+to a single thread, and the callback is called on whichever thread accepted the
+connection. Note that while the port is shared like that, other processes run by the
+same user can bind to it too.
+
+If `reuse_port` is false, or the platform doesn't support `SO_REUSEPORT`, it only
+listens on the thread it was created on. */
+class linux_sharded_tcp_listener_t : public home_thread_mixin_t {
+public:
+    linux_sharded_tcp_listener_t(const std::set<ip_address_t> &bind_addresses, int port,
+        bool reuse_port,
+        const std::function<void(scoped_ptr_t<linux_tcp_conn_descriptor_t> &)> &callback);
+    ~linux_sharded_tcp_listener_t();
+
+    int get_port() const;
+
+private:
+    // Indexed by thread. Each one lives on its own thread.
+    scoped_array_t<scoped_ptr_t<linux_nonthrowing_tcp_listener_t> > listeners;
+    int port;
+
+    DISABLE_COPYING(linux_sharded_tcp_listener_t);
+};
+
 /* Like a linux tcp listener but repeatedly tries to bind to its port until successful */
 class linux_repeated_nonthrowing_tcp_listener_t {
 public:
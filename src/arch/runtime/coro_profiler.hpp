@@ -63,6 +63,9 @@
  *
  * The aggregated data is written to the file "coro_profiler_out_PID.py" in the working
  * directory. Data is written every `CORO_PROFILER_REPORTING_INTERVAL` ticks.
+ *
+ * To find out where a running server spends its time without a special build, use
+ * the sampling profiler in `arch/runtime/coro_sampler.hpp` instead.
  */
 class coro_profiler_t {
 public:
@@ -0,0 +1,305 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/runtime/coro_sampler.hpp"
+
+#include <errno.h>
+#include <string.h>
+#ifdef __linux__
+#include <ucontext.h>
+#endif
+
+#include <algorithm>
+
+#include "arch/io/io_utils.hpp"
+#include "arch/runtime/coroutines.hpp"
+#include "arch/runtime/runtime.hpp"
+#include "arch/runtime/runtime_utils.hpp"
+#include "backtrace.hpp"
+#include "concurrency/pmap.hpp"
+#include "rethinkdb_backtrace.hpp"
+#include "utils.hpp"
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+#ifdef __linux__
+// The thread pool's threads block `SIGPROF` except while we are sampling them, so that
+// a stray `SIGPROF` can't do anything to them the rest of the time.
+static void set_sigprof_blocked(bool blocked) {
+    sigset_t sigmask;
+    int res = sigemptyset(&sigmask);
+    guarantee_err(res == 0, "Could not create an empty signal mask");
+    res = sigaddset(&sigmask, SIGPROF);
+    guarantee_err(res == 0, "Could not add SIGPROF to signal mask");
+    res = pthread_sigmask(blocked ? SIG_BLOCK : SIG_UNBLOCK, &sigmask, nullptr);
+    guarantee_xerr(res == 0, res, "Could not change whether SIGPROF is blocked");
+}
+#endif
+
+coro_sampler_t::coro_sampler_t() : frequency_(0), installed_handler_(false) { }
+
+coro_sampler_t::~coro_sampler_t() {
+    assert_thread();
+    if (is_enabled()) {
+        disable();
+    }
+#ifdef __linux__
+    if (installed_handler_) {
+        // The default action for `SIGPROF` terminates the process, so we'd better not
+        // restore it.
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = SIG_IGN;
+        int res = sigaction(SIGPROF, &sa, nullptr);
+        guarantee_err(res == 0, "Could not unregister the SIGPROF handler");
+    }
+#endif
+}
+
+bool coro_sampler_t::enable(int frequency, UNUSED std::string *error_out) {
+    assert_thread();
+    guarantee(frequency > 0);
+#ifdef __linux__
+    new_mutex_acq_t acq(&mutex_);
+    if (is_enabled()) {
+        pmap(states_.size(), [this](int64_t i) { stop_thread(i); });
+        frequency_ = 0;
+    }
+
+    if (!installed_handler_) {
+        // The first call to `backtrace()` might allocate memory while it loads the
+        // unwinder, which we mustn't do in the signal handler. So we get it out of the
+        // way, like `stall_detector_t::install()` does.
+        void *dummy[1];
+        rethinkdb_backtrace(dummy, 1);
+
+        struct sigaction sa = make_sa_sigaction(SA_SIGINFO | SA_RESTART,
+                                                &coro_sampler_t::on_signal);
+        int res = sigaction(SIGPROF, &sa, nullptr);
+        guarantee_err(res == 0, "Could not register the SIGPROF handler");
+        installed_handler_ = true;
+    }
+
+    // We only allocate the buffers once the sampler is used, so that an unused
+    // sampler doesn't cost anything.
+    states_.clear();
+    for (int i = 0; i < get_num_threads(); ++i) {
+        states_.push_back(make_scoped<thread_state_t>());
+    }
+    pmap(states_.size(), [this, frequency](int64_t i) { start_thread(i, frequency); });
+    frequency_ = frequency;
+    return true;
+#else
+    *error_out = "The sampling profiler is only supported on Linux.";
+    return false;
+#endif
+}
+
+void coro_sampler_t::disable() {
+    assert_thread();
+    new_mutex_acq_t acq(&mutex_);
+    if (is_enabled()) {
+        pmap(states_.size(), [this](int64_t i) { stop_thread(i); });
+        frequency_ = 0;
+    }
+}
+
+void coro_sampler_t::start_thread(int thread, int frequency) {
+#ifdef __linux__
+    on_thread_t thread_switcher((threadnum_t(thread)));
+    thread_state_t *state = states_[thread].get();
+
+    struct sigevent evp;
+    memset(&evp, 0, sizeof(evp));
+    evp.sigev_signo = SIGPROF;
+    evp.sigev_notify = SIGEV_THREAD_ID;
+    evp.sigev_notify_thread_id = _gettid();
+    evp.sigev_value.sival_ptr = state;
+
+    // `CLOCK_THREAD_CPUTIME_ID` only advances while this thread is running, so an
+    // idle thread doesn't get sampled.
+    int res = timer_create(CLOCK_THREAD_CPUTIME_ID, &evp, &state->timer);
+    guarantee_err(res == 0, "Could not create the sampling timer");
+    state->has_timer = true;
+
+    set_sigprof_blocked(false);
+
+    const int64_t interval_nanos = BILLION / frequency;
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = interval_nanos / BILLION;
+    spec.it_interval.tv_nsec = interval_nanos % BILLION;
+    spec.it_value = spec.it_interval;
+    res = timer_settime(state->timer, 0, &spec, nullptr);
+    guarantee_err(res == 0, "Could not arm the sampling timer");
+
+    // Every sample holds a whole stack, so the buffer is small and gets drained four
+    // times per second. That's enough for up to 4096 samples per second.
+    state->drain_timer.init(new repeating_timer_t(250, [state]() { drain(state); }));
+#else
+    (void)thread;
+    (void)frequency;
+#endif
+}
+
+void coro_sampler_t::stop_thread(int thread) {
+#ifdef __linux__
+    on_thread_t thread_switcher((threadnum_t(thread)));
+    thread_state_t *state = states_[thread].get();
+    state->drain_timer.reset();
+    if (state->has_timer) {
+        // This also discards a signal that's still pending.
+        int res = timer_delete(state->timer);
+        guarantee_err(res == 0, "Could not delete the sampling timer");
+        state->has_timer = false;
+        set_sigprof_blocked(true);
+    }
+    drain(state);
+#else
+    (void)thread;
+#endif
+}
+
+void coro_sampler_t::on_signal(UNUSED int signum, siginfo_t *siginfo, void *ucontext) {
+#ifdef __linux__
+    // Somebody might have sent us a `SIGPROF` by hand.
+    if (siginfo->si_code != SI_TIMER || siginfo->si_value.sival_ptr == nullptr) {
+        return;
+    }
+    int saved_errno = errno;
+    thread_state_t *state = static_cast<thread_state_t *>(siginfo->si_value.sival_ptr);
+
+    const void *pc = nullptr;
+#if defined(__x86_64__)
+    pc = reinterpret_cast<const void *>(
+        static_cast<ucontext_t *>(ucontext)->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+    pc = reinterpret_cast<const void *>(
+        static_cast<ucontext_t *>(ucontext)->uc_mcontext.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+    pc = reinterpret_cast<const void *>(
+        static_cast<ucontext_t *>(ucontext)->uc_mcontext.pc);
+#else
+    (void)ucontext;
+#endif
+    coro_t *coro = coro_t::self();
+
+    // The thread itself only ever advances `tail`, and it can't run while we do.
+    uint64_t head = state->head.load(std::memory_order_relaxed);
+    if (head - state->tail.load(std::memory_order_acquire) >= buffer_size) {
+        state->dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // The frames before the interrupted one belong to the signal handler and the
+        // signal trampoline. We look for the interrupted instruction to find out how
+        // many of them there are, and assume two if we can't.
+        void *frames[max_frames + 2];
+        const int num_frames = rethinkdb_backtrace(frames, max_frames + 2);
+        int first = 2;
+        for (int i = 0; i < num_frames && i <= 2; ++i) {
+            if (pc != nullptr && frames[i] == pc) {
+                first = i;
+                break;
+            }
+        }
+
+        sample_t *sample = &state->buffer[head % buffer_size];
+        int n = 0;
+        for (int i = first; i < num_frames && n < max_frames; ++i) {
+            sample->frames[n++] = frames[i];
+        }
+        if (n == 0 && pc != nullptr) {
+            sample->frames[n++] = pc;
+        }
+        sample->num_frames = n;
+        sample->spawn_site = coro != nullptr ? coro->get_spawn_site() : nullptr;
+        state->head.store(head + 1, std::memory_order_release);
+    }
+    errno = saved_errno;
+#else
+    (void)siginfo;
+    (void)ucontext;
+#endif
+}
+
+void coro_sampler_t::drain(thread_state_t *state) {
+    uint64_t head = state->head.load(std::memory_order_acquire);
+    uint64_t tail = state->tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+        const sample_t &sample = state->buffer[tail % buffer_size];
+        std::vector<const void *> stack(sample.frames,
+                                        sample.frames + sample.num_frames);
+        ++state->counts[std::make_pair(sample.spawn_site, std::move(stack))];
+        ++state->total;
+    }
+    state->tail.store(tail, std::memory_order_release);
+}
+
+static std::string demangle_or_raw(const char *name) {
+    try {
+        return demangle_cpp_name(name);
+    } catch (const demangle_failed_exc_t &) {
+        return name;
+    }
+}
+
+std::vector<coro_sampler_t::thread_report_t> coro_sampler_t::get_report(
+        size_t max_entries) {
+    assert_thread();
+    new_mutex_acq_t acq(&mutex_);
+
+    std::vector<counts_t> counts(states_.size());
+    std::vector<thread_report_t> reports(states_.size());
+    pmap(states_.size(), [&](int64_t i) {
+        on_thread_t thread_switcher((threadnum_t(i)));
+        thread_state_t *state = states_[i].get();
+        drain(state);
+        counts[i] = state->counts;
+        reports[i].samples = state->total;
+        reports[i].dropped_samples = state->dropped.load(std::memory_order_relaxed);
+    });
+
+    // Resolving symbols is slow, so we only do it once per address.
+    std::map<const void *, std::string> functions;
+    std::map<const char *, std::string> spawn_sites;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        std::map<std::pair<std::string, std::vector<std::string> >, uint64_t> by_stack;
+        for (const auto &pair : counts[i]) {
+            const char *spawn_site = pair.first.first;
+            auto site_it = spawn_sites.find(spawn_site);
+            if (site_it == spawn_sites.end()) {
+                site_it = spawn_sites.insert(std::make_pair(spawn_site,
+                    spawn_site == nullptr ? std::string() : demangle_or_raw(spawn_site)))
+                    .first;
+            }
+
+            std::vector<std::string> stack;
+            for (const void *pc : pair.first.second) {
+                auto function_it = functions.find(pc);
+                if (function_it == functions.end()) {
+                    backtrace_frame_t frame(pc);
+                    frame.initialize_symbols();
+                    std::string function = frame.get_name().empty()
+                        ? strprintf("%p", pc)
+                        : demangle_or_raw(frame.get_name().c_str());
+                    function_it = functions.insert(std::make_pair(pc, function)).first;
+                }
+                stack.push_back(function_it->second);
+            }
+            if (stack.empty()) {
+                stack.push_back("(unknown)");
+            }
+
+            by_stack[std::make_pair(site_it->second, std::move(stack))] += pair.second;
+        }
+
+        for (const auto &pair : by_stack) {
+            reports[i].entries.push_back(entry_t{
+                pair.first.first, pair.first.second[0], pair.first.second, pair.second});
+        }
+        std::sort(reports[i].entries.begin(), reports[i].entries.end(),
+            [](const entry_t &a, const entry_t &b) { return a.samples > b.samples; });
+        if (reports[i].entries.size() > max_entries) {
+            reports[i].entries.resize(max_entries);
+        }
+    }
+    return reports;
+}
@@ -0,0 +1,118 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef ARCH_RUNTIME_CORO_SAMPLER_HPP_
+#define ARCH_RUNTIME_CORO_SAMPLER_HPP_
+
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arch/timing.hpp"
+#include "concurrency/new_mutex.hpp"
+#include "containers/scoped.hpp"
+#include "threading.hpp"
+
+/* `coro_sampler_t` is a sampling profiler that can be turned on and off while the
+server is running. While it's enabled, every thread in the thread pool has a timer that
+sends it a signal whenever the thread has used up another `1 / frequency` seconds of CPU
+time. The signal handler records a bounded backtrace of what the thread was executing
+and the spawn site of the coroutine it was running (see `coro_t::get_spawn_site()`) in a
+per-thread buffer, and every thread periodically folds its samples into counts per
+stack. A report tells, for each thread, where its CPU time went and how it got there.
+
+Unlike `coro_profiler_t`, it doesn't need a special build and costs nothing while it's
+disabled. It's only supported on Linux.
+
+There should be at most one `coro_sampler_t` per process, since it owns the `SIGPROF`
+handler. All of its methods must be called on its home thread. */
+class coro_sampler_t : public home_thread_mixin_t {
+public:
+    struct entry_t {
+        /* The demangled spawn site, or empty if the thread wasn't running a
+        coroutine. */
+        std::string spawn_site;
+        /* The function that the thread was executing, which is the same as
+        `stack[0]`. */
+        std::string function;
+        /* The functions on the stack, innermost first, cut off after `max_frames`. */
+        std::vector<std::string> stack;
+        uint64_t samples;
+    };
+
+    struct thread_report_t {
+        uint64_t samples;
+        /* Samples that were lost because the buffer was full. */
+        uint64_t dropped_samples;
+        /* Sorted by `samples`, in descending order. */
+        std::vector<entry_t> entries;
+    };
+
+    coro_sampler_t();
+    ~coro_sampler_t();
+
+    /* Starts sampling every thread `frequency` times per second of CPU time, and
+    discards the samples from any previous run. Returns false and sets `error_out` if
+    sampling isn't supported. */
+    bool enable(int frequency, std::string *error_out);
+    void disable();
+
+    bool is_enabled() const { return frequency_ != 0; }
+    int frequency() const { return frequency_; }
+
+    /* Returns the samples that were taken since the sampler was last enabled, with at
+    most `max_entries` entries per thread. Works while the sampler is disabled, too. */
+    std::vector<thread_report_t> get_report(size_t max_entries);
+
+private:
+    static const size_t buffer_size = 1024;
+    static const int max_frames = 16;
+
+    struct sample_t {
+        const void *frames[max_frames];
+        int num_frames;
+        const char *spawn_site;
+    };
+
+    typedef std::map<std::pair<const char *, std::vector<const void *> >, uint64_t>
+        counts_t;
+
+    /* The signal handler is the only writer of `buffer` and `head`; the thread itself
+    is the only reader, and the only one who touches everything else. */
+    struct thread_state_t {
+        thread_state_t() : head(0), tail(0), dropped(0), total(0), has_timer(false) { }
+
+        sample_t buffer[buffer_size];
+        std::atomic<uint64_t> head;
+        std::atomic<uint64_t> tail;
+        std::atomic<uint64_t> dropped;
+
+        counts_t counts;
+        uint64_t total;
+
+        bool has_timer;
+        timer_t timer;
+        scoped_ptr_t<repeating_timer_t> drain_timer;
+    };
+
+    static void on_signal(int signum, siginfo_t *siginfo, void *ucontext);
+    static void drain(thread_state_t *state);
+
+    void start_thread(int thread, int frequency);
+    void stop_thread(int thread);
+
+    std::vector<scoped_ptr_t<thread_state_t> > states_;
+    int frequency_;
+    bool installed_handler_;
+
+    /* Serializes `enable()`, `disable()` and `get_report()`. */
+    new_mutex_t mutex_;
+
+    DISABLE_COPYING(coro_sampler_t);
+};
+
+#endif  // ARCH_RUNTIME_CORO_SAMPLER_HPP_
@@ -13,6 +13,7 @@
 
 #include "arch/runtime/context_switching.hpp"
 #include "arch/runtime/coro_profiler.hpp"
+#include "arch/runtime/resource_account.hpp"
 #include "arch/runtime/runtime.hpp"
 #include "arch/runtime/thread_pool.hpp"
 #include "config/args.hpp"
@@ -167,6 +168,9 @@ coro_t::coro_t() :
     current_thread_(linux_thread_pool_t::get_thread_id()),
     notified_(false),
     waiting_(false),
+    spawn_site_(nullptr),
+    resource_account_(nullptr),
+    resource_account_resumed_at_(0),
     protected_stack_lru_entry_(this)
 #ifndef NDEBUG
     , selfname_number(get_thread_id().threadnum + MAX_THREADS *
@@ -361,6 +365,7 @@ void coro_t::wait() {   /* class method */
     self()->waiting_ = true;
 
     PROFILER_CORO_YIELD(1);
+    self()->pause_resource_account();
     if (TLS_get_cglobals()->prev_coro) {
         TLS_get_cglobals()->prev_coro->switch_to_coro_with_protection(
             &self()->stack.context);
@@ -372,6 +377,7 @@ void coro_t::wait() {   /* class method */
     rassert(self());
     rassert(self()->waiting_);
     self()->waiting_ = false;
+    self()->resume_resource_account();
 }
 
 void coro_t::yield() {  /* class method */
@@ -404,6 +410,7 @@ void coro_t::notify_now_deprecated() {
 
     if (coro_t::self() != nullptr) {
         PROFILER_CORO_YIELD(1);
+        coro_t::self()->pause_resource_account();
     }
     coro_t *prev_prev_coro = TLS_get_cglobals()->prev_coro;
     TLS_get_cglobals()->prev_coro = TLS_get_cglobals()->current_coro;
@@ -420,6 +427,7 @@ void coro_t::notify_now_deprecated() {
     TLS_get_cglobals()->prev_coro = prev_prev_coro;
     if (coro_t::self() != nullptr) {
         PROFILER_CORO_RESUME;
+        coro_t::self()->resume_resource_account();
     }
 
 #ifndef NDEBUG
@@ -479,6 +487,19 @@ void coro_t::on_thread_switch() {
     notify_now_deprecated();
 }
 
+void coro_t::pause_resource_account() {
+    if (resource_account_ != nullptr) {
+        resource_account_->charge_cpu_nanos(
+            get_ticks().nanos - resource_account_resumed_at_);
+    }
+}
+
+void coro_t::resume_resource_account() {
+    if (resource_account_ != nullptr) {
+        resource_account_resumed_at_ = get_ticks().nanos;
+    }
+}
+
 void coro_t::set_coroutine_stack_size(size_t size) {
     coro_stack_size = size;
 }
@@ -3,6 +3,7 @@
 #define ARCH_RUNTIME_COROUTINES_HPP_
 
 #include <exception>
+#include <typeinfo>
 #ifndef NDEBUG
 #include <string>
 #endif
@@ -26,6 +27,7 @@
 threadnum_t get_thread_id();
 struct coro_globals_t;
 class coro_t;
+class resource_account_t;
 
 
 struct coro_profiler_mixin_t {
@@ -165,6 +167,11 @@ public:
     Returns how many entries have been deposited into `buffer_out`. */
     int copy_spawn_backtrace(void **buffer_out, int size) const;
 
+    /* Returns the mangled name of the type of the callable that the coroutine was
+    spawned with. It's cheap enough to record in release mode, and it usually tells
+    where the coroutine was spawned, for example for lambdas. */
+    const char *get_spawn_site() const { return spawn_site_; }
+
 private:
     /* When called from within a coroutine, schedules the coroutine to be run on
     the given thread and then suspends the coroutine until that other thread
@@ -191,6 +198,7 @@ private:
         coro->parse_coroutine_type(CURRENT_FUNCTION_PRETTY);
 #endif
         coro->grab_spawn_backtrace();
+        coro->spawn_site_ = typeid(callable_t).name();
         coro->action_wrapper.reset(std::forward<callable_t>(action));
 
         // If we were called from a coroutine, the new coroutine inherits our
@@ -215,6 +223,13 @@ private:
     friend struct coro_globals_t;
     ~coro_t();
 
+    /* Called whenever the coroutine stops and starts running, to charge the time in
+    between to `resource_account_`. */
+    friend class resource_account_t;
+    friend class resource_account_scope_t;
+    void pause_resource_account();
+    void resume_resource_account();
+
     virtual void on_thread_switch();
 
     coro_stack_t stack;
@@ -227,6 +242,12 @@ private:
 
     callable_action_wrapper_t action_wrapper;
 
+    const char *spawn_site_;
+
+    /* See `resource_account_t`. `resource_account_resumed_at_` is in ticks. */
+    resource_account_t *resource_account_;
+    int64_t resource_account_resumed_at_;
+
     /* Used to eventually unprotect the coroutine if it has been inactive for a while. */
     coro_lru_entry_t protected_stack_lru_entry_;
 
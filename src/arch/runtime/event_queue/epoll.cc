@@ -59,7 +59,9 @@ void epoll_event_queue_t::run() {
     // Now, start the loop
     while (!parent->should_shut_down()) {
         // Grab the events from the kernel!
+        parent->on_wait_start();
         res = epoll_wait(epoll_fd, events, MAX_IO_EVENT_PROCESSING_BATCH_SIZE, -1);
+        parent->on_wait_end();
 
         // epoll_wait might return with EINTR in some cases (in
         // particular under GDB), we just need to retry.
@@ -114,12 +114,14 @@ void iocp_event_queue_t::run() {
                      wait_ms,
                      wait_ms == INFINITE ? " inf" : "");
 
+        thread->on_wait_start();
         BOOL res = GetQueuedCompletionStatus(completion_port,
                                              &nb_bytes,
                                              &key,
                                              &overlapped,
                                              wait_ms);
         DWORD error = res ? NO_ERROR : GetLastError();
+        thread->on_wait_end();
 
         if (timer_cb != nullptr &&
               (error == WAIT_TIMEOUT || next_time.nanos < get_ticks().nanos)) {
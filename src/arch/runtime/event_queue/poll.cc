@@ -90,19 +90,31 @@ void poll_event_queue_t::run() {
     // sigmask_restricted is configured to allow this
     // one signal through while blocking the other signals
     // for the main thread to handle.
-    sigset_t sigmask_restricted, sigmask_full;
+    // `SIGPROF` stays blocked while we wait; the sampler's timer only fires while the
+    // thread uses CPU time, which it doesn't do in `ppoll()`.
+    sigset_t sigmask_restricted, sigmask_timer;
     res = sigfillset(&sigmask_restricted);
     guarantee_err(res == 0, "Could not create an full signal mask");
     res = sigdelset(&sigmask_restricted, TIMER_NOTIFY_SIGNAL);
     guarantee_err(res == 0, "Could not remove TIMER_NOTIFY_SIGNAL from signal mask");
+#ifdef STALL_DETECTOR_SIGNAL
+    res = sigdelset(&sigmask_restricted, STALL_DETECTOR_SIGNAL);
+    guarantee_err(res == 0, "Could not remove STALL_DETECTOR_SIGNAL from signal mask");
+#endif
 
-    res = sigfillset(&sigmask_full);
-    guarantee_err(res == 0, "Could not create a full signal mask");
+    // Outside of `ppoll()`, we only ever change whether `TIMER_NOTIFY_SIGNAL` is
+    // blocked, and leave the rest of the thread's signal mask alone. In particular,
+    // `coro_sampler_t` unblocks `SIGPROF` while it's enabled.
+    res = sigemptyset(&sigmask_timer);
+    guarantee_err(res == 0, "Could not create an empty signal mask");
+    res = sigaddset(&sigmask_timer, TIMER_NOTIFY_SIGNAL);
+    guarantee_err(res == 0, "Could not add TIMER_NOTIFY_SIGNAL to signal mask");
 #endif  // RDB_TIMER_PROVIDER
 
     // Now, start the loop
     while (!parent->should_shut_down()) {
         // Grab the events from the kernel!
+        parent->on_wait_start();
 #ifndef RDB_TIMER_PROVIDER
 #error "RDB_TIMER_PROVIDER not defined."
 #elif RDB_TIMER_PROVIDER == RDB_TIMER_PROVIDER_SIGNAL
@@ -110,6 +122,7 @@ void poll_event_queue_t::run() {
 #else
         res = poll(&watched_fds[0], watched_fds.size(), -1);
 #endif
+        parent->on_wait_end();
         // ppoll might return with EINTR in some cases (in particular
         // under GDB), we just need to retry.
         if (res == -1 && get_errno() == EINTR) {
@@ -140,9 +153,9 @@ void poll_event_queue_t::run() {
         // kernel starves out signals, so we need to unblock them to
         // let the signal handlers get called, and then block them
         // right back. What a sensible fucking system.
-        res = pthread_sigmask(SIG_SETMASK, &sigmask_restricted, nullptr);
+        res = pthread_sigmask(SIG_UNBLOCK, &sigmask_timer, nullptr);
         guarantee_xerr(res == 0, res, "Could not unblock signals");
-        res = pthread_sigmask(SIG_SETMASK, &sigmask_full, nullptr);
+        res = pthread_sigmask(SIG_BLOCK, &sigmask_timer, nullptr);
         guarantee_xerr(res == 0, res, "Could not block signals");
 #endif  // RDB_TIMER_PROVIDER
 
@@ -15,6 +15,9 @@ struct linux_event_callback_t {
 struct linux_queue_parent_t {
     virtual void pump() = 0;
     virtual bool should_shut_down() = 0;
+    // Called right before and right after the event queue blocks waiting for events
+    virtual void on_wait_start() = 0;
+    virtual void on_wait_end() = 0;
     virtual ~linux_queue_parent_t() {}
 };
 
@@ -8,6 +8,7 @@
 
 #include "config/args.hpp"
 #include "arch/runtime/event_queue.hpp"
+#include "arch/runtime/stall_detector.hpp"
 #include "arch/runtime/thread_pool.hpp"
 #include "logger.hpp"
 #include "random.hpp"
@@ -20,10 +21,13 @@
 
 linux_message_hub_t::linux_message_hub_t(linux_event_queue_t *queue,
                                          linux_thread_pool_t *thread_pool,
+                                         stall_detector_t *stall_detector,
                                          threadnum_t current_thread)
     : queue_(queue),
       thread_pool_(thread_pool),
+      stall_detector_(stall_detector),
       is_woken_up_(false),
+      runnable_messages_avg_(0),
       current_thread_(current_thread) {
 
 #ifndef NDEBUG
@@ -113,6 +117,13 @@ linux_message_hub_t::msg_list_t &linux_message_hub_t::get_priority_msg_list(int
     return priority_msg_lists_[priority - MESSAGE_SCHEDULER_MIN_PRIORITY];
 }
 
+void linux_message_hub_t::update_runnable_average(size_t runnable) {
+    // Every sample has a weight of 1/8. Only this thread writes the average.
+    int64_t avg = runnable_messages_avg_.load(std::memory_order_relaxed);
+    int64_t sample = static_cast<int64_t>(runnable) * runnable_avg_scale;
+    runnable_messages_avg_.store(avg + (sample - avg) / 8, std::memory_order_relaxed);
+}
+
 void linux_message_hub_t::on_event(int events) {
     if (events != poll_event_in) {
         logERR("Unexpected event mask: %d", events);
@@ -135,6 +146,7 @@ void linux_message_hub_t::on_event(int events) {
     }
     const size_t effective_granularity = std::min(total_pending_msgs,
                                                   static_cast<size_t>(MESSAGE_SCHEDULER_GRANULARITY));
+    update_runnable_average(total_pending_msgs);
 
     // Process a certain number of messages from each priority
     for (int current_priority = MESSAGE_SCHEDULER_MAX_PRIORITY;
@@ -167,9 +179,17 @@ void linux_message_hub_t::on_event(int events) {
             }
 #endif
 
+            stall_detector_->on_message(get_coarse_ticks());
             m->on_thread_switch();
         }
     }
+    stall_detector_->on_message(get_coarse_ticks());
+
+    size_t remaining_msgs = 0;
+    for (int i = 0; i < NUM_SCHEDULER_PRIORITIES; ++i) {
+        remaining_msgs += priority_msg_lists_[i].size();
+    }
+    update_runnable_average(remaining_msgs);
 
     // We might have left some messages unprocessed.
     // Check if that is the case, and if yes, make sure we are called again.
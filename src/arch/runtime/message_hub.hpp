@@ -4,6 +4,8 @@
 
 #include <pthread.h>
 
+#include <atomic>
+
 #include "arch/runtime/event_queue.hpp"
 #include "arch/runtime/runtime_utils.hpp"
 #include "arch/runtime/system_event.hpp"
@@ -19,6 +21,7 @@
 
 
 class linux_thread_pool_t;
+class stall_detector_t;
 
 /* There is one message hub per thread, NOT one message hub for the entire program.
 
@@ -30,7 +33,7 @@ public:
     typedef intrusive_list_t<linux_thread_message_t> msg_list_t;
 
     linux_message_hub_t(linux_event_queue_t *queue, linux_thread_pool_t *thread_pool,
-                        threadnum_t current_thread);
+                        stall_detector_t *stall_detector, threadnum_t current_thread);
 
     /* For each thread, transfer messages from our msg_local_list for that thread to our
     msg_global_list for that thread */
@@ -48,6 +51,16 @@ public:
     // (which does not have an event queue)
     void insert_external_message(linux_thread_message_t *msg);
 
+    /* How many messages have been waiting to be delivered, which mostly means
+    coroutines that are ready to run, rounded to a whole number. This is a moving
+    average over the recent passes of `on_event()`, so that a momentary burst or lull
+    doesn't count for much. It can be called from any thread, and is meant for
+    spreading load across threads. */
+    size_t runnable_message_count() const {
+        return (runnable_messages_avg_.load(std::memory_order_relaxed)
+                + runnable_avg_scale / 2) / runnable_avg_scale;
+    }
+
     ~linux_message_hub_t();
 
 private:
@@ -64,6 +77,9 @@ private:
     linux_event_queue_t *const queue_;
     linux_thread_pool_t *const thread_pool_;
 
+    /* Told about every message we deliver, so it can tell how long each one took. */
+    stall_detector_t *const stall_detector_;
+
     /* Queue for messages going from this->current_thread to other threads */
     struct thread_queue_t {
         //TODO this doesn't need to be a class anymore
@@ -87,6 +103,14 @@ private:
     // MESSAGE_SCHEDULER_ORDERED_PRIORITY)
     msg_list_t priority_msg_lists_[NUM_SCHEDULER_PRIORITIES];
 
+    // Adds a sample of the number of waiting messages to `runnable_messages_avg_`.
+    void update_runnable_average(size_t runnable);
+
+    // `runnable_messages_avg_` is in units of 1 / `runnable_avg_scale` messages. It's
+    // updated by `on_event()` and read by `runnable_message_count()`.
+    static const int64_t runnable_avg_scale = 16;
+    std::atomic<int64_t> runnable_messages_avg_;
+
     void on_event(int events);
 
     // The eventfd (or pipe-based alternative) notified after the first incoming
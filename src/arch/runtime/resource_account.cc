@@ -0,0 +1,49 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/runtime/resource_account.hpp"
+
+#include "arch/runtime/coroutines.hpp"
+#include "containers/archive/archive.hpp"
+
+RDB_IMPL_SERIALIZABLE_4_FOR_CLUSTER(resource_usage_t,
+    cpu_nanos, blocks_from_cache, blocks_from_disk, rows_scanned);
+
+resource_account_t::resource_account_t()
+    : cpu_nanos_(0), blocks_from_cache_(0), blocks_from_disk_(0), rows_scanned_(0) { }
+
+resource_account_t *resource_account_t::current() {
+    coro_t *coro = coro_t::self();
+    return coro == nullptr ? nullptr : coro->resource_account_;
+}
+
+void resource_account_t::charge(const resource_usage_t &usage) {
+    cpu_nanos_.fetch_add(usage.cpu_nanos, std::memory_order_relaxed);
+    blocks_from_cache_.fetch_add(usage.blocks_from_cache, std::memory_order_relaxed);
+    blocks_from_disk_.fetch_add(usage.blocks_from_disk, std::memory_order_relaxed);
+    rows_scanned_.fetch_add(usage.rows_scanned, std::memory_order_relaxed);
+}
+
+resource_usage_t resource_account_t::get_usage() const {
+    resource_usage_t usage;
+    usage.cpu_nanos = cpu_nanos_.load(std::memory_order_relaxed);
+    usage.blocks_from_cache = blocks_from_cache_.load(std::memory_order_relaxed);
+    usage.blocks_from_disk = blocks_from_disk_.load(std::memory_order_relaxed);
+    usage.rows_scanned = rows_scanned_.load(std::memory_order_relaxed);
+    return usage;
+}
+
+resource_account_scope_t::resource_account_scope_t(resource_account_t *account)
+    : coro_(coro_t::self()),
+      parent_(coro_ == nullptr ? nullptr : coro_->resource_account_) {
+    guarantee(coro_ != nullptr, "Resource accounting only works in a coroutine.");
+    guarantee(account != nullptr);
+    coro_->pause_resource_account();
+    coro_->resource_account_ = account;
+    coro_->resume_resource_account();
+}
+
+resource_account_scope_t::~resource_account_scope_t() {
+    rassert(coro_t::self() == coro_);
+    coro_->pause_resource_account();
+    coro_->resource_account_ = parent_;
+    coro_->resume_resource_account();
+}
@@ -0,0 +1,106 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef ARCH_RUNTIME_RESOURCE_ACCOUNT_HPP_
+#define ARCH_RUNTIME_RESOURCE_ACCOUNT_HPP_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "errors.hpp"
+#include "rpc/serialize_macros.hpp"
+
+class coro_t;
+
+/* `resource_usage_t` is what a piece of work, usually a query or one shard's part of
+one, cost the server. */
+struct resource_usage_t {
+    resource_usage_t()
+        : cpu_nanos(0), blocks_from_cache(0), blocks_from_disk(0), rows_scanned(0) { }
+
+    void add(const resource_usage_t &other) {
+        cpu_nanos += other.cpu_nanos;
+        blocks_from_cache += other.blocks_from_cache;
+        blocks_from_disk += other.blocks_from_disk;
+        rows_scanned += other.rows_scanned;
+    }
+
+    /* What was used between an earlier reading `before` of the same account and
+    this one. */
+    resource_usage_t since(const resource_usage_t &before) const {
+        resource_usage_t res;
+        res.cpu_nanos = cpu_nanos - before.cpu_nanos;
+        res.blocks_from_cache = blocks_from_cache - before.blocks_from_cache;
+        res.blocks_from_disk = blocks_from_disk - before.blocks_from_disk;
+        res.rows_scanned = rows_scanned - before.rows_scanned;
+        return res;
+    }
+
+    /* How long the work's coroutines were running. Since the event loop doesn't
+    block, this is close to the CPU time that they used. */
+    int64_t cpu_nanos;
+    /* Blocks that the buffer cache already had in memory, and blocks that it had to
+    read from the serializer. */
+    uint64_t blocks_from_cache;
+    uint64_t blocks_from_disk;
+    /* Key/value pairs that the btree looked at. */
+    uint64_t rows_scanned;
+};
+RDB_DECLARE_SERIALIZABLE_FOR_CLUSTER(resource_usage_t);
+
+/* A `resource_account_t` collects the `resource_usage_t` of a coroutine while a
+`resource_account_scope_t` for it exists on the coroutine's stack. The coroutine
+charges the time it spends running to the account, and the buffer cache and the btree
+charge the blocks and rows that it reads. Coroutines that it spawns aren't charged to
+the account, and neither is work that it waits for on other coroutines; that work has
+to be measured separately and added with `charge()`.
+
+The account can be read from any thread while the coroutine updates it. */
+class resource_account_t {
+public:
+    resource_account_t();
+
+    /* Returns the account of the current coroutine, or `nullptr` if there is none. */
+    static resource_account_t *current();
+
+    void charge(const resource_usage_t &usage);
+
+    void charge_cpu_nanos(int64_t nanos) {
+        cpu_nanos_.fetch_add(nanos, std::memory_order_relaxed);
+    }
+    void charge_block_from_cache() {
+        blocks_from_cache_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void charge_block_from_disk() {
+        blocks_from_disk_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void charge_row_scanned() {
+        rows_scanned_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    resource_usage_t get_usage() const;
+
+private:
+    std::atomic<int64_t> cpu_nanos_;
+    std::atomic<uint64_t> blocks_from_cache_;
+    std::atomic<uint64_t> blocks_from_disk_;
+    std::atomic<uint64_t> rows_scanned_;
+
+    DISABLE_COPYING(resource_account_t);
+};
+
+/* Charges the current coroutine to `account` until the scope is destroyed, and then
+to whatever account it was charged to before. It must be destroyed on the same
+coroutine that created it. */
+class resource_account_scope_t {
+public:
+    explicit resource_account_scope_t(resource_account_t *account);
+    ~resource_account_scope_t();
+
+private:
+    coro_t *const coro_;
+    resource_account_t *const parent_;
+
+    DISABLE_COPYING(resource_account_scope_t);
+};
+
+#endif  // ARCH_RUNTIME_RESOURCE_ACCOUNT_HPP_
@@ -24,6 +24,12 @@ int get_num_threads() {
     return linux_thread_pool_t::get_thread_pool()->n_threads;
 }
 
+size_t get_runnable_count(threadnum_t thread) {
+    assert_good_thread_id(thread);
+    return linux_thread_pool_t::get_thread_pool()->threads[thread.threadnum]
+        ->message_hub.runnable_message_count();
+}
+
 #ifndef NDEBUG
 void assert_good_thread_id(threadnum_t thread) {
     if (linux_thread_pool_t::get_thread_pool() == nullptr) {
@@ -11,6 +11,11 @@ threadnum_t get_thread_id();
 
 int get_num_threads();
 
+/* How many coroutines (and other messages) have recently been ready to run on `thread`,
+averaged over its last few passes through the event loop. Can be called from any thread
+in the thread pool. It's cheap, so it's good for deciding where to put new work. */
+size_t get_runnable_count(threadnum_t thread);
+
 #ifndef NDEBUG
 bool in_thread_pool();
 void assert_good_thread_id(threadnum_t thread);
@@ -0,0 +1,221 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/runtime/stall_detector.hpp"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "arch/runtime/coroutines.hpp"
+#include "arch/runtime/runtime_utils.hpp"
+#include "arch/runtime/thread_pool.hpp"
+#include "backtrace.hpp"
+#include "config/args.hpp"
+#include "logger.hpp"
+#include "perfmon/perfmon.hpp"
+#include "rethinkdb_backtrace.hpp"
+#include "utils.hpp"
+
+/* The window over which `stats_t::busy_ratio` is computed. */
+static const int64_t busy_ratio_window_nanos = BILLION;
+
+class perfmon_stall_detectors_t
+    : public perfmon_perthread_t<stall_detector_t::stats_t,
+                                 std::vector<stall_detector_t::stats_t> > {
+protected:
+    void get_thread_stat(stall_detector_t::stats_t *stat) {
+        *stat = linux_thread_pool_t::get_thread()->stall_detector->get_stats(
+            get_ticks());
+    }
+
+    std::vector<stall_detector_t::stats_t> combine_stats(
+            const stall_detector_t::stats_t *stats) {
+        return std::vector<stall_detector_t::stats_t>(stats, stats + get_num_threads());
+    }
+
+    ql::datum_t output_stat(const std::vector<stall_detector_t::stats_t> &stats) {
+        ql::datum_array_builder_t threads(ql::configured_limits_t::unlimited);
+        uint64_t stalls_total = 0;
+        for (const stall_detector_t::stats_t &stat : stats) {
+            ql::datum_object_builder_t thread;
+            thread.overwrite("busy_ratio", ql::datum_t(stat.busy_ratio));
+            thread.overwrite("stalls_total",
+                ql::datum_t(static_cast<double>(stat.stalls)));
+            threads.add(std::move(thread).to_datum());
+            stalls_total += stat.stalls;
+        }
+        ql::datum_object_builder_t builder;
+        builder.overwrite("threads", std::move(threads).to_datum());
+        builder.overwrite("stalls_total",
+            ql::datum_t(static_cast<double>(stalls_total)));
+        return std::move(builder).to_datum();
+    }
+};
+
+stall_detector_t::stall_detector_t()
+    : segment_(1), segment_start_(0), capture_requested_(0), captured_(0),
+      backtrace_size_(0), spawn_site_(nullptr),
+      stalls_(0), unlogged_stalls_(0), last_log_(0),
+      wait_start_(0), idle_nanos_(0), window_start_(0), window_idle_nanos_(0),
+      busy_ratio_(0) { }
+
+void stall_detector_t::install() {
+#ifdef __linux__
+    // The first call to `backtrace()` might allocate memory while it loads the
+    // unwinder, which we mustn't do in a signal handler. So we get it out of the way.
+    void *dummy[1];
+    rethinkdb_backtrace(dummy, 1);
+
+    struct sigaction sa = make_sa_sigaction(SA_SIGINFO | SA_RESTART,
+                                            &stall_detector_t::on_signal);
+    int res = sigaction(STALL_DETECTOR_SIGNAL, &sa, nullptr);
+    guarantee_err(res == 0, "Could not install the stall detector's signal handler");
+#endif
+}
+
+void stall_detector_t::on_thread_start(ticks_t now) {
+    // This can't be a static variable at file scope, for the same reason as the one in
+    // `pm_eventloop_singleton_t::get()`.
+    static perfmon_stall_detectors_t pm_stall_detectors;
+    static perfmon_membership_t pm_stall_detectors_membership(
+        &get_global_perfmon_collection(), &pm_stall_detectors, "eventloop_threads");
+
+    window_start_ = now.nanos;
+    segment_start_.store(now.nanos, std::memory_order_release);
+}
+
+void stall_detector_t::on_wait_start(ticks_t now) {
+    end_segment(now.nanos);
+    segment_start_.store(0, std::memory_order_release);
+    wait_start_ = now.nanos;
+}
+
+void stall_detector_t::on_wait_end(ticks_t now) {
+    idle_nanos_ += now.nanos - wait_start_;
+    update_busy_ratio(now.nanos);
+    segment_.fetch_add(1, std::memory_order_release);
+    segment_start_.store(now.nanos, std::memory_order_release);
+}
+
+void stall_detector_t::end_segment(int64_t now) {
+    // Once `segment_` has moved on, the signal handler ignores requests to capture the
+    // segment that just ended. So if it captured that segment, it has finished doing so
+    // by the time we get past this line.
+    uint64_t segment = segment_.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    int64_t start = segment_start_.load(std::memory_order_relaxed);
+    if (start != 0 && now - start >= EVENT_LOOP_STALL_THRESHOLD_MS * MILLION) {
+        on_stall(now - start, captured_.load(std::memory_order_acquire) == segment, now);
+    }
+    segment_start_.store(now, std::memory_order_release);
+}
+
+static std::string demangle_or_raw(const char *name) {
+    try {
+        return demangle_cpp_name(name);
+    } catch (const demangle_failed_exc_t &) {
+        return name;
+    }
+}
+
+void stall_detector_t::on_stall(int64_t duration, bool captured, int64_t now) {
+    ++stalls_;
+    if (last_log_ != 0
+            && now - last_log_ < EVENT_LOOP_STALL_LOG_INTERVAL_MS * MILLION) {
+        ++unlogged_stalls_;
+        return;
+    }
+    last_log_ = now;
+
+    std::string details;
+    if (captured) {
+        details += "\nCoroutine: ";
+        details += spawn_site_ == nullptr
+            ? "none"
+            : demangle_or_raw(spawn_site_);
+        details += "\nBacktrace:";
+        // The first two frames are the signal handler and the signal trampoline.
+        for (int i = 2; i < backtrace_size_; ++i) {
+            backtrace_frame_t frame(backtrace_[i]);
+            frame.initialize_symbols();
+            details += strprintf("\n%d [%p]: ", i - 1, frame.get_addr());
+            details += frame.get_name().empty()
+                ? "<unknown function>"
+                : demangle_or_raw(frame.get_name().c_str());
+        }
+    }
+    if (unlogged_stalls_ > 0) {
+        details += strprintf("\n(%" PRIu64 " earlier stalls on this thread were not "
+                             "logged.)", unlogged_stalls_);
+        unlogged_stalls_ = 0;
+    }
+    logWRN("Thread %d spent %" PRIi64 " ms on a single task without yielding, so no "
+           "other work could run on it in the meantime. This can cause timeouts and "
+           "lost connections.%s",
+           get_thread_id().threadnum, static_cast<int64_t>(duration / MILLION),
+           details.c_str());
+}
+
+void stall_detector_t::update_busy_ratio(int64_t now) {
+    int64_t elapsed = now - window_start_;
+    if (elapsed >= busy_ratio_window_nanos) {
+        int64_t idle = idle_nanos_ - window_idle_nanos_;
+        busy_ratio_ = std::min(1.0, std::max(0.0,
+            1.0 - static_cast<double>(idle) / static_cast<double>(elapsed)));
+        window_start_ = now;
+        window_idle_nanos_ = idle_nanos_;
+    }
+}
+
+stall_detector_t::stats_t stall_detector_t::get_stats(ticks_t now) {
+    // We're not waiting for events right now, since we're running a message.
+    update_busy_ratio(now.nanos);
+    stats_t stats;
+    stats.busy_ratio = busy_ratio_;
+    stats.stalls = stalls_;
+    return stats;
+}
+
+void stall_detector_t::watchdog_check(pthread_t thread, ticks_t now) {
+#ifdef __linux__
+    uint64_t segment = segment_.load(std::memory_order_acquire);
+    int64_t start = segment_start_.load(std::memory_order_acquire);
+    if (start == 0
+            || now.nanos - start < EVENT_LOOP_STALL_THRESHOLD_MS * MILLION / 2
+            || capture_requested_.load(std::memory_order_relaxed) == segment) {
+        return;
+    }
+    capture_requested_.store(segment, std::memory_order_release);
+    union sigval value;
+    value.sival_ptr = this;
+    // If the segment has already ended, the signal handler will notice and ignore us.
+    int res = pthread_sigqueue(thread, STALL_DETECTOR_SIGNAL, value);
+    guarantee_xerr(res == 0 || res == EAGAIN, res, "Could not signal a stalled thread");
+#else
+    (void)thread;
+    (void)now;
+#endif
+}
+
+#ifdef __linux__
+void stall_detector_t::on_signal(UNUSED int signum, siginfo_t *siginfo,
+                                 UNUSED void *ucontext) {
+    if (siginfo->si_code != SI_QUEUE || siginfo->si_value.sival_ptr == nullptr) {
+        return;
+    }
+    int saved_errno = errno;
+    stall_detector_t *self = static_cast<stall_detector_t *>(siginfo->si_value.sival_ptr);
+    uint64_t segment = self->segment_.load(std::memory_order_relaxed);
+    if (self->capture_requested_.load(std::memory_order_acquire) == segment) {
+        self->backtrace_size_ = rethinkdb_backtrace(self->backtrace_, max_backtrace_frames);
+        coro_t *coro = coro_t::self();
+        self->spawn_site_ = coro != nullptr ? coro->get_spawn_site() : nullptr;
+        self->captured_.store(segment, std::memory_order_release);
+    }
+    errno = saved_errno;
+}
+#endif
@@ -0,0 +1,121 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef ARCH_RUNTIME_STALL_DETECTOR_HPP_
+#define ARCH_RUNTIME_STALL_DETECTOR_HPP_
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "errors.hpp"
+#include "time.hpp"
+
+/* A thread's event loop stalls when a single callback or coroutine runs for so long
+without yielding that nothing else gets to run on the thread: no other connection, no
+heartbeat and no timer. `stall_detector_t` watches one thread of the thread pool for
+stalls.
+
+The event loop splits the thread's time into segments: one for every time it blocks
+waiting for events, and one for every message it delivers, which usually means resuming
+a coroutine. It calls `on_wait_start()`, `on_wait_end()` and `on_message()` at the
+boundaries. Every segment that isn't spent waiting and that takes longer than
+`EVENT_LOOP_STALL_THRESHOLD_MS` is counted as a stall and logged.
+
+The thread only notices a stall once it's over, and by then there's no way to tell what
+caused it. So the thread pool's main thread periodically calls `watchdog_check()` for
+every thread. When it finds a thread that has been in the same segment for half the
+threshold, it sends it `STALL_DETECTOR_SIGNAL`. The signal handler records a backtrace
+and the spawn site of the running coroutine, which go into the log message if the
+segment turns out to be a stall. This only works on Linux.
+
+The detector also keeps track of how much of its time the thread spends waiting for
+events. The busy ratios of all threads are reported by the "eventloop_threads" perfmon.
+
+The callers pass in the current time, so that the detector doesn't depend on the clock.
+Since some of them are on hot paths, they may use `get_coarse_ticks()`.
+*/
+
+#ifdef __linux__
+#define STALL_DETECTOR_SIGNAL (SIGRTMIN + 4)
+#endif
+
+class stall_detector_t {
+public:
+    struct stats_t {
+        stats_t() : busy_ratio(0), stalls(0) { }
+        /* The fraction of the last complete second that the thread didn't spend
+        waiting for events. */
+        double busy_ratio;
+        uint64_t stalls;
+    };
+
+    stall_detector_t();
+
+    /* Installs the signal handler and registers the perfmon. Must be called before
+    any thread calls `on_thread_start()`. */
+    static void install();
+
+    /* Called on the detector's thread before it starts its event loop. */
+    void on_thread_start(ticks_t now);
+
+    /* Called on the detector's thread by the event queue, right before and right after
+    the blocking call that waits for events. */
+    void on_wait_start(ticks_t now);
+    void on_wait_end(ticks_t now);
+
+    /* Called on the detector's thread by the message hub before it delivers a message,
+    and once after the last message of a batch. */
+    void on_message(ticks_t now) {
+        end_segment(now.nanos);
+    }
+
+    /* Called on the detector's thread. */
+    stats_t get_stats(ticks_t now);
+
+    /* Called on the thread pool's main thread, with the `pthread_t` of the detector's
+    thread. */
+    void watchdog_check(pthread_t thread, ticks_t now);
+
+private:
+    static const int max_backtrace_frames = 32;
+
+#ifdef __linux__
+    static void on_signal(int signum, siginfo_t *siginfo, void *ucontext);
+#endif
+
+    /* Ends the current segment at `now` and starts a new one. */
+    void end_segment(int64_t now);
+    void on_stall(int64_t duration, bool captured, int64_t now);
+    void update_busy_ratio(int64_t now);
+
+    /* `segment_` is incremented at every segment boundary, and `segment_start_` is
+    the time at which the current segment started, or 0 while the thread waits for
+    events. Both are written by the thread and read by the watchdog. */
+    std::atomic<uint64_t> segment_;
+    std::atomic<int64_t> segment_start_;
+
+    /* The segment that the watchdog asked the signal handler to capture, and the
+    segment that the signal handler actually captured into `backtrace_`,
+    `backtrace_size_` and `spawn_site_`. */
+    std::atomic<uint64_t> capture_requested_;
+    std::atomic<uint64_t> captured_;
+    void *backtrace_[max_backtrace_frames];
+    int backtrace_size_;
+    const char *spawn_site_;
+
+    /* Everything below is only touched by the thread itself. */
+    uint64_t stalls_;
+    uint64_t unlogged_stalls_;
+    int64_t last_log_;
+
+    int64_t wait_start_;
+    int64_t idle_nanos_;
+    int64_t window_start_;
+    int64_t window_idle_nanos_;
+    double busy_ratio_;
+
+    DISABLE_COPYING(stall_detector_t);
+};
+
+#endif  // ARCH_RUNTIME_STALL_DETECTOR_HPP_
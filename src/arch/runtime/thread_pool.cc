@@ -19,6 +19,7 @@
 #include "arch/timing.hpp"
 #include "errors.hpp"
 #include "logger.hpp"
+#include "time.hpp"
 #include "utils.hpp"
 
 #if !defined(VALGRIND) && !defined(_WIN32)
@@ -74,6 +75,8 @@ linux_thread_pool_t::linux_thread_pool_t(int worker_threads, bool _do_set_affini
     rassert(n_threads > 1);             // we want at least one non-utility thread
     rassert(n_threads <= MAX_THREADS);
 
+    stall_detectors.init(n_threads);
+
     int res;
 
     res = pthread_cond_init(&shutdown_cond, nullptr);
@@ -105,8 +108,10 @@ struct thread_data_t {
 
 void *linux_thread_pool_t::start_thread(void *arg) {
 #ifndef _WIN32
-    // Block all signals but `SIGSEGV` and `SIGBUS` (will be unblocked by the event
-    // queue in case of poll).
+    // Block all signals but `SIGSEGV`, `SIGBUS` and `STALL_DETECTOR_SIGNAL` (will be
+    // unblocked by the event queue in case of poll). `STALL_DETECTOR_SIGNAL` is sent by
+    // the main thread when the thread's event loop seems to be stalled. `coro_sampler_t`
+    // unblocks `SIGPROF` while it's enabled.
     {
         sigset_t sigmask;
         int res = sigfillset(&sigmask);
@@ -116,6 +121,10 @@ void *linux_thread_pool_t::start_thread(void *arg) {
         guarantee_err(res == 0, "Could not remove SIGSEGV from sigmask");
         res = sigdelset(&sigmask, SIGBUS);
         guarantee_err(res == 0, "Could not remove SIGBUS from sigmask");
+#ifdef STALL_DETECTOR_SIGNAL
+        res = sigdelset(&sigmask, STALL_DETECTOR_SIGNAL);
+        guarantee_err(res == 0, "Could not remove STALL_DETECTOR_SIGNAL from sigmask");
+#endif
 
         res = pthread_sigmask(SIG_SETMASK, &sigmask, nullptr);
         guarantee_xerr(res == 0, res, "Could not block signal");
@@ -182,6 +191,7 @@ void *linux_thread_pool_t::start_thread(void *arg) {
             local_thread.message_hub.insert_external_message(tdata->initial_message);
         }
 
+        local_thread.stall_detector->on_thread_start(get_ticks());
         local_thread.queue.run();
 
         // If one thread is allowed to delete itself before another one has
@@ -212,6 +222,8 @@ void linux_thread_pool_t::enable_coroutine_summary() {
 void linux_thread_pool_t::run_thread_pool(linux_thread_message_t *initial_message) {
     do_shutdown = false;
 
+    stall_detector_t::install();
+
     // Start child threads
     thread_barrier_t barrier(n_threads + 1);
 
@@ -276,8 +288,20 @@ void linux_thread_pool_t::run_thread_pool(linux_thread_message_t *initial_messag
     guarantee_xerr(res == 0, res, "Could not lock shutdown cond mutex");
 
     while (!do_shutdown) {   // while loop guards against spurious wakeups
+#ifdef __linux__
+        // While we're waiting anyway, we act as the watchdog for the stall detectors.
+        timespec deadline = clock_realtime();
+        add_to_timespec(&deadline, EVENT_LOOP_STALL_THRESHOLD_MS * MILLION / 4);
+        res = pthread_cond_timedwait(&shutdown_cond, &shutdown_cond_mutex, &deadline);
+        guarantee_xerr(res == 0 || res == ETIMEDOUT, res,
+                       "Could not wait for shutdown cond");
+        for (int i = 0; i < n_threads; ++i) {
+            stall_detectors[i].watchdog_check(pthreads[i], get_coarse_ticks());
+        }
+#else
         res = pthread_cond_wait(&shutdown_cond, &shutdown_cond_mutex);
         guarantee_xerr(res == 0, res, "Could not wait for shutdown cond");
+#endif
     }
 
     res = pthread_mutex_unlock(&shutdown_cond_mutex);
@@ -456,8 +480,10 @@ linux_thread_pool_t::~linux_thread_pool_t() {
 
 linux_thread_t::linux_thread_t(linux_thread_pool_t *parent_pool, int thread_id)
     : queue(this),
-      message_hub(&queue, parent_pool, threadnum_t(thread_id)),
+      message_hub(&queue, parent_pool, &parent_pool->stall_detectors[thread_id],
+                  threadnum_t(thread_id)),
       timer_handler(&queue),
+      stall_detector(&parent_pool->stall_detectors[thread_id]),
       do_shutdown(false)
 #ifndef NDEBUG
       , coroutine_counts_at_shutdown(NULL)
@@ -488,6 +514,14 @@ void linux_thread_t::pump() {
     message_hub.push_messages();
 }
 
+void linux_thread_t::on_wait_start() {
+    stall_detector->on_wait_start(get_ticks());
+}
+
+void linux_thread_t::on_wait_end() {
+    stall_detector->on_wait_end(get_ticks());
+}
+
 void linux_thread_t::on_event(int events) {
     // No-op. This is just to make sure that the event queue wakes up
     // so it can shut down.
@@ -14,9 +14,11 @@
 #include "arch/runtime/system_event.hpp"
 #include "arch/runtime/message_hub.hpp"
 #include "arch/runtime/coroutines.hpp"
+#include "arch/runtime/stall_detector.hpp"
 #include "arch/io/blocker_pool.hpp"
 #include "arch/io/timer_provider.hpp"
 #include "arch/timer.hpp"
+#include "containers/scoped.hpp"
 
 class linux_thread_t;
 class os_signal_cond_t;
@@ -96,6 +98,10 @@ public:
     pthread_t pthreads[MAX_THREADS];
     linux_thread_t *threads[MAX_THREADS];
 
+    // One for each thread. They live as long as the thread pool rather than the
+    // threads, so that the main thread can look at them at any time.
+    scoped_array_t<stall_detector_t> stall_detectors;
+
     // Cooperatively run a blocking function call using the generic_blocker_pool
     template <class Callable>
     static void run_in_blocker_pool(const Callable &);
@@ -188,8 +194,12 @@ public:
     for coroutines. */
     coro_runtime_t coro_runtime;
 
+    stall_detector_t *const stall_detector;
+
     void pump();   // Called by the event queue
     bool should_shut_down();   // Called by the event queue
+    void on_wait_start();   // Called by the event queue
+    void on_wait_end();   // Called by the event queue
 #ifndef NDEBUG
     void initiate_shut_down(std::map<std::string, size_t> *coroutine_counts); // Can be called from any thread
 #else
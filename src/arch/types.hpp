@@ -88,6 +88,9 @@ typedef linux_nonthrowing_tcp_listener_t non_throwing_tcp_listener_t;
 class linux_tcp_listener_t;
 typedef linux_tcp_listener_t tcp_listener_t;
 
+class linux_sharded_tcp_listener_t;
+typedef linux_sharded_tcp_listener_t sharded_tcp_listener_t;
+
 class linux_repeated_nonthrowing_tcp_listener_t;
 typedef linux_repeated_nonthrowing_tcp_listener_t repeated_nonthrowing_tcp_listener_t;
 
@@ -126,6 +129,11 @@ public:
     // writev_async doesn't provide the atomicity guarantees of writev.
     virtual void writev_async(int64_t offset, size_t length, scoped_array_t<iovec> &&bufs,
                               file_account_t *account, linux_iocallback_t *cb) = 0;
+    // Tells the file system that the range's contents are no longer needed.  Later
+    // reads of the range may return either zeroes or the old contents.  Reads and
+    // writes submitted afterwards are ordered after the discard.
+    virtual void discard_async(int64_t offset, size_t length,
+                               file_account_t *account, linux_iocallback_t *cb) = 0;
 
     virtual void *create_account(int priority, int outstanding_requests_limit) = 0;
     virtual void destroy_account(void *account) = 0;
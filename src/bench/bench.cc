@@ -0,0 +1,191 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench.hpp"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "arch/runtime/starter.hpp"
+#include "config/args.hpp"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "time.hpp"
+
+namespace bench {
+
+struct benchmark_t {
+    std::string name;
+    bench_fn_t fn;
+    int num_threads;
+};
+
+// A function-local static, so that registrations in other translation units don't
+// depend on static initialization order.
+static std::vector<benchmark_t> *registry() {
+    static std::vector<benchmark_t> benchmarks;
+    return &benchmarks;
+}
+
+// We stop calibrating at this many iterations even if they take less than the
+// minimum time, so that a benchmark the compiler optimized away can't hang us.
+static const int64_t max_iterations = 1000 * MILLION;
+
+state_t::state_t(int64_t iterations)
+    : iterations_(iterations),
+      remaining_(iterations),
+      timing_(false),
+      started_at_nanos_(0),
+      elapsed_nanos_(0),
+      items_per_iteration_(0),
+      bytes_per_iteration_(0) {
+    guarantee(iterations > 0);
+}
+
+void state_t::pause_timing() {
+    if (timing_) {
+        elapsed_nanos_ += get_ticks().nanos - started_at_nanos_;
+        timing_ = false;
+    }
+}
+
+void state_t::resume_timing() {
+    if (!timing_) {
+        started_at_nanos_ = get_ticks().nanos;
+        timing_ = true;
+    }
+}
+
+registration_t::registration_t(const char *group, const char *name, bench_fn_t fn,
+                               int num_threads) {
+    guarantee(num_threads >= 1);
+    registry()->push_back(
+        benchmark_t{std::string(group) + "/" + name, fn, num_threads});
+}
+
+std::vector<std::string> list_benchmarks() {
+    std::vector<std::string> names;
+    for (const benchmark_t &benchmark : *registry()) {
+        names.push_back(benchmark.name);
+    }
+    return names;
+}
+
+static int64_t run_once(const benchmark_t &benchmark, int64_t iterations,
+                        int64_t *items_per_iteration_out,
+                        int64_t *bytes_per_iteration_out) {
+    state_t state(iterations);
+    benchmark.fn(&state);
+    guarantee(state.finished(),
+              "Benchmark %s returned before running all of its iterations.",
+              benchmark.name.c_str());
+    *items_per_iteration_out = state.items_per_iteration();
+    *bytes_per_iteration_out = state.bytes_per_iteration();
+    return std::max<int64_t>(1, state.elapsed_nanos());
+}
+
+static result_t run_benchmark(const benchmark_t &benchmark, const options_t &options) {
+    result_t result;
+    result.name = benchmark.name;
+    result.num_threads = benchmark.num_threads;
+
+    run_in_thread_pool([&]() {
+        const int64_t min_nanos = static_cast<int64_t>(options.min_time_secs * BILLION);
+
+        // Find out how many iterations take the minimum time.
+        int64_t iterations = 1;
+        for (;;) {
+            int64_t elapsed = run_once(benchmark, iterations,
+                &result.items_per_iteration, &result.bytes_per_iteration);
+            if (elapsed >= min_nanos || iterations >= max_iterations) {
+                break;
+            }
+            // Aim a bit past the minimum, but don't grow too fast, since a short run
+            // is a poor predictor.
+            double multiplier = std::min(
+                10.0, 1.4 * static_cast<double>(min_nanos) / elapsed);
+            iterations = std::min(max_iterations, std::max(
+                iterations + 1, static_cast<int64_t>(iterations * multiplier)));
+        }
+        result.iterations = iterations;
+
+        std::vector<double> per_iteration_nanos;
+        for (int i = 0; i < options.repetitions; ++i) {
+            int64_t elapsed = run_once(benchmark, iterations,
+                &result.items_per_iteration, &result.bytes_per_iteration);
+            per_iteration_nanos.push_back(static_cast<double>(elapsed) / iterations);
+        }
+        std::sort(per_iteration_nanos.begin(), per_iteration_nanos.end());
+        result.median_nanos = per_iteration_nanos[per_iteration_nanos.size() / 2];
+        result.min_nanos = per_iteration_nanos.front();
+        result.max_nanos = per_iteration_nanos.back();
+    }, benchmark.num_threads);
+
+    return result;
+}
+
+std::vector<result_t> run_benchmarks(const options_t &options) {
+    guarantee(options.repetitions >= 1);
+    std::vector<result_t> results;
+    printf("%-40s %14s %14s %14s %12s\n",
+           "benchmark", "ns/op", "min ns/op", "max ns/op", "iterations");
+    for (const benchmark_t &benchmark : *registry()) {
+        if (benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(run_benchmark(benchmark, options));
+        const result_t &result = results.back();
+        printf("%-40s %14.1f %14.1f %14.1f %12" PRIi64 "\n",
+               result.name.c_str(), result.median_nanos, result.min_nanos,
+               result.max_nanos, result.iterations);
+        fflush(stdout);
+    }
+    return results;
+}
+
+std::string results_to_json(const options_t &options,
+                            const std::vector<result_t> &results) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("version");
+    writer.String(RETHINKDB_VERSION);
+    writer.Key("timestamp");
+    writer.Int64(time(nullptr));
+    writer.Key("min_time_secs");
+    writer.Double(options.min_time_secs);
+    writer.Key("repetitions");
+    writer.Int(options.repetitions);
+    writer.Key("benchmarks");
+    writer.StartArray();
+    for (const result_t &result : results) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(result.name.c_str());
+        writer.Key("threads");
+        writer.Int(result.num_threads);
+        writer.Key("iterations");
+        writer.Int64(result.iterations);
+        writer.Key("ns_per_op");
+        writer.Double(result.median_nanos);
+        writer.Key("min_ns_per_op");
+        writer.Double(result.min_nanos);
+        writer.Key("max_ns_per_op");
+        writer.Double(result.max_nanos);
+        if (result.items_per_iteration > 0) {
+            writer.Key("items_per_sec");
+            writer.Double(result.items_per_iteration * BILLION / result.median_nanos);
+        }
+        if (result.bytes_per_iteration > 0) {
+            writer.Key("bytes_per_sec");
+            writer.Double(result.bytes_per_iteration * BILLION / result.median_nanos);
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return std::string(buffer.GetString(), buffer.GetSize()) + "\n";
+}
+
+}  // namespace bench
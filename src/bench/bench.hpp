@@ -0,0 +1,129 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef BENCH_BENCH_HPP_
+#define BENCH_BENCH_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "errors.hpp"
+
+/* Microbenchmarks for the engine's hot paths. They are built into
+`rethinkdb-bench` alongside the unit tests, and `make bench` runs them and writes the
+results to `bench.json` in the build directory, so that they can be compared from
+one commit to the next.
+
+A benchmark looks like this:
+
+    BENCH(Group, Name) {
+        ... set up, which isn't timed ...
+        while (state->keep_running()) {
+            ... the operation being measured ...
+        }
+    }
+
+It runs in a coroutine in a thread pool with one thread, or with as many threads as
+are given as an extra argument to `BENCH()`. The harness calls it several times with
+increasing iteration counts until one run takes `--min-time` seconds, and then
+`--repetitions` more times with that many iterations to get the reported times. */
+
+namespace bench {
+
+class state_t {
+public:
+    explicit state_t(int64_t iterations);
+
+    // Returns true until the benchmark has run `iterations()` times. The time
+    // between the first and the last call is what gets measured.
+    bool keep_running() {
+        if (remaining_ > 0) {
+            if (remaining_ == iterations_) {
+                resume_timing();
+            }
+            --remaining_;
+            return true;
+        }
+        pause_timing();
+        return false;
+    }
+
+    // For excluding per-iteration setup from the measurement. These are slow
+    // compared to most of the operations we measure, so use them sparingly.
+    void pause_timing();
+    void resume_timing();
+
+    // How many items (e.g. documents or keys) or bytes one iteration processes, so
+    // that we can report throughput.
+    void set_items_per_iteration(int64_t items) { items_per_iteration_ = items; }
+    void set_bytes_per_iteration(int64_t bytes) { bytes_per_iteration_ = bytes; }
+
+    int64_t iterations() const { return iterations_; }
+    bool finished() const { return remaining_ == 0 && !timing_; }
+    int64_t elapsed_nanos() const { return elapsed_nanos_; }
+    int64_t items_per_iteration() const { return items_per_iteration_; }
+    int64_t bytes_per_iteration() const { return bytes_per_iteration_; }
+
+private:
+    const int64_t iterations_;
+    int64_t remaining_;
+    bool timing_;
+    int64_t started_at_nanos_;
+    int64_t elapsed_nanos_;
+    int64_t items_per_iteration_;
+    int64_t bytes_per_iteration_;
+
+    DISABLE_COPYING(state_t);
+};
+
+typedef void (*bench_fn_t)(state_t *);
+
+class registration_t {
+public:
+    registration_t(const char *group, const char *name, bench_fn_t fn,
+                   int num_threads = 1);
+};
+
+struct options_t {
+    options_t() : min_time_secs(0.5), repetitions(5) { }
+    // Only benchmarks whose "Group/Name" contains this are run.
+    std::string filter;
+    double min_time_secs;
+    int repetitions;
+};
+
+struct result_t {
+    std::string name;
+    int num_threads;
+    int64_t iterations;
+    // Per-iteration times over the repetitions
+    double median_nanos;
+    double min_nanos;
+    double max_nanos;
+    int64_t items_per_iteration;
+    int64_t bytes_per_iteration;
+};
+
+std::vector<std::string> list_benchmarks();
+
+// Runs the benchmarks that match `options.filter`, printing a line for each one to
+// stdout as it finishes. Must not be called from a thread pool.
+std::vector<result_t> run_benchmarks(const options_t &options);
+
+std::string results_to_json(const options_t &options,
+                            const std::vector<result_t> &results);
+
+// Keeps the compiler from optimizing away the computation of `value`.
+template <class T>
+inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+}  // namespace bench
+
+#define BENCH(group, name, ...) void bench_##group##_##name(::bench::state_t *); \
+    static ::bench::registration_t bench_registration_##group##_##name(          \
+        #group, #name, &bench_##group##_##name, ##__VA_ARGS__);                  \
+    void bench_##group##_##name(::bench::state_t *state)
+
+#endif  // BENCH_BENCH_HPP_
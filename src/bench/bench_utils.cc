@@ -0,0 +1,58 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench_utils.hpp"
+
+#include "perfmon/perfmon.hpp"
+#include "random.hpp"
+#include "rdb_protocol/configured_limits.hpp"
+#include "utils.hpp"
+
+namespace bench {
+
+ql::datum_t make_sample_document(int id) {
+    rng_t rng(id);
+    ql::datum_object_builder_t address;
+    address.overwrite("street",
+                      ql::datum_t(strprintf("%d Main Street", rng.randint(1000))));
+    address.overwrite("city", ql::datum_t("Mountain View"));
+    address.overwrite("zip", ql::datum_t(strprintf("%05d", rng.randint(100000))));
+
+    ql::datum_array_builder_t tags(ql::configured_limits_t::unlimited);
+    for (int i = 0; i < 3; ++i) {
+        tags.add(ql::datum_t(strprintf("tag%d", rng.randint(50))));
+    }
+
+    ql::datum_object_builder_t builder;
+    builder.overwrite("id", ql::datum_t(static_cast<double>(id)));
+    builder.overwrite("name", ql::datum_t(strprintf("user_%d", id)));
+    builder.overwrite("email", ql::datum_t(strprintf("user_%d@example.com", id)));
+    builder.overwrite("age", ql::datum_t(static_cast<double>(18 + rng.randint(60))));
+    builder.overwrite("score", ql::datum_t(rng.randdouble() * 100));
+    builder.overwrite("active", ql::datum_t::boolean(rng.randint(2) == 0));
+    builder.overwrite("created_at", ql::datum_t(1.4e9 + rng.randint(100000000)));
+    builder.overwrite("tags", std::move(tags).to_datum());
+    builder.overwrite("address", std::move(address).to_datum());
+    return std::move(builder).to_datum();
+}
+
+std::vector<ql::datum_t> make_sample_documents(int count) {
+    std::vector<ql::datum_t> documents;
+    documents.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        documents.push_back(make_sample_document(i));
+    }
+    return documents;
+}
+
+mock_cache_t::mock_cache_t() : balancer_(GIGABYTE) {
+    log_serializer_t::create(&file_opener_, log_serializer_t::static_config_t());
+    serializer_ = make_scoped<log_serializer_t>(
+        log_serializer_t::dynamic_config_t(),
+        &file_opener_,
+        &get_global_perfmon_collection());
+    cache_ = make_scoped<cache_t>(serializer_.get(), &balancer_,
+                                  &get_global_perfmon_collection(),
+                                  which_cpu_shard_t{0, 1});
+    cache_conn_ = make_scoped<cache_conn_t>(cache_.get());
+}
+
+}  // namespace bench
@@ -0,0 +1,43 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef BENCH_BENCH_UTILS_HPP_
+#define BENCH_BENCH_UTILS_HPP_
+
+#include <vector>
+
+#include "buffer_cache/alt.hpp"
+#include "buffer_cache/cache_balancer.hpp"
+#include "containers/scoped.hpp"
+#include "rdb_protocol/datum.hpp"
+#include "serializer/log/log_serializer.hpp"
+#include "unittest/mock_file.hpp"
+
+namespace bench {
+
+// A document shaped like a typical row: a few short strings and numbers, a small
+// array and a nested object. Documents with the same `id` are identical.
+ql::datum_t make_sample_document(int id);
+
+std::vector<ql::datum_t> make_sample_documents(int count);
+
+// A buffer cache on top of a log serializer whose file is kept in memory, so that
+// what we measure isn't disk latency. The cache is big enough to hold everything.
+class mock_cache_t {
+public:
+    mock_cache_t();
+
+    cache_t *cache() { return cache_.get(); }
+    cache_conn_t *cache_conn() { return cache_conn_.get(); }
+
+private:
+    unittest::mock_file_opener_t file_opener_;
+    scoped_ptr_t<log_serializer_t> serializer_;
+    dummy_cache_balancer_t balancer_;
+    scoped_ptr_t<cache_t> cache_;
+    scoped_ptr_t<cache_conn_t> cache_conn_;
+
+    DISABLE_COPYING(mock_cache_t);
+};
+
+}  // namespace bench
+
+#endif  // BENCH_BENCH_UTILS_HPP_
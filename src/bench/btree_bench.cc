@@ -0,0 +1,174 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench.hpp"
+#include "bench/bench_utils.hpp"
+#include "btree/reql_specific.hpp"
+#include "concurrency/cond_var.hpp"
+#include "rdb_protocol/btree.hpp"
+#include "rdb_protocol/profile.hpp"
+#include "unittest/btree_utils.hpp"
+
+namespace bench {
+
+static const int btree_keys = 10000;
+
+static store_key_t btree_key(int i) {
+    return store_key_t(strprintf("key%08d", i));
+}
+
+// A B-tree with short values, like the one in the `btree_whole` unit tests, in a
+// `mock_cache_t`.
+class mock_btree_t {
+public:
+    mock_btree_t()
+        : sizer_(mock_.cache()->max_block_size()),
+          value_(sizer_.max_possible_size()),
+          stats_(&get_global_perfmon_collection(), "bench-btree") {
+        txn_t txn(mock_.cache_conn(), write_durability_t::SOFT, 1);
+        {
+            buf_lock_t sb_lock(&txn, SUPERBLOCK_ID, alt_create_t::create);
+            real_superblock_t superblock(std::move(sb_lock));
+            btree_slice_t::init_real_superblock(
+                &superblock, std::vector<char>(), binary_blob_t());
+        }
+        txn.commit();
+    }
+
+    void set(const store_key_t &key, const std::string &value) {
+        scoped_ptr_t<txn_t> txn;
+        scoped_ptr_t<real_superblock_t> superblock;
+        get_btree_superblock_and_txn_for_writing(
+            mock_.cache_conn(), nullptr, write_access_t::write, 1,
+            write_durability_t::SOFT, &superblock, &txn);
+
+        profile::trace_t trace;
+        noop_value_deleter_t deleter;
+        null_key_modification_callback_t null_cb;
+        keyvalue_location_t kv_location;
+        find_keyvalue_location_for_write(
+            &sizer_, superblock.get(), key.btree_key(),
+            repli_timestamp_t::distant_past, &deleter, &kv_location, &trace);
+
+        short_value_buffer_t buf(value);
+        scoped_malloc_t<void> value_data(
+            reinterpret_cast<char *>(buf.data()), buf.size());
+        kv_location.value = std::move(value_data);
+        apply_keyvalue_change(
+            &sizer_, &kv_location, key.btree_key(), repli_timestamp_t::distant_past,
+            &deleter, &null_cb, delete_mode_t::REGULAR_QUERY);
+        txn->commit();
+    }
+
+    bool get(const store_key_t &key) {
+        scoped_ptr_t<txn_t> txn;
+        scoped_ptr_t<real_superblock_t> superblock;
+        get_btree_superblock_and_txn_for_reading(
+            mock_.cache_conn(), CACHE_SNAPSHOTTED_NO, &superblock, &txn);
+
+        profile::trace_t trace;
+        keyvalue_location_t kv_location;
+        find_keyvalue_location_for_read(
+            &sizer_, superblock.get(), key.btree_key(), &kv_location, &stats_, &trace);
+        return kv_location.value.has();
+    }
+
+    // The fast path that point reads try first. Returns whether it found the key;
+    // crashes if it had to give up, since nothing else uses the cache.
+    bool get_without_acquiring(const store_key_t &key) {
+        bool found;
+        bool succeeded = find_value_without_acquiring(
+            mock_.cache(), &sizer_, key.btree_key(), value_.get(), &found);
+        guarantee(succeeded);
+        return found;
+    }
+
+    // Returns how many keys are in `range`.
+    int range(const key_range_t &range) {
+        scoped_ptr_t<txn_t> txn;
+        scoped_ptr_t<real_superblock_t> superblock;
+        get_btree_superblock_and_txn_for_reading(
+            mock_.cache_conn(), CACHE_SNAPSHOTTED_NO, &superblock, &txn);
+
+        counter_callback_t counter;
+        cond_t non_interruptor;
+        btree_depth_first_traversal(
+            superblock.get(), range, &counter, access_t::read, direction_t::FORWARD,
+            release_superblock_t::RELEASE, &non_interruptor);
+        return counter.count;
+    }
+
+private:
+    class counter_callback_t : public depth_first_traversal_callback_t {
+    public:
+        counter_callback_t() : count(0) { }
+        continue_bool_t handle_pair(scoped_key_value_t &&, signal_t *) {
+            ++count;
+            return continue_bool_t::CONTINUE;
+        }
+        int count;
+    };
+
+    mock_cache_t mock_;
+    short_value_sizer_t sizer_;
+    scoped_malloc_t<void> value_;
+    btree_stats_t stats_;
+
+    DISABLE_COPYING(mock_btree_t);
+};
+
+static void fill_btree(mock_btree_t *btree) {
+    for (int i = 0; i < btree_keys; ++i) {
+        btree->set(btree_key(i), "value123");
+    }
+}
+
+BENCH(BTree, PointWrite) {
+    mock_btree_t btree;
+    int i = 0;
+    while (state->keep_running()) {
+        btree.set(btree_key(i), "value123");
+        i = (i + 1) % btree_keys;
+    }
+}
+
+BENCH(BTree, PointRead) {
+    mock_btree_t btree;
+    fill_btree(&btree);
+    // Step through the keys in a scattered order, so consecutive reads don't all
+    // hit the same leaf.
+    int i = 0;
+    while (state->keep_running()) {
+        bool found = btree.get(btree_key(i));
+        guarantee(found);
+        i = (i + 7919) % btree_keys;
+    }
+}
+
+// The same reads as `PointRead`, but without creating a transaction or acquiring any
+// blocks. The cache holds the whole tree after `fill_btree()`, so they all succeed.
+BENCH(BTree, PointReadWithoutAcquiring) {
+    mock_btree_t btree;
+    fill_btree(&btree);
+    int i = 0;
+    while (state->keep_running()) {
+        bool found = btree.get_without_acquiring(btree_key(i));
+        guarantee(found);
+        i = (i + 7919) % btree_keys;
+    }
+}
+
+BENCH(BTree, RangeRead) {
+    const int keys_per_range = 100;
+    mock_btree_t btree;
+    fill_btree(&btree);
+    state->set_items_per_iteration(keys_per_range);
+    int i = 0;
+    while (state->keep_running()) {
+        key_range_t range(key_range_t::closed, btree_key(i),
+                          key_range_t::open, btree_key(i + keys_per_range));
+        int count = btree.range(range);
+        guarantee(count == keys_per_range);
+        i = (i + keys_per_range) % (btree_keys - keys_per_range);
+    }
+}
+
+}  // namespace bench
@@ -0,0 +1,21 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench.hpp"
+#include "random.hpp"
+#include "serializer/checksum.hpp"
+
+namespace bench {
+
+BENCH(Checksum, Block4K) {
+    const size_t block_size = 4096;
+    std::vector<uint32_t> block(block_size / sizeof(uint32_t));
+    rng_t rng(0);
+    for (uint32_t &word : block) {
+        word = rng.randuint64(UINT32_MAX);
+    }
+    state->set_bytes_per_iteration(block_size);
+    while (state->keep_running()) {
+        do_not_optimize(compute_checksum(block.data(), block.size()));
+    }
+}
+
+}  // namespace bench
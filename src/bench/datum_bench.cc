@@ -0,0 +1,41 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench.hpp"
+#include "bench/bench_utils.hpp"
+#include "containers/archive/buffer_stream.hpp"
+#include "containers/archive/vector_stream.hpp"
+#include "rdb_protocol/serialize_datum.hpp"
+
+namespace bench {
+
+static std::vector<char> serialize_to_vector(const ql::datum_t &datum) {
+    write_message_t wm;
+    ql::datum_serialize(&wm, datum, ql::check_datum_serialization_errors_t::NO);
+    vector_stream_t stream;
+    int res = send_write_message(&stream, &wm);
+    guarantee(res == 0);
+    std::vector<char> out;
+    stream.swap(&out);
+    return out;
+}
+
+BENCH(Datum, Serialize) {
+    ql::datum_t document = make_sample_document(0);
+    state->set_bytes_per_iteration(serialize_to_vector(document).size());
+    while (state->keep_running()) {
+        do_not_optimize(serialize_to_vector(document));
+    }
+}
+
+BENCH(Datum, Deserialize) {
+    std::vector<char> serialized = serialize_to_vector(make_sample_document(0));
+    state->set_bytes_per_iteration(serialized.size());
+    while (state->keep_running()) {
+        buffer_read_stream_t stream(serialized.data(), serialized.size());
+        ql::datum_t document;
+        archive_result_t res = ql::datum_deserialize(&stream, &document);
+        guarantee_deserialization(res, "benchmark datum");
+        do_not_optimize(document);
+    }
+}
+
+}  // namespace bench
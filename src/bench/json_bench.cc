@@ -0,0 +1,48 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench.hpp"
+#include "bench/bench_utils.hpp"
+#include "client_protocol/json.hpp"
+#include "rapidjson/document.h"
+#include "rdb_protocol/configured_limits.hpp"
+#include "rdb_protocol/response.hpp"
+
+namespace bench {
+
+// The default batch size for small documents is in this range.
+static const int documents_per_response = 100;
+
+static void fill_response(ql::response_t *response) {
+    response->set_type(Response::SUCCESS_PARTIAL);
+    response->set_data(make_sample_documents(documents_per_response));
+}
+
+BENCH(Json, EncodeResponse) {
+    ql::response_t response;
+    fill_response(&response);
+    state->set_items_per_iteration(documents_per_response);
+    while (state->keep_running()) {
+        rapidjson::StringBuffer buffer;
+        json_protocol_t::write_response_to_buffer(&response, &buffer);
+        do_not_optimize(buffer.GetString());
+    }
+}
+
+BENCH(Json, ParseResponse) {
+    ql::response_t response;
+    fill_response(&response);
+    rapidjson::StringBuffer buffer;
+    json_protocol_t::write_response_to_buffer(&response, &buffer);
+    const std::string json(buffer.GetString(), buffer.GetSize());
+    state->set_items_per_iteration(documents_per_response);
+    state->set_bytes_per_iteration(json.size());
+    while (state->keep_running()) {
+        rapidjson::Document doc;
+        doc.Parse(json.c_str());
+        guarantee(!doc.HasParseError());
+        ql::datum_t data = ql::to_datum(
+            doc["r"], ql::configured_limits_t::unlimited, reql_version_t::LATEST);
+        do_not_optimize(data);
+    }
+}
+
+}  // namespace bench
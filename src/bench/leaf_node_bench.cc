@@ -0,0 +1,67 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "bench/bench.hpp"
+#include "btree/leaf_node.hpp"
+#include "btree/node.hpp"
+#include "random.hpp"
+#include "repli_timestamp.hpp"
+#include "unittest/btree_utils.hpp"
+#include "utils.hpp"
+
+namespace bench {
+
+// Fills `node` with as many of the keys as fit, in a random order, and returns the
+// ones that fit in the order they were inserted.
+static std::vector<store_key_t> fill_leaf(value_sizer_t *sizer, leaf_node_t *node) {
+    std::vector<store_key_t> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(store_key_t(strprintf("key%08d", i * 7919 % 1000)));
+    }
+    short_value_buffer_t value(std::string("value123"));
+    leaf::init(sizer, node);
+    std::vector<store_key_t> inserted;
+    for (const store_key_t &key : keys) {
+        if (leaf::is_full(sizer, node, key.btree_key(), value.data())) {
+            break;
+        }
+        leaf::insert(sizer, node, key.btree_key(), value.data(),
+                     repli_timestamp_t::distant_past, repli_timestamp_t::distant_past,
+                     key_modification_proof_t::real_proof());
+        inserted.push_back(key);
+    }
+    return inserted;
+}
+
+BENCH(Leaf, Insert) {
+    max_block_size_t bs = max_block_size_t::unsafe_make(4096);
+    short_value_sizer_t sizer(bs);
+    scoped_malloc_t<leaf_node_t> node(bs.value());
+    std::vector<store_key_t> keys = fill_leaf(&sizer, node.get());
+    short_value_buffer_t value(std::string("value123"));
+    state->set_items_per_iteration(keys.size());
+    while (state->keep_running()) {
+        leaf::init(&sizer, node.get());
+        for (const store_key_t &key : keys) {
+            leaf::insert(&sizer, node.get(), key.btree_key(), value.data(),
+                         repli_timestamp_t::distant_past,
+                         repli_timestamp_t::distant_past,
+                         key_modification_proof_t::real_proof());
+        }
+    }
+}
+
+BENCH(Leaf, FindKey) {
+    max_block_size_t bs = max_block_size_t::unsafe_make(4096);
+    short_value_sizer_t sizer(bs);
+    scoped_malloc_t<leaf_node_t> node(bs.value());
+    std::vector<store_key_t> keys = fill_leaf(&sizer, node.get());
+    size_t i = 0;
+    while (state->keep_running()) {
+        int index;
+        bool found = leaf::find_key(node.get(), keys[i].btree_key(), &index);
+        do_not_optimize(found);
+        do_not_optimize(index);
+        i = (i + 1 == keys.size()) ? 0 : i + 1;
+    }
+}
+
+}  // namespace bench
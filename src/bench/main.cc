@@ -0,0 +1,76 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "extproc/extproc_spawner.hpp"
+#include "utils.hpp"
+
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --filter TEXT       only run benchmarks whose Group/Name contains TEXT\n"
+            "  --min-time SECS     run each benchmark for at least SECS (default 0.5)\n"
+            "  --repetitions N     report the median of N runs (default 5)\n"
+            "  --json FILE         also write the results to FILE as JSON\n"
+            "  --list              list the benchmarks and exit\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+
+#ifdef _WIN32
+    extproc_maybe_run_worker(argc, argv);
+#endif
+
+    bench::options_t options;
+    std::string json_path;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && has_value) {
+            options.min_time_secs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repetitions") == 0 && has_value) {
+            options.repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0) {
+            for (const std::string &name : bench::list_benchmarks()) {
+                printf("%s\n", name.c_str());
+            }
+            return EXIT_SUCCESS;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.min_time_secs <= 0 || options.repetitions < 1) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    startup_shutdown_t startup_shutdown;
+
+    std::vector<bench::result_t> results = bench::run_benchmarks(options);
+
+    if (!json_path.empty()) {
+        FILE *file = fopen(json_path.c_str(), "w");
+        if (file == nullptr) {
+            fprintf(stderr, "Could not open %s: %s\n",
+                    json_path.c_str(), errno_string(errno).c_str());
+            return EXIT_FAILURE;
+        }
+        std::string json = bench::results_to_json(options, results);
+        size_t written = fwrite(json.data(), 1, json.size(), file);
+        if (fclose(file) != 0 || written != json.size()) {
+            fprintf(stderr, "Could not write %s\n", json_path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
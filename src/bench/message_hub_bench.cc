@@ -0,0 +1,24 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/runtime/coroutines.hpp"
+#include "bench/bench.hpp"
+#include "threading.hpp"
+
+namespace bench {
+
+// Switching to another thread and back sends a message through each thread's message
+// hub, and is what every cross-thread operation in the server pays at least once.
+BENCH(MessageHub, RoundTrip, 2) {
+    const threadnum_t other(get_thread_id().threadnum == 0 ? 1 : 0);
+    while (state->keep_running()) {
+        on_thread_t thread_switcher(other);
+    }
+}
+
+// For comparison: the cost of a context switch without a message hub.
+BENCH(MessageHub, Yield) {
+    while (state->keep_running()) {
+        coro_t::yield();
+    }
+}
+
+}  // namespace bench
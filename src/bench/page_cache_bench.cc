@@ -0,0 +1,34 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <string.h>
+
+#include "bench/bench.hpp"
+#include "bench/bench_utils.hpp"
+
+namespace bench {
+
+BENCH(PageCache, AcquireRelease) {
+    mock_cache_t mock;
+    std::vector<block_id_t> block_ids;
+    {
+        txn_t txn(mock.cache_conn(), write_durability_t::SOFT, 1);
+        for (int i = 0; i < 1000; ++i) {
+            buf_lock_t lock(buf_parent_t(&txn), alt_create_t::create);
+            buf_write_t write(&lock);
+            memset(write.get_data_write(), i % 256,
+                   mock.cache()->max_block_size().value());
+            block_ids.push_back(lock.block_id());
+        }
+        txn.commit();
+    }
+
+    txn_t txn(mock.cache_conn(), read_access_t::read);
+    size_t i = 0;
+    while (state->keep_running()) {
+        buf_lock_t lock(buf_parent_t(&txn), block_ids[i], access_t::read);
+        buf_read_t read(&lock);
+        do_not_optimize(read.get_data_read());
+        i = (i + 1 == block_ids.size()) ? 0 : i + 1;
+    }
+}
+
+}  // namespace bench
@@ -0,0 +1,64 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <string>
+
+#include "arch/io/network.hpp"
+#include "arch/runtime/coroutines.hpp"
+#include "bench/bench.hpp"
+#include "concurrency/cond_var.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace bench {
+
+// Sends `messages_per_iteration` messages of `message_size` bytes per iteration from
+// one end of a loopback connection to the other, while a coroutine on the other end
+// reads them the way the cluster connections do.
+static void run_loopback_bench(state_t *state, size_t message_size,
+                               int messages_per_iteration, bool buffered) {
+    scoped_ptr_t<tcp_conn_t> client, server;
+    unittest::make_loopback_tcp_conns(&client, &server);
+    cond_t non_closer;
+
+    cond_t reader_done;
+    coro_t::spawn_sometime([&]() {
+        try {
+            for (;;) {
+                server->read_more_buffered(&non_closer);
+                const_charslice data = server->peek();
+                server->pop(data.end - data.beg, &non_closer);
+            }
+        } catch (const tcp_conn_read_closed_exc_t &) {
+        }
+        reader_done.pulse();
+    });
+
+    std::string message(message_size, 'x');
+    state->set_bytes_per_iteration(message_size * messages_per_iteration);
+    while (state->keep_running()) {
+        for (int i = 0; i < messages_per_iteration; ++i) {
+            if (buffered) {
+                client->write_buffered(message.data(), message.size(), &non_closer);
+            } else {
+                client->write(message.data(), message.size(), &non_closer);
+            }
+        }
+        if (buffered) {
+            client->flush_buffer_eventually(&non_closer);
+        }
+    }
+    client->flush_buffer(&non_closer);
+
+    client->shutdown_write();
+    reader_done.wait();
+}
+
+// Many small messages, which the write coroutine picks up several at a time.
+BENCH(TcpConn, SmallBufferedWrites) {
+    run_loopback_bench(state, 100, 64, true);
+}
+
+// Responses the size of a large batch, which are written without being copied.
+BENCH(TcpConn, LargeWrites) {
+    run_loopback_bench(state, MEGABYTE, 1, false);
+}
+
+}  // namespace bench
@@ -55,6 +55,14 @@ public:
         return continue_bool_t::CONTINUE;
     }
 
+    virtual bool should_prefetch(
+            const btree_key_t *left_excl_or_null,
+            const btree_key_t *right_incl) THROWS_NOTHING {
+        bool skip;
+        cb_->filter_range(left_excl_or_null, right_incl, &skip);
+        return !skip;
+    }
+
     void handle_pair_coro(scoped_key_value_t *fragile_keyvalue,
                           semaphore_acq_t *fragile_acq,
                           fifo_enforcer_write_token_t token,
@@ -107,6 +115,14 @@ public:
             ? continue_bool_t::ABORT : continue_bool_t::CONTINUE;
     }
 
+    virtual size_t get_prefetch_window() THROWS_NOTHING {
+        return cb_->get_prefetch_window();
+    }
+
+    virtual void note_prefetches(size_t issued, size_t hits) THROWS_NOTHING {
+        cb_->note_prefetches(issued, hits);
+    }
+
     virtual profile::trace_t *get_trace() THROWS_NOTHING {
         return cb_->get_trace();
     }
@@ -36,7 +36,8 @@ public:
     sync with respect to `handle_pair()`, so allowing `filter_range()` to abort the
     traversal would be confusing. The other `depth_first_traversal_callback_t` methods
     could be passed through, but we don't simply because there's no immediate use for
-    them. */
+    them. `filter_range()` must not have side effects, because the traversal also calls
+    it to decide which children to prefetch. */
     virtual void filter_range(
             UNUSED const btree_key_t *left_excl_or_null,
             UNUSED const btree_key_t *right_incl,
@@ -54,6 +55,12 @@ public:
             concurrent_traversal_fifo_enforcer_signal_t waiter)
             THROWS_ONLY(interrupted_exc_t) = 0;
 
+    /* Passed through to `depth_first_traversal_callback_t`. */
+    virtual size_t get_prefetch_window() THROWS_NOTHING { return 0; }
+    virtual void note_prefetches(
+            UNUSED size_t issued,
+            UNUSED size_t hits) THROWS_NOTHING { }
+
     virtual profile::trace_t *get_trace() THROWS_NOTHING { return nullptr; }
 
 protected:
@@ -1,6 +1,8 @@
 // Copyright 2010-2014 RethinkDB, all rights reserved.
 #include "btree/depth_first_traversal.hpp"
 
+#include <vector>
+
 #include "btree/internal_node.hpp"
 #include "btree/operations.hpp"
 #include "concurrency/interruptor.hpp"
@@ -45,6 +47,7 @@ continue_bool_t btree_depth_first_traversal(
         direction_t direction,
         const btree_key_t *left_excl_or_null,
         const btree_key_t *right_incl,
+        std::vector<buf_lock_t *> *ancestors,
         signal_t *interruptor);
 
 continue_bool_t btree_depth_first_traversal(
@@ -103,9 +106,10 @@ continue_bool_t btree_depth_first_traversal(
             wait_interruptible(root_block->lock.read_acq_signal(), interruptor);
         }
 
+        std::vector<buf_lock_t *> ancestors;
         return btree_depth_first_traversal(
             std::move(root_block), range, cb, access, direction,
-            left_excl_or_null, right_incl_buf.btree_key(), interruptor);
+            left_excl_or_null, right_incl_buf.btree_key(), &ancestors, interruptor);
     }
 }
 
@@ -153,6 +157,7 @@ continue_bool_t btree_depth_first_traversal(
         direction_t direction,
         const btree_key_t *left_excl_or_null,
         const btree_key_t *right_incl,
+        std::vector<buf_lock_t *> *ancestors,
         signal_t *interruptor) {
     bool skip;
     if (continue_bool_t::ABORT == cb->filter_range_ts(
@@ -180,10 +185,50 @@ continue_bool_t btree_depth_first_traversal(
             r.decrement();
             end_index = internal_node::get_offset_index(inode, r.btree_key()) + 1;
         }
-        for (int i = 0; i < end_index - start_index; ++i) {
-            int true_index = (direction == FORWARD ? start_index + i : (end_index - 1) - i);
+        const int num_children = end_index - start_index;
+        auto child_index = [&](int i) {
+            return direction == FORWARD ? start_index + i : (end_index - 1) - i;
+        };
+
+        const size_t prefetch_window = cb->get_prefetch_window();
+        std::vector<bool> prefetched;
+        size_t prefetches_issued = 0;
+        size_t prefetch_hits = 0;
+        // The child we're about to acquire gets loaded anyway, so start with the next.
+        int next_to_prefetch = 1;
+        if (prefetch_window > 0) {
+            prefetched.resize(num_children, false);
+        }
+        auto report_prefetches = [&]() {
+            if (prefetches_issued > 0) {
+                cb->note_prefetches(prefetches_issued, prefetch_hits);
+            }
+        };
+
+        for (int i = 0; i < num_children; ++i) {
+            int true_index = child_index(i);
             const btree_internal_pair *pair = internal_node::get_pair_by_index(inode, true_index);
 
+            // Keep the next `prefetch_window` children loading while we visit this one.
+            for (; prefetch_window > 0
+                     && next_to_prefetch < num_children
+                     && static_cast<size_t>(next_to_prefetch - i) <= prefetch_window;
+                 ++next_to_prefetch) {
+                const int ahead_index = child_index(next_to_prefetch);
+                const btree_internal_pair *ahead
+                    = internal_node::get_pair_by_index(inode, ahead_index);
+                const btree_key_t *ahead_left_excl_or_null;
+                const btree_key_t *ahead_right_incl;
+                get_child_key_range(inode, ahead_index,
+                                    left_excl_or_null, right_incl,
+                                    &ahead_left_excl_or_null, &ahead_right_incl);
+                if (cb->should_prefetch(ahead_left_excl_or_null, ahead_right_incl)
+                        && block->lock.prefetch_child(ahead->lnode)) {
+                    prefetched[next_to_prefetch] = true;
+                    ++prefetches_issued;
+                }
+            }
+
             // Get the child key range
             const btree_key_t *child_left_excl_or_null;
             const btree_key_t *child_right_incl;
@@ -193,9 +238,13 @@ continue_bool_t btree_depth_first_traversal(
 
             if (continue_bool_t::ABORT == cb->filter_range(
                     child_left_excl_or_null, child_right_incl, interruptor, &skip)) {
+                report_prefetches();
                 return continue_bool_t::ABORT;
             }
             if (!skip) {
+                if (prefetch_window > 0 && prefetched[i]) {
+                    ++prefetch_hits;
+                }
                 counted_t<counted_buf_lock_and_read_t> lock;
                 {
                     PROFILE_STARTER_IF_ENABLED(
@@ -206,13 +255,21 @@ continue_bool_t btree_depth_first_traversal(
                         &block->lock, pair->lnode, access);
                     wait_interruptible(lock->lock.read_acq_signal(), interruptor);
                 }
-                if (continue_bool_t::ABORT == btree_depth_first_traversal(
-                        std::move(lock), range, cb, access, direction,
-                        child_left_excl_or_null, child_right_incl, interruptor)) {
+                ancestors->push_back(&block->lock);
+                continue_bool_t res = btree_depth_first_traversal(
+                    std::move(lock), range, cb, access, direction,
+                    child_left_excl_or_null, child_right_incl, ancestors, interruptor);
+                ancestors->pop_back();
+                if (continue_bool_t::ABORT == res) {
+                    report_prefetches();
                     return continue_bool_t::ABORT;
                 }
             }
+            // We never come back to this child, so a snapshotted traversal doesn't
+            // need writers to preserve its old version anymore.
+            block->lock.release_snapshotted_child(pair->lnode, *ancestors);
         }
+        report_prefetches();
         return continue_bool_t::CONTINUE;
     } else {
         if (continue_bool_t::ABORT == cb->handle_pre_leaf(
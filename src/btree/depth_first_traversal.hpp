@@ -119,6 +119,28 @@ public:
         return continue_bool_t::CONTINUE;
     }
 
+    /* When the traversal reads an internal node, it starts loading up to this many of
+    the children it's going to visit next, so that acquiring them later doesn't have to
+    wait for the disk. */
+    virtual size_t get_prefetch_window() THROWS_NOTHING { return 0; }
+
+    /* Called before prefetching the child that covers the given range. Callbacks that
+    skip parts of the range in `filter_range()` can return `false` here so that the
+    traversal doesn't load children that it won't visit. Unlike `filter_range()`, this
+    may be called in any order and more than once for the same range. */
+    virtual bool should_prefetch(
+            UNUSED const btree_key_t *left_excl_or_null,
+            UNUSED const btree_key_t *right_incl) THROWS_NOTHING {
+        return true;
+    }
+
+    /* Called after the traversal is done with an internal node's children, if it
+    prefetched any of them. `hits` counts the prefetched children that the traversal
+    went on to acquire. */
+    virtual void note_prefetches(
+            UNUSED size_t issued,
+            UNUSED size_t hits) THROWS_NOTHING { }
+
     /* Note that the depth-first traversal proceeds in lexicographical order.
 
     If you were to collect all the calls to `handle_pre_leaf()`; calls to
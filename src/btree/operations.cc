@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 
+#include "arch/runtime/resource_account.hpp"
 #include "btree/internal_node.hpp"
 #include "buffer_cache/alt.hpp"
 #include "buffer_cache/blob.hpp"
@@ -23,6 +24,48 @@ block_id_t create_stat_block(buf_parent_t parent) {
     return stats_block.block_id();
 }
 
+/* Point lookups consult the cache's key filters (see `block_key_filters_t`) to skip
+reading leaves that can't contain the key. A leaf's filter must cover every key in the
+current version of the leaf: inserts add their key to it, and merging or leveling a
+leaf drops it, because that moves keys in from the sibling. Removing a key leaves the
+filter as it is, which only costs us false positives.
+
+Other reads don't use the filters. The `getAll` traversal reads a snapshot, which may
+hold keys that have since been removed from the leaf and its filter. Inserts, including
+those with `conflict: "error"`, have to load the leaf anyway to write the new key into
+it. */
+
+// Returns `true` if the filter of `leaf_id`, a child of `parent`, shows that the leaf
+// doesn't contain `key`.
+bool leaf_filter_rules_out(buf_lock_t *parent, block_id_t leaf_id,
+                           const btree_key_t *key) {
+    // A snapshotted lookup would see an old version of the leaf, which the filter
+    // doesn't describe. And if someone is about to write to the leaf, acquiring it
+    // would show us their write.
+    if (parent->is_snapshotted()
+        || parent->cache()->block_has_write_acquirer(leaf_id)) {
+        return false;
+    }
+    block_key_filters_t *filters = parent->cache()->key_filters();
+    block_key_filter_t *filter = filters->find(leaf_id);
+    if (filter == nullptr || filter->may_contain(key->contents, key->size)) {
+        return false;
+    }
+    ++filters->pm_saved_reads;
+    return true;
+}
+
+void rebuild_leaf_filter(buf_lock_t *buf, const leaf_node_t *leaf) {
+    block_key_filter_t *filter = buf->cache()->key_filters()->create(buf->block_id());
+    if (filter == nullptr) {
+        return;
+    }
+    for (auto it = leaf::begin(*leaf); it != leaf::end(*leaf); ++it) {
+        const btree_key_t *key = (*it).first;
+        filter->add(key->contents, key->size);
+    }
+}
+
 buf_lock_t get_root(value_sizer_t *sizer, superblock_t *sb) {
     const block_id_t node_id = sb->get_root_block_id();
 
@@ -354,6 +397,10 @@ void check_and_handle_underfull(value_sizer_t *sizer,
                                           replacement_key);
             }
         }
+
+        // `buf` may have received keys from its sibling that its filter doesn't know
+        // about.
+        buf->cache()->key_filters()->forget(buf->block_id());
     }
 }
 
@@ -480,6 +527,9 @@ void find_keyvalue_location_for_read(
         btree_stats_t *stats, profile::trace_t *trace) {
     stats->pm_keys_read.record();
     stats->pm_total_keys_read += 1;
+    if (resource_account_t *resource_account = resource_account_t::current()) {
+        resource_account->charge_row_scanned();
+    }
 
     const block_id_t root_id = superblock->get_root_block_id();
     rassert(root_id != SUPERBLOCK_ID);
@@ -520,6 +570,11 @@ void find_keyvalue_location_for_read(
         }
         rassert(node_id != NULL_BLOCK_ID && node_id != SUPERBLOCK_ID);
 
+        // Only leaves have filters, so this also stops at internal nodes.
+        if (leaf_filter_rules_out(&buf, node_id, key)) {
+            return;
+        }
+
         {
             PROFILE_STARTER_IF_ENABLED(
                 trace != nullptr, "Acquire a block for read.", trace);
@@ -544,6 +599,15 @@ void find_keyvalue_location_for_read(
         const leaf_node_t *leaf
             = static_cast<const leaf_node_t *>(read.get_data_read());
         value_found = leaf::lookup(sizer, leaf, key, value.get());
+
+        if (!buf.is_snapshotted()) {
+            block_key_filters_t *filters = buf.cache()->key_filters();
+            if (filters->find(buf.block_id()) == nullptr) {
+                rebuild_leaf_filter(&buf, leaf);
+            } else if (!value_found) {
+                ++filters->pm_false_positives;
+            }
+        }
     }
     if (value_found) {
         keyvalue_location_out->buf = std::move(buf);
@@ -607,6 +671,14 @@ void apply_keyvalue_change(
                          tstamp,
                          previous_leaf_recency,
                          km_proof);
+
+            block_key_filter_t *filter
+                = kv_loc->buf.cache()->key_filters()->find(kv_loc->buf.block_id());
+            if (filter != nullptr) {
+                filter->add(key->contents, key->size);
+            } else {
+                rebuild_leaf_filter(&kv_loc->buf, leaf_node);
+            }
         }
     } else {
         // Delete the value if it's there.
@@ -1,6 +1,7 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include "btree/reql_specific.hpp"
 
+#include "btree/internal_node.hpp"
 #include "btree/secondary_operations.hpp"
 #include "buffer_cache/blob.hpp"
 #include "containers/binary_blob.hpp"
@@ -413,3 +414,42 @@ void get_btree_superblock_and_txn_for_reading(
     }
 }
 
+bool find_value_without_acquiring(
+        cache_t *cache,
+        value_sizer_t *sizer,
+        const btree_key_t *key,
+        void *value_out,
+        bool *found_out) {
+    ASSERT_NO_CORO_WAITING;
+    const reql_btree_superblock_t *sb_data
+        = static_cast<const reql_btree_superblock_t *>(
+            cache->peek_block_for_read(SUPERBLOCK_ID));
+    if (sb_data == nullptr) {
+        return false;
+    }
+    block_id_t node_id = sb_data->root_block;
+    rassert(node_id != SUPERBLOCK_ID);
+    if (node_id == NULL_BLOCK_ID) {
+        // There is no root, so the tree is empty.
+        *found_out = false;
+        return true;
+    }
+
+    for (;;) {
+        const node_t *node
+            = static_cast<const node_t *>(cache->peek_block_for_read(node_id));
+        if (node == nullptr) {
+            return false;
+        }
+        if (!node::is_internal(node)) {
+            *found_out = leaf::lookup(sizer,
+                                      reinterpret_cast<const leaf_node_t *>(node),
+                                      key,
+                                      value_out);
+            return true;
+        }
+        node_id = internal_node::lookup(
+            reinterpret_cast<const internal_node_t *>(node), key);
+        rassert(node_id != NULL_BLOCK_ID && node_id != SUPERBLOCK_ID);
+    }
+}
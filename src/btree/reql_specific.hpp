@@ -206,5 +206,20 @@ void get_btree_superblock_and_txn_for_reading(
         scoped_ptr_t<real_superblock_t> *got_superblock_out,
         scoped_ptr_t<txn_t> *txn_out);
 
+/* A fast path for point reads on the primary B-tree that doesn't create a `txn_t` or
+acquire any blocks. It reads the in-memory contents of the superblock and of each node
+on the way to `key`'s leaf, which is only valid if all of them are cached and no write
+transaction holds or is waiting for any of them (see `cache_t::peek_block_for_read`).
+In that case the result is the same as that of `find_keyvalue_location_for_read()`
+right now: it returns `true`, sets `*found_out`, and copies the value (if found) into
+`value_out`, which must have room for `sizer->max_possible_size()` bytes. Otherwise it
+returns `false` and the caller should take the regular path. Never blocks. */
+bool find_value_without_acquiring(
+        cache_t *cache,
+        value_sizer_t *sizer,
+        const btree_key_t *key,
+        void *value_out,
+        bool *found_out);
+
 #endif /* BTREE_REQL_SPECIFIC_HPP_ */
 
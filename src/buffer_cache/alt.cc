@@ -1,5 +1,6 @@
 #include "buffer_cache/alt.hpp"
 
+#include <set>
 #include <stack>
 
 #include "arch/types.hpp"
@@ -54,6 +55,15 @@ private:
     // A NULL pointer associated with a block id indicates that the block is deleted.
     std::map<block_id_t, alt_snapshot_node_t *> children_;
 
+    // Children that the node's only reader has promised not to acquire again (see
+    // buf_lock_t::release_snapshotted_child).  Write transactions don't attach
+    // snapshots of these.
+    std::set<block_id_t> released_children_;
+
+    // False once a child has been released.  New readers must not share the node
+    // then, because they might still want the released children.
+    bool shareable_;
+
     // The number of buf_lock_t's referring to this node, plus the number of
     // alt_snapshot_node_t's referring to this node (via its children_ vector).
     int64_t ref_count_;
@@ -118,6 +128,7 @@ cache_t::cache_t(serializer_t *serializer,
     : throttler_(MINIMUM_SOFT_UNWRITTEN_CHANGES_LIMIT),
       page_cache_(serializer, balancer, &throttler_),
       stats_(make_scoped<alt_cache_stats_t>(&page_cache_, perfmon_collection)),
+      key_filters_(&stats_->cache_collection, &page_cache_.evicter()),
       soft_durability_flusher_(DEFAULT_FLUSH_INTERVAL, [this]() {
           // Smear it over 6.25% of the time.  (Not a well thought-through number.)
           // 6.25% is a worst case -- we'll smear faster if we can.
@@ -141,6 +152,14 @@ void cache_t::configure_flush_interval(flush_interval_t interval) {
         clamp_ring_length(which_cpu_shard_, interval.millis));
 }
 
+const void *cache_t::peek_block_for_read(block_id_t block_id) {
+    return page_cache_.peek_page_for_read(block_id);
+}
+
+bool cache_t::block_has_write_acquirer(block_id_t block_id) {
+    return page_cache_.block_has_write_acquirer(block_id);
+}
+
 cache_account_t cache_t::create_cache_account(int priority) {
     return page_cache_.create_cache_account(priority);
 }
@@ -155,13 +174,21 @@ cache_t::matching_snapshot_node_or_null(block_id_t block_id,
     }
     intrusive_list_t<alt_snapshot_node_t> *list = &list_it->second;
     for (alt_snapshot_node_t *p = list->tail(); p != nullptr; p = list->prev(p)) {
-        if (p->current_page_acq_->block_version() == block_version) {
+        if (p->shareable_ && p->current_page_acq_->block_version() == block_version) {
             return p;
         }
     }
     return nullptr;
 }
 
+size_t cache_t::snapshot_node_count() const {
+    size_t count = 0;
+    for (const auto &pair : snapshot_nodes_by_block_id_) {
+        count += pair.second.size();
+    }
+    return count;
+}
+
 void cache_t::add_snapshot_node(block_id_t block_id,
                                 alt_snapshot_node_t *node) {
     ASSERT_NO_CORO_WAITING;
@@ -302,7 +329,7 @@ void txn_t::set_account(cache_account_t *cache_account) {
 
 
 alt_snapshot_node_t::alt_snapshot_node_t(scoped_ptr_t<current_page_acq_t> &&acq)
-    : current_page_acq_(std::move(acq)), ref_count_(0) { }
+    : current_page_acq_(std::move(acq)), shareable_(true), ref_count_(0) { }
 
 alt_snapshot_node_t::~alt_snapshot_node_t() {
     // The only thing that deletes an alt_snapshot_node_t should be the
@@ -350,6 +377,8 @@ buf_lock_t::get_or_create_child_snapshot_node(cache_t *cache,
                                               alt_snapshot_node_t *parent,
                                               block_id_t child_id) {
     ASSERT_FINITE_CORO_WAITING;
+    rassert(parent->released_children_.count(child_id) == 0,
+            "Acquired a snapshotted child after releasing it.");
     auto it = parent->children_.find(child_id);
     if (it == parent->children_.end()) {
         // There's no child for the snapshot node for this child id.  That means a
@@ -401,6 +430,10 @@ void buf_lock_t::create_child_snapshot_attachments(cache_t *cache,
             // Already has a child, continue.
             continue;
         }
+        if (p->released_children_.count(child_id) != 0) {
+            // Nobody reading this snapshot wants the child anymore.
+            continue;
+        }
         if (p->current_page_acq_->block_version() >= parent_version) {
             // Version of snapshot node is _after_ the parent's version.
             continue;
@@ -435,6 +468,10 @@ void buf_lock_t::create_empty_child_snapshot_attachments(cache_t *cache,
             // Already has a child, continue.
             continue;
         }
+        if (p->released_children_.count(child_id) != 0) {
+            // Nobody reading this snapshot wants the child anymore.
+            continue;
+        }
         if (p->current_page_acq_->block_version() >= parent_version) {
             // Version of snapshot node is _after_ the parent's version.
             continue;
@@ -517,6 +554,8 @@ void buf_lock_t::help_construct(buf_parent_t parent, block_id_t _block_id,
                                                   _block_id,
                                                   access_t::write,
                                                   alt::page_create_t::yes));
+    // The block id might have belonged to a deleted block that had a key filter.
+    txn_->cache()->key_filters_.forget(current_page_acq_->block_id());
 
     if (parent.lock_or_null_ != nullptr) {
         create_empty_child_snapshot_attachments(txn_->cache(),
@@ -562,6 +601,7 @@ void buf_lock_t::mark_deleted() {
 #endif
     guarantee(!empty());
     guarantee(current_page_acq()->write_acq_signal()->is_pulsed());
+    cache()->key_filters_.forget(block_id());
     current_page_acq()->mark_deleted();
 }
 
@@ -596,6 +636,8 @@ void buf_lock_t::help_construct(
     current_page_acq_.init(new current_page_acq_t(txn_->page_txn(),
                                                   alt_create_t::create,
                                                   block_type));
+    // The block id might have belonged to a deleted block that had a key filter.
+    txn_->cache()->key_filters_.forget(current_page_acq_->block_id());
 
     if (parent.lock_or_null_ != nullptr) {
         create_empty_child_snapshot_attachments(txn_->cache(),
@@ -750,6 +792,76 @@ void buf_lock_t::detach_child(block_id_t child_id) {
             child_id);
 }
 
+void buf_lock_t::release_snapshotted_child(block_id_t child_id,
+                                           const std::vector<buf_lock_t *> &ancestors) {
+    ASSERT_FINITE_CORO_WAITING;
+    guarantee(!empty());
+    alt_snapshot_node_t *node = snapshot_node_;
+    if (node == nullptr) {
+        return;
+    }
+    // If anything else refers to the node or to one of the nodes above it (another
+    // buf_lock_t, or a snapshot node through which other readers could reach it),
+    // someone else might still want the child.  The references that our own locks
+    // and the nodes along our own path hold don't count: one from our lock on each
+    // node, and one from the node's parent if that's where we found it.
+    auto owned_snapshot_refs = [](alt_snapshot_node_t *parent,
+                                  block_id_t id,
+                                  alt_snapshot_node_t *n) -> int64_t {
+        if (parent != nullptr) {
+            auto it = parent->children_.find(id);
+            if (it != parent->children_.end() && it->second == n) {
+                return 2;
+            }
+        }
+        return 1;
+    };
+    alt_snapshot_node_t *parent = nullptr;
+    for (buf_lock_t *ancestor : ancestors) {
+        alt_snapshot_node_t *ancestor_node = ancestor->snapshot_node_;
+        if (ancestor_node == nullptr
+            || ancestor_node->ref_count_
+                != owned_snapshot_refs(parent, ancestor->block_id(), ancestor_node)) {
+            return;
+        }
+        parent = ancestor_node;
+    }
+    if (node->ref_count_ != owned_snapshot_refs(parent, block_id(), node)) {
+        return;
+    }
+
+    // New readers must not share any node on our path from now on, since they could
+    // reach the released child through it.
+    for (buf_lock_t *ancestor : ancestors) {
+        ancestor->snapshot_node_->shareable_ = false;
+    }
+    node->shareable_ = false;
+    node->released_children_.insert(child_id);
+
+    auto it = node->children_.find(child_id);
+    if (it != node->children_.end()) {
+        alt_snapshot_node_t *child = it->second;
+        node->children_.erase(it);
+        if (child != nullptr) {
+            --child->ref_count_;
+            if (child->ref_count_ == 0) {
+                cache()->remove_snapshot_node(child_id, child);
+            }
+        }
+    }
+}
+
+bool buf_lock_t::prefetch_child(block_id_t child_id) {
+    guarantee(!empty());
+    if (snapshot_node_ != nullptr
+        && snapshot_node_->children_.count(child_id) != 0) {
+        // We'll read the version that a writer preserved for our snapshot, not the
+        // current one.
+        return false;
+    }
+    return cache()->page_cache_.prefetch_block(child_id, txn_->account());
+}
+
 repli_timestamp_t buf_lock_t::get_recency() const {
     guarantee(!empty());
     current_page_acq_t *cpa = current_page_acq();
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "arch/timing.hpp"
+#include "buffer_cache/key_filters.hpp"
 #include "buffer_cache/page_cache.hpp"
 #include "buffer_cache/types.hpp"
 #include "containers/two_level_array.hpp"
@@ -64,6 +65,25 @@ public:
 
     void configure_flush_interval(flush_interval_t interval);
 
+    // Returns the current contents of the block without acquiring it, if that's
+    // equivalent to a read acquisition right now (see
+    // page_cache_t::peek_page_for_read), or NULL.  The pointer is only valid until
+    // the caller blocks.
+    const void *peek_block_for_read(block_id_t block_id);
+
+    // True if a write acquirer holds or waits for the block.  A read acquisition
+    // started right now would see the same contents as the caller does, unless this
+    // is true.
+    bool block_has_write_acquirer(block_id_t block_id);
+
+    // Bloom filters of the keys in some of the blocks (see key_filters.hpp).  The
+    // B-tree keeps them for leaf nodes.
+    block_key_filters_t *key_filters() { return &key_filters_; }
+
+    // The number of old versions of blocks that the cache keeps around for
+    // snapshotted read transactions.
+    size_t snapshot_node_count() const;
+
 private:
     friend class txn_t;
     friend class buf_read_t;
@@ -82,6 +102,8 @@ private:
 
     scoped_ptr_t<alt_cache_stats_t> stats_;
 
+    block_key_filters_t key_filters_;
+
     std::map<block_id_t, intrusive_list_t<alt_snapshot_node_t> >
         snapshot_nodes_by_block_id_;
 
@@ -204,6 +226,21 @@ public:
 
     void detach_child(block_id_t child_id);
 
+    // Tells a snapshotted lock that this txn will never acquire the child `child_id`
+    // through it again (for example, because a traversal has moved past it).  If no
+    // other txn shares the lock's snapshot, the snapshotted version of the child is
+    // dropped and later writes to the child stop preserving old versions for us, so
+    // a long scan only holds on to old versions of the blocks it hasn't read yet.
+    // `ancestors` are the locks that this txn holds on the way down to this one,
+    // starting with the first one it acquired and ending with this lock's parent.
+    // Does nothing if the lock isn't snapshotted.
+    void release_snapshotted_child(block_id_t child_id,
+                                   const std::vector<buf_lock_t *> &ancestors);
+
+    // Starts loading the child `child_id` into memory ahead of its acquisition, using
+    // the txn's cache account.  Returns true if a load was started.
+    bool prefetch_child(block_id_t child_id);
+
     block_id_t block_id() const {
         guarantee(txn_ != nullptr);
         return current_page_acq()->block_id();
@@ -11,6 +11,8 @@ const uint64_t alt_cache_balancer_t::rebalance_check_interval_ms = 20;
 const uint64_t alt_cache_balancer_t::rebalance_access_count_threshold = 100;
 const int64_t alt_cache_balancer_t::rebalance_timeout_ms = 500;
 
+const double alt_cache_balancer_t::cold_miss_weight = 0.25;
+
 const double alt_cache_balancer_t::read_ahead_proportion = 0.9;
 
 alt_cache_balancer_t::cache_data_t::cache_data_t(alt::evicter_t *_evicter) :
@@ -21,7 +23,23 @@ alt_cache_balancer_t::cache_data_t::cache_data_t(alt::evicter_t *_evicter) :
     evictable_disk_backed_size(evicter->evictable_disk_backed_size()),
     evictable_unbacked_size(evicter->evictable_unbacked_size()),
     bytes_loaded(evicter->get_bytes_loaded()),
-    access_count(evicter->access_count()) { }
+    access_count(evicter->access_count()),
+    cold_bytes_loaded(evicter->get_cold_bytes_loaded()),
+    reuse_histogram(evicter->working_set_estimator().reuse_histogram()) { }
+
+int64_t alt_cache_balancer_t::cache_data_t::demand(uint64_t step) const {
+    // This is the marginal gain of giving the cache `step` more memory. Scans and
+    // other cold misses would load the same bytes however much memory the cache had,
+    // and of the other misses, the reuse histogram tells us how many `step` would
+    // have avoided. Giving the cache memory for the rest would only take it away from
+    // caches whose misses it would avoid. They still count a little, so that caches
+    // that don't have any history yet can grow.
+    int64_t loaded = std::max<int64_t>(0, bytes_loaded);
+    int64_t warm = std::max<int64_t>(
+        0, loaded - std::max<int64_t>(0, cold_bytes_loaded));
+    double avoidable = warm * reuse_histogram.fraction_within(step);
+    return static_cast<int64_t>(avoidable + cold_miss_weight * (loaded - avoidable));
+}
 
 alt_cache_balancer_t::alt_cache_balancer_t(
         clone_ptr_t<watchable_t<uint64_t> > _total_cache_size_watchable) :
@@ -130,6 +148,17 @@ void alt_cache_balancer_t::rebalance_blocking(UNUSED signal_t *interruptor) {
         }
     }
 
+    // Caches' demands are compared by what the same amount of extra memory would do
+    // for each of them. We use an even share of the total.
+    const uint64_t demand_step
+        = total_evicters == 0 ? 0 : total_cache_size / total_evicters;
+    uint64_t total_demand = 0;
+    for (size_t i = 0; i < num_threads; ++i) {
+        for (size_t j = 0; j < cache_data[i].size(); ++j) {
+            total_demand += cache_data[i][j].demand(demand_step);
+        }
+    }
+
     // Reevaluate if read-ahead should be running
     if (read_ahead_ok) {
         bytes_toward_read_ahead_limit += total_bytes_loaded;
@@ -163,9 +192,9 @@ void alt_cache_balancer_t::rebalance_blocking(UNUSED signal_t *interruptor) {
                 if (total_cache_size > 0) {
                     double temp = data->old_size;
                     temp /= static_cast<double>(total_cache_size);
-                    temp *= static_cast<double>(total_bytes_loaded);
+                    temp *= static_cast<double>(total_demand);
 
-                    int64_t new_size = std::max<int64_t>(0, data->bytes_loaded);
+                    int64_t new_size = data->demand(demand_step);
                     new_size -= static_cast<int64_t>(temp);
                     new_size += data->old_size;
                     new_size = std::max<int64_t>(new_size, 0);
@@ -299,6 +328,7 @@ void alt_cache_balancer_t::apply_rebalance_to_thread(int index,
             new_size.evicter->update_memory_limit(new_size.new_size,
                                                   new_size.bytes_loaded,
                                                   new_size.access_count,
+                                                  new_size.cold_bytes_loaded,
                                                   new_read_ahead_ok);
         }
     }
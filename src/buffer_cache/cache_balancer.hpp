@@ -10,6 +10,7 @@
 
 #include "threading.hpp"
 #include "arch/timing.hpp"
+#include "buffer_cache/working_set_estimator.hpp"
 #include "concurrency/pump_coro.hpp"
 #include "concurrency/watchable.hpp"
 #include "containers/scoped.hpp"
@@ -113,6 +114,10 @@ private:
     static const int64_t rebalance_timeout_ms;
     static const uint64_t rebalance_check_interval_ms;
 
+    // How much a byte loaded by a miss that more memory wouldn't have avoided counts
+    // towards a cache's share of memory, compared to a byte that it would have
+    static const double cold_miss_weight;
+
     // Controls how much read ahead is allowed out of total cache size
     static const double read_ahead_proportion;
 
@@ -149,6 +154,12 @@ private:
 
         int64_t bytes_loaded;
         uint64_t access_count;
+        int64_t cold_bytes_loaded;
+        alt::working_set_estimator_t::reuse_histogram_t reuse_histogram;
+
+        // How much the cache wants to grow: `bytes_loaded`, with the bytes that
+        // `step` more memory wouldn't have saved it from loading discounted
+        int64_t demand(uint64_t step) const;
     };
 
     // Helper function to collect stats from each thread so we don't need
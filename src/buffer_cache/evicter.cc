@@ -1,5 +1,7 @@
 #include "buffer_cache/evicter.hpp"
 
+#include <algorithm>
+
 #include "arch/runtime/coroutines.hpp"
 #include "buffer_cache/alt.hpp"
 #include "buffer_cache/page.hpp"
@@ -8,14 +10,22 @@
 
 namespace alt {
 
+// Bounds on the number of evicted blocks that the working set estimator remembers.
+static const size_t min_ghost_capacity = 1024;
+static const size_t max_ghost_capacity = 64 * 1024;
+
 evicter_t::evicter_t()
     : initialized_(false),
       page_cache_(nullptr),
       balancer_(nullptr),
       balancer_notify_activity_boolean_(nullptr),
       throttler_(nullptr),
+      side_usage_(0),
       bytes_loaded_counter_(0),
       access_count_counter_(0),
+      cold_bytes_loaded_counter_(0),
+      hits_total_(0),
+      misses_total_(0),
       access_time_counter_(INITIAL_ACCESS_TIME),
       evict_if_necessary_active_(false),
       last_force_flush_time_(ticks_t{0}) { }
@@ -45,11 +55,13 @@ void evicter_t::initialize(page_cache_t *page_cache,
     balancer_->add_evicter(this);
     throttler_->inform_memory_limit_change(memory_limit_,
                                            page_cache_->max_block_size());
+    update_ghost_capacity();
 }
 
 void evicter_t::update_memory_limit(uint64_t new_memory_limit,
                                     int64_t bytes_loaded_accounted_for,
                                     uint64_t access_count_accounted_for,
+                                    int64_t cold_bytes_loaded_accounted_for,
                                     bool read_ahead_ok) {
     guarantee_initialized();
 
@@ -59,13 +71,21 @@ void evicter_t::update_memory_limit(uint64_t new_memory_limit,
 
     bytes_loaded_counter_ -= bytes_loaded_accounted_for;
     access_count_counter_ -= access_count_accounted_for;
+    cold_bytes_loaded_counter_ -= cold_bytes_loaded_accounted_for;
     memory_limit_ = new_memory_limit;
+    update_ghost_capacity();
     evict_if_necessary();
 
     throttler_->inform_memory_limit_change(memory_limit_,
                                            page_cache_->max_block_size());
 }
 
+void evicter_t::update_ghost_capacity() {
+    size_t blocks = memory_limit_ / page_cache_->max_block_size().value();
+    working_set_estimator_.set_ghost_capacity(
+        std::min(std::max(blocks, min_ghost_capacity), max_ghost_capacity));
+}
+
 void wake_up_balancer(cache_balancer_t *balancer,
                       UNUSED auto_drainer_t::lock_t drainer_lock) {
     on_thread_t th(balancer->home_thread());
@@ -85,6 +105,23 @@ void evicter_t::notify_bytes_loading(int64_t in_memory_buf_change) {
     }
 }
 
+void evicter_t::note_loaded_from_disk(page_t *page) {
+    uint32_t bytes = page->hypothetical_memory_usage(page_cache_);
+    if (!working_set_estimator_.note_loaded(page->block_id(), bytes)) {
+        cold_bytes_loaded_counter_ += bytes;
+    }
+}
+
+void evicter_t::note_access(bool hit) {
+    guarantee_initialized();
+    if (hit) {
+        ++hits_total_;
+    } else {
+        ++misses_total_;
+    }
+    working_set_estimator_.note_access(hit);
+}
+
 void evicter_t::add_deferred_loaded(page_t *page) {
     guarantee_initialized();
     evicted_.add(page, page->hypothetical_memory_usage(page_cache_));
@@ -100,11 +137,13 @@ void evicter_t::add_not_yet_loaded(page_t *page) {
     guarantee_initialized();
     unevictable_.add(page, page->hypothetical_memory_usage(page_cache_));
     evict_if_necessary();
+    note_loaded_from_disk(page);
     notify_bytes_loading(page->hypothetical_memory_usage(page_cache_));
 }
 
 void evicter_t::reloading_page(page_t *page) {
     guarantee_initialized();
+    note_loaded_from_disk(page);
     notify_bytes_loading(page->hypothetical_memory_usage(page_cache_));
 }
 
@@ -177,7 +216,17 @@ uint64_t evicter_t::in_memory_size() const {
     guarantee_initialized();
     return unevictable_.size()
         + evictable_disk_backed_.size()
-        + evictable_unbacked_.size();
+        + evictable_unbacked_.size()
+        + side_usage_;
+}
+
+void evicter_t::change_side_usage(int64_t bytes) {
+    guarantee_initialized();
+    guarantee(bytes >= 0 || static_cast<uint64_t>(-bytes) <= side_usage_);
+    side_usage_ += bytes;
+    if (bytes > 0) {
+        evict_if_necessary();
+    }
 }
 
 void evicter_t::evict_if_necessary() THROWS_NOTHING {
@@ -202,6 +251,7 @@ void evicter_t::evict_if_necessary() THROWS_NOTHING {
         uint32_t mem_usage = page->hypothetical_memory_usage(page_cache_);
         evictable_disk_backed_.remove(page, mem_usage);
         evicted_.add(page, mem_usage);
+        working_set_estimator_.note_evicted(page->block_id(), mem_usage);
         page->evict_self(page_cache_);
         page_cache_->consider_evicting_current_page(page->block_id());
     }
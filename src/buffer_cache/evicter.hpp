@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "buffer_cache/eviction_bag.hpp"
+#include "buffer_cache/working_set_estimator.hpp"
 #include "concurrency/auto_drainer.hpp"
 #include "concurrency/cache_line_padded.hpp"
 #include "concurrency/pubsub.hpp"
@@ -34,6 +35,8 @@ public:
     eviction_bag_t *evicted_category() { return &evicted_; }
     void remove_page(page_t *page);
     void reloading_page(page_t *page);
+    // Called whenever a page is acquired, with whether it was already in memory.
+    void note_access(bool hit);
 
     // Evicter will be unusable until initialize is called
     evicter_t();
@@ -45,6 +48,7 @@ public:
     void update_memory_limit(uint64_t new_memory_limit,
                              int64_t bytes_loaded_accounted_for,
                              uint64_t access_count_accounted_for,
+                             int64_t cold_bytes_loaded_accounted_for,
                              bool read_ahead_ok);
 
     uint64_t next_access_time() {
@@ -77,10 +81,35 @@ public:
         guarantee_initialized();
         return bytes_loaded_counter_;
     }
+    // The part of `get_bytes_loaded()` that was loaded by misses that more memory
+    // wouldn't have avoided.
+    int64_t get_cold_bytes_loaded() const {
+        guarantee_initialized();
+        return cold_bytes_loaded_counter_;
+    }
+
+    // How many page acquisitions found their page in memory, and how many didn't
+    uint64_t hits_total() const {
+        guarantee_initialized();
+        return hits_total_;
+    }
+    uint64_t misses_total() const {
+        guarantee_initialized();
+        return misses_total_;
+    }
 
+    const working_set_estimator_t &working_set_estimator() const {
+        guarantee_initialized();
+        return working_set_estimator_;
+    }
 
     uint64_t in_memory_size() const;
 
+    // Accounts for memory that the cache uses for something other than pages, such
+    // as the B-tree's key filters.  It counts towards the memory limit, so growing it
+    // evicts pages.
+    void change_side_usage(int64_t bytes);
+
     // This is decremented past UINT64_MAX to force code to be aware of access time
     // rollovers.
     static const uint64_t INITIAL_ACCESS_TIME = UINT64_MAX - 100;
@@ -96,6 +125,12 @@ private:
     // Tells the cache balancer about a page being loaded
     void notify_bytes_loading(int64_t ser_buf_change);
 
+    // Tells the working set estimator about a page being loaded from disk
+    void note_loaded_from_disk(page_t *page);
+
+    // Sizes the ghost list so that it covers about as much memory as the cache has
+    void update_ghost_capacity();
+
     // Evicts any evictable pages until under the memory limit
     void evict_if_necessary() THROWS_NOTHING;
 
@@ -108,11 +143,18 @@ private:
 
     uint64_t memory_limit_;
 
+    uint64_t side_usage_;
+
     // These are updated every time a page is loaded, created, or destroyed, and
     // cleared when cache memory limits are re-evaluated.  This value can go
     // negative, if you keep deleting blocks or suddenly drop a snapshot.
     int64_t bytes_loaded_counter_;
     uint64_t access_count_counter_;
+    int64_t cold_bytes_loaded_counter_;
+
+    uint64_t hits_total_;
+    uint64_t misses_total_;
+    working_set_estimator_t working_set_estimator_;
 
     // This gets incremented every time a page is accessed.
     uint64_t access_time_counter_;
@@ -0,0 +1,100 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "buffer_cache/key_filters.hpp"
+
+#include <string.h>
+
+#include "buffer_cache/evicter.hpp"
+
+namespace {
+
+// 64-bit FNV-1a, followed by a finalizer so that both halves of the result are usable
+// as independent hashes.
+uint64_t hash_key(const uint8_t *key, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= key[i];
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}  // namespace
+
+block_key_filter_t::block_key_filter_t() {
+    memset(bits_, 0, sizeof(bits_));
+}
+
+void block_key_filter_t::add(const uint8_t *key, size_t size) {
+    const uint64_t h = hash_key(key, size);
+    const uint32_t h1 = h, h2 = (h >> 32) | 1;
+    for (int i = 0; i < num_hashes; ++i) {
+        const size_t bit = (h1 + i * h2) % num_bits;
+        bits_[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+}
+
+bool block_key_filter_t::may_contain(const uint8_t *key, size_t size) const {
+    const uint64_t h = hash_key(key, size);
+    const uint32_t h1 = h, h2 = (h >> 32) | 1;
+    for (int i = 0; i < num_hashes; ++i) {
+        const size_t bit = (h1 + i * h2) % num_bits;
+        if ((bits_[bit / 64] & (uint64_t(1) << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+block_key_filters_t::block_key_filters_t(perfmon_collection_t *perfmon_collection,
+                                         alt::evicter_t *evicter)
+    : evicter_(evicter),
+      pm_membership_(perfmon_collection,
+                     &pm_saved_reads, "key_filter_saved_reads",
+                     &pm_false_positives, "key_filter_false_positives") { }
+
+block_key_filters_t::~block_key_filters_t() {
+    evicter_->change_side_usage(
+        -static_cast<int64_t>(filters_.size() * sizeof(block_key_filter_t)));
+}
+
+block_key_filter_t *block_key_filters_t::find(block_id_t block_id) {
+    assert_thread();
+    auto it = filters_.find(block_id);
+    return it == filters_.end() ? nullptr : &it->second;
+}
+
+block_key_filter_t *block_key_filters_t::create(block_id_t block_id) {
+    assert_thread();
+    auto it = filters_.find(block_id);
+    if (it != filters_.end()) {
+        it->second = block_key_filter_t();
+        return &it->second;
+    }
+    // The memory limit changes over time, so we may have to drop more than one.
+    const size_t max_filters =
+        evicter_->memory_limit() / max_memory_share / sizeof(block_key_filter_t);
+    if (max_filters == 0) {
+        return nullptr;
+    }
+    size_t dropped = 0;
+    while (filters_.size() >= max_filters) {
+        filters_.erase(filters_.begin());
+        ++dropped;
+    }
+    evicter_->change_side_usage(
+        (1 - static_cast<int64_t>(dropped))
+        * static_cast<int64_t>(sizeof(block_key_filter_t)));
+    return &filters_[block_id];
+}
+
+void block_key_filters_t::forget(block_id_t block_id) {
+    assert_thread();
+    if (filters_.erase(block_id) != 0) {
+        evicter_->change_side_usage(-static_cast<int64_t>(sizeof(block_key_filter_t)));
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef BUFFER_CACHE_KEY_FILTERS_HPP_
+#define BUFFER_CACHE_KEY_FILTERS_HPP_
+
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include "errors.hpp"
+#include "perfmon/perfmon.hpp"
+#include "serializer/types.hpp"
+#include "threading.hpp"
+
+namespace alt { class evicter_t; }
+
+/* A Bloom filter over the keys stored in one block. It never reports a key that was
+added as absent, but may report an absent key as present. */
+class block_key_filter_t {
+public:
+    block_key_filter_t();
+
+    void add(const uint8_t *key, size_t size);
+    bool may_contain(const uint8_t *key, size_t size) const;
+
+private:
+    static const size_t num_bits = 1024;
+    static const int num_hashes = 5;
+
+    uint64_t bits_[num_bits / 64];
+};
+
+/* `block_key_filters_t` keeps a `block_key_filter_t` for some of the blocks in a cache.
+The cache only makes sure that a block doesn't keep a filter when it's created or
+deleted; it's up to the user to keep the filters in sync with the blocks' contents, and
+to only consult them when that's safe. The filters only live in memory. Their memory
+counts towards the cache's memory limit, and they may take up at most a
+`1 / max_memory_share` part of it; when we reach that, an arbitrary filter is dropped to
+make room for a new one. */
+class block_key_filters_t : public home_thread_mixin_debug_only_t {
+public:
+    block_key_filters_t(perfmon_collection_t *perfmon_collection,
+                        alt::evicter_t *evicter);
+    ~block_key_filters_t();
+
+    /* Returns the block's filter, or `nullptr` if it doesn't have one. The pointer is
+    only valid until the caller blocks. */
+    block_key_filter_t *find(block_id_t block_id);
+
+    /* Creates an empty filter for the block, replacing any filter it already had.
+    Returns `nullptr` if the cache's memory limit is too small for any filters. */
+    block_key_filter_t *create(block_id_t block_id);
+
+    void forget(block_id_t block_id);
+
+    /* Lookups that didn't have to read the block because of a filter. */
+    perfmon_counter_t pm_saved_reads;
+    /* Lookups that read the block because of a filter, but didn't find the key. */
+    perfmon_counter_t pm_false_positives;
+
+private:
+    static const uint64_t max_memory_share = 32;
+
+    std::unordered_map<block_id_t, block_key_filter_t> filters_;
+
+    alt::evicter_t *evicter_;
+
+    perfmon_multi_membership_t pm_membership_;
+
+    DISABLE_COPYING(block_key_filters_t);
+};
+
+#endif  // BUFFER_CACHE_KEY_FILTERS_HPP_
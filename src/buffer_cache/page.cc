@@ -1,6 +1,7 @@
 #include "buffer_cache/page.hpp"
 
 #include "arch/runtime/coroutines.hpp"
+#include "arch/runtime/resource_account.hpp"
 #include "buffer_cache/page_cache.hpp"
 #include "serializer/serializer.hpp"
 
@@ -349,6 +350,7 @@ void page_t::load_with_block_id(page_t *page, block_id_t block_id,
     buf_ptr_t buf;
     counted_t<block_token_t> block_token;
 
+    ticks_t start_time = get_ticks();
     {
         serializer_t *const serializer = page_cache->serializer();
         on_thread_t th(serializer->home_thread());
@@ -357,6 +359,7 @@ void page_t::load_with_block_id(page_t *page, block_id_t block_id,
         buf = serializer->block_read(block_token,
                                      account->get());
     }
+    page_cache->miss_latency()->record(ticks_t{get_ticks().nanos - start_time.nanos});
 
     ASSERT_FINITE_CORO_WAITING;
     if (loader.abandon_page()) {
@@ -415,6 +418,17 @@ void page_t::add_waiter(page_acq_t *acq, cache_account_t *account) {
         = acq->page_cache()->evicter().correct_eviction_category(this);
     waiters_.push_front(acq);
     acq->page_cache()->evicter().change_to_correct_eviction_bag(old_bag, this);
+    acq->page_cache()->evicter().note_access(buf_.has());
+    resource_account_t *resource_account = resource_account_t::current();
+    if (resource_account != nullptr) {
+        // A block that's already on its way in from disk still counts as read from
+        // disk, since we have to wait for it.
+        if (buf_.has()) {
+            resource_account->charge_block_from_cache();
+        } else {
+            resource_account->charge_block_from_disk();
+        }
+    }
     if (buf_.has()) {
         acq->buf_ready_signal_.pulse();
     } else if (loader_ != nullptr) {
@@ -446,6 +460,7 @@ void page_t::load_using_block_token(page_t *page, page_cache_t *page_cache,
     rassert(block_token.has());
 
     buf_ptr_t buf;
+    ticks_t start_time = get_ticks();
     {
         serializer_t *const serializer = page_cache->serializer();
 
@@ -453,6 +468,7 @@ void page_t::load_using_block_token(page_t *page, page_cache_t *page_cache,
         buf = serializer->block_read(block_token,
                                      account->get());
     }
+    page_cache->miss_latency()->record(ticks_t{get_ticks().nanos - start_time.nanos});
 
     ASSERT_FINITE_CORO_WAITING;
     if (loader.abandon_page()) {
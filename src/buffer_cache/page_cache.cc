@@ -151,6 +151,65 @@ void page_cache_t::consider_evicting_current_page(block_id_t block_id) {
     }
 }
 
+bool page_cache_t::prefetch_block(block_id_t block_id, cache_account_t *account) {
+    assert_thread();
+    auto page_it = current_pages_.find(block_id);
+    if (page_it == current_pages_.end()) {
+        // Snapshotted readers can still see blocks that have since been deleted.
+        if (recency_for_block_id(block_id) == repli_timestamp_t::invalid) {
+            return false;
+        }
+        page_it = current_pages_.insert(
+            page_it, std::make_pair(block_id, new current_page_t(block_id, this)));
+    }
+
+    current_page_t *current_page = page_it->second;
+    if (current_page->is_deleted()) {
+        return false;
+    }
+    if (!current_page->page_.has()) {
+        current_page->convert_from_serializer_if_necessary(
+            current_page_help_t(block_id, this), account);
+        return true;
+    }
+    page_t *page = current_page->page_.get_page_for_read();
+    if (page->is_loaded() || page->is_loading()) {
+        return false;
+    }
+    // Adding a waiter starts loading the page, and the load runs to completion after
+    // the waiter goes away.  The page is then evictable like any other.
+    page_acq_t acq;
+    acq.init(page, this, account);
+    return true;
+}
+
+const void *page_cache_t::peek_page_for_read(block_id_t block_id) {
+    assert_thread();
+    ASSERT_NO_CORO_WAITING;
+    auto page_it = current_pages_.find(block_id);
+    if (page_it == current_pages_.end()) {
+        return nullptr;
+    }
+    current_page_t *current_page = page_it->second;
+    if (current_page->is_deleted()
+        || !current_page->page_.has()
+        || current_page->has_write_acquirer()) {
+        return nullptr;
+    }
+    page_t *page = current_page->page_.get_page_for_read();
+    if (!page->is_loaded()) {
+        return nullptr;
+    }
+    return page->get_page_buf(this);
+}
+
+bool page_cache_t::block_has_write_acquirer(block_id_t block_id) {
+    assert_thread();
+    auto page_it = current_pages_.find(block_id);
+    return page_it != current_pages_.end()
+        && page_it->second->has_write_acquirer();
+}
+
 block_version_t page_cache_t::gen_block_version() {
     block_version_t ret = next_block_version_;
     next_block_version_ = next_block_version_.subsequent();
@@ -249,6 +308,7 @@ page_cache_t::page_cache_t(serializer_t *_serializer,
       next_block_version_(block_version_t().subsequent()),
       free_list_(_serializer),
       evicter_(),
+      miss_latency_(secs_to_ticks(1)),
       read_ahead_cb_(nullptr),
       drainer_(make_scoped<auto_drainer_t>()) {
 
@@ -810,6 +870,17 @@ void current_page_t::reset(page_cache_t *page_cache) {
     }
 }
 
+bool current_page_t::has_write_acquirer() const {
+    for (current_page_acq_t *acq = acquirers_.head();
+         acq != nullptr;
+         acq = acquirers_.next(acq)) {
+        if (acq->access_ == access_t::write) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool current_page_t::should_be_evicted() const {
     // Consider reasons why the current_page_t should not be evicted.
 
@@ -23,6 +23,7 @@
 #include "containers/backindex_bag.hpp"
 #include "containers/intrusive_list.hpp"
 #include "containers/segmented_vector.hpp"
+#include "perfmon/perfmon.hpp"
 #include "repli_timestamp.hpp"
 #include "serializer/types.hpp"
 #include "time.hpp"
@@ -106,6 +107,9 @@ public:
     bool should_be_evicted() const;
 
 private:
+    // True if some write acquirer holds or is waiting for the page.
+    bool has_write_acquirer() const;
+
     // current_page_acq_t should not access our fields directly.
     friend class current_page_acq_t;
     void add_acquirer(current_page_acq_t *acq);
@@ -480,10 +484,28 @@ public:
     // `current_page_t *` to remain valid.)
     void consider_evicting_current_page(block_id_t block_id);
 
+    // Starts loading the current version of the block into memory, without acquiring
+    // it, so that a later acquisition doesn't have to wait for the disk.  Returns true
+    // if a load was started, false if the block is already in memory (or being
+    // loaded) or has been deleted.
+    bool prefetch_block(block_id_t block_id, cache_account_t *account);
+
+    // Returns the contents of the block's current version if reading them right now
+    // is equivalent to acquiring the block for read: the page must be in memory and
+    // no write acquirer may hold or wait for it.  Returns NULL otherwise.  Doesn't
+    // block, and the pointer stays valid until the caller does.
+    const void *peek_page_for_read(block_id_t block_id);
+
+    // True if some write acquirer holds or is waiting for the block's current page.
+    bool block_has_write_acquirer(block_id_t block_id);
+
     void have_read_ahead_cb_destroyed();
 
     evicter_t &evicter() { return evicter_; }
 
+    // How long it takes to load a block that isn't in memory from the serializer.
+    perfmon_latency_histogram_t *miss_latency() { return &miss_latency_; }
+
     auto_drainer_t::lock_t drainer_lock() { return drainer_->lock(); }
     serializer_t *serializer() { return serializer_; }
 
@@ -642,6 +664,8 @@ private:
 
     evicter_t evicter_;
 
+    perfmon_latency_histogram_t miss_latency_;
+
     // KSI: I bet this read_ahead_cb_ and read_ahead_cb_existence_ type could be
     // packaged in some new cross_thread_ptr type.
     page_read_ahead_cb_t *read_ahead_cb_;
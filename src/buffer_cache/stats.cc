@@ -3,33 +3,82 @@
 
 #include "perfmon/perfmon.hpp"
 
+static optional<double> get_in_use_bytes(const alt::evicter_t &evicter) {
+    return make_optional(static_cast<double>(evicter.in_memory_size()));
+}
+
+static optional<double> get_hits_total(const alt::evicter_t &evicter) {
+    return make_optional(static_cast<double>(evicter.hits_total()));
+}
+
+static optional<double> get_misses_total(const alt::evicter_t &evicter) {
+    return make_optional(static_cast<double>(evicter.misses_total()));
+}
+
+static optional<double> get_recent_hits(const alt::evicter_t &evicter) {
+    return make_optional(
+        static_cast<double>(evicter.working_set_estimator().hits()));
+}
+
+static optional<double> get_recent_misses(const alt::evicter_t &evicter) {
+    return make_optional(
+        static_cast<double>(evicter.working_set_estimator().misses()));
+}
+
+static optional<double> get_bytes_needed_for_95_percent_hits(
+        const alt::evicter_t &evicter) {
+    optional<uint64_t> extra
+        = evicter.working_set_estimator().extra_bytes_for_hit_ratio(0.95);
+    if (!extra.has_value()) {
+        return r_nullopt;
+    }
+    return make_optional(static_cast<double>(evicter.in_memory_size() + *extra));
+}
+
 alt_cache_stats_t::alt_cache_stats_t(alt::page_cache_t *_page_cache,
                                      perfmon_collection_t *parent) :
     page_cache(_page_cache),
     cache_collection(),
     cache_membership(parent, &cache_collection, "cache"),
-    in_use_bytes(this),
+    in_use_bytes(this, &get_in_use_bytes),
     in_use_bytes_membership(&cache_collection,
                             &in_use_bytes, "in_use_bytes"),
+    miss_latency_membership(&cache_collection,
+                            page_cache->miss_latency(), "miss_latency"),
+    hits_total(this, &get_hits_total),
+    hits_total_membership(&cache_collection, &hits_total, "hits_total"),
+    misses_total(this, &get_misses_total),
+    misses_total_membership(&cache_collection, &misses_total, "misses_total"),
+    recent_hits(this, &get_recent_hits),
+    recent_hits_membership(&cache_collection, &recent_hits, "recent_hits"),
+    recent_misses(this, &get_recent_misses),
+    recent_misses_membership(&cache_collection, &recent_misses, "recent_misses"),
+    bytes_needed_for_95_percent_hits(this, &get_bytes_needed_for_95_percent_hits),
+    bytes_needed_for_95_percent_hits_membership(&cache_collection,
+        &bytes_needed_for_95_percent_hits, "bytes_needed_for_95_percent_hits"),
     cache_collection_membership(&cache_collection) { }
 
-alt_cache_stats_t::perfmon_value_t::perfmon_value_t(alt_cache_stats_t *_parent) :
-    parent(_parent) { }
+alt_cache_stats_t::perfmon_value_t::perfmon_value_t(
+        alt_cache_stats_t *_parent,
+        std::function<optional<double>(const alt::evicter_t &)> _getter) :
+    parent(_parent), getter(std::move(_getter)) { }
 
 void *alt_cache_stats_t::perfmon_value_t::begin_stats() {
-    return new uint64_t;
+    return new optional<double>(0.0);
 }
 
 void alt_cache_stats_t::perfmon_value_t::visit_stats(void *ptr) {
     if (get_thread_id() == parent->home_thread()) {
-        uint64_t *value = reinterpret_cast<uint64_t *>(ptr);
-        *value = parent->page_cache->evicter().in_memory_size();
+        optional<double> *value = reinterpret_cast<optional<double> *>(ptr);
+        *value = getter(parent->page_cache->evicter());
     }
 }
 
 ql::datum_t alt_cache_stats_t::perfmon_value_t::end_stats(void *ptr) {
-    uint64_t *value = reinterpret_cast<uint64_t *>(ptr);
-    ql::datum_t res(static_cast<double>(*value));
+    optional<double> *value = reinterpret_cast<optional<double> *>(ptr);
+    ql::datum_t res = value->has_value()
+        ? ql::datum_t(**value)
+        : ql::datum_t::null();
     delete value;
     return res;
 }
@@ -2,6 +2,8 @@
 #ifndef BUFFER_CACHE_STATS_HPP_
 #define BUFFER_CACHE_STATS_HPP_
 
+#include <functional>
+
 #include "perfmon/perfmon.hpp"
 #include "buffer_cache/page_cache.hpp"
 
@@ -15,19 +17,36 @@ public:
     perfmon_collection_t cache_collection;
     perfmon_membership_t cache_membership;
 
+    // Reports a value that the evicter computes on the cache's home thread. The
+    // value is `null` if the getter returns `r_nullopt`.
     class perfmon_value_t : public perfmon_t {
     public:
-        explicit perfmon_value_t(alt_cache_stats_t *_parent);
+        perfmon_value_t(alt_cache_stats_t *_parent,
+                        std::function<optional<double>(const alt::evicter_t &)> _getter);
         void *begin_stats();
         void visit_stats(void *);
         ql::datum_t end_stats(void *);
     private:
         alt_cache_stats_t *parent;
+        std::function<optional<double>(const alt::evicter_t &)> getter;
         DISABLE_COPYING(perfmon_value_t);
     };
     perfmon_value_t in_use_bytes;
     perfmon_membership_t in_use_bytes_membership;
-
+    perfmon_membership_t miss_latency_membership;
+
+    perfmon_value_t hits_total;
+    perfmon_membership_t hits_total_membership;
+    perfmon_value_t misses_total;
+    perfmon_membership_t misses_total_membership;
+    // Hits and misses with the same decay as the working set estimate, so the hit
+    // ratio can be computed across shards.
+    perfmon_value_t recent_hits;
+    perfmon_membership_t recent_hits_membership;
+    perfmon_value_t recent_misses;
+    perfmon_membership_t recent_misses_membership;
+    perfmon_value_t bytes_needed_for_95_percent_hits;
+    perfmon_membership_t bytes_needed_for_95_percent_hits_membership;
 
     perfmon_multi_membership_t cache_collection_membership;
 };
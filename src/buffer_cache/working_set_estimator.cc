@@ -0,0 +1,140 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "buffer_cache/working_set_estimator.hpp"
+
+#include <algorithm>
+
+#include "config/args.hpp"
+
+namespace alt {
+
+// Bucket `i` holds reuse distances below `bucket_base_bytes << (i + 1)`.
+static const uint64_t bucket_base_bytes = 4 * KILOBYTE;
+
+working_set_estimator_t::reuse_histogram_t::reuse_histogram_t() {
+    std::fill(buckets, buckets + num_buckets, 0);
+}
+
+double working_set_estimator_t::reuse_histogram_t::fraction_within(
+        uint64_t extra_bytes) const {
+    uint64_t total = 0;
+    uint64_t within = 0;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        total += buckets[i];
+        if ((bucket_base_bytes << (i + 1)) <= extra_bytes) {
+            within += buckets[i];
+        }
+    }
+    return total == 0 ? 0.0 : static_cast<double>(within) / total;
+}
+
+working_set_estimator_t::working_set_estimator_t()
+    : ghost_capacity_(0),
+      evicted_bytes_(0),
+      hits_(0),
+      misses_(0) { }
+
+void working_set_estimator_t::set_ghost_capacity(size_t ghost_capacity) {
+    ghost_capacity_ = ghost_capacity;
+    trim_ghosts();
+}
+
+void working_set_estimator_t::trim_ghosts() {
+    while (!ghost_order_.empty()) {
+        auto it = ghosts_.find(ghost_order_.front().first);
+        bool stale = it == ghosts_.end() || it->second != ghost_order_.front().second;
+        if (!stale && ghosts_.size() <= ghost_capacity_) {
+            break;
+        }
+        if (!stale) {
+            ghosts_.erase(it);
+        }
+        ghost_order_.pop_front();
+    }
+}
+
+void working_set_estimator_t::note_access(bool hit) {
+    if (hit) {
+        ++hits_;
+    } else {
+        ++misses_;
+    }
+    if (hits_ + misses_ >= decay_access_count) {
+        decay();
+    }
+}
+
+void working_set_estimator_t::note_evicted(block_id_t block_id, uint64_t bytes) {
+    if (ghost_capacity_ == 0) {
+        return;
+    }
+    ghosts_[block_id] = evicted_bytes_;
+    ghost_order_.push_back(std::make_pair(block_id, evicted_bytes_));
+    evicted_bytes_ += bytes;
+    trim_ghosts();
+}
+
+bool working_set_estimator_t::note_loaded(block_id_t block_id, uint64_t bytes) {
+    auto it = ghosts_.find(block_id);
+    if (it == ghosts_.end()) {
+        return false;
+    }
+    // The block itself has to fit, too.
+    uint64_t reuse_distance = evicted_bytes_ - it->second + bytes;
+    ghosts_.erase(it);
+    ++reuse_histogram_.buckets[bucket_for(reuse_distance)];
+
+    if (ghost_order_.size() > 2 * ghosts_.size()) {
+        std::deque<std::pair<block_id_t, uint64_t> > live;
+        for (const auto &ghost : ghost_order_) {
+            auto jt = ghosts_.find(ghost.first);
+            if (jt != ghosts_.end() && jt->second == ghost.second) {
+                live.push_back(ghost);
+            }
+        }
+        ghost_order_.swap(live);
+    }
+    return true;
+}
+
+optional<double> working_set_estimator_t::hit_ratio() const {
+    if (hits_ + misses_ == 0) {
+        return r_nullopt;
+    }
+    return make_optional(static_cast<double>(hits_) / (hits_ + misses_));
+}
+
+optional<uint64_t> working_set_estimator_t::extra_bytes_for_hit_ratio(
+        double target_hit_ratio) const {
+    double allowed_misses = (1.0 - target_hit_ratio) * (hits_ + misses_);
+    double remaining_misses = misses_;
+    if (remaining_misses <= allowed_misses) {
+        return make_optional<uint64_t>(0);
+    }
+    for (size_t i = 0; i < num_buckets; ++i) {
+        remaining_misses -= reuse_histogram_.buckets[i];
+        if (remaining_misses <= allowed_misses) {
+            return make_optional(bucket_base_bytes << (i + 1));
+        }
+    }
+    return r_nullopt;
+}
+
+size_t working_set_estimator_t::bucket_for(uint64_t reuse_distance) {
+    size_t bucket = 0;
+    uint64_t limit = bucket_base_bytes << 1;
+    while (reuse_distance >= limit && bucket + 1 < num_buckets) {
+        ++bucket;
+        limit <<= 1;
+    }
+    return bucket;
+}
+
+void working_set_estimator_t::decay() {
+    hits_ /= 2;
+    misses_ /= 2;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        reuse_histogram_.buckets[i] /= 2;
+    }
+}
+
+}  // namespace alt
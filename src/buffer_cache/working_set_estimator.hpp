@@ -0,0 +1,104 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef BUFFER_CACHE_WORKING_SET_ESTIMATOR_HPP_
+#define BUFFER_CACHE_WORKING_SET_ESTIMATOR_HPP_
+
+#include <stdint.h>
+
+#include <deque>
+#include <unordered_map>
+#include <utility>
+
+#include "containers/optional.hpp"
+#include "errors.hpp"
+#include "serializer/types.hpp"
+
+namespace alt {
+
+/* `working_set_estimator_t` estimates how a cache's hit ratio would change if it had
+more memory, i.e. the part of its miss ratio curve above its current size.
+
+It keeps a "ghost list" of recently evicted block ids, together with how many bytes
+had been evicted when each block was evicted. When an evicted block gets loaded
+again, the bytes evicted since then are the extra memory the cache would have needed
+to keep it, so the miss would have been a hit with that much more memory. Misses on
+blocks that aren't on the ghost list are cold misses (or have a reuse distance larger
+than the ghost list covers), which more memory wouldn't have avoided.
+
+All of the counts decay by half every `decay_access_count` accesses, so the estimate
+follows changes in the workload. The estimator isn't thread safe; it belongs to an
+`evicter_t` and is only used on its thread. */
+class working_set_estimator_t {
+public:
+    // Reuse distances are put into power-of-two buckets, starting at 4 KB.
+    static const size_t num_buckets = 32;
+    static const uint64_t decay_access_count = 1 << 16;
+
+    // How many of the recent misses had reuse distances in each bucket. This is the
+    // part of the miss ratio curve that the ghost list covers.
+    struct reuse_histogram_t {
+        reuse_histogram_t();
+
+        // Returns the fraction of the misses in the histogram that `extra_bytes` more
+        // memory would certainly have avoided, or 0 if the histogram is empty.
+        double fraction_within(uint64_t extra_bytes) const;
+
+        uint64_t buckets[num_buckets];
+    };
+
+    working_set_estimator_t();
+
+    // Sets how many evicted blocks to remember. This bounds the reuse distances that
+    // the estimator can see.
+    void set_ghost_capacity(size_t ghost_capacity);
+
+    // Records an access to a block, and whether it was already in memory.
+    void note_access(bool hit);
+
+    // Records that a block of `bytes` bytes was evicted.
+    void note_evicted(block_id_t block_id, uint64_t bytes);
+
+    // Records that a block of `bytes` bytes is being loaded from disk. Returns true
+    // if the load would have been avoided with more memory.
+    bool note_loaded(block_id_t block_id, uint64_t bytes);
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+    // Returns the fraction of recent accesses that were hits, or `r_nullopt` if there
+    // haven't been any.
+    optional<double> hit_ratio() const;
+
+    // Returns how many bytes the cache would need in addition to its current size to
+    // reach `target_hit_ratio`, or `r_nullopt` if the ghost list doesn't show any
+    // size at which it would.
+    optional<uint64_t> extra_bytes_for_hit_ratio(double target_hit_ratio) const;
+
+    const reuse_histogram_t &reuse_histogram() const { return reuse_histogram_; }
+
+private:
+    static size_t bucket_for(uint64_t reuse_distance);
+    // Forgets the oldest ghosts until there are at most `ghost_capacity_` of them.
+    void trim_ghosts();
+    void decay();
+
+    size_t ghost_capacity_;
+    // How many bytes have ever been evicted. A ghost's reuse distance is measured
+    // against this.
+    uint64_t evicted_bytes_;
+    // Maps evicted block ids to the value of `evicted_bytes_` when they were evicted.
+    std::unordered_map<block_id_t, uint64_t> ghosts_;
+    // The ghosts in eviction order, so we can forget the oldest ones. Ghosts that have
+    // been loaded again leave stale entries here, which no longer match the map. They
+    // are dropped once they make up half of the deque.
+    std::deque<std::pair<block_id_t, uint64_t> > ghost_order_;
+
+    uint64_t hits_;
+    uint64_t misses_;
+    reuse_histogram_t reuse_histogram_;
+
+    DISABLE_COPYING(working_set_estimator_t);
+};
+
+}  // namespace alt
+
+#endif  // BUFFER_CACHE_WORKING_SET_ESTIMATOR_HPP_
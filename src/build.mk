@@ -217,7 +217,7 @@ RT_CXXFLAGS += -I$(PROTO_DIR)
 
 SOURCES := $(shell find $(TOP)/src -name '*.cc' -not -name '\.*')
 
-SERVER_EXEC_SOURCES := $(filter-out $(TOP)/src/unittest/%,$(SOURCES))
+SERVER_EXEC_SOURCES := $(filter-out $(TOP)/src/unittest/% $(TOP)/src/bench/%,$(SOURCES))
 
 QL2_PROTO_NAMES := rdb_protocol/ql2
 QL2_PROTO_SOURCES := $(foreach _,$(QL2_PROTO_NAMES),$(TOP)/src/$_.proto)
@@ -243,7 +243,12 @@ SERVER_EXEC_OBJS := $(QL2_PROTO_OBJS) $(patsubst $(TOP)/src/%.cc,$(OBJ_DIR)/%.o,
 
 SERVER_NOMAIN_OBJS := $(QL2_PROTO_OBJS) $(patsubst $(TOP)/src/%.cc,$(OBJ_DIR)/%.o,$(filter-out %/main.cc,$(SOURCES)))
 
-SERVER_UNIT_TEST_OBJS := $(SERVER_NOMAIN_OBJS) $(OBJ_DIR)/unittest/main.o
+SERVER_UNIT_TEST_OBJS := $(filter-out $(OBJ_DIR)/bench/%,$(SERVER_NOMAIN_OBJS)) $(OBJ_DIR)/unittest/main.o
+
+# The benchmarks use some of the unit tests' helpers, such as the mock file, but none
+# of the tests themselves.
+SERVER_BENCH_UNITTEST_OBJS := $(patsubst %,$(OBJ_DIR)/unittest/%.o,unittest_utils mock_file)
+SERVER_BENCH_OBJS := $(filter-out $(OBJ_DIR)/unittest/%,$(SERVER_NOMAIN_OBJS)) $(SERVER_BENCH_UNITTEST_OBJS) $(OBJ_DIR)/bench/main.o
 
 ##### Version number handling
 
@@ -257,7 +262,7 @@ ALL += $(TOP)/src
 $(TOP)/src/all: $(BUILD_DIR)/$(SERVER_EXEC_NAME) $(BUILD_DIR)/$(GDB_FUNCTIONS_NAME) | $(BUILD_DIR)/.
 
 ifeq ($(UNIT_TESTS),1)
-  $(TOP)/src/all: $(BUILD_DIR)/$(SERVER_UNIT_TEST_NAME)
+  $(TOP)/src/all: $(BUILD_DIR)/$(SERVER_UNIT_TEST_NAME) $(BUILD_DIR)/$(SERVER_BENCH_NAME)
 endif
 
 .PRECIOUS: $(PROTO_DIR)/. $(QL2_PROTO_HEADERS) $(QL2_PROTO_CODE)
@@ -321,14 +326,25 @@ endif
 
 # The unittests use gtest, which uses macros that expand into switch statements which don't contain
 # default cases. So we have to remove the -Wswitch-default argument for them.
-$(SERVER_UNIT_TEST_OBJS): RT_CXXFLAGS := $(filter-out -Wswitch-default,$(RT_CXXFLAGS)) $(GTEST_INCLUDE)
+$(sort $(SERVER_UNIT_TEST_OBJS) $(SERVER_BENCH_OBJS)): RT_CXXFLAGS := $(filter-out -Wswitch-default,$(RT_CXXFLAGS)) $(GTEST_INCLUDE)
 
-$(SERVER_UNIT_TEST_OBJS): | $(GTEST_INCLUDE_DEP)
+$(sort $(SERVER_UNIT_TEST_OBJS) $(SERVER_BENCH_OBJS)): | $(GTEST_INCLUDE_DEP)
 
 $(BUILD_DIR)/$(SERVER_UNIT_TEST_NAME): $(SERVER_UNIT_TEST_OBJS) $(GTEST_LIBS_DEP) | $(BUILD_DIR)/. $(RETHINKDB_DEPENDENCIES_LIBS)
 	$P LD $@
 	$(RT_CXX) $(SERVER_UNIT_TEST_OBJS) $(RT_LDFLAGS) $(GTEST_LIBS) -o $@ $(LD_OUTPUT_FILTER)
 
+$(BUILD_DIR)/$(SERVER_BENCH_NAME): $(SERVER_BENCH_OBJS) $(GTEST_LIBS_DEP) | $(BUILD_DIR)/. $(RETHINKDB_DEPENDENCIES_LIBS)
+	$P LD $@
+	$(RT_CXX) $(SERVER_BENCH_OBJS) $(RT_LDFLAGS) $(GTEST_LIBS) -o $@ $(LD_OUTPUT_FILTER)
+
+# Runs the microbenchmarks and writes the results to bench.json in the build
+# directory. Pass e.g. BENCH_FLAGS="--filter BTree" to run only some of them.
+.PHONY: bench
+bench: $(BUILD_DIR)/$(SERVER_BENCH_NAME)
+	$P RUN $<
+	$< --json $(BUILD_DIR)/bench.json $(BENCH_FLAGS)
+
 $(BUILD_DIR)/$(GDB_FUNCTIONS_NAME): | $(BUILD_DIR)/.
 	$P CP $@
 	cp $(TOP)/scripts/$(GDB_FUNCTIONS_NAME) $@
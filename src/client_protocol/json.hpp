@@ -33,6 +33,12 @@ public:
     static void write_response_to_buffer(ql::response_t *response,
                                          rapidjson::StringBuffer *buffer_out);
 
+    // Writes the whole message for a response, including the token and the size, so
+    // that it can be built on one thread and sent on another.
+    static void write_response_message(ql::response_t *response,
+                                       int64_t token,
+                                       rapidjson::StringBuffer *buffer_out);
+
     static void send_response(ql::response_t *response,
                               int64_t token,
                               tcp_conn_t *conn,
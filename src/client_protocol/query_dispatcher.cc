@@ -0,0 +1,31 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "client_protocol/query_dispatcher.hpp"
+
+#include "concurrency/pmap.hpp"
+
+query_dispatcher_t::query_dispatcher_t(rdb_context_t *_rdb_ctx,
+                                       const ql::query_cache_t &home_cache)
+    : rdb_ctx(_rdb_ctx),
+      client_addr_port(home_cache.get_client_addr_port()),
+      return_empty_normal_batches(home_cache.get_return_empty_normal_batches()),
+      user_context(home_cache.get_user_context()),
+      caches(get_num_threads()) { }
+
+query_dispatcher_t::~query_dispatcher_t() {
+    assert_thread();
+    pmap(caches.size(), [&](int64_t thread) {
+        if (caches[thread].has()) {
+            on_thread_t thread_switcher((threadnum_t(thread)));
+            caches[thread].reset();
+        }
+    });
+}
+
+ql::query_cache_t *query_dispatcher_t::get_cache(threadnum_t thread) {
+    rassert(get_thread_id() == thread);
+    if (!caches[thread.threadnum].has()) {
+        caches[thread.threadnum].init(new ql::query_cache_t(
+            rdb_ctx, client_addr_port, return_empty_normal_batches, user_context));
+    }
+    return caches[thread.threadnum].get();
+}
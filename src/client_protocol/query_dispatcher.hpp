@@ -0,0 +1,121 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef CLIENT_PROTOCOL_QUERY_DISPATCHER_HPP_
+#define CLIENT_PROTOCOL_QUERY_DISPATCHER_HPP_
+
+#include <exception>
+#include <map>
+#include <utility>
+
+#include "client_protocol/server.hpp"
+#include "concurrency/cross_thread_signal.hpp"
+#include "containers/scoped.hpp"
+#include "rapidjson/stringbuffer.h"
+#include "rdb_protocol/query_cache.hpp"
+#include "rdb_protocol/query_params.hpp"
+#include "rdb_protocol/response.hpp"
+#include "threading.hpp"
+
+/* Lets the queries of one connection run on other threads than the connection's own, so
+that a client that sends many queries over one connection can use more than one core.
+
+A query that runs on another thread gets a new `query_params_t` there, in a
+`query_cache_t` that we create on that thread for the connection. Its cursor stays on
+that thread, so later queries with the same token are sent there, too. The original
+`query_params_t` stays on the connection's thread until the query is done, which keeps
+its id outstanding in the connection's query cache, so NOREPLY_WAIT can still be
+answered there. */
+class query_dispatcher_t : public home_thread_mixin_t {
+public:
+    query_dispatcher_t(rdb_context_t *_rdb_ctx, const ql::query_cache_t &home_cache);
+    ~query_dispatcher_t();
+
+    /* Picks the thread to run `query` on. A new query only moves to `pick_thread()` if
+    the connection has other queries running, since a lone query is better off without
+    the trip to another thread. */
+    template <class pick_thread_t>
+    threadnum_t route(const ql::query_params_t &query,
+                      bool others_running,
+                      const pick_thread_t &pick_thread) {
+        assert_thread();
+        if (query.type != Query::START
+                && query.type != Query::CONTINUE
+                && query.type != Query::STOP) {
+            return home_thread();
+        }
+        auto it = tokens.find(query.token);
+        if (it != tokens.end()) {
+            return it->second;
+        }
+        if (query.type != Query::START || !others_running) {
+            return home_thread();
+        }
+        threadnum_t thread = pick_thread();
+        if (thread != home_thread()) {
+            tokens.insert(std::make_pair(query.token, thread));
+        }
+        return thread;
+    }
+
+    /* Runs `query` on `thread`, which `route()` returned, and writes the message with
+    its response into `message_out` unless it's a noreply query. */
+    template <class protocol_t>
+    void run(query_handler_t *handler,
+             threadnum_t thread,
+             ql::query_params_t *query,
+             rapidjson::StringBuffer *message_out,
+             signal_t *interruptor) {
+        assert_thread();
+        guarantee(thread != home_thread());
+        const int64_t token = query->token;
+        query->maybe_release_query_id();
+        scoped_ptr_t<ql::term_storage_t> term_storage = std::move(query->term_storage);
+
+        bool still_cached = false;
+        std::exception_ptr exc;
+        cross_thread_signal_t ct_interruptor(interruptor, thread);
+        {
+            on_thread_t thread_switcher(thread);
+            // We mustn't switch threads while an exception is in flight.
+            try {
+                ql::query_cache_t *cache = get_cache(thread);
+                ql::query_params_t remote_query(token, cache, std::move(term_storage));
+                ql::response_t response;
+                handler->run_query(&remote_query, &response, &ct_interruptor);
+                if (!remote_query.noreply) {
+                    protocol_t::write_response_message(&response, token, message_out);
+                }
+                still_cached = cache->contains(token);
+            } catch (...) {
+                exc = std::current_exception();
+                still_cached = caches[thread.threadnum].has()
+                    && caches[thread.threadnum]->contains(token);
+            }
+        }
+
+        if (!still_cached) {
+            tokens.erase(token);
+        }
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
+    }
+
+private:
+    ql::query_cache_t *get_cache(threadnum_t thread);
+
+    rdb_context_t *const rdb_ctx;
+    const ip_and_port_t client_addr_port;
+    const ql::return_empty_normal_batches_t return_empty_normal_batches;
+    const auth::user_context_t user_context;
+
+    // The tokens of the queries and cursors on other threads. Only touched on the
+    // connection's thread.
+    std::map<int64_t, threadnum_t> tokens;
+
+    // Indexed by thread. Each one is only touched on its own thread.
+    scoped_array_t<scoped_ptr_t<ql::query_cache_t> > caches;
+
+    DISABLE_COPYING(query_dispatcher_t);
+};
+
+#endif  // CLIENT_PROTOCOL_QUERY_DISPATCHER_HPP_
@@ -20,6 +20,7 @@
 #include "arch/io/network.hpp"
 #include "client_protocol/client_server_error.hpp"
 #include "client_protocol/protocols.hpp"
+#include "client_protocol/query_dispatcher.hpp"
 #include "clustering/administration/auth/authentication_error.hpp"
 #include "clustering/administration/auth/plaintext_authenticator.hpp"
 #include "clustering/administration/auth/scram_authenticator.hpp"
@@ -27,6 +28,7 @@
 #include "clustering/administration/metadata.hpp"
 #include "concurrency/coro_pool.hpp"
 #include "concurrency/cross_thread_signal.hpp"
+#include "concurrency/pmap.hpp"
 #include "concurrency/queue/limited_fifo.hpp"
 #include "crypto/error.hpp"
 #include "perfmon/perfmon.hpp"
@@ -39,6 +41,7 @@
 #include "time.hpp"
 
 #include "rdb_protocol/ql2proto.hpp"
+#include "rdb_protocol/query_params.hpp"
 #include "rdb_protocol/query_server.hpp"
 #include "rdb_protocol/query_cache.hpp"
 #include "rdb_protocol/response.hpp"
@@ -190,19 +193,25 @@ size_t http_conn_cache_t::sha_hasher_t::operator()(const conn_key_t &x) const {
 query_server_t::query_server_t(rdb_context_t *_rdb_ctx,
                                const std::set<ip_address_t> &local_addresses,
                                int port,
+                               bool reuse_port,
+                               bool _spread_queries,
                                query_handler_t *_handler,
                                uint32_t http_timeout_sec,
                                tls_ctx_t *_tls_ctx) :
         tls_ctx(_tls_ctx),
         rdb_ctx(_rdb_ctx),
         handler(_handler),
-        http_conn_cache(http_timeout_sec),
-        next_thread(0) {
+        spread_queries(_spread_queries),
+        thread_conn_counts(get_num_db_threads()),
+        next_thread(0),
+        http_conn_cache(http_timeout_sec) {
     rassert(rdb_ctx != nullptr);
+    for (size_t i = 0; i < thread_conn_counts.size(); ++i) {
+        thread_conn_counts[i].value.store(0);
+    }
     try {
-        tcp_listener.init(new tcp_listener_t(local_addresses, port,
-            std::bind(&query_server_t::handle_conn,
-                      this, ph::_1, auto_drainer_t::lock_t(&drainer))));
+        tcp_listener.init(new sharded_tcp_listener_t(local_addresses, port, reuse_port,
+            std::bind(&query_server_t::handle_conn, this, ph::_1)));
     } catch (const address_in_use_exc_t &ex) {
         throw address_in_use_exc_t(
             strprintf("Could not bind to RDB protocol port: %s", ex.what()));
@@ -250,10 +259,52 @@ ql::datum_t read_datum(tcp_conn_t *connection, signal_t *interruptor) {
     }
 }
 
-void query_server_t::handle_conn(const scoped_ptr_t<tcp_conn_descriptor_t> &nconn,
-                                 auto_drainer_t::lock_t keepalive) {
-    threadnum_t chosen_thread = threadnum_t(next_thread);
-    next_thread = (next_thread + 1) % get_num_db_threads();
+/* Counts a driver connection towards its thread's total for as long as it's open. */
+class conn_count_sentry_t {
+public:
+    explicit conn_count_sentry_t(std::atomic<int64_t> *count) : count_(count) {
+        count_->fetch_add(1, std::memory_order_relaxed);
+    }
+    ~conn_count_sentry_t() {
+        count_->fetch_sub(1, std::memory_order_relaxed);
+    }
+private:
+    std::atomic<int64_t> *const count_;
+    DISABLE_COPYING(conn_count_sentry_t);
+};
+
+threadnum_t query_server_t::choose_thread() {
+    // The runnable counts are averages rounded to whole coroutines, so most threads
+    // are tied when the server is quiet, and the connection counts decide. We start
+    // looking at a different thread every time to spread the remaining ties around.
+    const int num_threads = thread_conn_counts.size();
+    const int start = next_thread.fetch_add(1, std::memory_order_relaxed) % num_threads;
+    int best = start;
+    size_t best_runnable = get_runnable_count(threadnum_t(best));
+    int64_t best_conns = thread_conn_counts[best].value.load(std::memory_order_relaxed);
+    for (int i = 1; i < num_threads; ++i) {
+        const int thread = (start + i) % num_threads;
+        const size_t runnable = get_runnable_count(threadnum_t(thread));
+        const int64_t conns =
+            thread_conn_counts[thread].value.load(std::memory_order_relaxed);
+        if (runnable < best_runnable
+                || (runnable == best_runnable && conns < best_conns)) {
+            best = thread;
+            best_runnable = runnable;
+            best_conns = conns;
+        }
+    }
+    return threadnum_t(best);
+}
+
+void query_server_t::handle_conn(const scoped_ptr_t<tcp_conn_descriptor_t> &nconn) {
+    // We haven't blocked since the listener called us, so the listener for this thread
+    // still exists, and hence so does our drainer for this thread.
+    auto_drainer_t::lock_t keepalive(conn_drainers.get());
+
+    threadnum_t chosen_thread = choose_thread();
+    conn_count_sentry_t conn_count_sentry(
+        &thread_conn_counts[chosen_thread.threadnum].value);
 
     cross_thread_signal_t ct_keepalive(keepalive.get_drain_signal(), chosen_thread);
     on_thread_t rethreader(chosen_thread);
@@ -579,6 +630,8 @@ void query_server_t::connection_loop(tcp_conn_t *conn,
 #endif  // __linux
 
     new_semaphore_t sem(max_concurrent_queries);
+    query_dispatcher_t dispatcher(rdb_ctx, *query_cache);
+    size_t queries_running = 0;
     auto_drainer_t coro_drainer;
     while (!err) {
         scoped_ptr_t<ql::query_params_t> outer_query =
@@ -597,15 +650,32 @@ void query_server_t::connection_loop(tcp_conn_t *conn,
                 ql::response_t response;
                 bool replied = false;
 
+                threadnum_t thread = !spread_queries ? get_thread_id()
+                    : dispatcher.route(*query, queries_running > 0,
+                                       [this]() { return choose_thread(); });
+                ++queries_running;
                 save_exception(&err, &err_str, &abort, [&]() {
-                    handler->run_query(query.get(), &response, &cb_interruptor);
-                    if (!query->noreply) {
-                        new_mutex_acq_t send_lock(&send_mutex, &cb_interruptor);
-                        protocol_t::send_response(&response, query->token,
-                                                  conn, &cb_interruptor);
-                        replied = true;
+                    if (thread == get_thread_id()) {
+                        handler->run_query(query.get(), &response, &cb_interruptor);
+                        if (!query->noreply) {
+                            new_mutex_acq_t send_lock(&send_mutex, &cb_interruptor);
+                            protocol_t::send_response(&response, query->token,
+                                                      conn, &cb_interruptor);
+                            replied = true;
+                        }
+                    } else {
+                        rapidjson::StringBuffer message;
+                        dispatcher.run<protocol_t>(
+                            handler, thread, query.get(), &message, &cb_interruptor);
+                        if (!query->noreply) {
+                            new_mutex_acq_t send_lock(&send_mutex, &cb_interruptor);
+                            conn->write(message.GetString(), message.GetSize(),
+                                        &cb_interruptor);
+                            replied = true;
+                        }
                     }
                 });
+                --queries_running;
                 save_exception(&err, &err_str, &abort, [&]() {
                     if (!replied && !query->noreply) {
                         make_error_response(drain_signal->is_pulsed(), *conn,
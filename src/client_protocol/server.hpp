@@ -2,6 +2,7 @@
 #ifndef CLIENT_PROTOCOL_SERVER_HPP_
 #define CLIENT_PROTOCOL_SERVER_HPP_
 
+#include <atomic>
 #include <set>
 #include <map>
 #include <memory>
@@ -15,7 +16,9 @@
 #include "arch/runtime/runtime.hpp"
 #include "arch/timing.hpp"
 #include "concurrency/auto_drainer.hpp"
+#include "concurrency/cache_line_padded.hpp"
 #include "concurrency/cross_thread_signal.hpp"
+#include "concurrency/one_per_thread.hpp"
 #include "containers/archive/archive.hpp"
 #include "containers/counted.hpp"
 #include "http/http.hpp"
@@ -101,6 +104,8 @@ public:
         rdb_context_t *rdb_ctx,
         const std::set<ip_address_t> &local_addresses,
         int port,
+        bool reuse_port,
+        bool _spread_queries,
         query_handler_t *_handler,
         uint32_t http_timeout_sec,
         tls_ctx_t* tls_ctx);
@@ -114,9 +119,13 @@ private:
                              const std::string &err,
                              ql::response_t *response_out);
 
-    // For the client driver socket
-    void handle_conn(const scoped_ptr_t<tcp_conn_descriptor_t> &nconn,
-                     auto_drainer_t::lock_t);
+    // For the client driver socket. Called on whichever thread accepted the connection.
+    void handle_conn(const scoped_ptr_t<tcp_conn_descriptor_t> &nconn);
+
+    // Picks the thread to run a new driver connection on: the one that has recently
+    // had the fewest coroutines ready to run, or if there's a tie, the fewest driver
+    // connections.
+    threadnum_t choose_thread();
 
     // This is templatized based on the wire protocol requested by the client
     template<class protocol_t>
@@ -133,13 +142,22 @@ private:
     tls_ctx_t *tls_ctx;
     rdb_context_t *const rdb_ctx;
     query_handler_t *const handler;
+    /* If false, every query runs on its connection's thread instead of going through
+    `query_dispatcher_t`. */
+    const bool spread_queries;
+
+    /* The number of driver connections on each thread, for `choose_thread()`. These
+    must outlive the connections. */
+    scoped_array_t<cache_line_padded_t<std::atomic<int64_t> > > thread_conn_counts;
+    std::atomic<int> next_thread;
 
     /* WARNING: The order here is fragile. */
     auto_drainer_t drainer;
+    /* Driver connections hold a lock on the drainer for the thread that accepted them,
+    since with `reuse_port` that can be any thread. */
+    one_per_thread_t<auto_drainer_t> conn_drainers;
     http_conn_cache_t http_conn_cache;
-    scoped_ptr_t<tcp_listener_t> tcp_listener;
-
-    int next_thread;
+    scoped_ptr_t<sharded_tcp_listener_t> tcp_listener;
 };
 
 #endif /* CLIENT_PROTOCOL_SERVER_HPP_ */
@@ -842,6 +842,26 @@ artificial_reql_cluster_backends_t::artificial_reql_cluster_backends_t(
         name_string_t::guarantee_valid("_debug_stats"),
         std::make_pair(debug_stats_backend.get(), debug_stats_backend.get()));
 
+    debug_coro_profiler_backend.init(
+        new debug_coro_profiler_artificial_table_backend_t(
+            rdb_context,
+            name_resolver));
+    debug_coro_profiler_sentry = backend_sentry_t(
+        artificial_reql_cluster_interface->get_table_backends_map_mutable(),
+        name_string_t::guarantee_valid("_debug_coro_profiler"),
+        std::make_pair(debug_coro_profiler_backend.get(),
+                       debug_coro_profiler_backend.get()));
+
+    debug_slow_queries_backend.init(
+        new debug_slow_queries_artificial_table_backend_t(
+            rdb_context,
+            name_resolver));
+    debug_slow_queries_sentry = backend_sentry_t(
+        artificial_reql_cluster_interface->get_table_backends_map_mutable(),
+        name_string_t::guarantee_valid("_debug_slow_queries"),
+        std::make_pair(debug_slow_queries_backend.get(),
+                       debug_slow_queries_backend.get()));
+
     debug_table_status_backend.init(
         new debug_table_status_artificial_table_backend_t(
             rdb_context,
@@ -7,6 +7,8 @@
 #include <string>
 
 #include "clustering/administration/cluster_config.hpp"
+#include "clustering/administration/debug_coro_profiler.hpp"
+#include "clustering/administration/debug_slow_queries.hpp"
 #include "clustering/administration/metadata.hpp"
 #include "clustering/administration/servers/server_config.hpp"
 #include "clustering/administration/servers/server_status.hpp"
@@ -345,6 +347,14 @@ private:
     scoped_ptr_t<debug_stats_artificial_table_backend_t> debug_stats_backend;
     backend_sentry_t debug_stats_sentry;
 
+    scoped_ptr_t<debug_coro_profiler_artificial_table_backend_t>
+        debug_coro_profiler_backend;
+    backend_sentry_t debug_coro_profiler_sentry;
+
+    scoped_ptr_t<debug_slow_queries_artificial_table_backend_t>
+        debug_slow_queries_backend;
+    backend_sentry_t debug_slow_queries_sentry;
+
     scoped_ptr_t<debug_table_status_artificial_table_backend_t>
         debug_table_status_backend;
     backend_sentry_t debug_table_status_sentry;
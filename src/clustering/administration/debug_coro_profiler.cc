@@ -0,0 +1,185 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "clustering/administration/debug_coro_profiler.hpp"
+
+#include "clustering/administration/admin_op_exc.hpp"
+#include "clustering/administration/datum_adapter.hpp"
+
+/* How many functions we report per thread. */
+static const size_t max_report_entries = 30;
+
+debug_coro_profiler_artificial_table_backend_t::
+        debug_coro_profiler_artificial_table_backend_t(
+            rdb_context_t *rdb_context,
+            lifetime_t<name_resolver_t const &> name_resolver)
+    : caching_cfeed_artificial_table_backend_t(
+        name_string_t::guarantee_valid("_debug_coro_profiler"),
+        rdb_context,
+        name_resolver) { }
+
+debug_coro_profiler_artificial_table_backend_t::
+        ~debug_coro_profiler_artificial_table_backend_t() {
+    begin_changefeed_destruction();
+}
+
+std::string debug_coro_profiler_artificial_table_backend_t::get_primary_key_name() {
+    return "id";
+}
+
+bool debug_coro_profiler_artificial_table_backend_t::read_all_rows_as_vector(
+        UNUSED auth::user_context_t const &user_context,
+        UNUSED signal_t *interruptor,
+        std::vector<ql::datum_t> *rows_out,
+        UNUSED admin_err_t *error_out) {
+    on_thread_t thread_switcher(sampler.home_thread());
+    rows_out->clear();
+    rows_out->push_back(format_config_row());
+    rows_out->push_back(format_report_row());
+    return true;
+}
+
+bool debug_coro_profiler_artificial_table_backend_t::read_row(
+        UNUSED auth::user_context_t const &user_context,
+        ql::datum_t primary_key,
+        UNUSED signal_t *interruptor,
+        ql::datum_t *row_out,
+        UNUSED admin_err_t *error_out) {
+    on_thread_t thread_switcher(sampler.home_thread());
+    *row_out = ql::datum_t();
+    if (primary_key.get_type() == ql::datum_t::R_STR) {
+        if (primary_key.as_str() == "config") {
+            *row_out = format_config_row();
+        } else if (primary_key.as_str() == "report") {
+            *row_out = format_report_row();
+        }
+    }
+    return true;
+}
+
+bool debug_coro_profiler_artificial_table_backend_t::write_row(
+        UNUSED auth::user_context_t const &user_context,
+        ql::datum_t primary_key,
+        UNUSED bool pkey_was_autogenerated,
+        ql::datum_t *new_value_inout,
+        UNUSED signal_t *interruptor,
+        admin_err_t *error_out) {
+    on_thread_t thread_switcher(sampler.home_thread());
+    if (primary_key.get_type() != ql::datum_t::R_STR
+            || primary_key.as_str() != "config"
+            || !new_value_inout->has()) {
+        *error_out = admin_err_t{
+            "The only change you can make to the `rethinkdb._debug_coro_profiler` "
+            "table is to update the `config` row.",
+            query_state_t::FAILED};
+        return false;
+    }
+
+    converter_from_datum_object_t converter;
+    admin_err_t dummy_error;
+    if (!converter.init(*new_value_inout, &dummy_error)) {
+        crash("artificial_table_t should guarantee input is an object");
+    }
+    ql::datum_t dummy_pkey;
+    if (!converter.get("id", &dummy_pkey, &dummy_error)) {
+        crash("artificial_table_t should guarantee primary key is present and correct");
+    }
+
+    ql::datum_t enabled_datum;
+    if (!converter.get("enabled", &enabled_datum, error_out)) {
+        return false;
+    }
+    if (enabled_datum.get_type() != ql::datum_t::R_BOOL) {
+        *error_out = admin_err_t{
+            "Expected a boolean; got " + enabled_datum.print(),
+            query_state_t::FAILED};
+        return false;
+    }
+
+    int frequency = 100;
+    ql::datum_t frequency_datum;
+    converter.get_optional("samples_per_sec", &frequency_datum);
+    if (frequency_datum.has() && frequency_datum.get_type() != ql::datum_t::R_NULL) {
+        if (frequency_datum.get_type() != ql::datum_t::R_NUM
+                || frequency_datum.as_num() < 1
+                || frequency_datum.as_num() > 10000) {
+            *error_out = admin_err_t{
+                "`samples_per_sec` must be a number between 1 and 10000; got "
+                    + frequency_datum.print(),
+                query_state_t::FAILED};
+            return false;
+        }
+        frequency = static_cast<int>(frequency_datum.as_num());
+    }
+
+    if (!converter.check_no_extra_keys(error_out)) {
+        return false;
+    }
+
+    if (enabled_datum.as_bool()) {
+        std::string error;
+        if (!sampler.enable(frequency, &error)) {
+            *error_out = admin_err_t{error, query_state_t::FAILED};
+            return false;
+        }
+    } else {
+        sampler.disable();
+    }
+    *new_value_inout = format_config_row();
+    notify_row(ql::datum_t("config"));
+    return true;
+}
+
+ql::datum_t debug_coro_profiler_artificial_table_backend_t::format_config_row() {
+    ql::datum_object_builder_t builder;
+    builder.overwrite("id", ql::datum_t("config"));
+    builder.overwrite("enabled", ql::datum_t::boolean(sampler.is_enabled()));
+    builder.overwrite("samples_per_sec", sampler.is_enabled()
+        ? ql::datum_t(static_cast<double>(sampler.frequency()))
+        : ql::datum_t::null());
+    return std::move(builder).to_datum();
+}
+
+ql::datum_t debug_coro_profiler_artificial_table_backend_t::format_report_row() {
+    std::vector<coro_sampler_t::thread_report_t> reports =
+        sampler.get_report(max_report_entries);
+
+    ql::datum_array_builder_t threads_builder(ql::configured_limits_t::unlimited);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const coro_sampler_t::thread_report_t &report = reports[i];
+        if (report.samples == 0 && report.dropped_samples == 0) {
+            continue;
+        }
+        ql::datum_array_builder_t entries_builder(ql::configured_limits_t::unlimited);
+        for (const coro_sampler_t::entry_t &entry : report.entries) {
+            ql::datum_object_builder_t entry_builder;
+            entry_builder.overwrite("function", ql::datum_t(
+                datum_string_t(entry.function)));
+            ql::datum_array_builder_t stack_builder(ql::configured_limits_t::unlimited);
+            for (const std::string &function : entry.stack) {
+                stack_builder.add(ql::datum_t(datum_string_t(function)));
+            }
+            entry_builder.overwrite("stack", std::move(stack_builder).to_datum());
+            entry_builder.overwrite("spawn_site", entry.spawn_site.empty()
+                ? ql::datum_t::null()
+                : ql::datum_t(datum_string_t(entry.spawn_site)));
+            entry_builder.overwrite("samples", ql::datum_t(
+                static_cast<double>(entry.samples)));
+            entry_builder.overwrite("fraction", ql::datum_t(
+                static_cast<double>(entry.samples) / report.samples));
+            entries_builder.add(std::move(entry_builder).to_datum());
+        }
+
+        ql::datum_object_builder_t thread_builder;
+        thread_builder.overwrite("thread", ql::datum_t(static_cast<double>(i)));
+        thread_builder.overwrite("samples", ql::datum_t(
+            static_cast<double>(report.samples)));
+        thread_builder.overwrite("dropped_samples", ql::datum_t(
+            static_cast<double>(report.dropped_samples)));
+        thread_builder.overwrite("top", std::move(entries_builder).to_datum());
+        threads_builder.add(std::move(thread_builder).to_datum());
+    }
+
+    ql::datum_object_builder_t builder;
+    builder.overwrite("id", ql::datum_t("report"));
+    builder.overwrite("threads", std::move(threads_builder).to_datum());
+    return std::move(builder).to_datum();
+}
@@ -0,0 +1,60 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef CLUSTERING_ADMINISTRATION_DEBUG_CORO_PROFILER_HPP_
+#define CLUSTERING_ADMINISTRATION_DEBUG_CORO_PROFILER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "arch/runtime/coro_sampler.hpp"
+#include "rdb_protocol/artificial_table/caching_cfeed_backend.hpp"
+
+/* The `rethinkdb._debug_coro_profiler` table controls the sampling profiler of the
+server that the client is connected to, and reports its results. It has two rows:
+
+`{"id": "config", "enabled": <bool>, "samples_per_sec": <number>}` turns the profiler
+on and off. Enabling it discards the results of the previous run.
+
+`{"id": "report", "threads": [...]}` has an entry for every thread that was sampled,
+with the number of samples and the stacks and coroutine spawn sites that they were taken
+in, most frequent first. Each stack lists its functions innermost first. */
+
+class debug_coro_profiler_artificial_table_backend_t :
+    public caching_cfeed_artificial_table_backend_t
+{
+public:
+    debug_coro_profiler_artificial_table_backend_t(
+            rdb_context_t *rdb_context,
+            lifetime_t<name_resolver_t const &> name_resolver);
+    ~debug_coro_profiler_artificial_table_backend_t();
+
+    std::string get_primary_key_name();
+
+    bool read_all_rows_as_vector(
+            auth::user_context_t const &user_context,
+            signal_t *interruptor,
+            std::vector<ql::datum_t> *rows_out,
+            admin_err_t *error_out);
+
+    bool read_row(
+            auth::user_context_t const &user_context,
+            ql::datum_t primary_key,
+            signal_t *interruptor,
+            ql::datum_t *row_out,
+            admin_err_t *error_out);
+
+    bool write_row(
+            auth::user_context_t const &user_context,
+            ql::datum_t primary_key,
+            bool pkey_was_autogenerated,
+            ql::datum_t *new_value_inout,
+            signal_t *interruptor,
+            admin_err_t *error_out);
+
+private:
+    ql::datum_t format_config_row();
+    ql::datum_t format_report_row();
+
+    coro_sampler_t sampler;
+};
+
+#endif /* CLUSTERING_ADMINISTRATION_DEBUG_CORO_PROFILER_HPP_ */
@@ -0,0 +1,219 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "clustering/administration/debug_slow_queries.hpp"
+
+#include "clustering/administration/admin_op_exc.hpp"
+#include "clustering/administration/auth/user_context.hpp"
+#include "clustering/administration/datum_adapter.hpp"
+#include "rdb_protocol/context.hpp"
+
+static bool is_visible_to(
+        auth::user_context_t const &user_context,
+        const slow_query_log_t::entry_t &entry) {
+    return user_context.is_admin_user() || entry.user == user_context.to_string();
+}
+
+debug_slow_queries_artificial_table_backend_t::
+        debug_slow_queries_artificial_table_backend_t(
+            rdb_context_t *rdb_context,
+            lifetime_t<name_resolver_t const &> name_resolver)
+    : timer_cfeed_artificial_table_backend_t(
+        name_string_t::guarantee_valid("_debug_slow_queries"),
+        rdb_context,
+        name_resolver),
+      slow_query_log(&rdb_context->slow_query_log) { }
+
+debug_slow_queries_artificial_table_backend_t::
+        ~debug_slow_queries_artificial_table_backend_t() {
+    begin_changefeed_destruction();
+}
+
+std::string debug_slow_queries_artificial_table_backend_t::get_primary_key_name() {
+    return "id";
+}
+
+bool debug_slow_queries_artificial_table_backend_t::read_all_rows_as_vector(
+        auth::user_context_t const &user_context,
+        UNUSED signal_t *interruptor,
+        std::vector<ql::datum_t> *rows_out,
+        UNUSED admin_err_t *error_out) {
+    rows_out->clear();
+    rows_out->push_back(format_config_row());
+    for (const slow_query_log_t::entry_t &entry : slow_query_log->get_entries()) {
+        if (is_visible_to(user_context, entry)) {
+            rows_out->push_back(format_entry_row(entry));
+        }
+    }
+    return true;
+}
+
+bool debug_slow_queries_artificial_table_backend_t::read_row(
+        auth::user_context_t const &user_context,
+        ql::datum_t primary_key,
+        UNUSED signal_t *interruptor,
+        ql::datum_t *row_out,
+        UNUSED admin_err_t *error_out) {
+    *row_out = ql::datum_t();
+    if (primary_key.get_type() == ql::datum_t::R_STR
+            && primary_key.as_str() == "config") {
+        *row_out = format_config_row();
+        return true;
+    }
+    uuid_u id;
+    admin_err_t dummy_error;
+    if (!convert_uuid_from_datum(primary_key, &id, &dummy_error)) {
+        return true;
+    }
+    for (const slow_query_log_t::entry_t &entry : slow_query_log->get_entries()) {
+        if (entry.id == id && is_visible_to(user_context, entry)) {
+            *row_out = format_entry_row(entry);
+            break;
+        }
+    }
+    return true;
+}
+
+bool debug_slow_queries_artificial_table_backend_t::write_row(
+        auth::user_context_t const &user_context,
+        ql::datum_t primary_key,
+        UNUSED bool pkey_was_autogenerated,
+        ql::datum_t *new_value_inout,
+        UNUSED signal_t *interruptor,
+        admin_err_t *error_out) {
+    if (primary_key.get_type() == ql::datum_t::R_STR
+            && primary_key.as_str() == "config"
+            && new_value_inout->has()) {
+        return write_config_row(new_value_inout, error_out);
+    }
+
+    uuid_u id;
+    admin_err_t dummy_error;
+    if (!new_value_inout->has()
+            && convert_uuid_from_datum(primary_key, &id, &dummy_error)) {
+        for (const slow_query_log_t::entry_t &entry : slow_query_log->get_entries()) {
+            if (entry.id == id && is_visible_to(user_context, entry)) {
+                slow_query_log->erase_entry(id);
+                notify_row(primary_key);
+                break;
+            }
+        }
+        return true;
+    }
+
+    *error_out = admin_err_t{
+        "The only changes you can make to the `rethinkdb._debug_slow_queries` table "
+        "are to update the `config` row and to delete other rows.",
+        query_state_t::FAILED};
+    return false;
+}
+
+bool debug_slow_queries_artificial_table_backend_t::write_config_row(
+        ql::datum_t *new_value_inout,
+        admin_err_t *error_out) {
+    converter_from_datum_object_t converter;
+    admin_err_t dummy_error;
+    if (!converter.init(*new_value_inout, &dummy_error)) {
+        crash("artificial_table_t should guarantee input is an object");
+    }
+    ql::datum_t dummy_pkey;
+    if (!converter.get("id", &dummy_pkey, &dummy_error)) {
+        crash("artificial_table_t should guarantee primary key is present and correct");
+    }
+
+    int64_t threshold_nanos = -1;
+    ql::datum_t threshold_datum;
+    if (!converter.get("threshold_secs", &threshold_datum, error_out)) {
+        return false;
+    }
+    if (threshold_datum.get_type() != ql::datum_t::R_NULL) {
+        if (threshold_datum.get_type() != ql::datum_t::R_NUM
+                || threshold_datum.as_num() < 0) {
+            *error_out = admin_err_t{
+                "`threshold_secs` must be a non-negative number or `null`; got "
+                    + threshold_datum.print(),
+                query_state_t::FAILED};
+            return false;
+        }
+        threshold_nanos = static_cast<int64_t>(threshold_datum.as_num() * BILLION);
+    }
+
+    size_t capacity = slow_query_log->get_capacity();
+    ql::datum_t capacity_datum;
+    converter.get_optional("capacity", &capacity_datum);
+    if (capacity_datum.has()) {
+        if (capacity_datum.get_type() != ql::datum_t::R_NUM
+                || capacity_datum.as_num() < 1
+                || capacity_datum.as_num() > 100000) {
+            *error_out = admin_err_t{
+                "`capacity` must be a number between 1 and 100000; got "
+                    + capacity_datum.print(),
+                query_state_t::FAILED};
+            return false;
+        }
+        capacity = static_cast<size_t>(capacity_datum.as_num());
+    }
+
+    if (!converter.check_no_extra_keys(error_out)) {
+        return false;
+    }
+
+    slow_query_log->set_config(threshold_nanos, capacity);
+    *new_value_inout = format_config_row();
+    notify_row(ql::datum_t("config"));
+    return true;
+}
+
+ql::datum_t debug_slow_queries_artificial_table_backend_t::format_config_row() {
+    int64_t threshold_nanos = slow_query_log->get_threshold_nanos();
+    ql::datum_object_builder_t builder;
+    builder.overwrite("id", ql::datum_t("config"));
+    builder.overwrite("threshold_secs", threshold_nanos < 0
+        ? ql::datum_t::null()
+        : ql::datum_t(static_cast<double>(threshold_nanos) / BILLION));
+    builder.overwrite("capacity", ql::datum_t(
+        static_cast<double>(slow_query_log->get_capacity())));
+    return std::move(builder).to_datum();
+}
+
+ql::datum_t debug_slow_queries_artificial_table_backend_t::format_entry_row(
+        const slow_query_log_t::entry_t &entry) {
+    ql::datum_object_builder_t builder;
+    builder.overwrite("id", convert_uuid_to_datum(entry.id));
+    builder.overwrite("job_id", convert_uuid_to_datum(entry.job_id));
+    builder.overwrite("started_at", convert_microtime_to_datum(entry.started_at));
+    builder.overwrite("duration_secs", ql::datum_t(
+        static_cast<double>(entry.duration.nanos) / BILLION));
+    builder.overwrite("batch", ql::datum_t(entry.continuation ? "continue" : "start"));
+    builder.overwrite("query", convert_string_to_datum(entry.query));
+    builder.overwrite("client_address",
+        convert_string_to_datum(entry.client_addr_port.ip().to_string()));
+    builder.overwrite("client_port",
+        convert_port_to_datum(entry.client_addr_port.port().value()));
+    builder.overwrite("user", convert_string_to_datum(entry.user));
+    builder.overwrite("rows_returned", ql::datum_t(
+        static_cast<double>(entry.rows_returned)));
+    builder.overwrite("cpu_secs", ql::datum_t(
+        static_cast<double>(entry.resources.cpu_nanos) / BILLION));
+    builder.overwrite("blocks_read_from_cache", ql::datum_t(
+        static_cast<double>(entry.resources.blocks_from_cache)));
+    builder.overwrite("blocks_read_from_disk", ql::datum_t(
+        static_cast<double>(entry.resources.blocks_from_disk)));
+    builder.overwrite("rows_scanned", ql::datum_t(
+        static_cast<double>(entry.resources.rows_scanned)));
+    if (entry.profile.has_value()) {
+        // Every split in the profile is a read or write that was sent to several
+        // shards in parallel.
+        size_t shard_fanout = 0;
+        for (const profile::event_t &event : *entry.profile) {
+            if (const profile::split_t *split = boost::get<profile::split_t>(&event)) {
+                shard_fanout += split->n_parallel_jobs_;
+            }
+        }
+        builder.overwrite("shard_fanout", ql::datum_t(
+            static_cast<double>(shard_fanout)));
+        builder.overwrite("profile", profile::event_log_as_datum(*entry.profile));
+    } else {
+        builder.overwrite("shard_fanout", ql::datum_t::null());
+        builder.overwrite("profile", ql::datum_t::null());
+    }
+    return std::move(builder).to_datum();
+}
@@ -0,0 +1,63 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef CLUSTERING_ADMINISTRATION_DEBUG_SLOW_QUERIES_HPP_
+#define CLUSTERING_ADMINISTRATION_DEBUG_SLOW_QUERIES_HPP_
+
+#include <string>
+#include <vector>
+
+#include "rdb_protocol/artificial_table/caching_cfeed_backend.hpp"
+#include "rdb_protocol/slow_query_log.hpp"
+
+/* The `rethinkdb._debug_slow_queries` table shows the slow query log of the server that
+the client is connected to. It has one row per slow batch, keyed by a random UUID, with
+the query, how long the batch took, how many rows it returned, the CPU time, blocks and
+rows that it used (like the query's entry in `rethinkdb.jobs`, but for the batch alone)
+and, if the client asked for a profile, the profile and how many shard reads the batch
+fanned out to. Deleting a row removes it from the log. Users who aren't admin only see
+their own queries.
+
+The `{"id": "config", "threshold_secs": <number or null>, "capacity": <number>}` row
+configures the log. A null threshold turns it off. */
+
+class debug_slow_queries_artificial_table_backend_t :
+    public timer_cfeed_artificial_table_backend_t
+{
+public:
+    debug_slow_queries_artificial_table_backend_t(
+            rdb_context_t *rdb_context,
+            lifetime_t<name_resolver_t const &> name_resolver);
+    ~debug_slow_queries_artificial_table_backend_t();
+
+    std::string get_primary_key_name();
+
+    bool read_all_rows_as_vector(
+            auth::user_context_t const &user_context,
+            signal_t *interruptor,
+            std::vector<ql::datum_t> *rows_out,
+            admin_err_t *error_out);
+
+    bool read_row(
+            auth::user_context_t const &user_context,
+            ql::datum_t primary_key,
+            signal_t *interruptor,
+            ql::datum_t *row_out,
+            admin_err_t *error_out);
+
+    bool write_row(
+            auth::user_context_t const &user_context,
+            ql::datum_t primary_key,
+            bool pkey_was_autogenerated,
+            ql::datum_t *new_value_inout,
+            signal_t *interruptor,
+            admin_err_t *error_out);
+
+private:
+    bool write_config_row(ql::datum_t *new_value_inout, admin_err_t *error_out);
+
+    ql::datum_t format_config_row();
+    ql::datum_t format_entry_row(const slow_query_log_t::entry_t &entry);
+
+    slow_query_log_t *const slow_query_log;
+};
+
+#endif /* CLUSTERING_ADMINISTRATION_DEBUG_SLOW_QUERIES_HPP_ */
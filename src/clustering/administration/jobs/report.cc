@@ -227,11 +227,13 @@ query_job_report_t::query_job_report_t(
         server_id_t const &_server_id,
         ip_and_port_t const &_client_addr_port,
         std::string const &_query,
-        auth::user_context_t const &_user_context)
+        auth::user_context_t const &_user_context,
+        resource_usage_t const &_resources)
     : job_report_base_t<query_job_report_t>("query", _id, _duration, _server_id),
       client_addr_port(_client_addr_port),
       query(_query),
-      user_context(_user_context) { }
+      user_context(_user_context),
+      resources(_resources) { }
 
 void query_job_report_t::merge_derived(query_job_report_t const &) { }
 
@@ -248,12 +250,21 @@ bool query_job_report_t::info_derived(
     info_builder_out->overwrite("query", convert_string_to_datum(query));
     info_builder_out->overwrite(
         "user", convert_string_to_datum(user_context.to_string()));
+    info_builder_out->overwrite("cpu_secs", ql::datum_t(
+        static_cast<double>(resources.cpu_nanos) / BILLION));
+    info_builder_out->overwrite("blocks_read_from_cache", ql::datum_t(
+        static_cast<double>(resources.blocks_from_cache)));
+    info_builder_out->overwrite("blocks_read_from_disk", ql::datum_t(
+        static_cast<double>(resources.blocks_from_disk)));
+    info_builder_out->overwrite("rows_scanned", ql::datum_t(
+        static_cast<double>(resources.rows_scanned)));
 
     return true;
 }
 
-RDB_IMPL_SERIALIZABLE_7_FOR_CLUSTER(
-    query_job_report_t, type, id, duration, servers, client_addr_port, query, user_context);
+RDB_IMPL_SERIALIZABLE_8_FOR_CLUSTER(
+    query_job_report_t, type, id, duration, servers, client_addr_port, query, user_context,
+    resources);
 
 RDB_IMPL_SERIALIZABLE_2_FOR_CLUSTER(jobs_manager_business_card_t,
                                     get_job_reports_mailbox_address,
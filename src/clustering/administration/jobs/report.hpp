@@ -5,6 +5,7 @@
 #include <string>
 
 #include "arch/address.hpp"
+#include "arch/runtime/resource_account.hpp"
 #include "btree/secondary_operations.hpp"
 #include "clustering/administration/auth/user_context.hpp"
 #include "clustering/administration/datum_adapter.hpp"
@@ -140,7 +141,8 @@ public:
             server_id_t const &server_id,
             ip_and_port_t const &client_addr_port,
             std::string const &query,
-            auth::user_context_t const &user_context);
+            auth::user_context_t const &user_context,
+            resource_usage_t const &resources);
 
     void merge_derived(query_job_report_t const &job_report);
 
@@ -154,6 +156,7 @@ public:
     ip_and_port_t client_addr_port;
     std::string query;
     auth::user_context_t user_context;
+    resource_usage_t resources;
 };
 RDB_DECLARE_SERIALIZABLE_FOR_CLUSTER(query_job_report_t);
 
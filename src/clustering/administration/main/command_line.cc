@@ -481,6 +481,30 @@ optional<int> parse_node_reconnect_timeout_secs_option(
     return optional<int>();
 }
 
+/* Returns the backfill budget in bytes per second, where zero means no limit. An empty
+`optional` means the `--backfill-budget` parameter is not present. */
+optional<uint64_t> parse_backfill_budget_option(
+        const std::map<std::string, options::values_t> &opts) {
+    if (exists_option(opts, "--backfill-budget")) {
+        const std::string budget_opt = get_single_option(opts, "--backfill-budget");
+        uint64_t budget_megs;
+        if (!strtou64_strict(budget_opt, 10, &budget_megs)) {
+            throw std::runtime_error(strprintf(
+                    "ERROR: backfill-budget should be a number, got '%s'",
+                    budget_opt.c_str()));
+        }
+        if (budget_megs > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())
+                / MEGABYTE) {
+            throw std::runtime_error(strprintf(
+                    "ERROR: backfill-budget is too large, got '%s'",
+                    budget_opt.c_str()));
+        }
+        return optional<uint64_t>(budget_megs * MEGABYTE);
+    } else {
+        return optional<uint64_t>();
+    }
+}
+
 /* An empty outer `optional` means the `--cache-size` parameter is not present. An
 empty inner `optional` means the cache size is set to `auto`. */
 optional<optional<uint64_t> > parse_total_cache_size_option(
@@ -1043,6 +1067,7 @@ void run_rethinkdb_create(const base_path_t &base_path,
                           const std::set<name_string_t> &server_tags,
                           const std::string &initial_password,
                           optional<uint64_t> total_cache_size,
+                          optional<uint64_t> backfill_budget,
                           const file_direct_io_mode_t direct_io_mode,
                           const int max_concurrent_io_requests,
                           bool *const result_out) {
@@ -1056,6 +1081,7 @@ void run_rethinkdb_create(const base_path_t &base_path,
     server_config.config.name = server_name;
     server_config.config.tags = server_tags;
     server_config.config.cache_size_bytes = total_cache_size;
+    server_config.config.backfill_budget_bytes_per_sec = backfill_budget.value_or(0);
     server_config.version = 1;
 
     io_backender_t io_backender(direct_io_mode, max_concurrent_io_requests);
@@ -1141,6 +1167,7 @@ void run_rethinkdb_serve(const base_path_t &base_path,
                          const int max_concurrent_io_requests,
                          const optional<optional<uint64_t> >
                             &total_cache_size,
+                         const optional<uint64_t> &backfill_budget,
                          const server_id_t *our_server_id,
                          const server_config_versioned_t *server_config,
                          const cluster_semilattice_metadata_t *cluster_metadata,
@@ -1184,6 +1211,8 @@ void run_rethinkdb_serve(const base_path_t &base_path,
                 &non_interruptor));
             guarantee(!static_cast<bool>(total_cache_size), "rethinkdb porcelain should "
                 "have already set up total_cache_size");
+            guarantee(!static_cast<bool>(backfill_budget), "rethinkdb porcelain should "
+                "have already set up backfill_budget");
         } else {
             metadata_file.init(new metadata_file_t(
                 &io_backender,
@@ -1226,6 +1255,18 @@ void run_rethinkdb_serve(const base_path_t &base_path,
                 }
                 txn.commit();
             }
+            if (static_cast<bool>(backfill_budget)) {
+                /* Apply change to backfill budget */
+                metadata_file_t::write_txn_t txn(metadata_file.get(), &non_interruptor);
+                server_config_versioned_t config =
+                    txn.read(mdkey_server_config(), &non_interruptor);
+                if (config.config.backfill_budget_bytes_per_sec != *backfill_budget) {
+                    config.config.backfill_budget_bytes_per_sec = *backfill_budget;
+                    ++config.version;
+                    txn.write(mdkey_server_config(), config, &non_interruptor);
+                }
+                txn.commit();
+            }
             if (!initial_password.empty()) {
                 /* Apply the initial password if there isn't one already. */
                 metadata_file_t::write_txn_t txn(metadata_file.get(), &non_interruptor);
@@ -1286,6 +1327,7 @@ void run_rethinkdb_porcelain(const base_path_t &base_path,
                              const int max_concurrent_io_requests,
                              const optional<optional<uint64_t> >
                                 &total_cache_size,
+                             const optional<uint64_t> &backfill_budget,
                              const bool new_directory,
                              serve_info_t *serve_info,
                              directory_lock_t *data_directory_lock,
@@ -1293,7 +1335,8 @@ void run_rethinkdb_porcelain(const base_path_t &base_path,
     if (!new_directory) {
         run_rethinkdb_serve(base_path, serve_info, initial_password, direct_io_mode,
                             max_concurrent_io_requests, total_cache_size,
-                            nullptr, nullptr, nullptr, data_directory_lock,
+                            backfill_budget, nullptr, nullptr, nullptr,
+                            data_directory_lock,
                             result_out);
     } else {
         logNTC("Initializing directory %s\n", base_path.path().c_str());
@@ -1325,11 +1368,14 @@ void run_rethinkdb_porcelain(const base_path_t &base_path,
         server_config.config.cache_size_bytes = static_cast<bool>(total_cache_size)
             ? *total_cache_size
             : optional<uint64_t>();   /* default to 'auto' */
+        server_config.config.backfill_budget_bytes_per_sec =
+            backfill_budget.value_or(0);
         server_config.version = 1;
 
         run_rethinkdb_serve(base_path, serve_info, initial_password, direct_io_mode,
                             max_concurrent_io_requests,
                             optional<optional<uint64_t> >(),
+                            optional<uint64_t>(),
                             &our_server_id, &server_config, &cluster_metadata,
                             data_directory_lock, result_out);
     }
@@ -1417,6 +1463,15 @@ options::help_section_t get_file_options(std::vector<options::option_t> *options
                                              options::OPTIONAL));
     help.add("--cache-size mb", "total cache size (in megabytes) for the process. Can "
         "be 'auto'.");
+    options_out->push_back(options::option_t(options::names_t("--backfill-budget"),
+                                             options::OPTIONAL));
+    help.add("--backfill-budget mb", "limit (in megabytes per second) on the amount of "
+        "backfilled data that this server reads out of and writes into its tables. 0 "
+        "means no limit.");
+    options_out->push_back(options::option_t(options::names_t("--redo-log"),
+                                             options::OPTIONAL_NO_PARAMETER));
+    help.add("--redo-log", "make hard durability writes durable by syncing a per-shard "
+        "log of writes instead of the data files");
     return help;
 }
 
@@ -1593,6 +1648,16 @@ options::help_section_t get_network_options(const bool join_required, std::vecto
                                              options::OPTIONAL,
                                              strprintf("%d", port_defaults::reql_port)));
     help.add("--driver-port port", "port for rethinkdb protocol client drivers");
+    options_out->push_back(options::option_t(options::names_t("--reuse-driver-port"),
+                                             options::OPTIONAL_NO_PARAMETER));
+    help.add("--reuse-driver-port", "accept client driver connections on every thread "
+             "by sharing the driver port with SO_REUSEPORT (Linux only). Other processes "
+             "run by the same user can then bind to the port, too.");
+    options_out->push_back(options::option_t(options::names_t("--no-query-spreading"),
+                                             options::OPTIONAL_NO_PARAMETER));
+    help.add("--no-query-spreading", "run all queries of a client driver connection on "
+             "the connection's thread, instead of moving queries that arrive while "
+             "others are running to less busy threads");
 
     options_out->push_back(options::option_t(options::names_t("--port-offset", "-o"),
                                              options::OPTIONAL,
@@ -1923,6 +1988,7 @@ int main_rethinkdb_create(int argc, char *argv[]) {
                 parse_total_cache_size_option(opts)) {
             total_cache_size = *x;
         }
+        optional<uint64_t> backfill_budget = parse_backfill_budget_option(opts);
 
         int max_concurrent_io_requests;
         if (!parse_io_threads_option(opts, &max_concurrent_io_requests)) {
@@ -1956,6 +2022,7 @@ int main_rethinkdb_create(int argc, char *argv[]) {
                                      server_tag_names,
                                      initial_password,
                                      total_cache_size,
+                                     backfill_budget,
                                      direct_io_mode,
                                      max_concurrent_io_requests,
                                      &result),
@@ -2061,6 +2128,7 @@ int main_rethinkdb_serve(int argc, char *argv[]) {
 
         optional<optional<uint64_t> > total_cache_size =
             parse_total_cache_size_option(opts);
+        optional<uint64_t> backfill_budget = parse_backfill_budget_option(opts);
 
         optional<int> join_delay_secs = parse_join_delay_secs_option(opts);
         optional<int> node_reconnect_timeout_secs =
@@ -2107,6 +2175,9 @@ int main_rethinkdb_serve(int argc, char *argv[]) {
                                 std::vector<std::string>(argv, argv + argc),
                                 join_delay_secs.value_or(0),
                                 node_reconnect_timeout_secs.value_or(cluster_defaults::reconnect_timeout),
+                                exists_option(opts, "--redo-log"),
+                                exists_option(opts, "--reuse-driver-port"),
+                                !exists_option(opts, "--no-query-spreading"),
                                 tls_configs);
 
         const file_direct_io_mode_t direct_io_mode = parse_direct_io_mode_option(opts);
@@ -2119,6 +2190,7 @@ int main_rethinkdb_serve(int argc, char *argv[]) {
                                      direct_io_mode,
                                      max_concurrent_io_requests,
                                      total_cache_size,
+                                     backfill_budget,
                                      static_cast<server_id_t*>(nullptr),
                                      static_cast<server_config_versioned_t *>(nullptr),
                                      static_cast<cluster_semilattice_metadata_t*>(nullptr),
@@ -2210,6 +2282,9 @@ int main_rethinkdb_proxy(int argc, char *argv[]) {
                                 std::vector<std::string>(argv, argv + argc),
                                 join_delay_secs.value_or(0),
                                 node_reconnect_timeout_secs.value_or(cluster_defaults::reconnect_timeout),
+                                false,
+                                exists_option(opts, "--reuse-driver-port"),
+                                !exists_option(opts, "--no-query-spreading"),
                                 tls_configs);
 
         bool result;
@@ -2365,6 +2440,7 @@ int main_rethinkdb_porcelain(int argc, char *argv[]) {
 
         optional<optional<uint64_t> > total_cache_size =
             parse_total_cache_size_option(opts);
+        optional<uint64_t> backfill_budget = parse_backfill_budget_option(opts);
 
         if (check_pid_file(opts) != EXIT_SUCCESS) {
             return EXIT_FAILURE;
@@ -2400,6 +2476,9 @@ int main_rethinkdb_porcelain(int argc, char *argv[]) {
                                 std::vector<std::string>(argv, argv + argc),
                                 join_delay_secs.value_or(0),
                                 node_reconnect_timeout_secs.value_or(cluster_defaults::reconnect_timeout),
+                                exists_option(opts, "--redo-log"),
+                                exists_option(opts, "--reuse-driver-port"),
+                                !exists_option(opts, "--no-query-spreading"),
                                 tls_configs);
 
         const file_direct_io_mode_t direct_io_mode = parse_direct_io_mode_option(opts);
@@ -2413,6 +2492,7 @@ int main_rethinkdb_porcelain(int argc, char *argv[]) {
                                      direct_io_mode,
                                      max_concurrent_io_requests,
                                      total_cache_size,
+                                     backfill_budget,
                                      is_new_directory,
                                      &serve_info,
                                      &data_directory_lock,
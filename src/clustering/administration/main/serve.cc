@@ -311,7 +311,8 @@ bool do_serve(io_backender_t *io_backender,
                         cache_balancer.get(),
                         base_path,
                         &rdb_ctx,
-                        metadata_file));
+                        metadata_file,
+                        serve_info.use_redo_log));
                 multi_table_manager.init(new multi_table_manager_t(
                     server_id,
                     &mailbox_manager,
@@ -322,7 +323,8 @@ bool do_serve(io_backender_t *io_backender,
                     table_persistence_interface.get(),
                     base_path,
                     io_backender,
-                    &perfmon_collection_repo));
+                    &perfmon_collection_repo,
+                    server_config_server->get_backfill_budget_bytes_per_sec()));
             } else {
                 /* Proxies still need a `multi_table_manager_t` because it takes care of
                 receiving table names, databases, and primary keys from other servers and
@@ -539,6 +541,8 @@ bool do_serve(io_backender_t *io_backender,
                 rdb_query_server_t rdb_query_server(
                     serve_info.ports.local_addresses_driver,
                     serve_info.ports.reql_port,
+                    serve_info.reuse_driver_port,
+                    serve_info.spread_queries,
                     &rdb_ctx,
                     &server_config_client,
                     server_id,
@@ -119,6 +119,9 @@ public:
                  std::vector<std::string> &&_argv,
                  const int _join_delay_secs,
                  const int _node_reconnect_timeout_secs,
+                 bool _use_redo_log,
+                 bool _reuse_driver_port,
+                 bool _spread_queries,
                  tls_configs_t _tls_configs) :
         joins(std::move(_joins)),
         reql_http_proxy(std::move(_reql_http_proxy)),
@@ -128,7 +131,10 @@ public:
         config_file(_config_file),
         argv(std::move(_argv)),
         join_delay_secs(_join_delay_secs),
-        node_reconnect_timeout_secs(_node_reconnect_timeout_secs)
+        node_reconnect_timeout_secs(_node_reconnect_timeout_secs),
+        use_redo_log(_use_redo_log),
+        reuse_driver_port(_reuse_driver_port),
+        spread_queries(_spread_queries)
     {
         tls_configs = _tls_configs;
     }
@@ -149,6 +155,14 @@ public:
     std::vector<std::string> argv;
     int join_delay_secs;
     int node_reconnect_timeout_secs;
+    /* If true, hard-durability writes are made durable through per-shard redo logs. */
+    bool use_redo_log;
+    /* If true, client driver connections are accepted on every thread, with the
+    driver port shared between threads through `SO_REUSEPORT`. */
+    bool reuse_driver_port;
+    /* If true, the queries of one client driver connection can run on other threads
+    than the connection's own. */
+    bool spread_queries;
     tls_configs_t tls_configs;
 };
 
@@ -9,6 +9,7 @@
 #include "clustering/administration/persist/raft_storage_interface.hpp"
 #include "clustering/administration/perfmon_collection_repo.hpp"
 #include "logger.hpp"
+#include "rdb_protocol/redo_log.hpp"
 #include "rdb_protocol/store.hpp"
 #include "serializer/log/log_serializer.hpp"
 #include "serializer/merger.hpp"
@@ -28,6 +29,7 @@ public:
             perfmon_collection_t *perfmon_collection_serializers,
             scoped_ptr_t<thread_allocation_t> &&serializer_thread,
             std::vector<scoped_ptr_t<thread_allocation_t> > &&store_threads,
+            bool use_redo_log,
             std::map<
                 namespace_id_t, std::pair<real_multistore_ptr_t *, auto_drainer_t::lock_t>
             > *real_multistores) :
@@ -112,6 +114,18 @@ public:
                     write_durability_t::HARD,
                     &non_interruptor);
             }
+
+            if (use_redo_log) {
+                std::string redo_log_path =
+                    real_table_persistence_interface_t::redo_log_path_for(path, ix);
+                if (create) {
+                    /* Don't replay anything that a failed earlier attempt to create
+                    this table may have left behind. */
+                    redo_log_t::destroy(redo_log_path);
+                }
+                cond_t non_interruptor;
+                stores[ix]->enable_redo_log(redo_log_path, &non_interruptor);
+            }
         });
 
         if (create) {
@@ -301,6 +315,7 @@ void real_table_persistence_interface_t::load_multistore(
         perfmon_collection_serializers,
         std::move(serializer_thread),
         std::move(store_threads),
+        use_redo_log,
         &real_multistores));
 }
 
@@ -321,11 +336,18 @@ void real_table_persistence_interface_t::destroy_multistore(
     guarantee(multistore_ptr_in->has());
     multistore_ptr_in->reset();
 
-    std::string filepath = file_name_for(table_id).permanent_path();
+    serializer_filepath_t path = file_name_for(table_id);
+    std::string filepath = path.permanent_path();
     logNTC("Removing file %s\n", filepath.c_str());
     const int res = ::unlink(filepath.c_str());
     guarantee_err(res == 0 || get_errno() == ENOENT,
                   "unlink failed for file %s", filepath.c_str());
+
+    /* The table may have had redo logs in an earlier run even if it doesn't now, so we
+    always try to remove them. */
+    for (size_t ix = 0; ix < CPU_SHARDING_FACTOR; ++ix) {
+        redo_log_t::destroy(redo_log_path_for(path, ix));
+    }
 }
 
 serializer_filepath_t real_table_persistence_interface_t::file_name_for(
@@ -333,6 +355,11 @@ serializer_filepath_t real_table_persistence_interface_t::file_name_for(
     return serializer_filepath_t(base_path, uuid_to_str(table_id));
 }
 
+std::string real_table_persistence_interface_t::redo_log_path_for(
+        const serializer_filepath_t &path, size_t shard) {
+    return strprintf("%s.redo_%zu", path.permanent_path().c_str(), shard);
+}
+
 bool real_table_persistence_interface_t::is_gc_active() const {
     for (int thread = 0; thread < get_num_db_threads(); ++thread) {
         std::map<serializer_t *, auto_drainer_t::lock_t> serializers_copy;
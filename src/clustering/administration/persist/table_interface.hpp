@@ -19,12 +19,14 @@ public:
             cache_balancer_t *_cache_balancer,
             const base_path_t &_base_path,
             rdb_context_t *_rdb_context,
-            metadata_file_t *_metadata_file) :
+            metadata_file_t *_metadata_file,
+            bool _use_redo_log) :
         io_backender(_io_backender),
         cache_balancer(_cache_balancer),
         base_path(_base_path),
         rdb_context(_rdb_context),
         metadata_file(_metadata_file),
+        use_redo_log(_use_redo_log),
         /* We assign threads from the lowest thread number upwards. This is to reduce
         the potential for conflicting with cluster connection threads, which are
         assigned from the highest thread number downwards. */
@@ -72,6 +74,10 @@ public:
 
     bool is_gc_active() const;
 
+    /* Returns the path of the redo log for the given shard of the table whose data file
+    is at `path`. */
+    static std::string redo_log_path_for(const serializer_filepath_t &path, size_t shard);
+
 private:
     serializer_filepath_t file_name_for(const namespace_id_t &table_id);
     threadnum_t pick_thread();
@@ -81,6 +87,8 @@ private:
     base_path_t const base_path;
     rdb_context_t * const rdb_context;
     metadata_file_t * const metadata_file;
+    /* If true, every shard gets a redo log; see `store_t::enable_redo_log()`. */
+    bool const use_redo_log;
 
     std::map<
         namespace_id_t, std::pair<real_multistore_ptr_t *, auto_drainer_t::lock_t>
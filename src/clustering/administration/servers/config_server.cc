@@ -21,6 +21,9 @@ server_config_server_t::server_config_server_t(
     my_server_id = read_txn.read(mdkey_server_id(), &non_interruptor);
     my_config.set_value(read_txn.read(mdkey_server_config(), &non_interruptor));
     update_actual_cache_size(my_config.get_ref().config.cache_size_bytes);
+    if (my_config.get_ref().config.backfill_budget_bytes_per_sec != 0) {
+        log_backfill_budget(my_config.get_ref().config.backfill_budget_bytes_per_sec);
+    }
 }
 
 server_config_business_card_t server_config_server_t::get_business_card() {
@@ -64,6 +67,10 @@ void server_config_server_t::on_set_config(
     if (old_config.cache_size_bytes != new_config.cache_size_bytes) {
         update_actual_cache_size(new_config.cache_size_bytes);
     }
+    if (old_config.backfill_budget_bytes_per_sec
+            != new_config.backfill_budget_bytes_per_sec) {
+        log_backfill_budget(new_config.backfill_budget_bytes_per_sec);
+    }
     send(mailbox_manager, ack_addr, my_config.get_ref().version, std::string());
 }
 
@@ -96,3 +103,12 @@ void server_config_server_t::update_actual_cache_size(
     actual_cache_size_bytes.set_value(actual_size);
 }
 
+
+void server_config_server_t::log_backfill_budget(uint64_t setting) {
+    if (setting == 0) {
+        logINF("Backfills are not limited");
+    } else {
+        logINF("Backfills are limited to %g MB per second",
+            static_cast<double>(setting) / MEGABYTE);
+    }
+}
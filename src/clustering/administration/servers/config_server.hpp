@@ -28,6 +28,14 @@ public:
         return actual_cache_size_bytes.get_watchable();
     }
 
+    /* Returns the backfill budget setting. Zero means that backfills are unlimited. */
+    clone_ptr_t<watchable_t<uint64_t> > get_backfill_budget_bytes_per_sec() {
+        return my_config.get_watchable()->subview(
+            [](const server_config_versioned_t &config) {
+                return config.config.backfill_budget_bytes_per_sec;
+            });
+    }
+
 private:
     /* `on_set_config()` is a mailbox callback */
     void on_set_config(
@@ -36,6 +44,7 @@ private:
         const mailbox_t<uint64_t, std::string>::address_t &ack_addr);
 
     void update_actual_cache_size(const optional<uint64_t> &setting);
+    void log_backfill_budget(uint64_t setting);
 
     mailbox_manager_t *const mailbox_manager;
     metadata_file_t *const file;
@@ -80,6 +80,36 @@ bool convert_server_config_from_datum(
         return false;
     }
 
+    /* Rows that were written before `backfill_budget_mb` existed don't have it. */
+    ql::datum_t backfill_budget_datum;
+    converter.get_optional("backfill_budget_mb", &backfill_budget_datum);
+    if (!backfill_budget_datum.has()) {
+        server_config_out->backfill_budget_bytes_per_sec = 0;
+    } else if (backfill_budget_datum.get_type() == ql::datum_t::R_NUM) {
+        double backfill_budget_mb = backfill_budget_datum.as_num();
+        if (backfill_budget_mb * MEGABYTE >
+                static_cast<double>(std::numeric_limits<int64_t>::max())) {
+            *error_out = admin_err_t{
+                "In `backfill_budget_mb`: Value is too big.",
+                query_state_t::FAILED};
+            return false;
+        }
+        if (backfill_budget_mb < 0) {
+            *error_out = admin_err_t{
+                "In `backfill_budget_mb`: Backfill budget cannot be negative.",
+                query_state_t::FAILED};
+            return false;
+        }
+        server_config_out->backfill_budget_bytes_per_sec =
+            static_cast<uint64_t>(backfill_budget_mb * MEGABYTE);
+    } else {
+        *error_out = admin_err_t{
+            "In `backfill_budget_mb`: Expected a number, got "
+            + backfill_budget_datum.print(),
+            query_state_t::FAILED};
+        return false;
+    }
+
     if (!converter.check_no_extra_keys(error_out)) {
         return false;
     }
@@ -129,6 +159,10 @@ bool server_config_artificial_table_backend_t::format_row(
         builder.overwrite("cache_size_mb", ql::datum_t("auto"));
     }
 
+    builder.overwrite("backfill_budget_mb", ql::datum_t(
+        static_cast<double>(metadata.server_config.config.backfill_budget_bytes_per_sec)
+            / MEGABYTE));
+
     *row_out = std::move(builder).to_datum();
 
     return true;
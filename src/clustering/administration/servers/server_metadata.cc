@@ -3,8 +3,53 @@
 
 #include "logger.hpp"
 
-RDB_IMPL_SERIALIZABLE_3_SINCE_v2_1(server_config_t, name, tags, cache_size_bytes);
-RDB_IMPL_EQUALITY_COMPARABLE_3(server_config_t, name, tags, cache_size_bytes);
+template <cluster_version_t W>
+archive_result_t deserialize_server_config_pre_v2_5(
+    read_stream_t *s, server_config_t *sc) {
+    archive_result_t res;
+
+    res = deserialize<W>(s, &sc->name);
+    if (bad(res)) { return res; }
+
+    res = deserialize<W>(s, &sc->tags);
+    if (bad(res)) { return res; }
+
+    res = deserialize<W>(s, &sc->cache_size_bytes);
+    if (bad(res)) { return res; }
+
+    sc->backfill_budget_bytes_per_sec = 0;
+
+    return res;
+}
+
+template <>
+archive_result_t deserialize<cluster_version_t::v2_1>(
+    read_stream_t *s, server_config_t *sc) {
+    return deserialize_server_config_pre_v2_5<cluster_version_t::v2_1>(s, sc);
+}
+
+template <>
+archive_result_t deserialize<cluster_version_t::v2_2>(
+    read_stream_t *s, server_config_t *sc) {
+    return deserialize_server_config_pre_v2_5<cluster_version_t::v2_2>(s, sc);
+}
+
+template <>
+archive_result_t deserialize<cluster_version_t::v2_3>(
+    read_stream_t *s, server_config_t *sc) {
+    return deserialize_server_config_pre_v2_5<cluster_version_t::v2_3>(s, sc);
+}
+
+template <>
+archive_result_t deserialize<cluster_version_t::v2_4>(
+    read_stream_t *s, server_config_t *sc) {
+    return deserialize_server_config_pre_v2_5<cluster_version_t::v2_4>(s, sc);
+}
+
+RDB_IMPL_SERIALIZABLE_4_SINCE_v2_5(server_config_t,
+    name, tags, cache_size_bytes, backfill_budget_bytes_per_sec);
+RDB_IMPL_EQUALITY_COMPARABLE_4(server_config_t,
+    name, tags, cache_size_bytes, backfill_budget_bytes_per_sec);
 
 RDB_IMPL_SERIALIZABLE_2_SINCE_v2_1(server_config_versioned_t, config, version);
 RDB_IMPL_EQUALITY_COMPARABLE_2(server_config_versioned_t, config, version);
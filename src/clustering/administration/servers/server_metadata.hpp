@@ -17,9 +17,13 @@
 
 class server_config_t {
 public:
+    server_config_t() : backfill_budget_bytes_per_sec(0) { }
     name_string_t name;
     std::set<name_string_t> tags;
     optional<uint64_t> cache_size_bytes;
+    /* The limit on the backfill items that this server reads and writes, shared by all
+    of its backfills. Zero means no limit. */
+    uint64_t backfill_budget_bytes_per_sec;
 };
 
 RDB_DECLARE_SERIALIZABLE(server_config_t);
@@ -31,6 +31,24 @@ const char *table_server_stats_request_t::table_server_request_type = "table_ser
     (BUILDER).overwrite(#NAME, ql::datum_t( \
         (STATS).accumulate_server(SERVER, &parsed_stats_t::table_stats_t::NAME)));
 
+// Latency histograms are reported as their percentiles
+#define ADD_LATENCY_STAT(BUILDER, SUB_STATS, NAME) \
+    (BUILDER).overwrite(#NAME, (SUB_STATS).NAME.to_datum(false))
+
+#define ADD_CLUSTER_LATENCY_STAT(BUILDER, STATS, NAME) \
+    (BUILDER).overwrite(#NAME, (STATS).merge_latency( \
+        &parsed_stats_t::server_stats_t::NAME).to_datum(false));
+
+#define ADD_TABLE_LATENCY_STAT(BUILDER, STATS, TABLE, NAME) \
+    (BUILDER).overwrite(#NAME, (STATS).merge_table_latency( \
+        TABLE, &parsed_stats_t::table_stats_t::NAME).to_datum(false));
+
+static ql::datum_t cache_hit_ratio_to_datum(double recent_hits, double recent_misses) {
+    return recent_hits + recent_misses == 0
+        ? ql::datum_t::null()
+        : ql::datum_t(recent_hits / (recent_hits + recent_misses));
+}
+
 parsed_stats_t::server_stats_t::server_stats_t() :
     responsive(false),
     queries_per_sec(0), queries_total(0),
@@ -39,10 +57,15 @@ parsed_stats_t::server_stats_t::server_stats_t() :
 parsed_stats_t::table_stats_t::table_stats_t() :
     read_docs_per_sec(0), read_docs_total(0),
     written_docs_per_sec(0), written_docs_total(0),
-    in_use_bytes(0), metadata_bytes(0), data_bytes(0),
+    in_use_bytes(0),
+    cache_hits_total(0), cache_misses_total(0),
+    cache_recent_hits(0), cache_recent_misses(0),
+    cache_bytes_needed_for_95_percent_hits(0), cache_bytes_needed_unknown(false),
+    metadata_bytes(0), data_bytes(0),
     garbage_bytes(0), preallocated_bytes(0),
     read_bytes_per_sec(0), read_bytes_total(0),
-    written_bytes_per_sec(0), written_bytes_total(0) { }
+    written_bytes_per_sec(0), written_bytes_total(0),
+    block_written_bytes_total(0), gc_written_bytes_total(0) { }
 
 parsed_stats_t::parsed_stats_t(const std::vector<ql::datum_t> &stats) {
     for (auto const &s : stats) {
@@ -65,6 +88,8 @@ parsed_stats_t::parsed_stats_t(const std::vector<ql::datum_t> &stats) {
             std::pair<datum_string_t, ql::datum_t> perf_pair = s.get_pair(i);
             if (perf_pair.first == "query_engine") {
                 store_query_engine_stats(perf_pair.second, &serv_stats);
+            } else if (perf_pair.first == "eventloop_threads") {
+                serv_stats.event_loop = perf_pair.second;
             } else {
                 namespace_id_t table_id;
                 res = str_to_uuid(perf_pair.first.to_std(), &table_id);
@@ -101,6 +126,15 @@ void parsed_stats_t::add_perfmon_value(const ql::datum_t &perf,
     }
 }
 
+void parsed_stats_t::merge_perfmon_latency(const ql::datum_t &perf,
+                                           const std::string &key,
+                                           latency_histogram_t *histogram_out) {
+    ql::datum_t v = perf.get_field(key.c_str(), ql::throw_bool_t::NOTHROW);
+    if (v.has()) {
+        histogram_out->merge_datum(v);
+    }
+}
+
 void parsed_stats_t::store_shard_values(const ql::datum_t &shard_perf,
                                         table_stats_t *stats_out) {
     r_sanity_check(shard_perf.get_type() == ql::datum_t::R_OBJECT);
@@ -125,6 +159,27 @@ void parsed_stats_t::store_shard_values(const ql::datum_t &shard_perf,
                 } else if (key == "cache") {
                     add_perfmon_value(sub_pair.second, "in_use_bytes",
                                       &stats_out->in_use_bytes);
+                    merge_perfmon_latency(sub_pair.second, "miss_latency",
+                                          &stats_out->cache_miss_latency);
+                    add_perfmon_value(sub_pair.second, "hits_total",
+                                      &stats_out->cache_hits_total);
+                    add_perfmon_value(sub_pair.second, "misses_total",
+                                      &stats_out->cache_misses_total);
+                    add_perfmon_value(sub_pair.second, "recent_hits",
+                                      &stats_out->cache_recent_hits);
+                    add_perfmon_value(sub_pair.second, "recent_misses",
+                                      &stats_out->cache_recent_misses);
+                    // This one is `null` if the shard's estimate is unbounded.
+                    ql::datum_t needed = sub_pair.second.get_field(
+                        "bytes_needed_for_95_percent_hits", ql::throw_bool_t::NOTHROW);
+                    if (needed.has()) {
+                        if (needed.get_type() == ql::datum_t::R_NUM) {
+                            stats_out->cache_bytes_needed_for_95_percent_hits
+                                += needed.as_num();
+                        } else {
+                            stats_out->cache_bytes_needed_unknown = true;
+                        }
+                    }
                 }
             }
         }
@@ -142,6 +197,14 @@ void parsed_stats_t::store_serializer_values(const ql::datum_t &ser_perf,
                         &stats_out->written_bytes_per_sec);
     store_perfmon_value(ser_perf, "serializer_written_bytes_total",
                         &stats_out->written_bytes_total);
+    store_perfmon_value(ser_perf, "serializer_block_written_bytes_total",
+                        &stats_out->block_written_bytes_total);
+    store_perfmon_value(ser_perf, "serializer_gc_written_bytes_total",
+                        &stats_out->gc_written_bytes_total);
+    merge_perfmon_latency(ser_perf, "serializer_block_read_latency",
+                          &stats_out->read_latency);
+    merge_perfmon_latency(ser_perf, "serializer_index_write_latency",
+                          &stats_out->write_latency);
 
     store_perfmon_value(ser_perf, "serializer_data_extents",
                         &stats_out->data_bytes);
@@ -167,6 +230,7 @@ void parsed_stats_t::store_query_engine_stats(const ql::datum_t &qe_perf,
     store_perfmon_value(qe_perf, "queries_total", &stats_out->queries_total);
     store_perfmon_value(qe_perf, "client_connections", &stats_out->client_connections);
     store_perfmon_value(qe_perf, "clients_active", &stats_out->clients_active);
+    merge_perfmon_latency(qe_perf, "query_latency", &stats_out->query_latency);
 }
 
 void parsed_stats_t::store_table_stats(const namespace_id_t &table_id,
@@ -219,6 +283,17 @@ double parsed_stats_t::accumulate_table(const namespace_id_t &table_id,
     return res;
 }
 
+bool parsed_stats_t::cache_bytes_needed_known(const namespace_id_t &table_id) const {
+    for (auto const &server_pair : servers) {
+        auto const &table_it = server_pair.second.tables.find(table_id);
+        if (table_it != server_pair.second.tables.end()
+                && table_it->second.cache_bytes_needed_unknown) {
+            return false;
+        }
+    }
+    return true;
+}
+
 double parsed_stats_t::accumulate_server(const server_id_t &server_id,
                                          double table_stats_t::*field) const {
     double res = 0;
@@ -230,6 +305,28 @@ double parsed_stats_t::accumulate_server(const server_id_t &server_id,
     return res;
 }
 
+latency_histogram_t parsed_stats_t::merge_latency(
+        latency_histogram_t server_stats_t::*field) const {
+    latency_histogram_t res;
+    for (auto const &pair : servers) {
+        res.merge(pair.second.*field);
+    }
+    return res;
+}
+
+latency_histogram_t parsed_stats_t::merge_table_latency(
+        const namespace_id_t &table_id,
+        latency_histogram_t table_stats_t::*field) const {
+    latency_histogram_t res;
+    for (auto const &server_pair : servers) {
+        auto const &table_it = server_pair.second.tables.find(table_id);
+        if (table_it != server_pair.second.tables.end()) {
+            res.merge(table_it->second.*field);
+        }
+    }
+    return res;
+}
+
 bool add_table_fields(const namespace_id_t &table_id,
                       const cluster_semilattice_metadata_t &metadata,
                       table_meta_client_t *table_meta_client,
@@ -253,6 +350,7 @@ bool add_table_fields(const namespace_id_t &table_id,
 std::set<std::vector<std::string> > stats_request_t::global_stats_filter() {
     return std::set<std::vector<std::string> >(
         { {"query_engine"},
+          {"eventloop_threads"},
           {"[0-9A-Fa-f-]+", "serializers" } });
 }
 
@@ -312,6 +410,7 @@ bool cluster_stats_request_t::to_datum(const parsed_stats_t &stats,
     ADD_CLUSTER_SERVER_STAT(qe_builder, stats, clients_active);
     ADD_CLUSTER_TABLE_STAT(qe_builder, stats, read_docs_per_sec);
     ADD_CLUSTER_TABLE_STAT(qe_builder, stats, written_docs_per_sec);
+    ADD_CLUSTER_LATENCY_STAT(qe_builder, stats, query_latency);
     row_builder.overwrite("query_engine", std::move(qe_builder).to_datum());
 
     *result_out = std::move(row_builder).to_datum();
@@ -344,7 +443,11 @@ table_stats_request_t::table_stats_request_t(const namespace_id_t &_table_id) :
 
 std::set<std::vector<std::string> > table_stats_request_t::get_filter() const {
     return std::set<std::vector<std::string> >({
-        { uuid_to_str(table_id), "serializers", "shard_[0-9]+", "btree-.*", "keys_.*" }
+        { uuid_to_str(table_id), "serializers", "shard_[0-9]+", "btree-.*", "keys_.*" },
+        { uuid_to_str(table_id), "serializers", "shard_[0-9]+", "cache",
+          "(miss_latency|recent_.*|bytes_needed_for_95_percent_hits)" },
+        { uuid_to_str(table_id), "serializers", "serializer",
+          "serializer_.*_latency" }
         });
 }
 
@@ -376,6 +479,28 @@ bool table_stats_request_t::to_datum(const parsed_stats_t &stats,
     ADD_TABLE_STAT(qe_builder, stats, table_id, written_docs_per_sec);
     row_builder.overwrite("query_engine", std::move(qe_builder).to_datum());
 
+    ql::datum_object_builder_t se_cache_builder;
+    se_cache_builder.overwrite("miss_latency", stats.merge_table_latency(
+        table_id, &parsed_stats_t::table_stats_t::cache_miss_latency).to_datum(false));
+    typedef parsed_stats_t::table_stats_t table_stats_t;
+    se_cache_builder.overwrite("hit_ratio", cache_hit_ratio_to_datum(
+        stats.accumulate_table(table_id, &table_stats_t::cache_recent_hits),
+        stats.accumulate_table(table_id, &table_stats_t::cache_recent_misses)));
+    se_cache_builder.overwrite("bytes_needed_for_95_percent_hits",
+        stats.cache_bytes_needed_known(table_id)
+            ? ql::datum_t(stats.accumulate_table(
+                table_id, &table_stats_t::cache_bytes_needed_for_95_percent_hits))
+            : ql::datum_t::null());
+
+    ql::datum_object_builder_t se_disk_builder;
+    ADD_TABLE_LATENCY_STAT(se_disk_builder, stats, table_id, read_latency);
+    ADD_TABLE_LATENCY_STAT(se_disk_builder, stats, table_id, write_latency);
+
+    ql::datum_object_builder_t se_builder;
+    se_builder.overwrite("cache", std::move(se_cache_builder).to_datum());
+    se_builder.overwrite("disk", std::move(se_disk_builder).to_datum());
+    row_builder.overwrite("storage_engine", std::move(se_builder).to_datum());
+
     *result_out = std::move(row_builder).to_datum();
     return true;
 }
@@ -407,6 +532,7 @@ server_stats_request_t::server_stats_request_t(const server_id_t &_server_id) :
 std::set<std::vector<std::string> > server_stats_request_t::get_filter() const {
     return std::set<std::vector<std::string> >(
         { {"query_engine"},
+          {"eventloop_threads"},
           {".*", "serializers", "shard_[0-9]+", "btree-.*" } });
 }
 
@@ -452,11 +578,15 @@ bool server_stats_request_t::to_datum(const parsed_stats_t &stats,
         ADD_STAT(qe_builder, server_stats, clients_active);
         ADD_STAT(qe_builder, server_stats, queries_per_sec);
         ADD_STAT(qe_builder, server_stats, queries_total);
+        ADD_LATENCY_STAT(qe_builder, server_stats, query_latency);
         ADD_SERVER_STAT(qe_builder, stats, server_id, read_docs_per_sec);
         ADD_SERVER_STAT(qe_builder, stats, server_id, read_docs_total);
         ADD_SERVER_STAT(qe_builder, stats, server_id, written_docs_per_sec);
         ADD_SERVER_STAT(qe_builder, stats, server_id, written_docs_total);
         row_builder.overwrite("query_engine", std::move(qe_builder).to_datum());
+        if (server_stats.event_loop.has()) {
+            row_builder.overwrite("event_loop", server_stats.event_loop);
+        }
     }
     *result_out = std::move(row_builder).to_datum();
     return true;
@@ -552,6 +682,18 @@ bool table_server_stats_request_t::to_datum(const parsed_stats_t &stats,
 
         ql::datum_object_builder_t se_cache_builder;
         ADD_STAT(se_cache_builder, table_stats, in_use_bytes);
+        se_cache_builder.overwrite("miss_latency",
+                                   table_stats.cache_miss_latency.to_datum(false));
+        se_cache_builder.overwrite("hits_total",
+                                   ql::datum_t(table_stats.cache_hits_total));
+        se_cache_builder.overwrite("misses_total",
+                                   ql::datum_t(table_stats.cache_misses_total));
+        se_cache_builder.overwrite("hit_ratio", cache_hit_ratio_to_datum(
+            table_stats.cache_recent_hits, table_stats.cache_recent_misses));
+        se_cache_builder.overwrite("bytes_needed_for_95_percent_hits",
+            table_stats.cache_bytes_needed_unknown
+                ? ql::datum_t::null()
+                : ql::datum_t(table_stats.cache_bytes_needed_for_95_percent_hits));
 
         ql::datum_object_builder_t se_disk_space_builder;
         ADD_STAT(se_disk_space_builder, table_stats, metadata_bytes);
@@ -564,6 +706,14 @@ bool table_server_stats_request_t::to_datum(const parsed_stats_t &stats,
         ADD_STAT(se_disk_builder, table_stats, read_bytes_total);
         ADD_STAT(se_disk_builder, table_stats, written_bytes_per_sec);
         ADD_STAT(se_disk_builder, table_stats, written_bytes_total);
+        ADD_STAT(se_disk_builder, table_stats, gc_written_bytes_total);
+        ADD_LATENCY_STAT(se_disk_builder, table_stats, read_latency);
+        ADD_LATENCY_STAT(se_disk_builder, table_stats, write_latency);
+        // Bytes rewritten by the garbage collector per byte written for the cache
+        se_disk_builder.overwrite("gc_write_amplification", ql::datum_t(
+            table_stats.block_written_bytes_total == 0 ? 0.0 :
+                table_stats.gc_written_bytes_total
+                / table_stats.block_written_bytes_total));
         se_disk_builder.overwrite("space_usage", std::move(se_disk_space_builder).to_datum());
 
         ql::datum_object_builder_t se_builder;
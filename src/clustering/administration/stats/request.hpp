@@ -9,6 +9,7 @@
 
 #include "clustering/administration/metadata.hpp"
 #include "containers/uuid.hpp"
+#include "perfmon/latency_histogram.hpp"
 #include "rdb_protocol/datum.hpp"
 
 class server_config_client_t;
@@ -28,6 +29,14 @@ public:
         double written_docs_per_sec;
         double written_docs_total;
         double in_use_bytes;
+        double cache_hits_total;
+        double cache_misses_total;
+        double cache_recent_hits;
+        double cache_recent_misses;
+        // The cache size at which 95% of recent accesses would have been hits, or
+        // unknown if any shard's estimate is unbounded
+        double cache_bytes_needed_for_95_percent_hits;
+        bool cache_bytes_needed_unknown;
         double metadata_bytes;
         double data_bytes;
         double garbage_bytes;
@@ -36,6 +45,12 @@ public:
         double read_bytes_total;
         double written_bytes_per_sec;
         double written_bytes_total;
+        double block_written_bytes_total;
+        double gc_written_bytes_total;
+
+        latency_histogram_t cache_miss_latency;
+        latency_histogram_t read_latency;
+        latency_histogram_t write_latency;
     };
 
     struct server_stats_t {
@@ -47,6 +62,12 @@ public:
         double client_connections;
         double clients_active;
 
+        latency_histogram_t query_latency;
+
+        // The busy ratio and stall count of each thread, from the "eventloop_threads"
+        // perfmon. Passed through as they are.
+        ql::datum_t event_loop;
+
         std::map<namespace_id_t, table_stats_t> tables;
     };
 
@@ -66,6 +87,18 @@ public:
     double accumulate_server(const server_id_t &server_id,
                              double table_stats_t::*field) const;
 
+    // Returns false if any server's cache can't estimate how much memory it would
+    // need for a 95% hit ratio on the table
+    bool cache_bytes_needed_known(const namespace_id_t &table_id) const;
+
+    // Merge a latency histogram in all servers
+    latency_histogram_t merge_latency(latency_histogram_t server_stats_t::*field) const;
+
+    // Merge a latency histogram in a specific table (across all servers)
+    latency_histogram_t merge_table_latency(
+        const namespace_id_t &table_id,
+        latency_histogram_t table_stats_t::*field) const;
+
     std::map<server_id_t, server_stats_t> servers;
 
 private:
@@ -81,6 +114,12 @@ private:
                              const std::string &key,
                              double *value_out);
 
+    // Merges a latency histogram into an existing one; like `add_perfmon_value`,
+    // this ignores missing values.
+    void merge_perfmon_latency(const ql::datum_t &perf,
+                               const std::string &key,
+                               latency_histogram_t *histogram_out);
+
     void store_shard_values(const ql::datum_t &shard_perf,
                             table_stats_t *stats_out);
 
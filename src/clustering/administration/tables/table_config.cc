@@ -275,6 +275,42 @@ bool convert_flush_interval_from_datum(
     return true;
 }
 
+ql::datum_t convert_compaction_to_datum(const compaction_config_t &compaction) {
+    switch (compaction.mode) {
+        case gc_mode_t::AUTOMATIC:
+            return ql::datum_t("auto");
+        case gc_mode_t::PAUSED:
+            return ql::datum_t("paused");
+        case gc_mode_t::FORCED:
+        default:
+            unreachable();
+    }
+}
+
+bool convert_compaction_from_datum(
+        const ql::datum_t &datum,
+        const compaction_config_t &old_compaction,
+        compaction_config_t *compaction_out,
+        admin_err_t *error_out) {
+    compaction_out->forced_generation = old_compaction.forced_generation;
+    if (datum == ql::datum_t("auto")) {
+        compaction_out->mode = gc_mode_t::AUTOMATIC;
+    } else if (datum == ql::datum_t("paused")) {
+        compaction_out->mode = gc_mode_t::PAUSED;
+    } else if (datum == ql::datum_t("forced")) {
+        /* The table goes back to "auto" once the forced compaction is done, so that's
+        what we store and what reading the config returns from now on. */
+        compaction_out->mode = gc_mode_t::AUTOMATIC;
+        compaction_out->forced_generation = old_compaction.forced_generation + 1;
+    } else {
+        *error_out = admin_err_t{
+            "Expected \"auto\", \"paused\", or \"forced\", got: " + datum.print(),
+            query_state_t::FAILED};
+        return false;
+    }
+    return true;
+}
+
 ql::datum_t convert_table_config_shard_to_datum(
         const table_config_t::shard_t &shard,
         admin_identifier_format_t identifier_format,
@@ -461,6 +497,7 @@ ql::datum_t convert_table_config_to_datum(
     builder.overwrite("flush_interval",
         convert_flush_interval_to_datum(config.flush_interval));
     builder.overwrite("data", config.user_data.datum);
+    builder.overwrite("compaction", convert_compaction_to_datum(config.compaction));
     return std::move(builder).to_datum();
 }
 
@@ -703,6 +740,23 @@ bool convert_table_config_and_name_from_datum(
         config_out->user_data = default_user_data();
     }
 
+    if (existed_before || converter.has("compaction")) {
+        ql::datum_t compaction_datum;
+        if (!converter.get("compaction", &compaction_datum, error_out)) {
+            return false;
+        }
+        if (!convert_compaction_from_datum(
+                compaction_datum,
+                existed_before ? old_config.config.compaction : compaction_config_t(),
+                &config_out->compaction,
+                error_out)) {
+            error_out->msg = "In `compaction`: " + error_out->msg;
+            return false;
+        }
+    } else {
+        config_out->compaction = compaction_config_t();
+    }
+
     if (!converter.check_no_extra_keys(error_out)) {
         return false;
     }
@@ -26,6 +26,14 @@ ql::datum_t convert_table_config_to_datum(
 ql::datum_t convert_write_hook_to_datum(
     const optional<write_hook_config_t> &write_hook);
 
+/* These are exposed for the unit tests. */
+ql::datum_t convert_compaction_to_datum(const compaction_config_t &compaction);
+bool convert_compaction_from_datum(
+    const ql::datum_t &datum,
+    const compaction_config_t &old_compaction,
+    compaction_config_t *compaction_out,
+    admin_err_t *error_out);
+
 class table_config_artificial_table_backend_t :
     public common_table_artificial_table_backend_t
 {
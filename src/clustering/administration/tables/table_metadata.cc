@@ -34,6 +34,8 @@ RDB_IMPL_EQUALITY_COMPARABLE_1(user_data_t, datum);
 
 RDB_IMPL_EQUALITY_COMPARABLE_1(flush_interval_config_t, variant);
 
+RDB_IMPL_EQUALITY_COMPARABLE_2(compaction_config_t, mode, forced_generation);
+
 RDB_DECLARE_SERIALIZABLE(table_config_t);
 
 template <cluster_version_t W>
@@ -68,6 +70,7 @@ archive_result_t deserialize_table_config_pre_v2_4(
     tc->durability = std::move(durability);
     tc->flush_interval = default_flush_interval_config();
     tc->user_data = default_user_data();
+    tc->compaction = compaction_config_t();
 
     return res;
 }
@@ -108,7 +111,8 @@ archive_result_t deserialize_table_config_v2_4(
                          std::move(write_ack_config),
                          std::move(durability),
                          default_flush_interval_config(),
-                         default_user_data()};
+                         default_user_data(),
+                         compaction_config_t()};
 
     return res;
 }
@@ -137,13 +141,13 @@ archive_result_t deserialize<cluster_version_t::v2_4>(
     return deserialize_table_config_v2_4(s, tc);
 }
 
-RDB_IMPL_SERIALIZABLE_8_SINCE_v2_5(table_config_t,
+RDB_IMPL_SERIALIZABLE_9_SINCE_v2_5(table_config_t,
     basic, shards, write_hook, sindexes, write_ack_config, durability,
-    flush_interval, user_data);
+    flush_interval, user_data, compaction);
 
-RDB_IMPL_EQUALITY_COMPARABLE_8(table_config_t,
+RDB_IMPL_EQUALITY_COMPARABLE_9(table_config_t,
     basic, shards, write_hook, sindexes, write_ack_config, durability,
-    flush_interval, user_data);
+    flush_interval, user_data, compaction);
 
 RDB_IMPL_SERIALIZABLE_1_SINCE_v1_16(table_shard_scheme_t, split_points);
 RDB_IMPL_EQUALITY_COMPARABLE_1(table_shard_scheme_t, split_points);
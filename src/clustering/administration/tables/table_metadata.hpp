@@ -21,6 +21,7 @@
 #include "rpc/semilattice/joins/map.hpp"
 #include "rpc/semilattice/joins/versioned.hpp"
 #include "rpc/serialize_macros.hpp"
+#include "serializer/types.hpp"
 
 /* This is the metadata for a single table. */
 
@@ -70,6 +71,30 @@ flush_interval_config_t default_flush_interval_config();
 
 RDB_MAKE_SERIALIZABLE_1(flush_interval_config_t, variant);
 
+ARCHIVE_PRIM_MAKE_RANGED_SERIALIZABLE(
+    gc_mode_t,
+    int8_t,
+    gc_mode_t::AUTOMATIC,
+    gc_mode_t::FORCED);
+
+/* How eagerly the serializers that store the table's data compact their files. This
+is applied to every replica by the `compaction_manager_t`.
+
+`mode` is either `AUTOMATIC` or `PAUSED`. A forced compaction isn't a mode that the table
+stays in, since the serializer goes back to automatic compaction once it's done. Instead
+every request for one bumps `forced_generation`, and replicas start a forced compaction
+whenever they see it change. */
+class compaction_config_t {
+public:
+    compaction_config_t() : mode(gc_mode_t::AUTOMATIC), forced_generation(0) { }
+    explicit compaction_config_t(gc_mode_t _mode)
+        : mode(_mode), forced_generation(0) { }
+    gc_mode_t mode;
+    uint64_t forced_generation;
+};
+
+RDB_MAKE_SERIALIZABLE_2(compaction_config_t, mode, forced_generation);
+
 class user_data_t {
 public:
     ql::datum_t datum;
@@ -107,6 +132,7 @@ public:
     write_durability_t durability;
     flush_interval_config_t flush_interval;
     user_data_t user_data;  // has user-exposed name "data"
+    compaction_config_t compaction;
 };
 
 RDB_DECLARE_EQUALITY_COMPARABLE(table_config_t);
@@ -524,7 +524,12 @@ private:
     public:
         raft_term_t term;
         bool success;
-        RDB_MAKE_ME_SERIALIZABLE_2(append_entries_t, term, success);
+        /* `last_log_index` is the index of the last entry in the follower's log. It
+        doesn't correspond to anything in the Raft paper; the leader uses it after a
+        rejection to skip straight to the end of the follower's log instead of backing
+        off one entry at a time. */
+        raft_log_index_t last_log_index;
+        RDB_MAKE_ME_SERIALIZABLE_3(append_entries_t, term, success, last_log_index);
     };
 
     boost::variant<request_vote_t, install_snapshot_t, append_entries_t> reply;
@@ -728,6 +733,19 @@ public:
         const std::set<raft_member_t<state_t> *> &members);
 #endif
 
+    /* When the number of committed entries in the log exceeds this number, we will take
+    a snapshot to compress them. */
+    static const size_t snapshot_threshold = 20;
+
+    /* When we take a snapshot, we keep this many of the most recently committed entries
+    in the log instead of compressing all of them. A follower that falls behind by less
+    than this (for example because it restarted) can then catch up by receiving just the
+    missing entries in an append-entries RPC, instead of an install-snapshot RPC that
+    contains the entire state. */
+    static const size_t snapshot_retained_entries = 10;
+    static_assert(snapshot_retained_entries < snapshot_threshold,
+                  "A snapshot must compress at least one entry.");
+
 private:
     enum class mode_t {
         follower,
@@ -747,10 +765,6 @@ private:
     the maximum value set here: */
     const int32_t election_retry_timeout_max_ms = 30000;
 
-    /* When the number of committed entries in the log exceeds this number, we will take
-    a snapshot to compress them. */
-    const size_t snapshot_threshold = 20;
-
     /* Note: Methods prefixed with `follower_`, `candidate_`, or `leader_` are methods
     that are only used when in that state. This convention will hopefully make the code
     slightly clearer. */
@@ -50,6 +50,12 @@ raft_persistent_state_t<state_t>::make_initial(
     return ps;
 }
 
+template<class state_t>
+const size_t raft_member_t<state_t>::snapshot_threshold;
+
+template<class state_t>
+const size_t raft_member_t<state_t>::snapshot_retained_entries;
+
 template<class state_t>
 raft_member_t<state_t>::raft_member_t(
         const raft_member_id_t &_this_member_id,
@@ -634,6 +640,7 @@ void raft_member_t<state_t>::on_append_entries_rpc(
         itself" */
         reply_out->term = ps().current_term;
         reply_out->success = false;
+        reply_out->last_log_index = ps().log.get_latest_index();
         DEBUG_ONLY_CODE(check_invariants(&mutex_acq));
         return;
     }
@@ -651,6 +658,7 @@ void raft_member_t<state_t>::on_append_entries_rpc(
                     request.entries.prev_term)) {
         reply_out->term = ps().current_term;
         reply_out->success = false;
+        reply_out->last_log_index = ps().log.get_latest_index();
         DEBUG_ONLY_CODE(check_invariants(&mutex_acq));
         return;
     }
@@ -729,6 +737,7 @@ void raft_member_t<state_t>::on_append_entries_rpc(
 
     reply_out->term = ps().current_term;
     reply_out->success = true;
+    reply_out->last_log_index = ps().log.get_latest_index();
 
     DEBUG_ONLY_CODE(check_invariants(&mutex_acq));
 }
@@ -1168,28 +1177,52 @@ void raft_member_t<state_t>::update_commit_index(
         token->sentry.reset();
     }
 
+    size_t num_committed_entries = new_commit_index - ps().log.prev_index;
 #ifndef NDEBUG
-    /* In debug mode, snapshot randomly with 1/3 probability after each change. This is
-    so that the tests will exercise many different code paths. */
+    /* In debug mode, snapshot randomly with 1/3 probability after each change, and
+    retain a random number of committed entries. This is so that the tests will exercise
+    many different code paths. */
     bool should_take_snapshot = (randint(3) == 0);
+    size_t num_retained_entries = std::min<size_t>(
+        randint(snapshot_retained_entries + 1), num_committed_entries);
 #else
     /* In release mode, snapshot when the log grows beyond a certain margin. */
-    size_t num_committed_entries = new_commit_index - ps().log.prev_index;
     bool should_take_snapshot = (num_committed_entries > snapshot_threshold);
+    size_t num_retained_entries = snapshot_retained_entries;
 #endif /* NDEBUG */
-    if (should_take_snapshot) {
+    raft_log_index_t snapshot_index = new_commit_index - num_retained_entries;
+    if (should_take_snapshot && snapshot_index > ps().log.prev_index) {
         /* Take a snapshot as described in Section 7.
 
         This automatically updates `ps().log.prev_index` and `ps().log.prev_term`, which
         are equivalent to the "last included index" and "last included term" described in
-        Section 7 of the Raft paper.*/
-        storage->write_snapshot(
-            committed_state.get_ref().state,
-            committed_state.get_ref().config,
-            false,
-            new_commit_index,
-            ps().log.get_entry_term(new_commit_index),
-            new_commit_index);
+        Section 7 of the Raft paper.
+
+        We don't compress the most recent committed entries, so that lagging followers
+        can be brought up to date with just the entries they're missing. That means the
+        snapshot is usually older than `committed_state`, so we have to compute it by
+        applying the entries up to `snapshot_index` to the old snapshot. */
+        if (snapshot_index == new_commit_index) {
+            storage->write_snapshot(
+                committed_state.get_ref().state,
+                committed_state.get_ref().config,
+                false,
+                snapshot_index,
+                ps().log.get_entry_term(snapshot_index),
+                new_commit_index);
+        } else {
+            state_and_config_t snapshot(
+                ps().log.prev_index, ps().snapshot_state, ps().snapshot_config);
+            apply_log_entries(
+                &snapshot, ps().log, ps().log.prev_index + 1, snapshot_index);
+            storage->write_snapshot(
+                snapshot.state,
+                snapshot.config,
+                false,
+                snapshot_index,
+                ps().log.get_entry_term(snapshot_index),
+                new_commit_index);
+        }
     }
 
     /* If we just committed the second step of a config change, then we might need to
@@ -1902,8 +1935,13 @@ void raft_member_t<state_t>::leader_send_updates(
                     member_commit_index = request.leader_commit;
                 } else {
                     /* Raft paper, Section 5.3: "After a rejection, the leader decrements
-                    nextIndex and retries the AppendEntries RPC. */
-                    --next_index;
+                    nextIndex and retries the AppendEntries RPC.
+                    This implementation deviates from the Raft paper in that if the
+                    follower's log is shorter than `next_index - 1`, we jump directly to
+                    the end of the follower's log. Otherwise a follower that is far
+                    behind (for example after a restart) would need one round-trip per
+                    missing entry. */
+                    next_index = std::min(next_index - 1, reply->last_log_index + 1);
                 }
                 send_even_if_empty = false;
 
@@ -57,6 +57,18 @@ public:
         signal_t *get_preempt_signal() {
             return &preempt_signal;
         }
+        /* `consume_write_budget()` blocks until the backfill is allowed to write another
+        `bytes` bytes of backfill items to the store. The bytes are the in-memory size
+        of the items, not what ends up going to disk. After the items are written,
+        `report_write_latency()` tells the throttler how long it took, so it can back off
+        if the disk is busy serving other requests. */
+        void consume_write_budget(size_t bytes, signal_t *interruptor)
+                THROWS_ONLY(interrupted_exc_t) {
+            parent->consume_write_budget(this, bytes, interruptor);
+        }
+        void report_write_latency(size_t bytes, double secs) {
+            parent->report_write_latency(this, bytes, secs);
+        }
         const priority_t priority;
     private:
         friend class backfill_throttler_t;
@@ -64,6 +76,13 @@ public:
         cond_t preempt_signal;
     };
 
+    /* `consume_read_budget()` blocks until the backfiller is allowed to read another
+    `bytes` bytes of backfill items out of its store. It doesn't take a `lock_t` because
+    the backfiller side of a backfill doesn't hold one; the budget is shared with the
+    writes of the backfills that this server receives. By default, it doesn't block. */
+    virtual void consume_read_budget(size_t, signal_t *)
+        THROWS_ONLY(interrupted_exc_t) { }
+
 protected:
     friend class lock_t;
 
@@ -72,6 +91,11 @@ protected:
     virtual void enter(lock_t *lock, signal_t *interruptor) = 0;
     virtual void exit(lock_t *lock) = 0;
 
+    /* By default, backfill I/O isn't limited at all. */
+    virtual void consume_write_budget(lock_t *, size_t, signal_t *)
+        THROWS_ONLY(interrupted_exc_t) { }
+    virtual void report_write_latency(lock_t *, size_t, double) { }
+
     /* This allows subclasses to signal locks' preempt signals even though
     `preempt_signal` is a private member of `lock_t` */
     void preempt(lock_t *lock) {
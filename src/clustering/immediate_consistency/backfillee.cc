@@ -217,8 +217,13 @@ private:
                     auto_drainer_t drainer;
                 } producer(this);
 
+                size_t batch_mem_size = items.get_mem_size();
+                callback->throttle_items(batch_mem_size, keepalive.get_drain_signal());
+                ticks_t write_start = get_ticks();
                 parent->store->receive_backfill(
                     subregion, &producer, keepalive.get_drain_signal());
+                callback->on_items_written(batch_mem_size,
+                    ticks_to_secs(ticks_t{get_ticks().nanos - write_start.nanos}));
             }
             /* We reached the end of the range to be backfilled. The callback may or may
             not have returned `false` at some point along the way. */
@@ -52,6 +52,13 @@ public:
     public:
         virtual bool on_progress(
             const region_map_t<version_t> &chunk) THROWS_NOTHING = 0;
+        /* `throttle_items()` is called before each batch of backfill items is written to
+        the store, with the total mem size of the batch. It may block to limit the rate
+        at which the backfill writes. `on_items_written()` is called afterwards with the
+        time the write took. */
+        virtual void throttle_items(size_t, signal_t *)
+            THROWS_ONLY(interrupted_exc_t) { }
+        virtual void on_items_written(size_t, double) THROWS_NOTHING { }
     protected:
         virtual ~callback_t() { }
     };
@@ -1,6 +1,7 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include "clustering/immediate_consistency/backfiller.hpp"
 
+#include "clustering/immediate_consistency/backfill_throttler.hpp"
 #include "clustering/immediate_consistency/history.hpp"
 #include "rdb_protocol/distribution_progress.hpp"
 #include "rdb_protocol/protocol.hpp"
@@ -9,10 +10,12 @@
 backfiller_t::backfiller_t(
         mailbox_manager_t *_mailbox_manager,
         branch_history_manager_t *_branch_history_manager,
-        store_view_t *_store) :
+        store_view_t *_store,
+        backfill_throttler_t *_backfill_throttler) :
     mailbox_manager(_mailbox_manager),
     branch_history_manager(_branch_history_manager),
     store(_store),
+    backfill_throttler(_backfill_throttler),
     registrar(mailbox_manager, this)
     { }
 
@@ -352,6 +355,14 @@ private:
                     what it was before */
                 }
 
+                /* Charge what we just read to the backfill budget. If we get
+                interrupted here, nothing has been sent yet, so it's as if we had been
+                interrupted during `send_backfill()`. */
+                if (parent->parent->backfill_throttler != nullptr) {
+                    parent->parent->backfill_throttler->consume_read_budget(
+                        chunk.get_mem_size(), keepalive.get_drain_signal());
+                }
+
                 /* Check if we actually got a non-empty chunk; if we got an empty chunk
                 there's no point in sending it over the network. Note that we use
                 `empty_domain()` instead of `empty_of_items()`, because the knowledge
@@ -11,6 +11,7 @@
 #include "store_view.hpp"
 
 class backfill_progress_tracker_t;
+class backfill_throttler_t;
 
 /* `backfiller_t` is responsible for copying the given store's state to other servers via
 `backfillee_t`.
@@ -20,13 +21,17 @@ apply writes along the current branch. In particular, it might break if the unde
 store receives a backfill, changes branches, or erases data while the `backfiller_t`
 exists. (If the underlying store is a `store_subview_t`, it's OK if other changes happen
 to the underlying store's underlying store outside of the region covered by the
-`store_subview_t`.) */
+`store_subview_t`.)
+
+If `backfill_throttler` isn't `nullptr`, the items that the `backfiller_t` reads out of
+the store are charged to its budget. */
 
 class backfiller_t : public home_thread_mixin_debug_only_t {
 public:
     backfiller_t(mailbox_manager_t *_mailbox_manager,
                  branch_history_manager_t *_branch_history_manager,
-                 store_view_t *_store);
+                 store_view_t *_store,
+                 backfill_throttler_t *_backfill_throttler);
 
     backfiller_bcard_t get_business_card() {
         return backfiller_bcard_t {
@@ -111,6 +116,7 @@ private:
     mailbox_manager_t *const mailbox_manager;
     branch_history_manager_t *const branch_history_manager;
     store_view_t *const store;
+    backfill_throttler_t *const backfill_throttler;
 
     registrar_t<backfiller_bcard_t::intro_1_t, backfiller_t *, client_t> registrar;
 
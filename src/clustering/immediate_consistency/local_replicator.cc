@@ -9,6 +9,7 @@ local_replicator_t::local_replicator_t(
         primary_dispatcher_t *primary,
         store_view_t *_store,
         branch_history_manager_t *bhm,
+        backfill_throttler_t *backfill_throttler,
         signal_t *interruptor) :
     store(_store),
     replica(
@@ -16,7 +17,8 @@ local_replicator_t::local_replicator_t(
         store,
         bhm,
         primary->get_branch_id(),
-        primary->get_branch_birth_certificate().initial_timestamp)
+        primary->get_branch_birth_certificate().initial_timestamp,
+        backfill_throttler)
 {
     order_source_t order_source;
 
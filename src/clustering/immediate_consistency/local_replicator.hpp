@@ -25,6 +25,7 @@ public:
         primary_dispatcher_t *primary,
         store_view_t *store,
         branch_history_manager_t *bhm,
+        backfill_throttler_t *backfill_throttler,
         signal_t *interruptor);
 
     /* This destructor can block */
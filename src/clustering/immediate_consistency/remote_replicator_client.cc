@@ -162,6 +162,8 @@ remote_replicator_client_t::remote_replicator_client_t(
 
     next_write_waiter_(nullptr),
 
+    batched_ack_count_(0),
+
     write_async_mailbox_(mailbox_manager,
         std::bind(&remote_replicator_client_t::on_write_async, this,
             ph::_1, ph::_2, ph::_3, ph::_4, ph::_5)),
@@ -198,6 +200,7 @@ remote_replicator_client_t::remote_replicator_client_t(
             mailbox_manager,
             [&](signal_t *, const remote_replicator_client_intro_t &i) {
                 intro = i;
+                batched_ack_addr_ = intro.batched_ack_mailbox;
                 mode_ = backfill_mode_t::PAUSED;
                 timestamp_enforcer_.init(new timestamp_enforcer_t(
                     intro.streaming_begin_timestamp));
@@ -270,8 +273,9 @@ remote_replicator_client_t::remote_replicator_client_t(
         lock tells us to pause again */
         class callback_t : public backfillee_t::callback_t {
         public:
-            callback_t(remote_replicator_client_t *p, signal_t *ps) :
-                parent(p), preempt_signal(ps) { }
+            callback_t(remote_replicator_client_t *p,
+                       backfill_throttler_t::lock_t *l) :
+                parent(p), throttler_lock(l) { }
             bool on_progress(const region_map_t<version_t> &chunk) THROWS_NOTHING {
                 mutex_assertion_t::acq_t mutex_assertion_acq(&parent->mutex_assertion_);
                 chunk.visit(chunk.get_domain(),
@@ -287,11 +291,18 @@ remote_replicator_client_t::remote_replicator_client_t(
                  ok to backfill because of secondary index construction, then interrupt
                 `backfillee.go()` */
                 return parent->store_->check_ok_to_receive_backfill()
-                    && !preempt_signal->is_pulsed();
+                    && !throttler_lock->get_preempt_signal()->is_pulsed();
+            }
+            void throttle_items(size_t mem_size, signal_t *interruptor2)
+                    THROWS_ONLY(interrupted_exc_t) {
+                throttler_lock->consume_write_budget(mem_size, interruptor2);
+            }
+            void on_items_written(size_t mem_size, double secs) THROWS_NOTHING {
+                throttler_lock->report_write_latency(mem_size, secs);
             }
             remote_replicator_client_t *parent;
-            signal_t *preempt_signal;
-        } callback(this, backfill_throttler_lock.get_preempt_signal());
+            backfill_throttler_t::lock_t *throttler_lock;
+        } callback(this, &backfill_throttler_lock);
 
         backfillee.go(
             &callback,
@@ -345,7 +356,8 @@ remote_replicator_client_t::remote_replicator_client_t(
         /* Now we're completely up-to-date and synchronized with the primary, it's time
         to create a `replica_t`. */
         replica_.init(new replica_t(mailbox_manager_, store_, branch_history_manager,
-            branch_id, timestamp_enforcer_->get_latest_all_before_completed()));
+            branch_id, timestamp_enforcer_->get_latest_all_before_completed(),
+            backfill_throttler));
 
         tracker_.reset();   /* we don't need `tracker_` anymore */
         mode_ = backfill_mode_t::STREAMING;
@@ -463,7 +475,27 @@ void remote_replicator_client_t::on_write_sync(
     replica_->do_write(
         write, timestamp, order_token, durability,
         interruptor, &response);
-    send(mailbox_manager_, ack_addr, response);
+    if (durability == write_durability_t::HARD) {
+        send_batched_ack(timestamp, std::move(response));
+    } else {
+        send(mailbox_manager_, ack_addr, response);
+    }
+}
+
+void remote_replicator_client_t::send_batched_ack(
+        state_timestamp_t timestamp,
+        write_response_t &&response) {
+    bool is_sender = pending_batched_acks_.empty();
+    pending_batched_acks_.insert(std::make_pair(timestamp, std::move(response)));
+    if (is_sender) {
+        /* All of the writes covered by the same group commit were woken up at the same
+        time. Yielding lets them add their responses before we send the batch. */
+        coro_t::yield();
+        std::map<state_timestamp_t, write_response_t> batch;
+        batch.swap(pending_batched_acks_);
+        ++batched_ack_count_;
+        send(mailbox_manager_, batched_ack_addr_, batch);
+    }
 }
 
 void remote_replicator_client_t::on_dummy_write(
@@ -2,6 +2,7 @@
 #ifndef CLUSTERING_IMMEDIATE_CONSISTENCY_REMOTE_REPLICATOR_CLIENT_HPP_
 #define CLUSTERING_IMMEDIATE_CONSISTENCY_REMOTE_REPLICATOR_CLIENT_HPP_
 
+#include <map>
 #include <queue>
 
 #include "clustering/generic/registrant.hpp"
@@ -75,6 +76,10 @@ public:
 
     ~remote_replicator_client_t();
 
+    /* How many batched acks we've sent to the primary so far. Each one covers every
+    hard-durability write that a single group commit made durable. */
+    int64_t get_batched_ack_count() const { return batched_ack_count_; }
+
 private:
     class timestamp_range_tracker_t;
 
@@ -103,6 +108,11 @@ private:
             const mailbox_t<write_response_t>::address_t &ack_addr)
         THROWS_ONLY(interrupted_exc_t);
 
+    /* `send_batched_ack()` is used by `on_write_sync()` for hard-durability writes. The
+    replica group-commits those writes, so many of them become durable at the same time;
+    their responses are collected and sent to the primary in a single message. */
+    void send_batched_ack(state_timestamp_t timestamp, write_response_t &&response);
+
     void on_read(
             signal_t *interruptor,
             const read_t &read,
@@ -165,6 +175,13 @@ private:
     `on_write_async()` has to wait for it before proceeding. */
     cond_t registered_;
 
+    /* `batched_ack_addr_` comes from the intro we get from the primary.
+    `pending_batched_acks_` holds the responses that `send_batched_ack()` hasn't sent
+    yet. */
+    remote_replicator_client_intro_t::batched_ack_mailbox_t::address_t batched_ack_addr_;
+    std::map<state_timestamp_t, write_response_t> pending_batched_acks_;
+    int64_t batched_ack_count_;
+
     /* `cleanup_rwlock_` is used to temporarily lock out writes when doing the very last
     phase of the backfill. Writes acquire it in read mode; the last phase of the backfill
     acquires it in write mode. */
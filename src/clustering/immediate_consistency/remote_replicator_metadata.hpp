@@ -2,6 +2,8 @@
 #ifndef CLUSTERING_IMMEDIATE_CONSISTENCY_REMOTE_REPLICATOR_METADATA_HPP_
 #define CLUSTERING_IMMEDIATE_CONSISTENCY_REMOTE_REPLICATOR_METADATA_HPP_
 
+#include <map>
+
 #include "clustering/generic/registration_metadata.hpp"
 #include "clustering/immediate_consistency/history.hpp"
 #include "rdb_protocol/protocol.hpp"
@@ -10,8 +12,19 @@ class remote_replicator_client_intro_t {
 public:
     typedef mailbox_t<> ready_mailbox_t;
 
+    /* Hard-durability writes are not acknowledged one at a time. Instead, the client
+    group-commits them and sends the responses for every write covered by a flush in a
+    single message to `batched_ack_mailbox`, keyed by timestamp.
+
+    Note that `batched_ack_mailbox` is part of the intro's cluster serialization, so a
+    server from before it was added can't exchange intros with one that has it. */
+    typedef mailbox_t<
+        std::map<state_timestamp_t, write_response_t>
+        > batched_ack_mailbox_t;
+
     state_timestamp_t streaming_begin_timestamp;
     ready_mailbox_t::address_t ready_mailbox;
+    batched_ack_mailbox_t::address_t batched_ack_mailbox;
 };
 
 RDB_DECLARE_SERIALIZABLE(remote_replicator_client_intro_t);
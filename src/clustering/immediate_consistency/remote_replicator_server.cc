@@ -1,6 +1,8 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include "clustering/immediate_consistency/remote_replicator_server.hpp"
 
+#include "containers/map_sentries.hpp"
+
 remote_replicator_server_t::remote_replicator_server_t(
         mailbox_manager_t *_mailbox_manager,
         primary_dispatcher_t *_primary) :
@@ -16,7 +18,10 @@ remote_replicator_server_t::proxy_replica_t::proxy_replica_t(
     client_bcard(_client_bcard), parent(_parent), is_ready(false),
     ready_mailbox(
         parent->mailbox_manager,
-        std::bind(&proxy_replica_t::on_ready, this, ph::_1))
+        std::bind(&proxy_replica_t::on_ready, this, ph::_1)),
+    batched_ack_mailbox(
+        parent->mailbox_manager,
+        std::bind(&proxy_replica_t::on_batched_ack, this, ph::_1, ph::_2))
 {
     state_timestamp_t first_timestamp;
     registration = make_scoped<primary_dispatcher_t::dispatchee_registration_t>(
@@ -24,7 +29,8 @@ remote_replicator_server_t::proxy_replica_t::proxy_replica_t(
     send(parent->mailbox_manager, client_bcard.intro_mailbox,
         remote_replicator_client_intro_t {
             first_timestamp,
-            ready_mailbox.get_address() });
+            ready_mailbox.get_address(),
+            batched_ack_mailbox.get_address() });
 }
 
 void remote_replicator_server_t::proxy_replica_t::do_read(
@@ -53,6 +59,20 @@ void remote_replicator_server_t::proxy_replica_t::do_write_sync(
         signal_t *interruptor,
         write_response_t *response_out) {
     guarantee(is_ready);
+    if (durability == write_durability_t::HARD) {
+        /* The response will arrive through `batched_ack_mailbox`, together with the
+        responses of the other writes that the replica flushed at the same time. */
+        cond_t got_response;
+        map_insertion_sentry_t<
+                state_timestamp_t, std::pair<write_response_t *, cond_t *> >
+            waiter(&batched_ack_waiters, timestamp,
+                std::make_pair(response_out, &got_response));
+        send(parent->mailbox_manager, client_bcard.write_sync_mailbox,
+            write, timestamp, order_token, durability,
+            mailbox_t<write_response_t>::address_t());
+        wait_interruptible(&got_response, interruptor);
+        return;
+    }
     cond_t got_response;
     mailbox_t<write_response_t> response_mailbox(
         parent->mailbox_manager,
@@ -103,3 +123,17 @@ void remote_replicator_server_t::proxy_replica_t::on_ready(signal_t *) {
     registration->mark_ready();
 }
 
+void remote_replicator_server_t::proxy_replica_t::on_batched_ack(
+        signal_t *,
+        const std::map<state_timestamp_t, write_response_t> &responses) {
+    ASSERT_FINITE_CORO_WAITING;
+    for (const auto &pair : responses) {
+        auto it = batched_ack_waiters.find(pair.first);
+        if (it == batched_ack_waiters.end()) {
+            /* The write was interrupted in the meantime. */
+            continue;
+        }
+        *it->second.first = pair.second;
+        it->second.second->pulse_if_not_already_pulsed();
+    }
+}
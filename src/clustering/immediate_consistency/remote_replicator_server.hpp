@@ -2,6 +2,9 @@
 #ifndef CLUSTERING_IMMEDIATE_CONSISTENCY_REMOTE_REPLICATOR_SERVER_HPP_
 #define CLUSTERING_IMMEDIATE_CONSISTENCY_REMOTE_REPLICATOR_SERVER_HPP_
 
+#include <map>
+#include <utility>
+
 #include "clustering/generic/registrar.hpp"
 #include "clustering/immediate_consistency/primary_dispatcher.hpp"
 #include "clustering/immediate_consistency/remote_replicator_metadata.hpp"
@@ -66,14 +69,27 @@ private:
     private:
         void on_ready(signal_t *interruptor);
 
+        /* `on_batched_ack()` receives the responses for a group of hard-durability
+        writes and wakes up the corresponding `do_write_sync()` calls. */
+        void on_batched_ack(
+            signal_t *interruptor,
+            const std::map<state_timestamp_t, write_response_t> &responses);
+
         remote_replicator_client_bcard_t client_bcard;
         remote_replicator_server_t *parent;
         bool is_ready;
 
+        /* Hard-durability writes that are waiting for a batched ack, keyed by
+        timestamp. */
+        std::map<state_timestamp_t, std::pair<write_response_t *, cond_t *> >
+            batched_ack_waiters;
+
         // The destruction order matters: The `ready_mailbox` callback assumes
-        // that `registration` is still valid.
+        // that `registration` is still valid, and the `batched_ack_mailbox` callback
+        // assumes that `batched_ack_waiters` is.
         scoped_ptr_t<primary_dispatcher_t::dispatchee_registration_t> registration;
         remote_replicator_client_intro_t::ready_mailbox_t ready_mailbox;
+        remote_replicator_client_intro_t::batched_ack_mailbox_t batched_ack_mailbox;
     };
 
     mailbox_manager_t *mailbox_manager;
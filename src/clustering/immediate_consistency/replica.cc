@@ -1,6 +1,7 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include "clustering/immediate_consistency/replica.hpp"
 
+#include "containers/map_sentries.hpp"
 #include "store_view.hpp"
 
 replica_t::replica_t(
@@ -8,13 +9,16 @@ replica_t::replica_t(
         store_view_t *_store,
         branch_history_manager_t *_bhm,
         const branch_id_t &_branch_id,
-        state_timestamp_t _timestamp) :
+        state_timestamp_t _timestamp,
+        backfill_throttler_t *_backfill_throttler) :
     mailbox_manager(_mailbox_manager),
     store(_store),
     branch_id(_branch_id),
     start_enforcer(_timestamp),
     end_enforcer(_timestamp),
-    backfiller(_mailbox_manager, _bhm, _store),
+    durable_timestamp(_timestamp),
+    group_commit_running(false),
+    backfiller(_mailbox_manager, _bhm, _store, _backfill_throttler),
     synchronize_mailbox(mailbox_manager,
         std::bind(&replica_t::on_synchronize, this, ph::_1, ph::_2, ph::_3))
     { }
@@ -88,6 +92,11 @@ void replica_t::do_write(
         });
 #endif
 
+    /* Hard-durability writes don't flush on their own. Instead they wait for a group
+    commit after the write has been applied, so that concurrent writes can share a
+    single flush. */
+    const bool group_commit = (durability == write_durability_t::HARD);
+
     // Perform the operation
     store->write(
         DEBUG_ONLY(metainfo_checker, )
@@ -96,7 +105,7 @@ void replica_t::do_write(
             binary_blob_t(version_t(branch_id, timestamp))),
         write,
         response_out,
-        durability,
+        group_commit ? write_durability_t::SOFT : durability,
         timestamp,
         order_token,
         &write_token,
@@ -104,6 +113,10 @@ void replica_t::do_write(
 
     /* Notify reads that were waiting for this write that it's OK to go */
     end_enforcer.complete(timestamp);
+
+    if (group_commit) {
+        wait_for_durability(timestamp, interruptor);
+    }
 }
 
 void replica_t::do_dummy_write(
@@ -113,6 +126,50 @@ void replica_t::do_dummy_write(
     response_out->response = dummy_write_response_t();
 }
 
+void replica_t::wait_for_durability(
+        state_timestamp_t timestamp,
+        signal_t *interruptor) {
+    assert_thread();
+    if (timestamp <= durable_timestamp) {
+        return;
+    }
+    cond_t waiter;
+    multimap_insertion_sentry_t<state_timestamp_t, cond_t *> sentry(
+        &durability_waiters, timestamp, &waiter);
+    if (!group_commit_running) {
+        group_commit_running = true;
+        coro_t::spawn_sometime(std::bind(
+            &replica_t::run_group_commits, this, drainer.lock()));
+    }
+    wait_interruptible(&waiter, interruptor);
+}
+
+void replica_t::run_group_commits(auto_drainer_t::lock_t keepalive) {
+    assert_thread();
+    try {
+        while (!durability_waiters.empty()
+                && durability_waiters.rbegin()->first > durable_timestamp) {
+            /* Every waiter registers itself only after its write transaction has been
+            committed, so the sync below covers all of the writes that are waiting right
+            now. Writes that arrive while it's running will be picked up by the next
+            iteration. */
+            state_timestamp_t target = durability_waiters.rbegin()->first;
+            write_token_t write_token;
+            store->new_write_token(&write_token);
+            store->sync(
+                order_token_t::ignore, &write_token, keepalive.get_drain_signal());
+            durable_timestamp = std::max(durable_timestamp, target);
+            for (auto it = durability_waiters.begin();
+                    it != durability_waiters.upper_bound(durable_timestamp); ++it) {
+                it->second->pulse_if_not_already_pulsed();
+            }
+        }
+    } catch (const interrupted_exc_t &) {
+        /* The `replica_t` is being destroyed. The waiters will be interrupted too. */
+    }
+    group_commit_running = false;
+}
+
 void replica_t::on_synchronize(
         signal_t *interruptor,
         state_timestamp_t timestamp,
@@ -2,6 +2,8 @@
 #ifndef CLUSTERING_IMMEDIATE_CONSISTENCY_REPLICA_HPP_
 #define CLUSTERING_IMMEDIATE_CONSISTENCY_REPLICA_HPP_
 
+#include <map>
+
 #include "clustering/immediate_consistency/backfill_metadata.hpp"
 #include "clustering/immediate_consistency/backfiller.hpp"
 #include "concurrency/timestamp_enforcer.hpp"
@@ -20,7 +22,8 @@ public:
         store_view_t *store,
         branch_history_manager_t *bhm,
         const branch_id_t &branch_id,
-        state_timestamp_t timestamp);
+        state_timestamp_t timestamp,
+        backfill_throttler_t *backfill_throttler);
 
     replica_bcard_t get_replica_bcard() {
         return replica_bcard_t {
@@ -37,7 +40,12 @@ public:
         read_response_t *response_out);
 
     /* Warning: If you interrupt `do_write()`, the `replica_t` will be left in an
-    undefined state, and you should destroy the `replica_t` soon after. */
+    undefined state, and you should destroy the `replica_t` soon after.
+
+    Hard-durability writes are group-committed: the write itself is applied with soft
+    durability, and then `do_write()` waits until a single flush covering every write
+    that's waiting for durability at that time has completed. See
+    `wait_for_durability()`. */
     void do_write(
         const write_t &write,
         state_timestamp_t timestamp,
@@ -51,6 +59,15 @@ public:
         write_response_t *response_out);
 
 private:
+    /* Blocks until every hard-durability write with a timestamp less than or equal to
+    `timestamp` has been flushed to disk. Writes that arrive while a flush is running
+    are collected and made durable together by the next flush. */
+    void wait_for_durability(state_timestamp_t timestamp, signal_t *interruptor);
+
+    /* Runs in a coroutine as long as there are writes waiting in
+    `durability_waiters`. */
+    void run_group_commits(auto_drainer_t::lock_t keepalive);
+
     void on_synchronize(
         signal_t *interruptor,
         state_timestamp_t timestamp,
@@ -65,9 +82,18 @@ private:
     has completed. */
     timestamp_enforcer_t start_enforcer, end_enforcer;
 
+    /* `durable_timestamp` is the latest timestamp such that every write waiting in
+    `wait_for_durability()` with a timestamp less than or equal to it has been flushed.
+    `durability_waiters` holds the writes that are still waiting for a flush. */
+    state_timestamp_t durable_timestamp;
+    std::multimap<state_timestamp_t, cond_t *> durability_waiters;
+    bool group_commit_running;
+
     backfiller_t backfiller;
 
     replica_bcard_t::synchronize_mailbox_t synchronize_mailbox;
+
+    auto_drainer_t drainer;
 };
 
 #endif /* CLUSTERING_IMMEDIATE_CONSISTENCY_REPLICA_HPP_ */
@@ -1,11 +1,92 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include "clustering/immediate_consistency/standard_backfill_throttler.hpp"
 
+#include "arch/timing.hpp"
 #include "concurrency/cross_thread_signal.hpp"
 #include "concurrency/wait_any.hpp"
 
 static const size_t max_active_backfills = 8;
 
+/* If the backfill budget is enabled, a backfill that takes longer than
+`write_latency_target_secs` to write a megabyte to the store makes us cut the refill
+rate in half. The rate never drops below `write_min_rate_fraction` of the configured
+budget, so backfills always make some progress. */
+static const double write_latency_target_secs = 0.25;
+static const double write_min_rate_fraction = 1.0 / 16;
+
+/* Writing a small batch is dominated by fixed overhead, so we don't adapt the rate based
+on batches smaller than this. */
+static const size_t write_min_latency_sample_bytes = 64 * KILOBYTE;
+
+backfill_budget_t::backfill_budget_t(uint64_t bytes_per_sec, ticks_t now) :
+    budget(static_cast<double>(bytes_per_sec)),
+    rate(budget),
+    tokens(budget),
+    last_refill(now) { }
+
+void backfill_budget_t::set_budget(uint64_t bytes_per_sec, ticks_t now) {
+    if (is_unlimited()) {
+        /* The bucket wasn't in use, so it starts out full. */
+        tokens = static_cast<double>(bytes_per_sec);
+    } else {
+        refill(now);
+    }
+    budget = static_cast<double>(bytes_per_sec);
+    rate = budget;
+    tokens = std::min(tokens, rate);
+    last_refill = now;
+}
+
+int64_t backfill_budget_t::take(size_t bytes, ticks_t now) {
+    if (is_unlimited()) {
+        return 0;
+    }
+    refill(now);
+    tokens -= static_cast<double>(bytes);
+    if (tokens < 0) {
+        return static_cast<int64_t>(-tokens * 1000 / rate) + 1;
+    } else {
+        return 0;
+    }
+}
+
+void backfill_budget_t::report_latency(size_t bytes, double secs, ticks_t now) {
+    if (is_unlimited() || bytes < write_min_latency_sample_bytes) {
+        return;
+    }
+    refill(now);
+    double secs_per_megabyte = secs * MEGABYTE / bytes;
+    if (secs_per_megabyte > write_latency_target_secs) {
+        rate = std::max(rate / 2, budget * write_min_rate_fraction);
+    } else {
+        rate = std::min(rate + budget * write_min_rate_fraction, budget);
+    }
+}
+
+void backfill_budget_t::refill(ticks_t now) {
+    if (now.nanos > last_refill.nanos) {
+        tokens += rate * ticks_to_secs(ticks_t{now.nanos - last_refill.nanos});
+        last_refill = now;
+    }
+    /* Don't let the bucket hold more than one second's worth of I/O, or backfills
+    could burst past the budget after an idle period. */
+    tokens = std::min(tokens, rate);
+}
+
+standard_backfill_throttler_t::standard_backfill_throttler_t() :
+    budget(0, get_ticks()),
+    budget_subscription([]() { }) { }
+
+standard_backfill_throttler_t::standard_backfill_throttler_t(
+        const clone_ptr_t<watchable_t<uint64_t> > &budget_bytes_per_sec) :
+    budget(budget_bytes_per_sec->get(), get_ticks()),
+    budget_subscription([this, budget_bytes_per_sec]() {
+        budget.set_budget(budget_bytes_per_sec->get(), get_ticks());
+    }) {
+    watchable_t<uint64_t>::freeze_t freeze(budget_bytes_per_sec);
+    budget_subscription.reset(budget_bytes_per_sec, &freeze);
+}
+
 standard_backfill_throttler_t::~standard_backfill_throttler_t() {
     guarantee(active.empty());
     guarantee(waiting.empty());
@@ -87,3 +168,29 @@ void standard_backfill_throttler_t::exit(lock_t *lock) {
     }
 }
 
+void standard_backfill_throttler_t::consume_read_budget(
+        size_t bytes, signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
+    consume_budget(bytes, interruptor);
+}
+
+void standard_backfill_throttler_t::consume_write_budget(
+        UNUSED lock_t *lock, size_t bytes, signal_t *interruptor_on_lock)
+        THROWS_ONLY(interrupted_exc_t) {
+    consume_budget(bytes, interruptor_on_lock);
+}
+
+void standard_backfill_throttler_t::report_write_latency(
+        UNUSED lock_t *lock, size_t bytes, double secs) {
+    on_thread_t thread_switcher(home_thread());
+    budget.report_latency(bytes, secs, get_ticks());
+}
+
+void standard_backfill_throttler_t::consume_budget(
+        size_t bytes, signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
+    cross_thread_signal_t interruptor_on_home(interruptor, home_thread());
+    on_thread_t thread_switcher(home_thread());
+    int64_t wait_ms = budget.take(bytes, get_ticks());
+    if (wait_ms > 0) {
+        nap(wait_ms, &interruptor_on_home);
+    }
+}
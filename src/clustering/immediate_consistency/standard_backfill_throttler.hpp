@@ -6,26 +6,93 @@
 
 #include "clustering/immediate_consistency/backfill_throttler.hpp"
 #include "concurrency/new_mutex.hpp"
+#include "concurrency/watchable.hpp"
+#include "time.hpp"
+
+/* `backfill_budget_t` is the token bucket behind the backfill budget. It counts the
+in-memory size of the backfill items that the backfiller reads out of its store and that
+the backfillee writes into its store. It refills at `bytes_per_sec`; readers and writers
+take tokens for every batch and wait while the bucket is in debt. If writing a batch takes
+longer than expected, which usually means that foreground queries are competing for the
+disk, the refill rate is halved; it then creeps back up towards the configured budget
+while the disk stays responsive.
+
+The caller passes in the current time, so that the bucket can be tested without
+sleeping. */
+
+class backfill_budget_t {
+public:
+    /* A `bytes_per_sec` of zero means that backfills are unlimited. */
+    backfill_budget_t(uint64_t bytes_per_sec, ticks_t now);
+
+    bool is_unlimited() const { return budget == 0; }
+
+    /* Changes the budget, for example because the server's config changed. The rate
+    starts over at the new budget. */
+    void set_budget(uint64_t bytes_per_sec, ticks_t now);
+
+    /* Takes `bytes` tokens out of the bucket and returns how many milliseconds the
+    caller has to wait before reading or writing them. The tokens are taken right away,
+    even if that puts the bucket in debt; callers that arrive later will have to wait for
+    the debt to be paid off too, so the budget is shared fairly in arrival order. */
+    int64_t take(size_t bytes, ticks_t now);
+
+    /* Adapts the refill rate to how long it took to write `bytes`. */
+    void report_latency(size_t bytes, double secs, ticks_t now);
+
+    double get_rate() const { return rate; }
+
+private:
+    void refill(ticks_t now);
+
+    double budget;
+    double rate;
+    double tokens;
+    ticks_t last_refill;
+};
 
 /* `standard_backfill_throttler_t` is the `backfill_throttler_t` that is used in
 production. It allows a fixed number of backfills total (currently 8); if there are more
 than 8 backfills trying to run, it will always allow the highest-priority backfills to go
-first, preempting the lower-priority backfills if necessary. */
+first, preempting the lower-priority backfills if necessary.
+
+It also enforces an optional `backfill_budget_t` shared by all of the server's
+backfills. The budget follows the `backfill_budget_bytes_per_sec` field of the server's
+config, so it can be changed while the server is running. */
 
 class standard_backfill_throttler_t : public backfill_throttler_t {
 public:
-    standard_backfill_throttler_t() { }
+    /* This constructor doesn't limit the backfill I/O at all. */
+    standard_backfill_throttler_t();
+    /* A budget of zero means that backfills are unlimited. */
+    explicit standard_backfill_throttler_t(
+        const clone_ptr_t<watchable_t<uint64_t> > &budget_bytes_per_sec);
     ~standard_backfill_throttler_t();
 
+    void consume_read_budget(size_t bytes, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t);
+
 private:
     void enter(lock_t *lock, signal_t *interruptor);
     void exit(lock_t *lock);
 
+    void consume_write_budget(lock_t *lock, size_t bytes, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t);
+    void report_write_latency(lock_t *lock, size_t bytes, double secs);
+
+    void consume_budget(size_t bytes, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t);
+
     std::multimap<priority_t, std::pair<lock_t *, cond_t *> > waiting;
     std::set<std::pair<priority_t, lock_t *> > active;
 
     new_mutex_t mutex;
+
+    backfill_budget_t budget;
+
+    /* Destructor order matters: `budget_subscription` must be destroyed before
+    `budget`, which it updates. */
+    watchable_t<uint64_t>::subscription_t budget_subscription;
 };
 
 #endif /* CLUSTERING_IMMEDIATE_CONSISTENCY_STANDARD_BACKFILL_THROTTLER_HPP_ */
-
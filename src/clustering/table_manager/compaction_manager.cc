@@ -0,0 +1,48 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "clustering/table_manager/compaction_manager.hpp"
+
+#include "concurrency/cross_thread_signal.hpp"
+#include "rdb_protocol/store.hpp"
+
+compaction_manager_t::compaction_manager_t(
+        multistore_ptr_t *multistore_,
+        const clone_ptr_t<watchable_t<table_config_t> > &table_config_) :
+    multistore(multistore_), table_config(table_config_),
+    update_pumper([this](signal_t *interruptor) { update_blocking(interruptor); }),
+    table_config_subs([this]() { update_pumper.notify(); })
+{
+    watchable_t<table_config_t>::freeze_t freeze(table_config);
+    /* A forced compaction that was requested before we started has either run
+    already, or was cut short by a restart. Either way we don't start another one. */
+    table_config->apply_read([&](const table_config_t *config) {
+        applied_forced_generation = config->compaction.forced_generation;
+    });
+    table_config_subs.reset(table_config, &freeze);
+    update_pumper.notify();
+}
+
+void compaction_manager_t::update_blocking(signal_t *interruptor) {
+    compaction_config_t compaction;
+    table_config->apply_read([&](const table_config_t *config) {
+        compaction = config->compaction;
+    });
+
+    gc_mode_t mode;
+    if (compaction.forced_generation != applied_forced_generation) {
+        mode = gc_mode_t::FORCED;
+    } else if (!applied_mode.has_value() || *applied_mode != compaction.mode) {
+        mode = compaction.mode;
+    } else {
+        return;
+    }
+
+    for (size_t i = 0; i < CPU_SHARDING_FACTOR; ++i) {
+        store_t *store = multistore->get_underlying_store(i);
+        cross_thread_signal_t ct_interruptor(interruptor, store->home_thread());
+        on_thread_t thread_switcher(store->home_thread());
+
+        store->set_gc_mode(mode);
+    }
+    applied_forced_generation = compaction.forced_generation;
+    applied_mode.set(compaction.mode);
+}
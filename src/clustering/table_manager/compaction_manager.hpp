@@ -0,0 +1,45 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef CLUSTERING_TABLE_MANAGER_COMPACTION_MANAGER_HPP_
+#define CLUSTERING_TABLE_MANAGER_COMPACTION_MANAGER_HPP_
+
+#include "clustering/table_contract/cpu_sharding.hpp"
+#include "clustering/administration/tables/table_metadata.hpp"
+#include "concurrency/pump_coro.hpp"
+#include "concurrency/watchable.hpp"
+
+/* The `compaction_manager_t` is responsible for reading the compaction mode from the
+`table_config_t` and passing it on to the serializer underneath the `store_t`s. This
+happens outside of any write transaction, because changing the mode may have to switch
+to the serializer's thread. */
+
+class compaction_manager_t {
+public:
+    compaction_manager_t(
+        multistore_ptr_t *multistore,
+        const clone_ptr_t<watchable_t<table_config_t> > &table_config);
+
+private:
+    void update_blocking(signal_t *interruptor);
+
+    multistore_ptr_t *const multistore;
+    clone_ptr_t<watchable_t<table_config_t> > const table_config;
+
+    /* The config's mode and forced generation when we last passed them on to the
+    stores. The config changes for all sorts of reasons, and we only want to tell the
+    stores about the changes that concern them. A forced compaction ends on its own, so
+    `applied_mode` stays the config's mode while it runs. Only accessed from the
+    constructor and from `update_blocking()`, which the `update_pumper` never runs twice
+    at once. */
+    optional<gc_mode_t> applied_mode;
+    uint64_t applied_forced_generation;
+
+    /* Destructor order matters: The `table_config_subs` must be destroyed before the
+    `update_pumper` because it calls `update_pumper.notify()`. But `update_pumper` must
+    be destroyed before the other variables because it runs `update_blocking()`, which
+    accesses the other variables. */
+    pump_coro_t update_pumper;
+
+    watchable_t<table_config_t>::subscription_t table_config_subs;
+};
+
+#endif /* CLUSTERING_TABLE_MANAGER_COMPACTION_MANAGER_HPP_ */
@@ -3,8 +3,30 @@
 
 #include "clustering/generic/raft_core.tcc"
 #include "clustering/table_manager/table_manager.hpp"
+#include "concurrency/pmap.hpp"
+#include "config/args.hpp"
 #include "logger.hpp"
 
+table_load_times_t load_tables_in_parallel(
+        size_t num_tables,
+        int64_t max_concurrent,
+        const std::function<void(size_t)> &load_stores,
+        const std::function<void(size_t)> &start_table_manager) {
+    table_load_times_t times;
+    times.store_load_nanos = 0;
+    times.table_manager_nanos = 0;
+    throttled_pmap(num_tables, [&](int64_t i) {
+        ticks_t t0 = get_ticks();
+        load_stores(i);
+        ticks_t t1 = get_ticks();
+        start_table_manager(i);
+        ticks_t t2 = get_ticks();
+        times.store_load_nanos += t1.nanos - t0.nanos;
+        times.table_manager_nanos += t2.nanos - t1.nanos;
+    }, max_concurrent);
+    return times;
+}
+
 multi_table_manager_t::multi_table_manager_t(
         const server_id_t &_server_id,
         mailbox_manager_t *_mailbox_manager,
@@ -18,7 +40,8 @@ multi_table_manager_t::multi_table_manager_t(
         table_persistence_interface_t *_persistence_interface,
         const base_path_t &_base_path,
         io_backender_t *_io_backender,
-        perfmon_collection_repo_t *_perfmon_collection_repo) :
+        perfmon_collection_repo_t *_perfmon_collection_repo,
+        const clone_ptr_t<watchable_t<uint64_t> > &backfill_budget_bytes_per_sec) :
     is_proxy_server(false),
     server_id(_server_id),
     mailbox_manager(_mailbox_manager),
@@ -29,29 +52,37 @@ multi_table_manager_t::multi_table_manager_t(
     persistence_interface(_persistence_interface),
     base_path(_base_path),
     io_backender(_io_backender),
-    perfmon_collection_repo(_perfmon_collection_repo) {
+    perfmon_collection_repo(_perfmon_collection_repo),
+    backfill_throttler(backfill_budget_bytes_per_sec) {
 
-    /* Resurrect any tables that were sitting on disk from when we last shut down */
+    /* Resurrect any tables that were sitting on disk from when we last shut down.
+    Reading the metadata is cheap, but loading a table's serializer and stores has to
+    read the serializer's LBA and metablock from disk. So we first read the metadata for
+    all tables, and then load the active tables in parallel. */
     cond_t non_interruptor;
+    ticks_t start_ticks = get_ticks();
+
+    class table_to_load_t {
+    public:
+        namespace_id_t table_id;
+        table_t *table;
+        table_active_persistent_state_t state;
+        raft_storage_interface_t<table_raft_state_t> *raft_storage;
+    };
+    std::vector<table_to_load_t> tables_to_load;
+    size_t num_inactive_tables = 0;
+
     persistence_interface->read_all_metadata(
         [&](const namespace_id_t &table_id,
                 const table_active_persistent_state_t &state,
                 raft_storage_interface_t<table_raft_state_t> *raft_storage,
-                metadata_file_t::read_txn_t *metadata_read_txn) {
+                metadata_file_t::read_txn_t *) {
             guarantee(tables.count(table_id) == 0);
             table_t *table;
             tables[table_id].init(table = new table_t);
-            rwlock_acq_t table_lock_acq(&table->access_rwlock, access_t::write);
-            perfmon_collection_repo_t::collections_t *perfmon_collections =
-                perfmon_collection_repo->get_perfmon_collections_for_namespace(table_id);
             table->status = table_t::status_t::ACTIVE;
-            persistence_interface->load_multistore(
-                table_id, metadata_read_txn, &table->multistore_ptr, &non_interruptor,
-                &perfmon_collections->serializers_collection);
-            table->active = make_scoped<active_table_t>(
-                this, table, table_id, state.epoch, state.raft_member_id, raft_storage,
-                raft_start_election_immediately_t::NO, table->multistore_ptr.get(),
-                &perfmon_collections->namespace_collection);
+            tables_to_load.push_back(
+                table_to_load_t { table_id, table, state, raft_storage });
         },
         [&](const namespace_id_t &table_id,
                 const table_inactive_persistent_state_t &state,
@@ -63,9 +94,53 @@ multi_table_manager_t::multi_table_manager_t(
             table->status = table_t::status_t::INACTIVE;
             table->basic_configs_entry.create(&table_basic_configs, table_id,
                 std::make_pair(state.second_hand_config, state.timestamp));
+            ++num_inactive_tables;
         },
         &non_interruptor);
 
+    ticks_t metadata_done_ticks = get_ticks();
+
+    table_load_times_t load_times = load_tables_in_parallel(
+        tables_to_load.size(),
+        MAX_CONCURRENT_TABLE_LOADS,
+        [&](size_t i) {
+            const table_to_load_t &t = tables_to_load[i];
+            perfmon_collection_repo_t::collections_t *perfmon_collections =
+                perfmon_collection_repo->get_perfmon_collections_for_namespace(
+                    t.table_id);
+            rwlock_acq_t table_lock_acq(&t.table->access_rwlock, access_t::write);
+            persistence_interface->create_multistore(
+                t.table_id, &t.table->multistore_ptr, &non_interruptor,
+                &perfmon_collections->serializers_collection);
+        },
+        [&](size_t i) {
+            const table_to_load_t &t = tables_to_load[i];
+            perfmon_collection_repo_t::collections_t *perfmon_collections =
+                perfmon_collection_repo->get_perfmon_collections_for_namespace(
+                    t.table_id);
+            rwlock_acq_t table_lock_acq(&t.table->access_rwlock, access_t::write);
+            t.table->active = make_scoped<active_table_t>(
+                this, t.table, t.table_id, t.state.epoch, t.state.raft_member_id,
+                t.raft_storage, raft_start_election_immediately_t::NO,
+                t.table->multistore_ptr.get(),
+                &perfmon_collections->namespace_collection);
+        });
+
+    if (!tables_to_load.empty() || num_inactive_tables != 0) {
+        ticks_t end_ticks = get_ticks();
+        logNTC("Loaded %zu active and %zu inactive tables in %.3fs (metadata: %.3fs, "
+               "loading %zu tables in parallel: %.3fs; total time spent loading "
+               "serializers and stores: %.3fs, starting table managers: %.3fs)\n",
+            tables_to_load.size(),
+            num_inactive_tables,
+            ticks_to_secs(ticks_t{end_ticks.nanos - start_ticks.nanos}),
+            ticks_to_secs(ticks_t{metadata_done_ticks.nanos - start_ticks.nanos}),
+            std::min<size_t>(tables_to_load.size(), MAX_CONCURRENT_TABLE_LOADS),
+            ticks_to_secs(ticks_t{end_ticks.nanos - metadata_done_ticks.nanos}),
+            ticks_to_secs(ticks_t{load_times.store_load_nanos}),
+            ticks_to_secs(ticks_t{load_times.table_manager_nanos}));
+    }
+
     help_construct();
 }
 
@@ -2,6 +2,8 @@
 #ifndef CLUSTERING_TABLE_MANAGER_MULTI_TABLE_MANAGER_HPP_
 #define CLUSTERING_TABLE_MANAGER_MULTI_TABLE_MANAGER_HPP_
 
+#include <functional>
+
 #include "clustering/administration/perfmon_collection_repo.hpp"
 #include "clustering/immediate_consistency/standard_backfill_throttler.hpp"
 #include "clustering/table_contract/cpu_sharding.hpp"
@@ -9,6 +11,25 @@
 #include "concurrency/rwlock.hpp"
 #include "containers/optional.hpp"
 
+/* How long loading the tables took when the server started up, summed over all tables.
+Since tables are loaded in parallel, these can add up to more than the time that
+loading took overall. */
+class table_load_times_t {
+public:
+    int64_t store_load_nanos;
+    int64_t table_manager_nanos;
+};
+
+/* `multi_table_manager_t` uses this to load the active tables that it finds on disk
+when the server starts up. For every table `i` in `[0, num_tables)` it calls
+`load_stores(i)` and then `start_table_manager(i)`, with at most `max_concurrent` tables
+loading at the same time. */
+table_load_times_t load_tables_in_parallel(
+    size_t num_tables,
+    int64_t max_concurrent,
+    const std::function<void(size_t)> &load_stores,
+    const std::function<void(size_t)> &start_table_manager);
+
 /* There is one `multi_table_manager_t` on each server. For tables hosted on this server,
 it handles administrative operations: table creation and deletion, adding and removing
 this server from the table, and changing the table configuration. It's also responsible
@@ -80,7 +101,8 @@ public:
         table_persistence_interface_t *_persistence_interface,
         const base_path_t &_base_path,
         io_backender_t *_io_backender,
-        perfmon_collection_repo_t *_perfmon_collection_repo);
+        perfmon_collection_repo_t *_perfmon_collection_repo,
+        const clone_ptr_t<watchable_t<uint64_t> > &backfill_budget_bytes_per_sec);
 
     /* This constructor is used on proxy servers. */
     multi_table_manager_t(
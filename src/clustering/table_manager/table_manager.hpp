@@ -5,6 +5,7 @@
 #include "clustering/table_contract/coordinator/coordinator.hpp"
 #include "clustering/table_contract/executor/executor.hpp"
 #include "clustering/table_manager/backfill_progress_tracker.hpp"
+#include "clustering/table_manager/compaction_manager.hpp"
 #include "clustering/table_manager/flush_interval_manager.hpp"
 #include "clustering/table_manager/server_name_cache_updater.hpp"
 #include "clustering/table_manager/sindex_manager.hpp"
@@ -185,6 +186,10 @@ private:
     interval according to what it sees. */
     flush_interval_manager_t flush_interval_manager;
 
+    /* The `compaction_manager` watches the `table_config_t` and changes how eagerly the
+    table's serializer compacts its file. */
+    compaction_manager_t compaction_manager;
+
     auto_drainer_t drainer;
 
     watchable_map_t<std::pair<peer_id_t, namespace_id_t>, table_manager_bcard_t>
@@ -95,6 +95,10 @@
 // I/O priority of block writes in the merger_serializer_t
 #define MERGER_BLOCK_WRITE_IO_PRIORITY            64
 
+// How many tables a server loads at the same time when it starts up. Loading a table
+// is mostly waiting for disk reads, so this can be larger than the number of threads.
+#define MAX_CONCURRENT_TABLE_LOADS                16
+
 // Maximum number of threads we support
 // TODO: make this dynamic where possible
 #define MAX_THREADS                               128
@@ -123,6 +127,14 @@
 // I/O priority for LBA garbage collection
 #define LBA_GC_IO_PRIORITY                        8
 
+// I/O priority for punching holes into the file where extents have been freed, how
+// many freed extents to discard per batch, and how long to wait after one batch is done
+// before issuing the next.  With the default extent size, that's at most 32 MB of
+// discards per second.
+#define EXTENT_DISCARD_IO_PRIORITY                4
+#define EXTENT_DISCARD_BATCH_SIZE                 16
+#define EXTENT_DISCARD_INTERVAL_MS                1000
+
 // How many block ids should the LBA garbage collector rewrite before yielding?
 #define LBA_GC_BATCH_SIZE                         (1024 * 8)
 
@@ -180,6 +192,18 @@
 // 2^(MESSAGE_SCHEDULER_MAX_PRIORITY - MESSAGE_SCHEDULER_MIN_PRIORITY + 1)
 #define MESSAGE_SCHEDULER_GRANULARITY           32
 
+// If a thread's event loop spends more than EVENT_LOOP_STALL_THRESHOLD_MS on a single
+// message or callback, we log a warning, since nothing else could run on that thread in
+// the meantime. At most one warning is logged per thread every
+// EVENT_LOOP_STALL_LOG_INTERVAL_MS; the stalls in between are only counted.
+#define EVENT_LOOP_STALL_THRESHOLD_MS           100
+#define EVENT_LOOP_STALL_LOG_INTERVAL_MS        10000
+
+// Defaults for the slow query log (see `rdb_protocol/slow_query_log.hpp`), which can be
+// changed at runtime through the `rethinkdb._debug_slow_queries` table.
+#define SLOW_QUERY_LOG_DEFAULT_THRESHOLD_MS     500
+#define SLOW_QUERY_LOG_DEFAULT_CAPACITY         100
+
 // Priorities for specific tasks
 #define CORO_PRIORITY_SINDEX_CONSTRUCTION       (-2)
 #define CORO_PRIORITY_BACKFILL_SENDER           (-2)
@@ -0,0 +1,147 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "perfmon/latency_histogram.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "rdb_protocol/configured_limits.hpp"
+#include "rdb_protocol/datum.hpp"
+
+latency_histogram_t::latency_histogram_t() : count_(0), max_micros_(0) { }
+
+void latency_histogram_t::record(ticks_t duration) {
+    record_micros(std::max<int64_t>(duration.nanos, 0) / 1000);
+}
+
+void latency_histogram_t::record_micros(uint64_t micros) {
+    if (buckets_.empty()) {
+        buckets_.resize(num_buckets, 0);
+    }
+    ++buckets_[bucket_for(micros)];
+    ++count_;
+    max_micros_ = std::max(max_micros_, micros);
+}
+
+void latency_histogram_t::merge(const latency_histogram_t &other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (buckets_.empty()) {
+        buckets_.resize(num_buckets, 0);
+    }
+    for (int i = 0; i < num_buckets; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    max_micros_ = std::max(max_micros_, other.max_micros_);
+}
+
+int latency_histogram_t::bucket_for(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(exact_buckets)) {
+        return micros;
+    }
+    // `micros` lies in [2^power, 2^(power + 1)), and the three bits below the
+    // highest one pick the sub-bucket.
+    int power = 63 - __builtin_clzll(micros);
+    int bucket = exact_buckets + (power - 4) * sub_buckets
+        + ((micros >> (power - 3)) & (sub_buckets - 1));
+    return std::min(bucket, num_buckets - 1);
+}
+
+uint64_t latency_histogram_t::bucket_upper_bound(int bucket) {
+    if (bucket < exact_buckets) {
+        return bucket;
+    }
+    int power = 4 + (bucket - exact_buckets) / sub_buckets;
+    uint64_t sub = (bucket - exact_buckets) % sub_buckets;
+    uint64_t width = uint64_t(1) << (power - 3);
+    return (sub_buckets + sub) * width + width - 1;
+}
+
+double latency_histogram_t::percentile(double fraction) const {
+    guarantee(count_ > 0);
+    uint64_t rank = ceil(fraction * count_);
+    rank = std::min(std::max<uint64_t>(rank, 1), count_);
+    uint64_t seen = 0;
+    for (int i = 0; i < num_buckets; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // The upper bound of the last bucket can be way off, but we know the
+            // duration didn't exceed the maximum.
+            return std::min(bucket_upper_bound(i), max_micros_) / 1000000.0;
+        }
+    }
+    unreachable();
+}
+
+double latency_histogram_t::max() const {
+    return max_micros_ / 1000000.0;
+}
+
+ql::datum_t latency_histogram_t::to_datum(bool include_buckets) const {
+    ql::datum_object_builder_t builder;
+    builder.overwrite("count", ql::datum_t(static_cast<double>(count_)));
+    if (count_ > 0) {
+        builder.overwrite("p50", ql::datum_t(percentile(0.5)));
+        builder.overwrite("p90", ql::datum_t(percentile(0.9)));
+        builder.overwrite("p99", ql::datum_t(percentile(0.99)));
+        builder.overwrite("p999", ql::datum_t(percentile(0.999)));
+        builder.overwrite("max", ql::datum_t(max()));
+    } else {
+        builder.overwrite("p50", ql::datum_t::null());
+        builder.overwrite("p90", ql::datum_t::null());
+        builder.overwrite("p99", ql::datum_t::null());
+        builder.overwrite("p999", ql::datum_t::null());
+        builder.overwrite("max", ql::datum_t::null());
+    }
+    if (include_buckets) {
+        ql::datum_array_builder_t buckets(ql::configured_limits_t::unlimited);
+        for (int i = 0; i < static_cast<int>(buckets_.size()); ++i) {
+            if (buckets_[i] != 0) {
+                std::vector<ql::datum_t> pair{
+                    ql::datum_t(static_cast<double>(i)),
+                    ql::datum_t(static_cast<double>(buckets_[i]))};
+                buckets.add(ql::datum_t(std::move(pair),
+                                        ql::configured_limits_t::unlimited));
+            }
+        }
+        builder.overwrite("buckets", std::move(buckets).to_datum());
+    }
+    return std::move(builder).to_datum();
+}
+
+void latency_histogram_t::merge_datum(const ql::datum_t &datum) {
+    // The datum comes from another server, so we ignore anything we don't
+    // understand instead of crashing.
+    if (!datum.has() || datum.get_type() != ql::datum_t::R_OBJECT) {
+        return;
+    }
+    ql::datum_t buckets = datum.get_field("buckets", ql::throw_bool_t::NOTHROW);
+    if (!buckets.has() || buckets.get_type() != ql::datum_t::R_ARRAY) {
+        return;
+    }
+    for (size_t i = 0; i < buckets.arr_size(); ++i) {
+        ql::datum_t pair = buckets.get(i);
+        if (pair.get_type() != ql::datum_t::R_ARRAY || pair.arr_size() != 2
+            || pair.get(0).get_type() != ql::datum_t::R_NUM
+            || pair.get(1).get_type() != ql::datum_t::R_NUM) {
+            continue;
+        }
+        double bucket = pair.get(0).as_num();
+        double n = pair.get(1).as_num();
+        if (bucket < 0 || bucket >= num_buckets || n < 0) {
+            continue;
+        }
+        if (buckets_.empty()) {
+            buckets_.resize(num_buckets, 0);
+        }
+        buckets_[static_cast<int>(bucket)] += static_cast<uint64_t>(n);
+        count_ += static_cast<uint64_t>(n);
+    }
+    ql::datum_t max_datum = datum.get_field("max", ql::throw_bool_t::NOTHROW);
+    if (max_datum.has() && max_datum.get_type() == ql::datum_t::R_NUM
+        && max_datum.as_num() > 0) {
+        max_micros_ = std::max<uint64_t>(max_micros_, llround(max_datum.as_num() * 1000000));
+    }
+}
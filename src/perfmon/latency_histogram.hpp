@@ -0,0 +1,61 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef PERFMON_LATENCY_HISTOGRAM_HPP_
+#define PERFMON_LATENCY_HISTOGRAM_HPP_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "time.hpp"
+
+namespace ql { class datum_t; }
+
+/* `latency_histogram_t` counts durations in logarithmically sized buckets, so that it
+can estimate percentiles in constant space. Durations are measured in microseconds.
+Below 16us every microsecond has its own bucket; above that, every power of two is
+split into eight buckets, so an estimate is never off by more than an eighth.
+
+Two histograms can be merged by adding up their buckets, which is what lets us combine
+histograms from different threads, and, through `to_datum()` and `merge_datum()`,
+from different servers. */
+class latency_histogram_t {
+public:
+    latency_histogram_t();
+
+    void record(ticks_t duration);
+    void record_micros(uint64_t micros);
+
+    void merge(const latency_histogram_t &other);
+
+    uint64_t count() const { return count_; }
+
+    /* Returns an upper bound for the duration below which `fraction` of the recorded
+    durations lie, in seconds. Must not be called on an empty histogram. */
+    double percentile(double fraction) const;
+    double max() const;
+
+    /* Returns an object with the number of recorded durations and a few percentiles,
+    which are null if the histogram is empty. With `include_buckets`, it also contains
+    the non-empty buckets, so that `merge_datum()` can reconstruct the histogram. */
+    ql::datum_t to_datum(bool include_buckets) const;
+
+    /* Merges in a histogram that was serialized by `to_datum(true)`. */
+    void merge_datum(const ql::datum_t &datum);
+
+private:
+    static const int exact_buckets = 16;
+    static const int sub_buckets = 8;
+    static const int num_powers = 36;
+    static const int num_buckets = exact_buckets + num_powers * sub_buckets;
+
+    static int bucket_for(uint64_t micros);
+    static uint64_t bucket_upper_bound(int bucket);
+
+    /* Empty until the first duration is recorded, so that unused histograms are
+    cheap. */
+    std::vector<uint64_t> buckets_;
+    uint64_t count_;
+    uint64_t max_micros_;
+};
+
+#endif  // PERFMON_LATENCY_HISTOGRAM_HPP_
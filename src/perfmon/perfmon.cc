@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include <map>
+#include <utility>
 
 #include "concurrency/pmap.hpp"
 #include "arch/arch.hpp"
@@ -148,6 +149,67 @@ ql::datum_t perfmon_sampler_t::output_stat(const stats_t &aggregated) {
     return std::move(builder).to_datum();
 }
 
+/* perfmon_latency_histogram_t */
+
+perfmon_latency_histogram_t::perfmon_latency_histogram_t(ticks_t _length)
+    : perfmon_perthread_t<latency_histogram_t>(),
+      thread_data(new thread_info_t[MAX_THREADS]), length(_length)
+{
+    for (int i = 0; i < MAX_THREADS; i++) {
+        thread_data[i].current_interval = get_ticks().nanos / length.nanos;
+    }
+}
+
+perfmon_latency_histogram_t::~perfmon_latency_histogram_t() {
+    delete[] thread_data;
+}
+
+void perfmon_latency_histogram_t::update(ticks_t now) {
+    int64_t interval = now.nanos / length.nanos;
+    rassert(get_thread_id().threadnum >= 0);
+    thread_info_t *thread = &thread_data[get_thread_id().threadnum];
+
+    if (thread->current_interval == interval) {
+        /* We're up to date; nothing to do */
+    } else if (thread->current_interval + 1 == interval) {
+        /* We're one step behind */
+        thread->last_stats = std::move(thread->current_stats);
+        thread->current_stats = latency_histogram_t();
+        thread->current_interval++;
+    } else {
+        /* We're more than one step behind */
+        thread->last_stats = thread->current_stats = latency_histogram_t();
+        thread->current_interval = interval;
+    }
+}
+
+void perfmon_latency_histogram_t::record(ticks_t duration) {
+    update(get_ticks());
+    rassert(get_thread_id().threadnum >= 0);
+    thread_data[get_thread_id().threadnum].current_stats.record(duration);
+}
+
+void perfmon_latency_histogram_t::get_thread_stat(latency_histogram_t *stat) {
+    update(get_ticks());
+    /* As in `perfmon_sampler_t`, we report the last complete interval. */
+    rassert(get_thread_id().threadnum >= 0);
+    *stat = thread_data[get_thread_id().threadnum].last_stats;
+}
+
+latency_histogram_t perfmon_latency_histogram_t::combine_stats(
+        const latency_histogram_t *stats) {
+    latency_histogram_t combined;
+    for (int i = 0; i < get_num_threads(); i++) {
+        combined.merge(stats[i]);
+    }
+    return combined;
+}
+
+ql::datum_t perfmon_latency_histogram_t::output_stat(
+        const latency_histogram_t &combined) {
+    return combined.to_datum(true);
+}
+
 /* perfmon_stddev_t */
 
 stddev_t::stddev_t()
@@ -339,6 +401,28 @@ ql::datum_t perfmon_duration_sampler_t::end_stats(void *data) {
     return stat.end_stats(data);
 }
 
+perfmon_ratio_t::perfmon_ratio_t(perfmon_t *_numerator, perfmon_t *_denominator)
+    : numerator(_numerator), denominator(_denominator) { }
+
+void *perfmon_ratio_t::begin_stats() {
+    return new std::pair<void *, void *>(
+        numerator->begin_stats(), denominator->begin_stats());
+}
+
+void perfmon_ratio_t::visit_stats(void *data) {
+    std::pair<void *, void *> *ctx = static_cast<std::pair<void *, void *> *>(data);
+    numerator->visit_stats(ctx->first);
+    denominator->visit_stats(ctx->second);
+}
+
+ql::datum_t perfmon_ratio_t::end_stats(void *data) {
+    std::unique_ptr<std::pair<void *, void *> > ctx(
+        static_cast<std::pair<void *, void *> *>(data));
+    double num = numerator->end_stats(ctx->first).as_num();
+    double den = denominator->end_stats(ctx->second).as_num();
+    return ql::datum_t(den == 0 ? 0.0 : num / den);
+}
+
 std::string perfmon_duration_sampler_t::call(UNUSED int argc, UNUSED char **argv) {
     ignore_global_full_perfmon = !ignore_global_full_perfmon;
     if (ignore_global_full_perfmon) {
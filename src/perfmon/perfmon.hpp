@@ -18,6 +18,7 @@
 #include "config/args.hpp"
 #include "perfmon/types.hpp"
 #include "perfmon/core.hpp"
+#include "perfmon/latency_histogram.hpp"
 #include "time.hpp"
 
 // Some arch/runtime declarations.
@@ -215,6 +216,32 @@ public:
     void record(double value = 1.0);
 };
 
+/* perfmon_latency_histogram_t records durations in a `latency_histogram_t`. Like
+ * perfmon_sampler_t, it reports on the last complete interval of `length` ticks. It
+ * produces the number of durations and their percentiles in seconds, along with the
+ * histogram's buckets so that the stats of several servers can be merged.
+ */
+class perfmon_latency_histogram_t : public perfmon_perthread_t<latency_histogram_t> {
+    struct thread_info_t {
+        latency_histogram_t current_stats, last_stats;
+        int64_t current_interval;
+    };
+
+    thread_info_t *thread_data;
+
+    void get_thread_stat(latency_histogram_t *);
+    latency_histogram_t combine_stats(const latency_histogram_t *);
+    ql::datum_t output_stat(const latency_histogram_t &);
+
+    void update(ticks_t now);
+
+    ticks_t length;
+public:
+    explicit perfmon_latency_histogram_t(ticks_t _length);
+    virtual ~perfmon_latency_histogram_t();
+    void record(ticks_t duration);
+};
+
 /* perfmon_duration_sampler_t is a perfmon_t that monitors events that have a
  * starting and ending time. When something starts, call begin(); when
  * something ends, call end() with the same value as begin. It will produce
@@ -253,6 +280,24 @@ public:
     std::string call(UNUSED int argc, UNUSED char **argv);
 };
 
+/* perfmon_ratio_t reports the ratio of two other perfmons that produce numbers, for
+ * example the number of bytes that the GC rewrote per byte written. It reports zero
+ * while the denominator is zero. It doesn't own the perfmons it refers to, and they
+ * shouldn't be registered anywhere else if they aren't meant to be visible.
+ */
+class perfmon_ratio_t : public perfmon_t {
+public:
+    perfmon_ratio_t(perfmon_t *_numerator, perfmon_t *_denominator);
+
+    void *begin_stats();
+    void visit_stats(void *data);
+    ql::datum_t end_stats(void *data);
+
+private:
+    perfmon_t *numerator;
+    perfmon_t *denominator;
+};
+
 struct block_pm_duration {
     ticks_t time;
     bool ended;
@@ -65,6 +65,8 @@ public:
                 0};
     }
     batch_type_t get_batch_type() { return batch_type; }
+    // How many more elements fit in the current batch.
+    int64_t get_els_left() const { return els_left; }
 private:
     DISABLE_COPYING(batcher_t);
     friend class batchspec_t;
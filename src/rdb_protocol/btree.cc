@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "arch/runtime/resource_account.hpp"
 #include "btree/concurrent_traversal.hpp"
 #include "btree/get_distribution.hpp"
 #include "btree/operations.hpp"
@@ -103,6 +104,32 @@ void rdb_get(const store_key_t &store_key, btree_slice_t *slice,
     }
 }
 
+bool rdb_get_without_acquiring(const store_key_t &store_key, btree_slice_t *slice,
+                               cache_t *cache, point_read_response_t *response) {
+    ASSERT_NO_CORO_WAITING;
+    rdb_value_sizer_t sizer(cache->max_block_size());
+    scoped_malloc_t<void> value(sizer.max_possible_size());
+    bool found;
+    if (!find_value_without_acquiring(
+            cache, &sizer, store_key.btree_key(), value.get(), &found)) {
+        return false;
+    }
+    ql::datum_t data;
+    if (found && !get_inline_data(static_cast<const rdb_value_t *>(value.get()),
+                                  cache->max_block_size(),
+                                  &data)) {
+        return false;
+    }
+
+    slice->stats.pm_keys_read.record();
+    slice->stats.pm_total_keys_read += 1;
+    if (resource_account_t *resource_account = resource_account_t::current()) {
+        resource_account->charge_row_scanned();
+    }
+    response->data = found ? data : ql::datum_t::null();
+    return true;
+}
+
 void kv_location_delete(keyvalue_location_t *kv_location,
                         const store_key_t &key,
                         repli_timestamp_t timestamp,
@@ -633,6 +660,13 @@ private:
     std::string rbound_trunc_key;
 };
 
+// Range scans keep up to this many of the upcoming leaves loading ahead of the
+// traversal.
+static const size_t RGET_MAX_PREFETCH_WINDOW = 16;
+// A rough guess at how many rows fit in a leaf, used to turn the number of rows that
+// a batch still wants into a number of leaves.
+static const int64_t RGET_ESTIMATED_ROWS_PER_LEAF = 32;
+
 class job_data_t {
 public:
     job_data_t(ql::env_t *_env,
@@ -696,6 +730,9 @@ public:
         concurrent_traversal_fifo_enforcer_signal_t waiter)
         THROWS_ONLY(interrupted_exc_t);
     void finish(continue_bool_t last_cb) THROWS_ONLY(interrupted_exc_t);
+
+    size_t get_prefetch_window() const;
+    void note_prefetches(size_t issued, size_t hits);
 private:
     const rget_io_data_t io; // How do get data in/out.
     job_data_t job; // What to do next (stateful).
@@ -708,6 +745,14 @@ private:
     optional<std::string> last_truncated_secondary_for_abort;
     scoped_ptr_t<profile::disabler_t> disabler;
     scoped_ptr_t<profile::sampler_t> sampler;
+
+    // Leaf prefetching done by the traversals, for the query profile.
+    size_t prefetches_issued;
+    size_t prefetch_hits;
+
+    // The account of the coroutine that runs the read. `handle_pair` runs on other
+    // coroutines, so it has to charge the rows it scans to this explicitly.
+    resource_account_t *const resource_account;
 };
 
 // This is the interface the btree code expects, but our actual callback needs a
@@ -729,19 +774,75 @@ public:
             skey_left,
             std::move(waiter));
     }
+    virtual size_t get_prefetch_window() THROWS_NOTHING {
+        return cb->get_prefetch_window();
+    }
+    virtual void note_prefetches(size_t issued, size_t hits) THROWS_NOTHING {
+        cb->note_prefetches(issued, hits);
+    }
 private:
     rget_cb_t *cb;
     size_t copies;
     optional<std::string> skey_left;
 };
 
+// Looks up a sorted set of primary keys in a single traversal. Children that don't
+// contain any of the keys are skipped, so every internal node on the way is acquired
+// only once, and the leaves that do contain keys are prefetched together.
+class rget_multi_key_cb_wrapper_t : public concurrent_traversal_callback_t {
+public:
+    rget_multi_key_cb_wrapper_t(
+            rget_cb_t *_cb,
+            const std::map<store_key_t, uint64_t> *_keys)
+        : cb(_cb), keys(_keys) { }
+    virtual void filter_range(
+            const btree_key_t *left_excl_or_null,
+            const btree_key_t *right_incl,
+            bool *skip_out) {
+        auto it = left_excl_or_null == nullptr
+            ? keys->begin()
+            : keys->upper_bound(store_key_t(left_excl_or_null));
+        *skip_out = it == keys->end()
+            || btree_key_cmp(it->first.btree_key(), right_incl) > 0;
+    }
+    virtual continue_bool_t handle_pair(
+        scoped_key_value_t &&keyvalue,
+        concurrent_traversal_fifo_enforcer_signal_t waiter)
+        THROWS_ONLY(interrupted_exc_t) {
+        auto it = keys->find(store_key_t(keyvalue.key()));
+        if (it == keys->end()) {
+            // A neighbour of one of the keys that happens to share its leaf.
+            return continue_bool_t::CONTINUE;
+        }
+        return cb->handle_pair(
+            std::move(keyvalue),
+            it->second,
+            r_nullopt,
+            std::move(waiter));
+    }
+    virtual size_t get_prefetch_window() THROWS_NOTHING {
+        // `filter_range()` keeps the traversal from prefetching leaves without any of
+        // the keys, so we can afford to look further ahead than a range scan does.
+        return std::min<size_t>(keys->size(), RGET_MAX_PREFETCH_WINDOW);
+    }
+    virtual void note_prefetches(size_t issued, size_t hits) THROWS_NOTHING {
+        cb->note_prefetches(issued, hits);
+    }
+private:
+    rget_cb_t *cb;
+    const std::map<store_key_t, uint64_t> *keys;
+};
+
 rget_cb_t::rget_cb_t(rget_io_data_t &&_io,
                      job_data_t &&_job,
                      optional<rget_sindex_data_t> &&_sindex)
     : io(std::move(_io)),
       job(std::move(_job)),
       sindex(std::move(_sindex)),
-      bad_init(false) {
+      bad_init(false),
+      prefetches_issued(0),
+      prefetch_hits(0),
+      resource_account(resource_account_t::current()) {
 
     if (sindex) {
         // Secondary index functions are deterministic (so no need for an
@@ -762,6 +863,35 @@ rget_cb_t::rget_cb_t(rget_io_data_t &&_io,
 
 void rget_cb_t::finish(continue_bool_t last_cb) THROWS_ONLY(interrupted_exc_t) {
     job.accumulator->finish(last_cb, &io.response->result);
+
+    // The traversal is over, so nothing runs in parallel anymore and we can stop
+    // sampling and report on prefetching.
+    sampler.reset();
+    disabler.reset();
+    if (prefetches_issued > 0) {
+        PROFILE_STARTER_IF_ENABLED(
+            job.env->profile() == profile_bool_t::PROFILE,
+            strprintf("Prefetched %zu blocks, %zu of them were used.",
+                      prefetches_issued, prefetch_hits),
+            job.env->trace);
+    }
+}
+
+size_t rget_cb_t::get_prefetch_window() const {
+    // Prefetch about as many leaves as the rest of the batch is going to need, so
+    // that small batches don't load blocks they won't get to.
+    const int64_t els_left = job.batcher->get_els_left();
+    if (els_left <= 0) {
+        return 0;
+    }
+    const int64_t leaves
+        = (els_left + RGET_ESTIMATED_ROWS_PER_LEAF - 1) / RGET_ESTIMATED_ROWS_PER_LEAF;
+    return std::min<size_t>(leaves, RGET_MAX_PREFETCH_WINDOW);
+}
+
+void rget_cb_t::note_prefetches(size_t issued, size_t hits) {
+    prefetches_issued += issued;
+    prefetch_hits += hits;
 }
 
 // Handle a keyvalue pair.  Returns whether or not we're done early.
@@ -790,6 +920,9 @@ continue_bool_t rget_cb_t::handle_pair(
     // Count stats whether or not we deserialize the value
     io.slice->stats.pm_keys_read.record();
     io.slice->stats.pm_total_keys_read += 1;
+    if (resource_account != nullptr) {
+        resource_account->charge_row_scanned();
+    }
     // We only load the value if we actually use it (`count` does not).
     if (job.accumulator->uses_val() || job.transformers.size() != 0 || sindex) {
         val = row.get();
@@ -1043,33 +1176,15 @@ void rdb_rget_slice(
     direction_t direction = reversed(sorting) ? BACKWARD : FORWARD;
     continue_bool_t cont = continue_bool_t::CONTINUE;
     if (primary_keys.has_value()) {
-        auto cb = [&](const std::pair<store_key_t, uint64_t> &pair, bool is_last) {
-            rget_cb_wrapper_t wrapper(&callback, pair.second, r_nullopt);
-            return btree_concurrent_traversal(
+        if (!primary_keys->empty()) {
+            rget_multi_key_cb_wrapper_t wrapper(&callback, &*primary_keys);
+            cont = btree_concurrent_traversal(
                 superblock,
-                key_range_t::one_key(pair.first),
+                key_range_t(key_range_t::closed, primary_keys->begin()->first,
+                            key_range_t::closed, primary_keys->rbegin()->first),
                 &wrapper,
                 direction,
-                is_last ? release_superblock : release_superblock_t::KEEP);
-        };
-        if (!reversed(sorting)) {
-            for (auto it = primary_keys->begin(); it != primary_keys->end();) {
-                auto this_it = it++;
-                if (cb(*this_it, it == primary_keys->end()) == continue_bool_t::ABORT) {
-                    // If required the superblock will get released further up the stack.
-                    cont = continue_bool_t::ABORT;
-                    break;
-                }
-            }
-        } else {
-            for (auto it = primary_keys->rbegin(); it != primary_keys->rend();) {
-                auto this_it = it++;
-                if (cb(*this_it, it == primary_keys->rend()) == continue_bool_t::ABORT) {
-                    // If required the superblock will get released further up the stack.
-                    cont = continue_bool_t::ABORT;
-                    break;
-                }
-            }
+                release_superblock);
         }
     } else {
         rget_cb_wrapper_t wrapper(&callback, 1, r_nullopt);
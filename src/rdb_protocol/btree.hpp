@@ -64,6 +64,15 @@ void rdb_get(
     point_read_response_t *response,
     profile::trace_t *trace);
 
+/* The optimistic version of `rdb_get()`, which reads cached blocks in place instead of
+acquiring them (see `find_value_without_acquiring()`). Returns `false` without having
+blocked if it can't, in which case the caller should use `rdb_get()`. */
+bool rdb_get_without_acquiring(
+    const store_key_t &key,
+    btree_slice_t *slice,
+    cache_t *cache,
+    point_read_response_t *response);
+
 struct btree_info_t {
     btree_info_t(btree_slice_t *_slice,
                  repli_timestamp_t _timestamp,
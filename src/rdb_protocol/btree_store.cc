@@ -4,6 +4,7 @@
 #include <functional>  // NOLINT(build/include_order)
 
 #include "arch/runtime/coroutines.hpp"
+#include "arch/runtime/resource_account.hpp"
 #include "btree/depth_first_traversal.hpp"
 #include "btree/node.hpp"
 #include "btree/operations.hpp"
@@ -22,6 +23,8 @@
 #include "rdb_protocol/btree.hpp"
 #include "rdb_protocol/erase_range.hpp"
 #include "rdb_protocol/protocol.hpp"
+#include "rdb_protocol/redo_log.hpp"
+#include "serializer/serializer.hpp"
 #include "stl_utils.hpp"
 
 // The maximal number of writes that can be in line for a superblock acquisition
@@ -77,7 +80,7 @@ const char* sindex_not_ready_exc_t::what() const throw() {
 sindex_not_ready_exc_t::~sindex_not_ready_exc_t() throw() { }
 
 store_t::store_t(const region_t &_region,
-                 serializer_t *serializer,
+                 serializer_t *_serializer,
                  cache_balancer_t *balancer,
                  const std::string &perfmon_name,
                  bool create,
@@ -90,11 +93,14 @@ store_t::store_t(const region_t &_region,
                  which_cpu_shard_t which_cpu_shard)
     : store_view_t(_region),
       perfmon_collection(),
+      serializer(_serializer),
       io_backender_(io_backender), base_path_(base_path),
       perfmon_collection_membership(parent_perfmon_collection, &perfmon_collection, perfmon_name),
       ctx(_ctx),
       table_id(_table_id),
-      write_superblock_acq_semaphore(WRITE_SUPERBLOCK_ACQ_WAITERS_LIMIT)
+      write_superblock_acq_semaphore(WRITE_SUPERBLOCK_ACQ_WAITERS_LIMIT),
+      redo_log_checkpoint_running(false),
+      has_unlogged_changes(false)
 {
     cache.init(new cache_t(serializer, balancer, &perfmon_collection, which_cpu_shard));
     general_cache_conn.init(new cache_conn_t(cache.get()));
@@ -191,15 +197,23 @@ void store_t::read(
         signal_t *interruptor)
         THROWS_ONLY(interrupted_exc_t) {
     assert_thread();
-    scoped_ptr_t<txn_t> txn;
-    scoped_ptr_t<real_superblock_t> superblock;
-
-    acquire_superblock_for_read(token, &txn, &superblock,
-                                interruptor,
-                                _read.use_snapshot());
-    DEBUG_ONLY_CODE(metainfo->visit(
-        superblock.get(), metainfo_checker.region, metainfo_checker.callback));
-    protocol_read(_read, response, superblock.get(), interruptor);
+    // Measure what our part of the query costs, so that the query can report it.
+    resource_account_t resource_account;
+    {
+        resource_account_scope_t resource_account_scope(&resource_account);
+        if (!try_read_without_acquiring(_read, response, token, interruptor)) {
+            scoped_ptr_t<txn_t> txn;
+            scoped_ptr_t<real_superblock_t> superblock;
+
+            acquire_superblock_for_read(token, &txn, &superblock,
+                                        interruptor,
+                                        _read.use_snapshot());
+            DEBUG_ONLY_CODE(metainfo->visit(
+                superblock.get(), metainfo_checker.region, metainfo_checker.callback));
+            protocol_read(_read, response, superblock.get(), interruptor);
+        }
+    }
+    response->resources = resource_account.get_usage();
 }
 
 void store_t::write(
@@ -215,14 +229,48 @@ void store_t::write(
         THROWS_ONLY(interrupted_exc_t) {
     assert_thread();
 
+    /* With a redo log, the write is recorded in the log and the transaction itself
+    uses soft durability. Hard durability is provided by syncing the log. That only works
+    if the store's metainfo on disk lets the record be replayed, so if there are unlogged
+    changes we commit a hard transaction instead, for the same reason as in `sync()`. */
+    const bool use_redo_log = redo_log.has();
+    const bool hard_txn = durability == write_durability_t::HARD
+        && (!use_redo_log || has_unlogged_changes);
+    if (use_redo_log && hard_txn) {
+        has_unlogged_changes = false;
+    }
+
     scoped_ptr_t<txn_t> txn;
     scoped_ptr_t<real_superblock_t> real_superblock;
     // We assume one block per document, plus changes to the stats block and superblock.
     const int expected_change_count = 2 + _write.expected_document_changes();
-    acquire_superblock_for_write(expected_change_count, durability, token,
-                                 &txn, &real_superblock, interruptor);
+    try {
+        acquire_superblock_for_write(
+            expected_change_count,
+            hard_txn ? write_durability_t::HARD : write_durability_t::SOFT,
+            token, &txn, &real_superblock, interruptor);
+    } catch (const interrupted_exc_t &) {
+        if (use_redo_log && hard_txn) {
+            has_unlogged_changes = true;
+        }
+        throw;
+    }
     DEBUG_ONLY_CODE(metainfo->visit(
         real_superblock.get(), metainfo_checker.region, metainfo_checker.callback));
+    if (use_redo_log) {
+        /* We append while holding the superblock, so the order of the records matches
+        the order in which the writes are applied. */
+        redo_log->append(
+            metainfo->get(real_superblock.get(), new_metainfo.get_domain()),
+            new_metainfo,
+            _write,
+            timestamp);
+        if (redo_log->needs_checkpoint() && !redo_log_checkpoint_running) {
+            redo_log_checkpoint_running = true;
+            coro_t::spawn_sometime(std::bind(
+                &store_t::checkpoint_redo_log, this, drainer.lock()));
+        }
+    }
     metainfo->update(real_superblock.get(), new_metainfo);
     try {
         protocol_write(_write, response, timestamp, &real_superblock, interruptor);
@@ -237,6 +285,81 @@ void store_t::write(
     }
     real_superblock.reset();
     txn->commit();
+
+    if (use_redo_log && durability == write_durability_t::HARD && !hard_txn) {
+        redo_log->flush(interruptor);
+    }
+}
+
+void store_t::set_gc_mode(gc_mode_t mode) {
+    assert_thread();
+    serializer->set_gc_mode(mode);
+}
+
+void store_t::enable_redo_log(const std::string &path, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+    guarantee(!redo_log.has());
+    scoped_ptr_t<redo_log_t> log(new redo_log_t(path));
+
+    /* Replay the writes that didn't make it into the store before the last shutdown.
+    The records that are already reflected in the store are recognizable by their
+    metainfo. */
+    std::vector<redo_log_t::record_t> records = log->read_records();
+    size_t replayed = 0;
+    for (const redo_log_t::record_t &record : records) {
+        read_token_t read_token;
+        new_read_token(&read_token);
+        region_map_t<binary_blob_t> current_metainfo = get_metainfo(
+            order_token_t::ignore, &read_token, record.new_metainfo.get_domain(),
+            interruptor);
+        if (current_metainfo != record.old_metainfo) {
+            continue;
+        }
+#ifndef NDEBUG
+        metainfo_checker_t metainfo_checker(record.new_metainfo.get_domain(),
+            [](const region_t &, const binary_blob_t &) { });
+#endif
+        write_token_t write_token;
+        new_write_token(&write_token);
+        write_response_t response;
+        write(DEBUG_ONLY(metainfo_checker, )
+              record.new_metainfo,
+              record.write,
+              &response,
+              write_durability_t::SOFT,
+              record.timestamp,
+              order_token_t::ignore,
+              &write_token,
+              interruptor);
+        ++replayed;
+    }
+
+    /* Make the replayed writes durable before we throw the log away. */
+    if (replayed != 0) {
+        write_token_t write_token;
+        new_write_token(&write_token);
+        sync_cache(&write_token, interruptor);
+        logNTC("Replayed %zu write(s) from the redo log %s\n",
+               replayed, path.c_str());
+    }
+    log->clear();
+    redo_log = std::move(log);
+}
+
+void store_t::checkpoint_redo_log(auto_drainer_t::lock_t store_keepalive) {
+    assert_thread();
+    try {
+        redo_log->begin_checkpoint(store_keepalive.get_drain_signal());
+        write_token_t token;
+        new_write_token(&token);
+        sync_cache(&token, store_keepalive.get_drain_signal());
+        redo_log->finish_checkpoint(store_keepalive.get_drain_signal());
+    } catch (const interrupted_exc_t &) {
+        /* The store is shutting down. Whatever is left in the old log file will be
+        skipped when it's replayed on the next startup. */
+    }
+    redo_log_checkpoint_running = false;
 }
 
 void store_t::reset_data(
@@ -248,6 +371,9 @@ void store_t::reset_data(
     guarantee(subregion.beg == get_region().beg && subregion.end == get_region().end);
     assert_thread();
     with_priority_t p(CORO_PRIORITY_RESET_DATA);
+    if (durability == write_durability_t::SOFT) {
+        has_unlogged_changes = true;
+    }
 
     // Erase the data in small chunks
     always_true_key_tester_t key_tester;
@@ -1181,6 +1307,9 @@ void store_t::set_metainfo(const region_map_t<binary_blob_t> &new_metainfo,
                            write_durability_t durability,
                            signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
     assert_thread();
+    if (durability == write_durability_t::SOFT) {
+        has_unlogged_changes = true;
+    }
 
     scoped_ptr_t<txn_t> txn;
     {
@@ -1197,6 +1326,63 @@ void store_t::set_metainfo(const region_map_t<binary_blob_t> &new_metainfo,
     txn->commit();
 }
 
+void store_t::sync(UNUSED order_token_t order_token,  // TODO
+                   write_token_t *token,
+                   signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+
+    if (redo_log.has() && !has_unlogged_changes) {
+        /* Acquiring the superblock makes sure that every write that came before us
+        has appended its record to the log. */
+        {
+            scoped_ptr_t<txn_t> txn;
+            {
+                scoped_ptr_t<real_superblock_t> superblock;
+                acquire_superblock_for_write(
+                    1,
+                    write_durability_t::SOFT,
+                    token,
+                    &txn,
+                    &superblock,
+                    interruptor);
+            }
+            txn->commit();
+        }
+        redo_log->flush(interruptor);
+        return;
+    }
+
+    has_unlogged_changes = false;
+    try {
+        sync_cache(token, interruptor);
+    } catch (const interrupted_exc_t &) {
+        has_unlogged_changes = true;
+        throw;
+    }
+}
+
+void store_t::sync_cache(write_token_t *token, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+
+    /* Every write transaction acquires the superblock for write, so the cache makes
+    this transaction depend on all of the writes that came before it. Committing it with
+    hard durability therefore flushes all of them, even though we don't change
+    anything ourselves. */
+    scoped_ptr_t<txn_t> txn;
+    {
+        scoped_ptr_t<real_superblock_t> superblock;
+        acquire_superblock_for_write(
+            1,
+            write_durability_t::HARD,
+            token,
+            &txn,
+            &superblock,
+            interruptor);
+    }
+    txn->commit();
+}
+
 cluster_version_t store_t::metainfo_version(read_token_t *token,
                                             signal_t *interruptor) {
     assert_thread();
@@ -1253,6 +1439,36 @@ void store_t::acquire_superblock_for_read(
         general_cache_conn.get(), cache_snapshotted, sb_out, txn_out);
 }
 
+bool store_t::try_read_without_acquiring(
+        const read_t &_read,
+        read_response_t *response,
+        read_token_t *token,
+        signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+    const point_read_t *get = boost::get<point_read_t>(&_read.read);
+    if (get == nullptr || _read.profile == profile_bool_t::PROFILE) {
+        return false;
+    }
+
+    /* The read token orders us after the writes we have to see. Once it's ready, each
+    of them has either finished or is queued up on the blocks that it's going to
+    change, which makes us fall back to the regular path. */
+    if (token->main_read_token.has()) {
+        wait_interruptible(token->main_read_token.get(), interruptor);
+    }
+    point_read_response_t res;
+    if (!rdb_get_without_acquiring(get->key, btree.get(), cache.get(), &res)) {
+        return false;
+    }
+    token->main_read_token.reset();
+
+    response->response = std::move(res);
+    response->n_shards = 1;
+    response->event_log.push_back(profile::stop_t());
+    return true;
+}
+
 void store_t::acquire_superblock_for_write(
         int expected_change_count,
         write_durability_t durability,
@@ -72,7 +72,10 @@ rdb_context_t::stats_t::stats_t(perfmon_collection_t *global_stats)
       queries_per_sec_membership(&qe_stats_collection,
                                  &queries_per_sec, "queries_per_sec"),
       queries_total_membership(&qe_stats_collection,
-                               &queries_total, "queries_total") { }
+                               &queries_total, "queries_total"),
+      query_latency(secs_to_ticks(1)),
+      query_latency_membership(&qe_stats_collection,
+                               &query_latency, "query_latency") { }
 
 rdb_context_t::rdb_context_t()
     : extproc_pool(nullptr),
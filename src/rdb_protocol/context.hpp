@@ -22,6 +22,7 @@
 #include "rdb_protocol/geo/distances.hpp"
 #include "rdb_protocol/geo/lon_lat_types.hpp"
 #include "rdb_protocol/shards.hpp"
+#include "rdb_protocol/slow_query_log.hpp"
 #include "rdb_protocol/wire_func.hpp"
 
 namespace auth {
@@ -493,10 +494,14 @@ public:
         perfmon_membership_t queries_per_sec_membership;
         perfmon_counter_t queries_total;
         perfmon_membership_t queries_total_membership;
+        perfmon_latency_histogram_t query_latency;
+        perfmon_membership_t query_latency_membership;
     private:
         DISABLE_COPYING(stats_t);
     } stats;
 
+    slow_query_log_t slow_query_log;
+
     std::set<ql::query_cache_t *> *get_query_caches_for_this_thread();
 
     clone_ptr_t<watchable_t<auth_semilattice_metadata_t>> get_auth_watchable() const;
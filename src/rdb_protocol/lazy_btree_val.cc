@@ -24,6 +24,27 @@ ql::datum_t get_data(const rdb_value_t *value, buf_parent_t parent) {
     return data;
 }
 
+bool get_inline_data(const rdb_value_t *value,
+                     max_block_size_t block_size,
+                     ql::datum_t *data_out) {
+    if (blob::ref_info(block_size, value->value_ref(), blob::btree_maxreflen).levels
+            != 0) {
+        return false;
+    }
+    rdb_blob_wrapper_t blob(block_size,
+                            const_cast<rdb_value_t *>(value)->value_ref(),
+                            blob::btree_maxreflen);
+
+    // An inline blob doesn't look at its parent.
+    blob_acq_t acq_group;
+    buffer_group_t buffer_group;
+    blob.expose_all(buf_parent_t(), access_t::read, &buffer_group, &acq_group);
+    buffer_group_read_stream_t read_stream(const_view(&buffer_group));
+    archive_result_t res = datum_deserialize(&read_stream, data_out);
+    guarantee_deserialization(res, "rdb value");
+    return true;
+}
+
 const ql::datum_t &lazy_btree_val_t::get() const {
     guarantee(pointee.has());
     if (!pointee->ptr.has()) {
@@ -30,6 +30,13 @@ public:
 ql::datum_t get_data(const rdb_value_t *value,
                      buf_parent_t parent);
 
+/* Like `get_data()` for values that are stored entirely in the leaf node, which
+doesn't need to acquire any blocks. Returns `false` if the value is stored in blob
+blocks of its own. */
+bool get_inline_data(const rdb_value_t *value,
+                     max_block_size_t block_size,
+                     ql::datum_t *data_out);
+
 class lazy_btree_val_pointee_t
         : public single_threaded_countable_t<lazy_btree_val_pointee_t> {
     lazy_btree_val_pointee_t(const rdb_value_t *_rdb_value, buf_parent_t _parent)
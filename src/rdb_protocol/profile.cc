@@ -293,15 +293,19 @@ void disabler_t::init(trace_t *parent) {
 trace_t::trace_t()
     : redirected_event_log_(NULL), disabled_ref_count_(0) { }
 
-ql::datum_t trace_t::as_datum() const {
-    guarantee(!redirected_event_log_);
-    event_log_t::const_iterator begin = event_log_.begin();
+ql::datum_t event_log_as_datum(const event_log_t &event_log) {
+    event_log_t::const_iterator begin = event_log.begin();
     // Again, use defaults, as there's no predicting where this could
     // come in response to user requests.
-    return construct_datum(&begin, event_log_.end(),
+    return construct_datum(&begin, event_log.end(),
                            ql::configured_limits_t());
 }
 
+ql::datum_t trace_t::as_datum() const {
+    guarantee(!redirected_event_log_);
+    return event_log_as_datum(event_log_);
+}
+
 event_log_t trace_t::extract_event_log() RVALUE_THIS {
     // These guarantees imply that this trace_t gets left in a default-constructed
     // state (which is valid, thereby acceptable for an RVALUE_THIS function).
@@ -68,6 +68,10 @@ typedef boost::variant<start_t, split_t, sample_t, stop_t> event_t;
 
 typedef std::vector<event_t> event_log_t;
 
+/* Converts a complete event log into the datum that's sent to the client as the
+profile of a query. */
+ql::datum_t event_log_as_datum(const event_log_t &event_log);
+
 /* A trace_t contains an event_log_t and provides private methods for adding
  * events to it. These methods are leveraged by the instruments. */
 class trace_t {
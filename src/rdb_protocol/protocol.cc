@@ -1043,6 +1043,10 @@ void read_t::unshard(read_response_t *responses, size_t count,
      * we set them here. */
     response_out->n_shards = 0;
     response_out->event_log.clear();
+    response_out->resources = resource_usage_t();
+    for (size_t i = 0; i < count; ++i) {
+        response_out->resources.add(responses[i].resources);
+    }
     if (profile == profile_bool_t::PROFILE) {
         for (size_t i = 0; i < count; ++i) {
             response_out->event_log.insert(
@@ -1433,6 +1437,10 @@ void write_t::unshard(write_response_t *responses, size_t count,
      * we set them here. */
     response_out->n_shards = 0;
     response_out->event_log.clear();
+    response_out->resources = resource_usage_t();
+    for (size_t i = 0; i < count; ++i) {
+        response_out->resources.add(responses[i].resources);
+    }
     if (profile == profile_bool_t::PROFILE) {
         for (size_t i = 0; i < count; ++i) {
             response_out->event_log.insert(
@@ -1484,7 +1492,11 @@ RDB_IMPL_SERIALIZABLE_2_FOR_CLUSTER(
 RDB_IMPL_SERIALIZABLE_1_FOR_CLUSTER(
     changefeed_point_stamp_response_t, resp);
 
-RDB_IMPL_SERIALIZABLE_3_FOR_CLUSTER(read_response_t, response, event_log, n_shards);
+// `resources` changed the wire format of `read_response_t` and `write_response_t`
+// without a new `cluster_version_t`, so servers from before it was added can't be in
+// the same cluster as servers from after.
+RDB_IMPL_SERIALIZABLE_4_FOR_CLUSTER(
+    read_response_t, response, event_log, n_shards, resources);
 RDB_IMPL_SERIALIZABLE_0_FOR_CLUSTER(dummy_read_response_t);
 
 RDB_IMPL_SERIALIZABLE_3_FOR_CLUSTER(
@@ -1560,7 +1572,9 @@ RDB_IMPL_SERIALIZABLE_1_FOR_CLUSTER(point_delete_response_t, result);
 RDB_IMPL_SERIALIZABLE_0_FOR_CLUSTER(sync_response_t);
 RDB_IMPL_SERIALIZABLE_0_FOR_CLUSTER(dummy_write_response_t);
 
-RDB_IMPL_SERIALIZABLE_3_FOR_CLUSTER(write_response_t, response, event_log, n_shards);
+// See the comment on `read_response_t` above.
+RDB_IMPL_SERIALIZABLE_4_FOR_CLUSTER(
+    write_response_t, response, event_log, n_shards, resources);
 
 RDB_IMPL_SERIALIZABLE_6_FOR_CLUSTER(
         batched_replace_t,
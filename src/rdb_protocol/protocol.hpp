@@ -13,6 +13,7 @@
 #include "errors.hpp"
 #include <boost/variant.hpp>
 
+#include "arch/runtime/resource_account.hpp"
 #include "btree/secondary_operations.hpp"
 #include "clustering/administration/auth/user_context.hpp"
 #include "concurrency/cond_var.hpp"
@@ -232,6 +233,8 @@ struct read_response_t {
     variant_t response;
     profile::event_log_t event_log;
     size_t n_shards;
+    /* What the read cost the shards, summed up over all of them. */
+    resource_usage_t resources;
 
     read_response_t() { }
     explicit read_response_t(const variant_t &r)
@@ -563,6 +566,8 @@ struct write_response_t {
 
     profile::event_log_t event_log;
     size_t n_shards;
+    /* What the write cost the primary replicas, summed up over all shards. */
+    resource_usage_t resources;
 
     write_response_t() { }
     template<class T>
@@ -1,6 +1,7 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include "rdb_protocol/query_cache.hpp"
 
+#include "pprint/js_pprint.hpp"
 #include "rdb_protocol/env.hpp"
 #include "rdb_protocol/pseudo_time.hpp"
 #include "rdb_protocol/response.hpp"
@@ -8,6 +9,8 @@
 
 namespace ql {
 
+const size_t query_cache_t::printed_query_columns = 89;
+
 query_cache_t::query_cache_t(
             rdb_context_t *_rdb_ctx,
             ip_and_port_t _client_addr_port,
@@ -156,6 +159,33 @@ query_cache_t::ref_t::ref_t(query_cache_t *_query_cache,
     wait_interruptible(mutex_lock.acq_signal(), interruptor);
 }
 
+void query_cache_t::ref_t::record_slow_query(
+        const response_t &res, ticks_t duration, bool continuation,
+        const resource_usage_t &resources) {
+    slow_query_log_t::entry_t slow_query;
+    slow_query.id = generate_uuid();
+    slow_query.job_id = entry->job_id;
+    slow_query.started_at = current_microtime() - duration.nanos / THOUSAND;
+    slow_query.duration = duration;
+    slow_query.continuation = continuation;
+    slow_query.query = pprint::pretty_print_as_js(
+        printed_query_columns, entry->term_storage->root_term());
+    slow_query.client_addr_port = query_cache->client_addr_port;
+    slow_query.user = query_cache->get_user_context().to_string();
+    if (res.type() == Response::SUCCESS_ATOM
+            && res.data().size() == 1
+            && res.data()[0].get_type() == datum_t::R_ARRAY) {
+        slow_query.rows_returned = res.data()[0].arr_size();
+    } else {
+        slow_query.rows_returned = res.data().size();
+    }
+    slow_query.resources = resources;
+    if (trace.has()) {
+        slow_query.profile.set(std::move(*trace).extract_event_log());
+    }
+    query_cache->rdb_ctx->slow_query_log.record(std::move(slow_query));
+}
+
 void query_cache_t::async_destroy_entry(query_cache_t::entry_t *entry) {
     delete entry;
 }
@@ -206,6 +236,10 @@ void query_cache_t::ref_t::fill_response(response_t *res) {
             serializable,
             trace.get_or_null());
 
+        resource_account_scope_t resource_account_scope(&entry->resources);
+        const resource_usage_t usage_before = entry->resources.get_usage();
+        ticks_t start_time = get_ticks();
+        bool continuation = entry->state == entry_t::state_t::STREAM;
         if (entry->state == entry_t::state_t::START) {
             run(&env, res);
             entry->term_tree.reset();
@@ -215,9 +249,23 @@ void query_cache_t::ref_t::fill_response(response_t *res) {
             serve(&env, res);
         }
 
+        // Changefeeds wait for changes for as long as they have to, so how long
+        // they took doesn't say anything about how fast we are.
+        ticks_t duration{get_ticks().nanos - start_time.nanos};
+        bool is_feed = entry->stream.has()
+            && entry->stream->cfeed_type() != feed_type_t::not_feed;
+        if (!is_feed) {
+            query_cache->rdb_ctx->stats.query_latency.record(duration);
+        }
+
         if (trace.has()) {
             res->set_profile(trace->as_datum());
         }
+
+        if (!is_feed && query_cache->rdb_ctx->slow_query_log.should_record(duration)) {
+            record_slow_query(*res, duration, continuation,
+                              entry->resources.get_usage().since(usage_before));
+        }
     } catch (const interrupted_exc_t &ex) {
         // We grab this before `terminate_internal` which will always pulse it.
         bool persistent_interruptor_pulsed = entry->persistent_interruptor.is_pulsed();
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "arch/address.hpp"
+#include "arch/runtime/resource_account.hpp"
 #include "clustering/administration/auth/user_context.hpp"
 #include "concurrency/auto_drainer.hpp"
 #include "concurrency/new_mutex.hpp"
@@ -59,6 +60,9 @@ public:
         void run(env_t *env, response_t *res);
         // Serve a batch from a stream
         void serve(env_t *env, response_t *res);
+        // Add the batch that was just served to the slow query log
+        void record_slow_query(const response_t &res, ticks_t duration,
+                               bool continuation, const resource_usage_t &resources);
 
         query_cache_t::entry_t *const entry;
         const int64_t token;
@@ -81,6 +85,13 @@ public:
     // Helper function used by the jobs table
     ip_and_port_t get_client_addr_port() const { return client_addr_port; }
 
+    // Whether there's a query or cursor with this token
+    bool contains(int64_t token) const { return queries.count(token) != 0; }
+
+    return_empty_normal_batches_t get_return_empty_normal_batches() const {
+        return return_empty_normal_batches;
+    }
+
     // Methods to obtain a unique reference to a given entry in the cache
     scoped_ptr_t<ref_t> create(query_params_t *query_params,
                                ql::datum_t &&deterministic_time,
@@ -125,6 +136,9 @@ private:
         const ql::datum_t deterministic_time;
         const kiloticks_t start_time;
 
+        // Everything the query did so far, for the jobs table
+        resource_account_t resources;
+
         cond_t persistent_interruptor;
 
         // This will be empty if the root term has already been run
@@ -146,6 +160,9 @@ private:
 
     static void async_destroy_entry(entry_t *entry);
 
+    // How wide the queries in the slow query log are printed
+    static const size_t printed_query_columns;
+
     rdb_context_t *const rdb_ctx;
     ip_and_port_t client_addr_port;
     return_empty_normal_batches_t return_empty_normal_batches;
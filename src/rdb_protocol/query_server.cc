@@ -10,12 +10,14 @@
 #include "rdb_protocol/response.hpp"
 
 rdb_query_server_t::rdb_query_server_t(
-    const std::set<ip_address_t> &local_addresses, int port,
-    rdb_context_t *_rdb_ctx, server_config_client_t *_server_config_client,
+    const std::set<ip_address_t> &local_addresses, int port, bool reuse_port,
+    bool spread_queries, rdb_context_t *_rdb_ctx,
+    server_config_client_t *_server_config_client,
     const server_id_t &_server_id, tls_ctx_t *tls_ctx
 ) :
     server(
-        _rdb_ctx, local_addresses, port, this, default_http_timeout_sec, tls_ctx
+        _rdb_ctx, local_addresses, port, reuse_port, spread_queries, this,
+        default_http_timeout_sec, tls_ctx
     ),
     rdb_ctx(_rdb_ctx),
     server_config_client(_server_config_client),
@@ -21,8 +21,9 @@ class rdb_context_t;
 class rdb_query_server_t : public query_handler_t {
 public:
     rdb_query_server_t(
-      const std::set<ip_address_t> &local_addresses, int port,
-      rdb_context_t *_rdb_ctx, server_config_client_t *_server_config_client,
+      const std::set<ip_address_t> &local_addresses, int port, bool reuse_port,
+      bool spread_queries, rdb_context_t *_rdb_ctx,
+      server_config_client_t *_server_config_client,
       const server_id_t &_server_id, tls_ctx_t *tls_ctx);
 
     http_app_t *get_http_app();
@@ -1,6 +1,7 @@
 // Copyright 2010-2014 RethinkDB, all rights reserved
 #include "rdb_protocol/real_table.hpp"
 
+#include "arch/runtime/resource_account.hpp"
 #include "clustering/administration/auth/permission_error.hpp"
 #include "clustering/administration/tables/table_metadata.hpp"
 #include "clustering/table_manager/table_meta_client.hpp"
@@ -369,6 +370,12 @@ void real_table_t::read_with_profile(ql::env_t *env, const read_t &read,
 
     /* Append the results of the profile to the current task */
     splitter.give_splits(response->n_shards, response->event_log);
+
+    /* The shards did the work on other coroutines, so we have to charge it to the
+    query ourselves. */
+    if (resource_account_t *resource_account = resource_account_t::current()) {
+        resource_account->charge(response->resources);
+    }
 }
 
 void real_table_t::write_with_profile(ql::env_t *env, write_t *write,
@@ -405,5 +412,11 @@ void real_table_t::write_with_profile(ql::env_t *env, write_t *write,
 
     /* Append the results of the profile to the current task */
     splitter.give_splits(response->n_shards, response->event_log);
+
+    /* The shards did the work on other coroutines, so we have to charge it to the
+    query ourselves. */
+    if (resource_account_t *resource_account = resource_account_t::current()) {
+        resource_account->charge(response->resources);
+    }
 }
 
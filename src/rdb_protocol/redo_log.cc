@@ -0,0 +1,363 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "rdb_protocol/redo_log.hpp"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+#include <algorithm>
+#include <utility>
+
+#include "arch/io/disk.hpp"
+#include "arch/runtime/thread_pool.hpp"
+#include "config/args.hpp"
+#include "containers/archive/buffer_stream.hpp"
+#include "containers/archive/stl_types.hpp"
+#include "containers/archive/vector_stream.hpp"
+#include "serializer/checksum.hpp"
+
+/* Once the current log file exceeds this size, the store starts a checkpoint. */
+#define REDO_LOG_CHECKPOINT_SIZE (32 * MEGABYTE)
+
+/* This defines the on-disk format. Don't change it without changing the magic. */
+ATTR_PACKED(struct redo_log_file_header_t {
+    char magic[8];
+    uint64_t generation;
+    int32_t cluster_version;
+    uint32_t padding;
+});
+
+/* Every record consists of this header, followed by the serialized record padded with
+zeroes to a multiple of four bytes. The checksum covers the padded payload. */
+ATTR_PACKED(struct redo_log_record_header_t {
+    uint32_t payload_size;
+    uint32_t padding;
+    serializer_checksum checksum;
+});
+
+static const char redo_log_magic[8] = { 'r', 'd', 'b', 'r', 'e', 'd', 'o', '1' };
+
+/* The metainfo blobs are serialized as strings, so that the log doesn't need to know
+what they contain. */
+static region_map_t<std::string> blobs_to_strings(
+        const region_map_t<binary_blob_t> &blobs) {
+    return blobs.map(blobs.get_domain(),
+        [](const binary_blob_t &blob) -> std::string {
+            return std::string(static_cast<const char *>(blob.data()), blob.size());
+        });
+}
+
+static region_map_t<binary_blob_t> strings_to_blobs(
+        const region_map_t<std::string> &strings) {
+    return strings.map(strings.get_domain(),
+        [](const std::string &str) -> binary_blob_t {
+            return binary_blob_t(
+                reinterpret_cast<const uint8_t *>(str.data()), str.size());
+        });
+}
+
+static scoped_fd_t open_log_file(const std::string &filename, bool create) {
+#ifdef _WIN32
+    HANDLE h = CreateFile(filename.c_str(),
+        GENERIC_READ | FILE_APPEND_DATA, FILE_SHARE_READ, NULL,
+        create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    return scoped_fd_t(h);
+#else
+    int res;
+    do {
+        res = open(filename.c_str(),
+            create ? (O_RDWR | O_APPEND | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+    } while (res == INVALID_FD && get_errno() == EINTR);
+    return scoped_fd_t(res);
+#endif
+}
+
+static void write_and_sync(fd_t fd, const char *data, size_t size,
+                           const std::string &filename) {
+#ifdef _WIN32
+    DWORD bytes_written;
+    BOOL res = WriteFile(fd, data, size, &bytes_written, nullptr);
+    guarantee_winerr(res && bytes_written == size,
+                     "could not write to redo log %s", filename.c_str());
+#else
+    while (size > 0) {
+        ssize_t res = ::write(fd, data, size);
+        if (res == -1 && get_errno() == EINTR) {
+            continue;
+        }
+        guarantee_err(res != -1, "could not write to redo log %s", filename.c_str());
+        data += res;
+        size -= res;
+    }
+#endif
+    int sync_res = perform_datasync(fd);
+    guarantee_xerr(sync_res == 0, sync_res, "could not sync redo log %s",
+                   filename.c_str());
+}
+
+/* Creates an empty log file that contains only a header for `generation`. */
+static scoped_fd_t create_log_file(const std::string &filename, uint64_t generation) {
+    scoped_fd_t fd = open_log_file(filename, true);
+#ifdef _WIN32
+    guarantee_winerr(fd.get() != INVALID_FD,
+                     "could not create redo log %s", filename.c_str());
+#else
+    guarantee_err(fd.get() != INVALID_FD,
+                  "could not create redo log %s", filename.c_str());
+#endif
+    redo_log_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, redo_log_magic, sizeof(redo_log_magic));
+    header.generation = generation;
+    header.cluster_version = static_cast<int32_t>(cluster_version_t::CLUSTER);
+    write_and_sync(fd.get(), reinterpret_cast<const char *>(&header), sizeof(header),
+                   filename);
+    warn_fsync_parent_directory(filename.c_str());
+    return fd;
+}
+
+/* Reads the whole file. Returns `false` if it doesn't exist. */
+static bool read_log_file(const std::string &filename, std::string *contents_out) {
+    scoped_fd_t fd = open_log_file(filename, false);
+    if (fd.get() == INVALID_FD) {
+        return false;
+    }
+    const size_t chunk_size = MEGABYTE;
+    contents_out->clear();
+    while (true) {
+        size_t offset = contents_out->size();
+        contents_out->resize(offset + chunk_size);
+        int64_t res = pread(fd.get(), &(*contents_out)[offset], chunk_size, offset);
+        guarantee_err(res != -1, "could not read redo log %s", filename.c_str());
+        contents_out->resize(offset + res);
+        if (res == 0) {
+            return true;
+        }
+    }
+}
+
+static void unlink_log_file(const std::string &filename) {
+    const int res = ::unlink(filename.c_str());
+    guarantee_err(res == 0 || get_errno() == ENOENT,
+                  "could not remove redo log %s", filename.c_str());
+}
+
+/* Parses the records in `contents`, stopping at the first one that's incomplete or
+doesn't match its checksum. */
+static void parse_records(const std::string &filename,
+                          const std::string &contents,
+                          std::vector<redo_log_t::record_t> *records_out) {
+    size_t offset = sizeof(redo_log_file_header_t);
+    while (offset + sizeof(redo_log_record_header_t) <= contents.size()) {
+        redo_log_record_header_t header;
+        memcpy(&header, contents.data() + offset, sizeof(header));
+        offset += sizeof(header);
+        size_t padded_size = (header.payload_size + 3) & ~size_t(3);
+        if (offset + padded_size > contents.size()) {
+            break;
+        }
+        serializer_checksum checksum = compute_checksum(
+            contents.data() + offset, padded_size / serializer_checksum::word_size);
+        if (checksum.value != header.checksum.value) {
+            break;
+        }
+
+        buffer_read_stream_t stream(contents.data() + offset, header.payload_size);
+        region_map_t<std::string> old_metainfo, new_metainfo;
+        redo_log_t::record_t record;
+        archive_result_t res =
+            deserialize<cluster_version_t::CLUSTER>(&stream, &old_metainfo);
+        if (!bad(res)) {
+            res = deserialize<cluster_version_t::CLUSTER>(&stream, &new_metainfo);
+        }
+        if (!bad(res)) {
+            res = deserialize<cluster_version_t::CLUSTER>(&stream, &record.write);
+        }
+        if (!bad(res)) {
+            res = deserialize<cluster_version_t::CLUSTER>(&stream, &record.timestamp);
+        }
+        /* The checksum matched, so this isn't a torn write. */
+        guarantee_deserialization(res, "redo log record in %s", filename.c_str());
+        record.old_metainfo = strings_to_blobs(old_metainfo);
+        record.new_metainfo = strings_to_blobs(new_metainfo);
+        records_out->push_back(std::move(record));
+        offset += padded_size;
+    }
+}
+
+redo_log_t::redo_log_t(const std::string &_path) :
+    path(_path),
+    current_generation(0),
+    current_size(0),
+    old_generation(0),
+    appended_count(0),
+    durable_count(0) { }
+
+redo_log_t::~redo_log_t() {
+    assert_thread();
+}
+
+std::string redo_log_t::slot_path(const std::string &p, int slot) {
+    return strprintf("%s.%d", p.c_str(), slot);
+}
+
+std::vector<redo_log_t::record_t> redo_log_t::read_records() {
+    assert_thread();
+    std::vector<std::pair<uint64_t, std::string> > files;
+    thread_pool_t::run_in_blocker_pool([&]() {
+        for (int slot = 0; slot < 2; ++slot) {
+            std::string contents;
+            if (read_log_file(slot_path(path, slot), &contents)
+                    && contents.size() >= sizeof(redo_log_file_header_t)) {
+                redo_log_file_header_t header;
+                memcpy(&header, contents.data(), sizeof(header));
+                if (memcmp(header.magic, redo_log_magic, sizeof(redo_log_magic)) != 0) {
+                    continue;
+                }
+                if (header.cluster_version
+                        != static_cast<int32_t>(cluster_version_t::CLUSTER)) {
+                    fail_due_to_user_error(
+                        "The redo log %s was written by a different version of "
+                        "RethinkDB. Start the server with the version that wrote it "
+                        "first, so that it can apply the log.",
+                        slot_path(path, slot).c_str());
+                }
+                uint64_t generation = header.generation;
+                files.push_back(std::make_pair(generation, std::move(contents)));
+            }
+        }
+    });
+    std::sort(files.begin(), files.end(),
+        [](const std::pair<uint64_t, std::string> &a,
+           const std::pair<uint64_t, std::string> &b) {
+            return a.first < b.first;
+        });
+
+    std::vector<record_t> records;
+    for (const auto &file : files) {
+        parse_records(slot_path(path, file.first % 2), file.second, &records);
+        current_generation = std::max(current_generation, file.first);
+    }
+    return records;
+}
+
+void redo_log_t::clear() {
+    assert_thread();
+    guarantee(old_fd.get() == INVALID_FD);
+    const uint64_t generation = current_generation + 1;
+    scoped_fd_t fd;
+    thread_pool_t::run_in_blocker_pool([&]() {
+        fd = create_log_file(slot_path(path, generation % 2), generation);
+        unlink_log_file(slot_path(path, (generation + 1) % 2));
+    });
+    current_fd = std::move(fd);
+    current_generation = generation;
+    current_size = sizeof(redo_log_file_header_t);
+    pending.clear();
+    durable_count = appended_count;
+}
+
+void redo_log_t::append(const region_map_t<binary_blob_t> &old_metainfo,
+                        const region_map_t<binary_blob_t> &new_metainfo,
+                        const write_t &write,
+                        state_timestamp_t timestamp) {
+    assert_thread();
+    guarantee(current_fd.get() != INVALID_FD, "redo log was not cleared before use");
+
+    write_message_t wm;
+    serialize<cluster_version_t::CLUSTER>(&wm, blobs_to_strings(old_metainfo));
+    serialize<cluster_version_t::CLUSTER>(&wm, blobs_to_strings(new_metainfo));
+    serialize<cluster_version_t::CLUSTER>(&wm, write);
+    serialize<cluster_version_t::CLUSTER>(&wm, timestamp);
+    vector_stream_t stream;
+    stream.reserve(wm.size());
+    int res = send_write_message(&stream, &wm);
+    guarantee(res == 0);
+    const std::vector<char> &payload = stream.vector();
+
+    redo_log_record_header_t header;
+    header.payload_size = payload.size();
+    header.padding = 0;
+    size_t padded_size = (payload.size() + 3) & ~size_t(3);
+    size_t offset = pending.size();
+    pending.resize(offset + sizeof(header) + padded_size, '\0');
+    char *payload_start = &pending[offset + sizeof(header)];
+    memcpy(payload_start, payload.data(), payload.size());
+    header.checksum = compute_checksum(
+        payload_start, padded_size / serializer_checksum::word_size);
+    memcpy(&pending[offset], &header, sizeof(header));
+
+    current_size += sizeof(header) + padded_size;
+    ++appended_count;
+}
+
+void redo_log_t::flush(signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+    const uint64_t target = appended_count;
+    if (durable_count >= target) {
+        return;
+    }
+    new_mutex_acq_t acq(&io_mutex, interruptor);
+    /* Whoever held the mutex before us may have written our records along with
+    theirs. */
+    if (durable_count >= target) {
+        return;
+    }
+    std::string data;
+    data.swap(pending);
+    const uint64_t new_durable_count = appended_count;
+    const fd_t fd = current_fd.get();
+    const std::string filename = slot_path(path, current_generation % 2);
+    thread_pool_t::run_in_blocker_pool([&]() {
+        write_and_sync(fd, data.data(), data.size(), filename);
+    });
+    durable_count = new_durable_count;
+}
+
+bool redo_log_t::needs_checkpoint() const {
+    return current_size > static_cast<uint64_t>(REDO_LOG_CHECKPOINT_SIZE);
+}
+
+void redo_log_t::begin_checkpoint(signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+    new_mutex_acq_t acq(&io_mutex, interruptor);
+    guarantee(old_fd.get() == INVALID_FD);
+    const uint64_t generation = current_generation + 1;
+    scoped_fd_t fd;
+    thread_pool_t::run_in_blocker_pool([&]() {
+        fd = create_log_file(slot_path(path, generation % 2), generation);
+    });
+    /* Records that are still in `pending` will go to the new file, which is fine; all
+    that matters is that the old file only contains records from before this point. */
+    old_fd = std::move(current_fd);
+    old_generation = current_generation;
+    current_fd = std::move(fd);
+    current_generation = generation;
+    current_size = sizeof(redo_log_file_header_t) + pending.size();
+}
+
+void redo_log_t::finish_checkpoint(signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+    new_mutex_acq_t acq(&io_mutex, interruptor);
+    guarantee(old_fd.get() != INVALID_FD);
+    scoped_fd_t fd = std::move(old_fd);
+    const std::string filename = slot_path(path, old_generation % 2);
+    thread_pool_t::run_in_blocker_pool([&]() {
+        fd.reset();
+        unlink_log_file(filename);
+    });
+}
+
+void redo_log_t::destroy(const std::string &p) {
+    thread_pool_t::run_in_blocker_pool([&]() {
+        unlink_log_file(slot_path(p, 0));
+        unlink_log_file(slot_path(p, 1));
+    });
+}
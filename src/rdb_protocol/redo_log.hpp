@@ -0,0 +1,112 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef RDB_PROTOCOL_REDO_LOG_HPP_
+#define RDB_PROTOCOL_REDO_LOG_HPP_
+
+#include <string>
+#include <vector>
+
+#include "arch/io/io_utils.hpp"
+#include "concurrency/new_mutex.hpp"
+#include "containers/binary_blob.hpp"
+#include "rdb_protocol/protocol.hpp"
+#include "region/region_map.hpp"
+#include "threading.hpp"
+#include "timestamps.hpp"
+
+/* `redo_log_t` is a sequential log of the writes that a `store_t` has applied. It lets
+the store make hard-durability writes durable by appending a small record to the log and
+syncing that, instead of flushing every block that the write dirtied in the cache. The
+dirty blocks are written out later by soft-durability flushes, and the log is
+checkpointed (see `begin_checkpoint()`) once it grows large.
+
+On disk the log consists of two files, `<path>.0` and `<path>.1`. Each starts with a
+header that records its generation; new records always go to the file with the highest
+generation. A checkpoint switches to the other file, so that the old one can be deleted
+once everything in it has been made durable in the store itself.
+
+`redo_log_t` must only be used on its home thread. Blocking file operations run in the
+blocker pool. */
+
+class redo_log_t : public home_thread_mixin_t {
+public:
+    class record_t {
+    public:
+        /* The store's metainfo for the write's region before and after the write. On
+        replay, a record is only applied if the store's metainfo still matches
+        `old_metainfo`. */
+        region_map_t<binary_blob_t> old_metainfo;
+        region_map_t<binary_blob_t> new_metainfo;
+        write_t write;
+        state_timestamp_t timestamp;
+    };
+
+    /* Doesn't touch the disk. Before appending anything, call `read_records()` to
+    find out what a previous run left behind, and then `clear()`. */
+    explicit redo_log_t(const std::string &path);
+    ~redo_log_t();
+
+    /* Returns every intact record in the log, oldest first. A torn record at the end of
+    a file (from a crash in the middle of an append) and everything after it are
+    ignored. */
+    std::vector<record_t> read_records();
+
+    /* Discards every record and starts a fresh, empty log. Only call this once the
+    store has made all of the records durable on its own, and not concurrently with
+    anything else. */
+    void clear();
+
+    /* Queues a record. It doesn't become durable until a subsequent call to `flush()`
+    returns. Doesn't block. */
+    void append(const region_map_t<binary_blob_t> &old_metainfo,
+                const region_map_t<binary_blob_t> &new_metainfo,
+                const write_t &write,
+                state_timestamp_t timestamp);
+
+    /* Makes every record that was appended before the call durable. Concurrent calls
+    are combined into a single write and sync. */
+    void flush(signal_t *interruptor) THROWS_ONLY(interrupted_exc_t);
+
+    /* Returns `true` if the current log file has grown large enough that the store
+    should checkpoint. */
+    bool needs_checkpoint() const;
+
+    /* A checkpoint happens in two steps. `begin_checkpoint()` directs all later records
+    to a fresh file. The caller must then make every write that was appended before
+    `begin_checkpoint()` returned durable in the store, and then call
+    `finish_checkpoint()`, which deletes the old file. If the server crashes in between,
+    both files are replayed, which is harmless because replay skips records that have
+    already been applied. */
+    void begin_checkpoint(signal_t *interruptor) THROWS_ONLY(interrupted_exc_t);
+    void finish_checkpoint(signal_t *interruptor) THROWS_ONLY(interrupted_exc_t);
+
+    /* Deletes the log files belonging to `path`, if there are any. Blocks. */
+    static void destroy(const std::string &path);
+
+private:
+    static std::string slot_path(const std::string &path, int slot);
+
+    const std::string path;
+
+    /* The file that new records are written to, and its generation. */
+    scoped_fd_t current_fd;
+    uint64_t current_generation;
+    uint64_t current_size;
+
+    /* The file that's being replaced by a checkpoint that's still in progress. */
+    scoped_fd_t old_fd;
+    uint64_t old_generation;
+
+    /* Serialized records that haven't been written yet. `appended_count` counts all
+    records that were ever appended, and `durable_count` counts those that are known to be
+    on disk. */
+    std::string pending;
+    uint64_t appended_count;
+    uint64_t durable_count;
+
+    /* Serializes writes to the files, and switches from one file to another. */
+    new_mutex_t io_mutex;
+
+    DISABLE_COPYING(redo_log_t);
+};
+
+#endif  // RDB_PROTOCOL_REDO_LOG_HPP_
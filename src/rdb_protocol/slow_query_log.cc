@@ -0,0 +1,82 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "rdb_protocol/slow_query_log.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "concurrency/pmap.hpp"
+#include "config/args.hpp"
+#include "threading.hpp"
+
+slow_query_log_t::slow_query_log_t()
+    : threshold_nanos_(SLOW_QUERY_LOG_DEFAULT_THRESHOLD_MS * MILLION),
+      capacity_(SLOW_QUERY_LOG_DEFAULT_CAPACITY) { }
+
+int64_t slow_query_log_t::get_threshold_nanos() const {
+    return threshold_nanos_.load(std::memory_order_relaxed);
+}
+
+size_t slow_query_log_t::get_capacity() const {
+    return capacity_.load(std::memory_order_relaxed);
+}
+
+void slow_query_log_t::set_config(int64_t threshold_nanos, size_t capacity) {
+    guarantee(capacity > 0);
+    threshold_nanos_.store(threshold_nanos, std::memory_order_relaxed);
+    capacity_.store(capacity, std::memory_order_relaxed);
+}
+
+bool slow_query_log_t::should_record(ticks_t duration) const {
+    int64_t threshold_nanos = get_threshold_nanos();
+    return threshold_nanos >= 0 && duration.nanos >= threshold_nanos;
+}
+
+void slow_query_log_t::record(entry_t &&entry) {
+    std::deque<entry_t> *entries = entries_.get();
+    entries->push_back(std::move(entry));
+    // Any thread might have had all of the most recent slow queries, so each one
+    // keeps as many as the whole log.
+    size_t capacity = get_capacity();
+    while (entries->size() > capacity) {
+        entries->pop_front();
+    }
+}
+
+std::vector<slow_query_log_t::entry_t> slow_query_log_t::get_entries() {
+    // The capacity might have shrunk since the rings were last trimmed.
+    size_t capacity = get_capacity();
+    std::vector<std::vector<entry_t> > entries_per_thread(get_num_threads());
+    pmap(get_num_threads(), [&](int thread) {
+        on_thread_t thread_switcher((threadnum_t(thread)));
+        const std::deque<entry_t> *entries = entries_.get();
+        size_t skip = entries->size() - std::min(entries->size(), capacity);
+        entries_per_thread[thread].assign(entries->begin() + skip, entries->end());
+    });
+
+    std::vector<entry_t> res;
+    for (std::vector<entry_t> &entries : entries_per_thread) {
+        std::move(entries.begin(), entries.end(), std::back_inserter(res));
+    }
+    std::sort(res.begin(), res.end(), [](const entry_t &a, const entry_t &b) {
+        return a.started_at < b.started_at;
+    });
+    if (res.size() > capacity) {
+        res.erase(res.begin(), res.end() - capacity);
+    }
+    return res;
+}
+
+bool slow_query_log_t::erase_entry(const uuid_u &id) {
+    bool found = false;
+    pmap(get_num_threads(), [&](int thread) {
+        on_thread_t thread_switcher((threadnum_t(thread)));
+        std::deque<entry_t> *entries = entries_.get();
+        auto it = std::find_if(entries->begin(), entries->end(),
+            [&](const entry_t &entry) { return entry.id == id; });
+        if (it != entries->end()) {
+            entries->erase(it);
+            found = true;
+        }
+    });
+    return found;
+}
@@ -0,0 +1,80 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#ifndef RDB_PROTOCOL_SLOW_QUERY_LOG_HPP_
+#define RDB_PROTOCOL_SLOW_QUERY_LOG_HPP_
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "arch/address.hpp"
+#include "arch/runtime/resource_account.hpp"
+#include "concurrency/one_per_thread.hpp"
+#include "containers/optional.hpp"
+#include "containers/uuid.hpp"
+#include "rdb_protocol/profile.hpp"
+#include "time.hpp"
+
+/* `slow_query_log_t` remembers the most recent batches of queries that took longer
+than a threshold to run. The query cache records them, and the
+`rethinkdb._debug_slow_queries` table shows them and changes the configuration.
+
+Every thread keeps its own ring of up to `get_capacity()` entries, so recording a slow
+query never needs to switch threads or take a lock. `get_entries()` merges the rings and
+only returns the most recent `get_capacity()` entries overall. Entries only hold plain
+data; they are turned into datums by whoever reads them.
+
+Timing a batch is cheap, but profiling it isn't, and a profile trace also keeps point
+reads off their fast path. So an entry only has a profile if the client asked for
+one. */
+
+class slow_query_log_t {
+public:
+    struct entry_t {
+        uuid_u id;
+        uuid_u job_id;
+        /* Wall-clock time, when the batch started. */
+        microtime_t started_at;
+        ticks_t duration;
+        /* True if this batch was a `CONTINUE` of a stream rather than the initial
+        `START` of the query. */
+        bool continuation;
+        std::string query;
+        ip_and_port_t client_addr_port;
+        std::string user;
+        size_t rows_returned;
+        /* What the batch cost, from the query's `resource_account_t`. */
+        resource_usage_t resources;
+        /* Empty unless the batch was profiled. */
+        optional<profile::event_log_t> profile;
+    };
+
+    slow_query_log_t();
+
+    /* All of these may be called on any thread. A negative threshold means that
+    nothing is logged. */
+    int64_t get_threshold_nanos() const;
+    size_t get_capacity() const;
+    void set_config(int64_t threshold_nanos, size_t capacity);
+
+    bool should_record(ticks_t duration) const;
+
+    /* Adds an entry to the current thread's ring, dropping the oldest one if the ring
+    is full. */
+    void record(entry_t &&entry);
+
+    /* These visit every thread, so they block. `get_entries()` returns the entries
+    ordered by start time. */
+    std::vector<entry_t> get_entries();
+    bool erase_entry(const uuid_u &id);
+
+private:
+    std::atomic<int64_t> threshold_nanos_;
+    std::atomic<size_t> capacity_;
+
+    one_per_thread_t<std::deque<entry_t> > entries_;
+
+    DISABLE_COPYING(slow_query_log_t);
+};
+
+#endif  // RDB_PROTOCOL_SLOW_QUERY_LOG_HPP_
@@ -3,6 +3,7 @@
 
 #include <list>
 
+#include "arch/runtime/resource_account.hpp"
 #include "btree/backfill_debug.hpp"
 #include "btree/reql_specific.hpp"
 #include "btree/superblock.hpp"
@@ -966,7 +967,10 @@ void store_t::protocol_write(const write_t &_write,
                              signal_t *interruptor) {
     scoped_ptr_t<profile::trace_t> trace = ql::maybe_make_profile_trace(_write.profile);
 
+    // Measure what our part of the query costs, so that the query can report it.
+    resource_account_t resource_account;
     {
+        resource_account_scope_t resource_account_scope(&resource_account);
         profile::sampler_t start_write("Perform write on shard.", trace);
         rdb_write_visitor_t v(btree.get(),
                               this,
@@ -981,6 +985,7 @@ void store_t::protocol_write(const write_t &_write,
         boost::apply_visitor(v, _write.write);
     }
 
+    response->resources = resource_account.get_usage();
     response->n_shards = 1;
     if (trace.has()) {
         response->event_log = std::move(*trace).extract_event_log();
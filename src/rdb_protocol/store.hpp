@@ -25,6 +25,7 @@
 #include "rdb_protocol/changefeed.hpp"
 #include "rdb_protocol/protocol.hpp"
 #include "rdb_protocol/store_metainfo.hpp"
+#include "serializer/types.hpp"
 #include "rpc/mailbox/typed.hpp"
 #include "store_view.hpp"
 #include "utils.hpp"
@@ -36,6 +37,7 @@ class cache_t;
 class internal_disk_backed_queue_t;
 class io_backender_t;
 class real_superblock_t;
+class redo_log_t;
 class sindex_superblock_t;
 class superblock_t;
 class txn_t;
@@ -94,6 +96,17 @@ public:
 
     void note_reshard(const region_t &shard_region);
 
+    /* Starts recording every write in a redo log at `path` (see `redo_log.hpp`), so that
+    hard durability only has to sync the log instead of the cache. Writes that a
+    previous run left in the log are replayed first. Call this right after
+    construction, before anything else uses the store. */
+    void enable_redo_log(const std::string &path, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t);
+
+    /* Changes how eagerly the serializer underneath this store compacts its file.
+    Stores that share a serializer share the setting. */
+    void set_gc_mode(gc_mode_t mode);
+
     /* store_view_t interface */
 
     void new_read_token(read_token_t *token_out);
@@ -114,6 +127,12 @@ public:
             signal_t *interruptor)
         THROWS_ONLY(interrupted_exc_t);
 
+    void sync(
+            order_token_t order_token,
+            write_token_t *token,
+            signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t);
+
     cluster_version_t metainfo_version(read_token_t *token,
                                        signal_t *interruptor);
 
@@ -305,6 +324,14 @@ public:
                        real_superblock_t *superblock,
                        signal_t *interruptor);
 
+    /* Answers point reads straight from the cache when that doesn't require acquiring
+    any blocks. Returns `false` if the read has to take the regular path. */
+    bool try_read_without_acquiring(const read_t &read,
+                                    read_response_t *response,
+                                    read_token_t *token,
+                                    signal_t *interruptor)
+            THROWS_ONLY(interrupted_exc_t);
+
     void protocol_write(const write_t &write,
                         write_response_t *response,
                         state_timestamp_t timestamp,
@@ -372,6 +399,7 @@ public:
     fifo_enforcer_sink_t main_token_sink, sindex_token_sink;
 
     perfmon_collection_t perfmon_collection;
+    serializer_t *const serializer;
     // Mind the constructor ordering. We must destruct the cache and btree
     // before we destruct perfmon_collection
     scoped_ptr_t<cache_t> cache;
@@ -440,6 +468,21 @@ private:
     // the superblock, if any).
     new_semaphore_t write_superblock_acq_semaphore;
 
+    // Flushes every write that came before `token` from the cache to disk.
+    void sync_cache(write_token_t *token, signal_t *interruptor)
+        THROWS_ONLY(interrupted_exc_t);
+
+    // Rotates the redo log and flushes the cache, so that the old log file can be
+    // deleted. To be run in a coroutine.
+    void checkpoint_redo_log(auto_drainer_t::lock_t store_keepalive);
+
+    // Empty unless `enable_redo_log()` was called.
+    scoped_ptr_t<redo_log_t> redo_log;
+    bool redo_log_checkpoint_running;
+    // Set by operations that change the data without going through the redo log, if
+    // they didn't use hard durability. `sync()` has to flush the cache when this is set.
+    bool has_unlogged_changes;
+
 public:
     // This lock is used to pause backfills while secondary indexes are being
     // post constructed. Secondary index post construction gets in line for a write
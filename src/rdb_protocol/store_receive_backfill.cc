@@ -389,6 +389,9 @@ continue_bool_t store_t::receive_backfill(
         THROWS_ONLY(interrupted_exc_t) {
     guarantee(_region.beg == get_region().beg && _region.end == get_region().end);
 
+    /* Backfill items don't go through the redo log. */
+    has_unlogged_changes = true;
+
     unsaved_data_limiter_t unsaved_data_limiter(general_cache_conn.get());
     receive_backfill_info_t info(
         general_cache_conn.get(), btree.get(), &unsaved_data_limiter);
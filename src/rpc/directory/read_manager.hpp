@@ -6,7 +6,6 @@
 #include <memory>
 
 #include "concurrency/auto_drainer.hpp"
-#include "concurrency/fifo_enforcer.hpp"
 #include "concurrency/one_per_thread.hpp"
 #include "concurrency/watchable.hpp"
 #include "concurrency/watchable_map.hpp"
@@ -57,7 +56,7 @@ private:
             connectivity_cluster_t::connection_t *connection,
             auto_drainer_t::lock_t connection_keepalive,
             const std::shared_ptr<metadata_t> &new_value,
-            fifo_enforcer_state_t metadata_fifo_state,
+            uint64_t version,
             auto_drainer_t::lock_t per_thread_keepalive)
             THROWS_NOTHING;
 
@@ -65,7 +64,7 @@ private:
             connectivity_cluster_t::connection_t *connection,
             auto_drainer_t::lock_t connection_keepalive,
             const std::shared_ptr<metadata_t> &new_value,
-            fifo_enforcer_write_token_t metadata_fifo_token,
+            uint64_t version,
             auto_drainer_t::lock_t per_thread_keepalive)
             THROWS_NOTHING;
 
@@ -74,10 +73,11 @@ private:
 
     class connection_info_t {
     public:
-        fifo_enforcer_sink_t *fifo_sink;
+        /* The version of the last value we applied for this connection. The writer
+        coalesces changes and the updates can be reordered on their way to the home
+        thread, so we discard any update that isn't newer than this. */
+        uint64_t version;
 
-        /* Destruction order is important here; the `auto_drainer_t` must be destroyed
-        before the `fifo_sink` pointer goes out of scope. */
         auto_drainer_t drainer;
     };
     std::map<connectivity_cluster_t::connection_t *, connection_info_t *> connection_map;
@@ -89,7 +89,7 @@ private:
     std::multimap<connectivity_cluster_t::connection_t *, cond_t *>
         waiting_for_initialization;
 
-    /* This protects `variable`, `fifo_sinks`, and `waiting_for_initialization` */
+    /* This protects `variable`, `connection_map`, and `waiting_for_initialization` */
     mutex_assertion_t mutex_assertion;
 
     /* Instances of `propagate_initialization()` and `propagate_update()` hold
@@ -51,12 +51,12 @@ void directory_read_manager_t<metadata_t>::on_message(
         case 'I': {
             /* Initial message from another peer */
             std::shared_ptr<metadata_t> initial_value(new metadata_t());
-            fifo_enforcer_state_t metadata_fifo_state;
+            uint64_t version;
             {
                 archive_result_t res =
-                    deserialize<cluster_version_t::CLUSTER>(s, initial_value.get());
+                    deserialize<cluster_version_t::CLUSTER>(s, &version);
                 if (res != archive_result_t::SUCCESS) { throw fake_archive_exc_t(); }
-                res = deserialize<cluster_version_t::CLUSTER>(s, &metadata_fifo_state);
+                res = deserialize<cluster_version_t::CLUSTER>(s, initial_value.get());
                 if (res != archive_result_t::SUCCESS) { throw fake_archive_exc_t(); }
             }
 
@@ -65,7 +65,7 @@ void directory_read_manager_t<metadata_t>::on_message(
             coro_t::spawn_sometime(std::bind(
                 &directory_read_manager_t::handle_connection, this,
                 connection, connection_keepalive,
-                initial_value, metadata_fifo_state,
+                initial_value, version,
                 auto_drainer_t::lock_t(per_thread_drainers.get())));
 
             break;
@@ -74,12 +74,12 @@ void directory_read_manager_t<metadata_t>::on_message(
         case 'U': {
             /* Update from another peer */
             std::shared_ptr<metadata_t> new_value(new metadata_t());
-            fifo_enforcer_write_token_t metadata_fifo_token;
+            uint64_t version;
             {
                 archive_result_t res =
-                    deserialize<cluster_version_t::CLUSTER>(s, new_value.get());
+                    deserialize<cluster_version_t::CLUSTER>(s, &version);
                 if (res != archive_result_t::SUCCESS) { throw fake_archive_exc_t(); }
-                res = deserialize<cluster_version_t::CLUSTER>(s, &metadata_fifo_token);
+                res = deserialize<cluster_version_t::CLUSTER>(s, new_value.get());
                 if (res != archive_result_t::SUCCESS) { throw fake_archive_exc_t(); }
             }
 
@@ -88,7 +88,7 @@ void directory_read_manager_t<metadata_t>::on_message(
             coro_t::spawn_sometime(std::bind(
                 &directory_read_manager_t::propagate_update, this,
                 connection, connection_keepalive,
-                new_value, metadata_fifo_token,
+                new_value, version,
                 auto_drainer_t::lock_t(per_thread_drainers.get())));
 
             break;
@@ -103,7 +103,7 @@ void directory_read_manager_t<metadata_t>::handle_connection(
         connectivity_cluster_t::connection_t *connection,
         auto_drainer_t::lock_t connection_keepalive,
         const std::shared_ptr<metadata_t> &new_value,
-        fifo_enforcer_state_t metadata_fifo_state,
+        uint64_t version,
         auto_drainer_t::lock_t per_thread_keepalive)
         THROWS_NOTHING
 {
@@ -125,9 +125,8 @@ void directory_read_manager_t<metadata_t>::handle_connection(
     map_variable.set_key_no_equals(connection->get_peer_id(), std::move(*new_value));
 
     {
-        fifo_enforcer_sink_t fifo_sink(metadata_fifo_state);
         connection_info_t connection_info;
-        connection_info.fifo_sink = &fifo_sink;
+        connection_info.version = version;
         {
             map_insertion_sentry_t<connectivity_cluster_t::connection_t *,
                                    connection_info_t *>
@@ -155,11 +154,11 @@ void directory_read_manager_t<metadata_t>::handle_connection(
         mutex_assertion_lock.reset();
 
         /* This will block until all instances of `propagate_update` are finished with
-        `fifo_sink`. After this point, no instances of `propagate_update` for this
+        `connection_info`. After this point, no instances of `propagate_update` for this
         connection can touch `variable`. */
         connection_info.drainer.drain();
 
-        /* Now it's safe to delete `fifo_sink` and the directory entry. */
+        /* Now it's safe to delete `connection_info` and the directory entry. */
     }
 
     /* Delete the directory entry */
@@ -177,7 +176,7 @@ void directory_read_manager_t<metadata_t>::propagate_update(
         connectivity_cluster_t::connection_t *connection,
         auto_drainer_t::lock_t connection_keepalive,
         const std::shared_ptr<metadata_t> &new_value,
-        fifo_enforcer_write_token_t metadata_fifo_token,
+        uint64_t version,
         auto_drainer_t::lock_t per_thread_keepalive)
         THROWS_NOTHING
 {
@@ -220,12 +219,6 @@ void directory_read_manager_t<metadata_t>::propagate_update(
                 auto_drainer_t::lock_t(&connection_info->drainer);
         }
 
-        /* Wait until it's our turn to update the directory. This ensures that updates
-        aren't ever reordered; it would be bad if an old update overwrote a newer one. */
-        fifo_enforcer_sink_t::exit_write_t exit_write(connection_info->fifo_sink,
-                                                      metadata_fifo_token);
-        wait_interruptible(&exit_write, &interruptor2);
-
         // This yield is here to avoid heartbeat timeouts in the following scenario:
         //  1. Have a cluster of many nodes, e.g. 64
         //  2. Create a table
@@ -233,6 +226,14 @@ void directory_read_manager_t<metadata_t>::propagate_update(
         coro_t::yield();
 
         DEBUG_VAR mutex_assertion_t::acq_t mutex_assertion_lock(&mutex_assertion);
+
+        /* Drop the update if we've already applied a newer one; it would be bad if an
+        old update overwrote a newer one. */
+        if (version <= connection_info->version) {
+            return;
+        }
+        connection_info->version = version;
+
         variable.apply_atomic_op(
             [&](change_tracking_map_t<peer_id_t, metadata_t> *map) -> bool {
                 map->begin_version();
@@ -6,7 +6,6 @@
 #include <memory>
 
 #include "concurrency/auto_drainer.hpp"
-#include "concurrency/fifo_enforcer.hpp"
 #include "concurrency/new_semaphore.hpp"
 #include "concurrency/watchable.hpp"
 #include "rpc/connectivity/cluster.hpp"
@@ -21,25 +20,65 @@ public:
         connectivity_cluster_t::message_tag_t message_tag,
         const clone_ptr_t<watchable_t<metadata_t> > &value) THROWS_NOTHING;
 
+    /* How many update messages we've sent to peers so far, how many bytes they took up,
+    and how many times we serialized the value. Initial values sent to new connections
+    don't count as updates. These let tests see how much the coalescing saves. */
+    uint64_t get_updates_sent() const { return updates_sent; }
+    uint64_t get_update_bytes_sent() const { return update_bytes_sent; }
+    uint64_t get_serializations() const { return serializations; }
+
 private:
-    class initialization_writer_t;
-    class update_writer_t;
+    /* For each connection, we have an instance of `conn_info_t` in `conns` and a
+    corresponding `stream_to_conn()` coroutine, much like `directory_map_write_manager_t`.
+    When the value changes, we just mark every connection as dirty; the coroutine sends
+    the newest value whenever it gets around to it. So a burst of changes costs one
+    message per peer instead of one message per change per peer, and the value is only
+    serialized once per change no matter how many peers there are. Every message carries
+    `version`, so the other side can discard messages that got reordered. */
+
+    class writer_t;
+
+    class conn_info_t {
+    public:
+        conn_info_t() : dirty(true), pulse_on_dirty(nullptr) { }
+        bool dirty;
+        cond_t *pulse_on_dirty;
+    };
 
     void on_connection_change(
         const peer_id_t &peer_id,
         const connectivity_cluster_t::connection_pair_t *pair) THROWS_NOTHING;
     void on_value_change() THROWS_NOTHING;
+    void stream_to_conn(
+        connectivity_cluster_t::connection_t *connection,
+        auto_drainer_t::lock_t connection_keepalive,
+        auto_drainer_t::lock_t this_keepalive,
+        typename std::map<connectivity_cluster_t::connection_t *, conn_info_t>::iterator
+            conns_entry);
+
+    /* Returns the serialization of the current value, reusing the last one if the
+    value hasn't changed since. */
+    std::shared_ptr<const write_message_t> get_serialized_value();
 
     connectivity_cluster_t *connectivity_cluster;
     connectivity_cluster_t::message_tag_t message_tag;
     clone_ptr_t<watchable_t<metadata_t> > value;
 
-    fifo_enforcer_source_t metadata_fifo_source;
-    std::map<peer_id_t, connectivity_cluster_t::connection_pair_t> last_connections;
-    /* protects `metadata_fifo_source` and `last_connections` */
+    /* `version` is incremented whenever `value` changes. `serialized_value` is the
+    serialization of `value` as of `serialized_version`, or empty. */
+    uint64_t version;
+    uint64_t serialized_version;
+    std::shared_ptr<const write_message_t> serialized_value;
+
+    uint64_t updates_sent;
+    uint64_t update_bytes_sent;
+    uint64_t serializations;
+
+    std::map<connectivity_cluster_t::connection_t *, conn_info_t> conns;
+    /* protects `conns` */
     mutex_assertion_t mutex_assertion;
 
-    /* Any time we want to write to the network, we acquire this first. */
+    /* We acquire this before sending the initial value to a new connection. */
     new_semaphore_t semaphore;
 
     /* Destructor order is important here. First we must destroy the subscriptions, so
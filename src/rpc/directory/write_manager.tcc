@@ -8,6 +8,7 @@
 #include <set>
 
 #include "arch/runtime/coroutines.hpp"
+#include "concurrency/wait_any.hpp"
 #include "containers/archive/versioned.hpp"
 
 #define MAX_OUTSTANDING_DIRECTORY_WRITES 4
@@ -20,6 +21,11 @@ directory_write_manager_t<metadata_t>::directory_write_manager_t(
     connectivity_cluster(connectivity_cluster_),
     message_tag(message_tag_),
     value(value_),
+    version(0),
+    serialized_version(0),
+    updates_sent(0),
+    update_bytes_sent(0),
+    serializations(0),
     semaphore(MAX_OUTSTANDING_DIRECTORY_WRITES),
     value_change_subscription([this]() { this->on_value_change(); }),
     connections_change_subscription(connectivity_cluster->get_connections(),
@@ -33,106 +39,71 @@ directory_write_manager_t<metadata_t>::directory_write_manager_t(
 
 template<class metadata_t>
 void directory_write_manager_t<metadata_t>::on_connection_change(
-        const peer_id_t &peer_id,
+        UNUSED const peer_id_t &peer_id,
         const connectivity_cluster_t::connection_pair_t *pair) THROWS_NOTHING {
     DEBUG_VAR mutex_assertion_t::acq_t mutex_assertion_lock(&mutex_assertion);
-    if (pair != nullptr && last_connections.count(peer_id) == 0) {
-        connectivity_cluster_t::connection_t *connection = pair->first;
-        auto_drainer_t::lock_t connection_keepalive = pair->second;
-        last_connections.insert(std::make_pair(peer_id, *pair));
-        auto_drainer_t::lock_t this_keepalive(&drainer);
-        metadata_t initial_value = value.get()->get();
-        fifo_enforcer_state_t initial_state = metadata_fifo_source.get_state();
-        coro_t::spawn_sometime(
-            [this, this_keepalive /* important to capture */,
-                    connection, connection_keepalive /* important to capture */,
-                    initial_value, initial_state]() {
-                new_semaphore_in_line_t acq(&this->semaphore, 1);
-                acq.acquisition_signal()->wait();
-                initialization_writer_t writer(initial_value, initial_state);
-                connectivity_cluster->send_message(connection, connection_keepalive,
-                        message_tag, &writer);
-            });
-    }
-    if (pair == nullptr && last_connections.count(peer_id) == 1) {
-        last_connections.erase(peer_id);
+    if (pair != nullptr) {
+        auto res = conns.insert(std::make_pair(pair->first, conn_info_t()));
+        if (res.second) {
+            coro_t::spawn_sometime(std::bind(
+                &directory_write_manager_t::stream_to_conn, this,
+                pair->first, pair->second, drainer.lock(), res.first));
+        }
     }
 }
 
 template<class metadata_t>
 void directory_write_manager_t<metadata_t>::on_value_change() THROWS_NOTHING {
     DEBUG_VAR mutex_assertion_t::acq_t mutex_assertion_lock(&mutex_assertion);
-    metadata_t current_value = value.get()->get();
-    fifo_enforcer_write_token_t token = metadata_fifo_source.enter_write();
-    auto_drainer_t::lock_t this_keepalive(&drainer);
-    for (auto pair : last_connections) {
-        connectivity_cluster_t::connection_t *connection = pair.second.first;
-        auto_drainer_t::lock_t connection_keepalive = pair.second.second;
-        coro_t::spawn_sometime(
-            [this, this_keepalive /* important to capture */,
-                    connection, connection_keepalive /* important to capture */,
-                    current_value, token]() {
-                update_writer_t writer(current_value, token);
-                connectivity_cluster->send_message(connection, connection_keepalive,
-                        message_tag, &writer);
-            });
+    ++version;
+    for (auto &pair : conns) {
+        pair.second.dirty = true;
+        if (pair.second.pulse_on_dirty != nullptr) {
+            pair.second.pulse_on_dirty->pulse_if_not_already_pulsed();
+        }
     }
 }
 
+template<class metadata_t>
+std::shared_ptr<const write_message_t>
+directory_write_manager_t<metadata_t>::get_serialized_value() {
+    if (!serialized_value || serialized_version != version) {
+        std::shared_ptr<write_message_t> wm = std::make_shared<write_message_t>();
+        serialize<cluster_version_t::CLUSTER>(wm.get(), value.get()->get());
+        serialized_value = wm;
+        serialized_version = version;
+        ++serializations;
+    }
+    return serialized_value;
+}
+
 template <class metadata_t>
-class directory_write_manager_t<metadata_t>::initialization_writer_t :
+class directory_write_manager_t<metadata_t>::writer_t :
     public cluster_send_message_write_callback_t
 {
 public:
-    initialization_writer_t(const metadata_t &_initial_value,
-                            fifo_enforcer_state_t _metadata_fifo_state) :
-        initial_value(_initial_value), metadata_fifo_state(_metadata_fifo_state) { }
-    ~initialization_writer_t() { }
-
-    void write(write_stream_t *stream) {
-        write_message_t wm;
+    writer_t(uint8_t _code,
+             uint64_t _version,
+             const std::shared_ptr<const write_message_t> &_serialized_value) :
+        code(_code), version(_version), serialized_value(_serialized_value) {
         // All cluster versions use a uint8_t code.
-        const uint8_t code = 'I';
-        serialize_universal(&wm, code);
-        serialize<cluster_version_t::CLUSTER>(&wm, initial_value);
-        serialize<cluster_version_t::CLUSTER>(&wm, metadata_fifo_state);
-        int res = send_write_message(stream, &wm);
-        if (res) {
-            throw fake_archive_exc_t();
-        }
+        serialize_universal(&header, code);
+        /* Note that the version comes before the value. Servers from before updates
+        were coalesced sent the value followed by a FIFO enforcer token instead, so they
+        can't read our directory messages and we can't read theirs. */
+        serialize<cluster_version_t::CLUSTER>(&header, version);
     }
+    ~writer_t() { }
 
-#ifdef ENABLE_MESSAGE_PROFILER
-    const char *message_profiler_tag() const {
-        static const std::string tag =
-            strprintf("directory<%s>.init", typeid(metadata_t).name());
-        return tag.c_str();
+    size_t size() const {
+        return header.size() + serialized_value->size();
     }
-#endif
-
-private:
-    const metadata_t &initial_value;
-    fifo_enforcer_state_t metadata_fifo_state;
-};
-
-template <class metadata_t>
-class directory_write_manager_t<metadata_t>::update_writer_t :
-    public cluster_send_message_write_callback_t
-{
-public:
-    update_writer_t(const metadata_t &_new_value,
-                    fifo_enforcer_write_token_t _metadata_fifo_token) :
-        new_value(_new_value), metadata_fifo_token(_metadata_fifo_token) { }
-    ~update_writer_t() { }
 
     void write(write_stream_t *stream) {
-        write_message_t wm;
-        // All cluster versions use a uint8_t code.
-        const uint8_t code = 'U';
-        serialize_universal(&wm, code);
-        serialize<cluster_version_t::CLUSTER>(&wm, new_value);
-        serialize<cluster_version_t::CLUSTER>(&wm, metadata_fifo_token);
-        int res = send_write_message(stream, &wm);
+        int res = send_write_message(stream, &header);
+        if (res == 0) {
+            res = send_write_message(stream, serialized_value.get());
+        }
         if (res) {
             throw fake_archive_exc_t();
         }
@@ -140,15 +111,66 @@ public:
 
 #ifdef ENABLE_MESSAGE_PROFILER
     const char *message_profiler_tag() const {
-        static const std::string tag =
+        static const std::string init_tag =
+            strprintf("directory<%s>.init", typeid(metadata_t).name());
+        static const std::string update_tag =
             strprintf("directory<%s>.update", typeid(metadata_t).name());
-        return tag.c_str();
+        return code == 'I' ? init_tag.c_str() : update_tag.c_str();
     }
 #endif
 
 private:
-    const metadata_t &new_value;
-    fifo_enforcer_write_token_t metadata_fifo_token;
+    uint8_t code;
+    uint64_t version;
+    std::shared_ptr<const write_message_t> serialized_value;
+    write_message_t header;
 };
 
+template<class metadata_t>
+void directory_write_manager_t<metadata_t>::stream_to_conn(
+        connectivity_cluster_t::connection_t *connection,
+        auto_drainer_t::lock_t connection_keepalive,
+        auto_drainer_t::lock_t this_keepalive,
+        typename std::map<connectivity_cluster_t::connection_t *, conn_info_t>::iterator
+            conns_entry) {
+    try {
+        wait_any_t interruptor(
+            connection_keepalive.get_drain_signal(),
+            this_keepalive.get_drain_signal());
+
+        /* The first message is the initial value; we throttle those so that we don't
+        flood the network when a lot of peers connect at once. */
+        {
+            new_semaphore_in_line_t acq(&semaphore, 1);
+            wait_interruptible(acq.acquisition_signal(), &interruptor);
+            conns_entry->second.dirty = false;
+            writer_t writer('I', version, get_serialized_value());
+            connectivity_cluster->send_message(
+                connection, connection_keepalive, message_tag, &writer);
+        }
+
+        while (true) {
+            if (!conns_entry->second.dirty) {
+                cond_t pulse_on_dirty;
+                assignment_sentry_t<cond_t *> cond_sentry(
+                    &conns_entry->second.pulse_on_dirty,
+                    &pulse_on_dirty);
+                wait_interruptible(&pulse_on_dirty, &interruptor);
+            }
+            /* If the value changes again while we're sending, `dirty` will be set
+            again and we'll send the newer value on the next pass. */
+            conns_entry->second.dirty = false;
+            writer_t writer('U', version, get_serialized_value());
+            ++updates_sent;
+            update_bytes_sent += writer.size();
+            connectivity_cluster->send_message(
+                connection, connection_keepalive, message_tag, &writer);
+        }
+    } catch (const interrupted_exc_t &) {
+        /* OK, we broke out of the loop */
+    }
+    DEBUG_VAR mutex_assertion_t::acq_t mutex_assertion_lock(&mutex_assertion);
+    conns.erase(conns_entry);
+}
+
 #endif  // RPC_DIRECTORY_WRITE_MANAGER_TCC_
@@ -46,6 +46,22 @@ constexpr double GC_STOP_RATIO = 0.05;
 // rate down.
 constexpr double GC_HIGH_RATIO = 0.3;
 
+// A forced GC run (see `gc_mode_t::FORCED`) keeps going until the ratio drops to this.
+constexpr double GC_FORCED_STOP_RATIO = 0.01;
+// While nothing is being written, we take the opportunity to compact the file and
+// already start GCing at this ratio.
+constexpr double GC_IDLE_START_RATIO = 0.06;
+// How long no blocks must have been written for the serializer to count as idle.
+const time_t GC_IDLE_TIMEOUT_SECS = 10;
+// When deciding how hard to GC, we extrapolate the garbage ratio this many seconds into
+// the future, so that a quickly growing garbage ratio gets the GC going early.
+constexpr double GC_TREND_HORIZON_SECS = 60.0;
+// If foreground writes have recently been this much slower than they usually are, the
+// disk is busy, and GC runs only a single coroutine until the garbage ratio gets high.
+constexpr double GC_BUSY_LATENCY_FACTOR = 2.0;
+// How often we update the garbage ratio trend and check whether we have become idle.
+const int64_t GC_PACING_INTERVAL_MS = 1000;
+
 // What's the maximum number of "young" extents we can have?
 const size_t GC_YOUNG_EXTENT_MAX_SIZE = 50;
 // What's the definition of a "young" extent in microseconds?
@@ -395,12 +411,67 @@ private:
     DISABLE_COPYING(gc_entry_t);
 };
 
+gc_pacer_t::gc_pacer_t(double garbage_ratio, ticks_t now)
+    : last_foreground_write_time(now),
+      foreground_write_latency_short(0.0),
+      foreground_write_latency_long(0.0),
+      garbage_ratio_trend(0.0),
+      last_garbage_ratio(garbage_ratio),
+      last_garbage_ratio_time(now) { }
+
+void gc_pacer_t::on_foreground_write_started(ticks_t now) {
+    last_foreground_write_time = now;
+}
+
+void gc_pacer_t::on_foreground_write_done(ticks_t start_time, ticks_t now) {
+    const double latency = ticks_to_secs(ticks_t{now.nanos - start_time.nanos});
+    if (foreground_write_latency_long == 0.0) {
+        foreground_write_latency_short = latency;
+        foreground_write_latency_long = latency;
+    } else {
+        foreground_write_latency_short = 0.8 * foreground_write_latency_short
+            + 0.2 * latency;
+        foreground_write_latency_long = 0.99 * foreground_write_latency_long
+            + 0.01 * latency;
+    }
+}
+
+void gc_pacer_t::on_pacing_timer(double garbage_ratio, ticks_t now) {
+    const double elapsed_secs = ticks_to_secs(
+        ticks_t{now.nanos - last_garbage_ratio_time.nanos});
+    if (elapsed_secs > 0.0) {
+        garbage_ratio_trend = 0.8 * garbage_ratio_trend
+            + 0.2 * (garbage_ratio - last_garbage_ratio) / elapsed_secs;
+    }
+    last_garbage_ratio = garbage_ratio;
+    last_garbage_ratio_time = now;
+}
+
+double gc_pacer_t::projected_garbage_ratio(double garbage_ratio) const {
+    // We only extrapolate upwards.  If the ratio is dropping, that's because we're
+    // already GCing, and we don't want to stop early.
+    return garbage_ratio + std::max(0.0, garbage_ratio_trend) * GC_TREND_HORIZON_SECS;
+}
+
+bool gc_pacer_t::is_idle(ticks_t now) const {
+    return now.nanos - last_foreground_write_time.nanos
+        > secs_to_ticks(GC_IDLE_TIMEOUT_SECS).nanos;
+}
+
+bool gc_pacer_t::is_disk_busy() const {
+    return foreground_write_latency_long > 0.0
+        && foreground_write_latency_short
+           > GC_BUSY_LATENCY_FACTOR * foreground_write_latency_long;
+}
+
 data_block_manager_t::data_block_manager_t(
         extent_manager_t *em, log_serializer_t *_serializer,
         const log_serializer_on_disk_static_config_t *_static_config,
         log_serializer_stats_t *_stats)
     : stats(_stats), shutdown_callback(nullptr), state(state_unstarted),
-      gc_enabled(true), static_config(_static_config), extent_manager(em),
+      gc_enabled(true), gc_mode(gc_mode_t::AUTOMATIC),
+      gc_pacer(0.0, get_ticks()),
+      static_config(_static_config), extent_manager(em),
       serializer(_serializer),
       gc_index_write_pumper(std::bind(
           &data_block_manager_t::flush_gc_index_writes, this, std::placeholders::_1)),
@@ -412,14 +483,19 @@ data_block_manager_t::data_block_manager_t(
     rassert(static_config != nullptr);
     rassert(extent_manager != nullptr);
     rassert(serializer != nullptr);
+    for (int i = 0; i < NUM_WRITE_STREAMS; ++i) {
+        active_extents[i] = nullptr;
+    }
 }
 
 data_block_manager_t::~data_block_manager_t() {
     guarantee(state == state_unstarted || state == state_shut_down);
 }
 
-void data_block_manager_t::prepare_initial_metablock(dbm_metablock_mixin_t *mb) {
+void data_block_manager_t::prepare_initial_metablock(
+        dbm_metablock_mixin_t *mb, dbm_cold_metablock_mixin_t *cold_mb) {
     mb->active_extent = NULL_OFFSET;
+    cold_mb->cold_active_extent = 0;
 }
 
 void data_block_manager_t::start_reconstruct() {
@@ -450,34 +526,20 @@ void data_block_manager_t::end_reconstruct() {
 
 void data_block_manager_t::start_existing(
         file_t *file,
-        const dbm_metablock_mixin_t *last_metablock) {
+        const dbm_metablock_mixin_t *last_metablock,
+        const dbm_cold_metablock_mixin_t *last_cold_metablock) {
     guarantee(state == state_unstarted);
     dbfile = file;
     gc_io_account_nice.init(new file_account_t(file, GC_IO_PRIORITY_NICE));
     gc_io_account_high.init(new file_account_t(file, GC_IO_PRIORITY_HIGH));
 
     /* Reconstruct the active data block extents from the metablock. */
-    const int64_t offset = last_metablock->active_extent;
-
-    if (offset != NULL_OFFSET) {
-        /* It is (perhaps) possible to have an active data block extent with no
-           actual data blocks in it. In this case we would not have created a
-           gc_entry_t for the extent yet. */
-        if (entries.get(offset / extent_manager->extent_size) == nullptr) {
-            gc_entry_t *e = new gc_entry_t(this, offset);
-            reconstructed_extents.push_back(e);
-        }
-
-        active_extent = entries.get(offset / extent_manager->extent_size);
-        guarantee(active_extent != nullptr);
-
-        /* Turn the extent from a reconstructing extent into an active extent */
-        guarantee(active_extent->state == gc_entry_t::state_reconstructing);
-        reconstructed_extents.remove(active_extent);
-
-        active_extent->make_active();
-    } else {
-        active_extent = nullptr;
+    if (last_metablock->active_extent != NULL_OFFSET) {
+        reconstruct_active_extent(last_metablock->active_extent, HOT_WRITE_STREAM);
+    }
+    if (last_cold_metablock->cold_active_extent != 0) {
+        reconstruct_active_extent(last_cold_metablock->cold_active_extent,
+                                  COLD_WRITE_STREAM);
     }
 
     /* Convert any extents that we found live blocks in, but that are not active
@@ -496,6 +558,10 @@ void data_block_manager_t::start_existing(
     }
 
     state = state_ready;
+
+    gc_pacer = gc_pacer_t(garbage_ratio(), get_ticks());
+    gc_pacing_timer.init(new repeating_timer_t(
+        GC_PACING_INTERVAL_MS, [this]() { on_gc_pacing_timer(); }));
 }
 
 // Computes an offset and end offset for the purposes of readahead.  Returns an interval
@@ -736,17 +802,105 @@ buf_ptr_t data_block_manager_t::read(int64_t off_in, block_size_t block_size,
     }
 }
 
+void data_block_manager_t::reconstruct_active_extent(int64_t offset,
+                                                     write_stream_t stream) {
+    guarantee(active_extents[stream] == nullptr);
+
+    /* It is (perhaps) possible to have an active data block extent with no
+       actual data blocks in it. In this case we would not have created a
+       gc_entry_t for the extent yet. */
+    if (entries.get(offset / extent_manager->extent_size) == nullptr) {
+        gc_entry_t *e = new gc_entry_t(this, offset);
+        reconstructed_extents.push_back(e);
+    }
+
+    gc_entry_t *active_extent = entries.get(offset / extent_manager->extent_size);
+    guarantee(active_extent != nullptr);
+
+    /* Turn the extent from a reconstructing extent into an active extent */
+    guarantee(active_extent->state == gc_entry_t::state_reconstructing);
+    reconstructed_extents.remove(active_extent);
+
+    active_extent->make_active();
+    active_extents[stream] = active_extent;
+}
+
+data_block_manager_t::write_stream_t
+data_block_manager_t::choose_write_stream(block_id_t block_id) {
+    /* We guess how long the new version of the block will live from how long the
+    previous version did. The LBA tells us where the previous version is, and if its
+    extent has already aged out of the young extent queue, the block hasn't been
+    rewritten in a while. */
+    flagged_off64_t old_offset = serializer->lba_index->get_block_offset(block_id);
+    if (!old_offset.has_value()) {
+        return HOT_WRITE_STREAM;
+    }
+    gc_entry_t *entry =
+        entries.get(old_offset.get_value() / extent_manager->extent_size);
+    if (entry != nullptr
+        && (entry->state == gc_entry_t::state_old
+            || entry->state == gc_entry_t::state_in_gc)) {
+        return COLD_WRITE_STREAM;
+    }
+    return HOT_WRITE_STREAM;
+}
+
+std::vector<counted_t<block_token_t>>
+data_block_manager_t::many_writes(const buf_write_info_t *writes,
+                                  size_t writes_count,
+                                  file_account_t *io_account,
+                                  iocallback_t *cb) {
+    return many_writes(writes, writes_count, false, io_account, cb);
+}
+
 // Sets maybe_checksum_out if one was computed, or sets it to zero otherwise.
 std::vector<counted_t<block_token_t>>
 data_block_manager_t::many_writes(const buf_write_info_t *writes,
                                   size_t writes_count,
+                                  bool from_gc,
                                   file_account_t *io_account,
                                   iocallback_t *cb) {
+    // Sort the writes by stream. We keep their relative order within each stream, so
+    // every stream still gets written with as few contiguous writes as possible.
+    // `order[i]` is the index in `writes` of `sorted_writes[i]`.
+    std::vector<write_stream_t> streams(writes_count, COLD_WRITE_STREAM);
+    if (!from_gc) {
+        for (size_t i = 0; i < writes_count; ++i) {
+            streams[i] = choose_write_stream(writes[i].block_id);
+        }
+    }
+    std::vector<size_t> order;
+    order.reserve(writes_count);
+    std::vector<buf_write_info_t> sorted_writes;
+    sorted_writes.reserve(writes_count);
+
     // These tokens are grouped by extent.  You can do a contiguous write in each
     // extent.
-    uint64_t cumulative_aligned_size;
-    std::vector<std::vector<counted_t<block_token_t>>> token_groups
-        = gimme_some_new_offsets(writes, writes_count, &cumulative_aligned_size);
+    uint64_t cumulative_aligned_size = 0;
+    std::vector<std::vector<counted_t<block_token_t>>> token_groups;
+    for (int stream = 0; stream < NUM_WRITE_STREAMS; ++stream) {
+        const size_t stream_begin = sorted_writes.size();
+        for (size_t i = 0; i < writes_count; ++i) {
+            if (streams[i] == stream) {
+                order.push_back(i);
+                sorted_writes.push_back(writes[i]);
+            }
+        }
+        if (sorted_writes.size() == stream_begin) {
+            continue;
+        }
+        uint64_t stream_aligned_size;
+        std::vector<std::vector<counted_t<block_token_t>>> stream_groups
+            = gimme_some_new_offsets(sorted_writes.data() + stream_begin,
+                                     sorted_writes.size() - stream_begin,
+                                     static_cast<write_stream_t>(stream),
+                                     &stream_aligned_size);
+        cumulative_aligned_size += stream_aligned_size;
+        for (auto &group : stream_groups) {
+            token_groups.push_back(std::move(group));
+        }
+    }
+    guarantee(sorted_writes.size() == writes_count);
     const bool wants_checksum
         = cumulative_aligned_size <= serializer->dynamic_config.checksum_threshold;
 
@@ -758,6 +912,9 @@ data_block_manager_t::many_writes(const buf_write_info_t *writes,
         virtual void on_io_complete() {
             --ops_remaining;
             if (ops_remaining == 0) {
+                if (parent != nullptr) {
+                    parent->gc_pacer.on_foreground_write_done(start_time, get_ticks());
+                }
                 iocallback_t *local_cb = cb;
                 delete this;
                 local_cb->on_io_complete();
@@ -766,6 +923,9 @@ data_block_manager_t::many_writes(const buf_write_info_t *writes,
 
         size_t ops_remaining;
         iocallback_t *cb;
+        // Only set for foreground writes, whose latency feeds into GC pacing.
+        data_block_manager_t *parent;
+        ticks_t start_time;
     };
 
     intermediate_cb_t *const intermediate_cb = new intermediate_cb_t;
@@ -773,6 +933,11 @@ data_block_manager_t::many_writes(const buf_write_info_t *writes,
     // intermediate_cb->on_io_complete later.
     intermediate_cb->ops_remaining = token_groups.size() + 1;
     intermediate_cb->cb = cb;
+    intermediate_cb->parent = from_gc || token_groups.empty() ? nullptr : this;
+    intermediate_cb->start_time = get_ticks();
+    if (!from_gc) {
+        gc_pacer.on_foreground_write_started(intermediate_cb->start_time);
+    }
 
     size_t write_number = 0;
     for (const std::vector<counted_t<block_token_t>> &group : token_groups) {
@@ -798,10 +963,11 @@ data_block_manager_t::many_writes(const buf_write_info_t *writes,
             total_aligned_size += j_aligned_size;
 
             // The behavior of gimme_some_new_offsets is supposed to retain order, so
-            // we expect writes[write_number] to have the currently-relevant write.
-            guarantee(writes[write_number].block_size == j_block_size);
+            // we expect sorted_writes[write_number] to have the currently-relevant
+            // write.
+            guarantee(sorted_writes[write_number].block_size == j_block_size);
 
-            void *buf = writes[write_number].buf;
+            void *buf = sorted_writes[write_number].buf;
             if (wants_checksum) {
                 size_t wordcount = j_aligned_size / serializer_checksum::word_size;
                 serializer_checksum chksum = compute_checksum(buf, wordcount);
@@ -821,17 +987,24 @@ data_block_manager_t::many_writes(const buf_write_info_t *writes,
                              std::move(iovecs), io_account, intermediate_cb);
 
         stats->bytes_written(total_aligned_size);
+        if (from_gc) {
+            stats->pm_serializer_gc_written_bytes_total += total_aligned_size;
+        } else {
+            stats->pm_serializer_block_written_bytes_total += total_aligned_size;
+        }
     }
 
     // Call on_io_complete for degenerate case (we added 1 to ops_remaining
     // earlier).
     intermediate_cb->on_io_complete();
 
-    std::vector<counted_t<block_token_t>> ret;
-    ret.reserve(writes_count);
+    // Put the tokens back into the order of `writes`.
+    std::vector<counted_t<block_token_t>> ret(writes_count);
+    size_t token_number = 0;
     for (std::vector<counted_t<block_token_t>> &group : token_groups) {
         for (counted_t<block_token_t> &token : group) {
-            ret.push_back(std::move(token));
+            ret[order[token_number]] = std::move(token);
+            ++token_number;
         }
     }
 
@@ -914,14 +1087,28 @@ size_t data_block_manager_t::compute_gc_concurrency() const {
     // Also see `choose_gc_io_account()` for the second component in the automatic
     // GC scaling process.
 
+    //
+    // Instead of the current ratio, we look at the ratio that we're heading towards,
+    // so that we ramp up while the garbage is still growing rather than after it has
+    // piled up.  And while foreground writes are suffering, we back off to a single
+    // coroutine unless the garbage ratio is about to get out of hand.
+
     CT_ASSERT(GC_HIGH_RATIO > GC_START_RATIO);
-    CT_ASSERT(GC_START_RATIO > GC_STOP_RATIO);
+    CT_ASSERT(GC_START_RATIO > GC_IDLE_START_RATIO);
+    CT_ASSERT(GC_IDLE_START_RATIO > GC_STOP_RATIO);
+    CT_ASSERT(GC_STOP_RATIO > GC_FORCED_STOP_RATIO);
 
-    const double gc_ratio = garbage_ratio();
+    if (gc_mode == gc_mode_t::FORCED) {
+        return MAX_CONCURRENT_GCS;
+    }
+
+    const double gc_ratio = gc_pacer.projected_garbage_ratio(garbage_ratio());
     if (gc_ratio < GC_START_RATIO) {
         return 1;
     } else if (gc_ratio >= GC_HIGH_RATIO) {
         return MAX_CONCURRENT_GCS;
+    } else if (gc_pacer.is_disk_busy()) {
+        return 1;
     } else {
         rassert(gc_ratio >= GC_START_RATIO);
         rassert(gc_ratio < GC_HIGH_RATIO);
@@ -945,7 +1132,10 @@ file_account_t *data_block_manager_t::choose_gc_io_account() {
 
     // Note that this means that we can end up oscillating between both accounts,
     // which is fine.
-    if (garbage_ratio() > GC_HIGH_RATIO) {
+    //
+    // A forced GC run always uses the high priority account, since someone explicitly
+    // asked for it.
+    if (gc_mode == gc_mode_t::FORCED || gc_pacer.projected_garbage_ratio(garbage_ratio()) > GC_HIGH_RATIO) {
         return gc_io_account_high.get();
     } else {
         return gc_io_account_nice.get();
@@ -1272,6 +1462,7 @@ void data_block_manager_t::write_gcs(
         }
 
         new_block_tokens = many_writes(the_writes.data(), the_writes.size(),
+                                       true,
                                        choose_gc_io_account(),
                                        &block_write_cond);
 
@@ -1384,14 +1575,23 @@ void data_block_manager_t::flush_gc_index_writes(signal_t *) {
     serializer->index_write(&dummy_acq, [] {}, index_write_ops);
 }
 
-void data_block_manager_t::prepare_metablock(dbm_metablock_mixin_t *metablock) {
+void data_block_manager_t::prepare_metablock(
+        dbm_metablock_mixin_t *metablock,
+        dbm_cold_metablock_mixin_t *cold_metablock) {
     guarantee(state == state_ready || state == state_shutting_down);
 
-    if (active_extent != nullptr) {
-        metablock->active_extent = active_extent->extent_ref.offset();
+    if (active_extents[HOT_WRITE_STREAM] != nullptr) {
+        metablock->active_extent =
+            active_extents[HOT_WRITE_STREAM]->extent_ref.offset();
     } else {
         metablock->active_extent = NULL_OFFSET;
     }
+    if (active_extents[COLD_WRITE_STREAM] != nullptr) {
+        cold_metablock->cold_active_extent =
+            active_extents[COLD_WRITE_STREAM]->extent_ref.offset();
+    } else {
+        cold_metablock->cold_active_extent = 0;
+    }
 }
 
 void data_block_manager_t::disable_gc() {
@@ -1402,6 +1602,7 @@ bool data_block_manager_t::shutdown(data_block_manager::shutdown_callback_t *cb)
     rassert(cb != nullptr);
     guarantee(state == state_ready);
     state = state_shutting_down;
+    gc_pacing_timer.reset();
 
     if (!active_gcs.empty()) {
         shutdown_callback = cb;
@@ -1419,10 +1620,12 @@ void data_block_manager_t::actually_shutdown() {
 
     guarantee(reconstructed_extents.head() == nullptr);
 
-    if (active_extent != nullptr) {
-        UNUSED int64_t extent = active_extent->extent_ref.release();
-        delete active_extent;
-        active_extent = nullptr;
+    for (int i = 0; i < NUM_WRITE_STREAMS; ++i) {
+        if (active_extents[i] != nullptr) {
+            UNUSED int64_t extent = active_extents[i]->extent_ref.release();
+            delete active_extents[i];
+            active_extents[i] = nullptr;
+        }
     }
 
     while (gc_entry_t *entry = young_extent_queue.head()) {
@@ -1447,9 +1650,12 @@ void data_block_manager_t::actually_shutdown() {
 std::vector<std::vector<counted_t<block_token_t>>>
 data_block_manager_t::gimme_some_new_offsets(const buf_write_info_t *writes,
                                              size_t writes_count,
+                                             write_stream_t stream,
                                              uint64_t *cumulative_aligned_size_out) {
     ASSERT_NO_CORO_WAITING;
 
+    gc_entry_t *&active_extent = active_extents[stream];
+
     // Start a new extent if necessary.
     if (active_extent == nullptr) {
         active_extent = new gc_entry_t(this);
@@ -1517,6 +1723,23 @@ bool data_block_manager_t::is_gc_active() const {
     return !active_gcs.empty();
 }
 
+void data_block_manager_t::set_gc_mode(gc_mode_t mode) {
+    gc_mode = mode;
+}
+
+void data_block_manager_t::on_gc_pacing_timer() {
+    const double ratio = garbage_ratio();
+    gc_pacer.on_pacing_timer(ratio, get_ticks());
+
+    if (gc_mode == gc_mode_t::FORCED && ratio <= GC_FORCED_STOP_RATIO) {
+        gc_mode = gc_mode_t::AUTOMATIC;
+    }
+
+    // Normally GC only gets started after index writes, so this is how we get going
+    // when there are no writes at all.
+    serializer->consider_start_gc();
+}
+
 // Looks at young_extent_queue and pops things off the queue that are
 // no longer deemed young, putting them on the priority queue.
 void data_block_manager_t::mark_unyoung_entries() {
@@ -1555,19 +1778,33 @@ void data_block_manager_t::remove_last_unyoung_entry() {
 // look, it's the next largest entry.  Should we keep gc'ing?  Returns
 // false when the garbage ratio is lower than GC_STOP_RATIO.
 bool data_block_manager_t::should_we_keep_gcing() const {
-    return gc_enabled && garbage_ratio() > GC_STOP_RATIO;
+    const double stop_ratio = gc_mode == gc_mode_t::FORCED
+        ? GC_FORCED_STOP_RATIO
+        : GC_STOP_RATIO;
+    return gc_enabled && gc_mode != gc_mode_t::PAUSED && garbage_ratio() > stop_ratio;
 }
 
 bool data_block_manager_t::should_terminate_one_gc_thread() const {
     const size_t goal_num_active_gcs = compute_gc_concurrency();
-    return !gc_enabled || active_gcs.size() > goal_num_active_gcs;
+    return !gc_enabled
+        || gc_mode == gc_mode_t::PAUSED
+        || active_gcs.size() > goal_num_active_gcs;
 }
 
 // Answers the following question: Do we want to bother gc'ing?
-// Returns true when our garbage_ratio is greater than
-// GC_THRESHOLD_RATIO_*.
+// Returns true when our garbage_ratio is greater than GC_START_RATIO, or a lower
+// threshold if we're idle or a GC run has been forced.
 bool data_block_manager_t::do_we_want_to_start_gcing() const {
-    return gc_enabled && garbage_ratio() > GC_START_RATIO;
+    if (!gc_enabled || gc_mode == gc_mode_t::PAUSED) {
+        return false;
+    }
+    double start_ratio = GC_START_RATIO;
+    if (gc_mode == gc_mode_t::FORCED) {
+        start_ratio = GC_FORCED_STOP_RATIO;
+    } else if (gc_pacer.is_idle(get_ticks())) {
+        start_ratio = GC_IDLE_START_RATIO;
+    }
+    return garbage_ratio() > start_ratio;
 }
 
 bool gc_entry_less_t::operator()(const gc_entry_t *x, const gc_entry_t *y) {
@@ -4,6 +4,7 @@
 
 #include <vector>
 
+#include "arch/timing.hpp"
 #include "arch/types.hpp"
 #include "concurrency/new_semaphore.hpp"
 #include "concurrency/pump_coro.hpp"
@@ -24,6 +25,7 @@ class data_block_manager_t;
 class gc_entry_t;
 
 struct dbm_metablock_mixin_t;
+struct dbm_cold_metablock_mixin_t;
 
 struct gc_entry_less_t {
     bool operator() (const gc_entry_t *x, const gc_entry_t *y);
@@ -33,6 +35,42 @@ namespace data_block_manager {
 struct shutdown_callback_t;  // see log_serializer.hpp.
 }  // namespace data_block_manager
 
+/* The inputs to the adaptive GC pacing. The data block manager feeds it the latency of
+foreground writes and, every `GC_PACING_INTERVAL_MS`, the garbage ratio. The current
+time is passed in rather than read from the clock, so that the unit tests can control
+it. */
+class gc_pacer_t {
+public:
+    gc_pacer_t(double garbage_ratio, ticks_t now);
+
+    void on_foreground_write_started(ticks_t now);
+    void on_foreground_write_done(ticks_t start_time, ticks_t now);
+
+    // Updates the garbage ratio trend.
+    void on_pacing_timer(double garbage_ratio, ticks_t now);
+
+    // The garbage ratio that we expect in a little while, given how it has been
+    // changing recently.  Used to ramp up the GC before the garbage piles up.
+    double projected_garbage_ratio(double garbage_ratio) const;
+
+    // True if no blocks have been written for a while.
+    bool is_idle(ticks_t now) const;
+
+    // True if foreground writes have recently been taking much longer than usual.
+    bool is_disk_busy() const;
+
+private:
+    ticks_t last_foreground_write_time;
+    // Moving averages of how long foreground block writes take, in seconds, over a
+    // short and a long horizon.
+    double foreground_write_latency_short;
+    double foreground_write_latency_long;
+    // How fast the garbage ratio has been growing recently, per second.
+    double garbage_ratio_trend;
+    double last_garbage_ratio;
+    ticks_t last_garbage_ratio_time;
+};
+
 class data_block_manager_t {
     friend class gc_entry_t;
     friend class dbm_read_ahead_t;
@@ -47,8 +85,10 @@ public:
     database FD. When restarting an existing database, call start() with the last
     metablock. */
 
-    static void prepare_initial_metablock(dbm_metablock_mixin_t *mb);
-    void start_existing(file_t *dbfile, const dbm_metablock_mixin_t *last_metablock);
+    static void prepare_initial_metablock(dbm_metablock_mixin_t *mb,
+                                          dbm_cold_metablock_mixin_t *cold_mb);
+    void start_existing(file_t *dbfile, const dbm_metablock_mixin_t *last_metablock,
+                        const dbm_cold_metablock_mixin_t *last_cold_metablock);
 
     buf_ptr_t read(int64_t off_in, block_size_t block_size,
                    file_account_t *io_account);
@@ -71,7 +111,8 @@ public:
     /* garbage collect the extents which meet the gc_criterion */
     void start_gc();
 
-    void prepare_metablock(dbm_metablock_mixin_t *metablock);
+    void prepare_metablock(dbm_metablock_mixin_t *metablock,
+                           dbm_cold_metablock_mixin_t *cold_metablock);
     bool do_we_want_to_start_gcing() const;
 
     // This stops further GC rounds from starting, but it doesn't wait for all
@@ -92,13 +133,42 @@ public:
                 file_account_t *io_account,
                 iocallback_t *cb);
 
+    bool is_gc_active() const;
+
+    void set_gc_mode(gc_mode_t mode);
+
+private:
+    /* New blocks are appended to one of several active extents, depending on how long
+    we expect them to live. Keeping long-lived blocks apart from frequently rewritten
+    ones makes it more likely that whole extents become garbage, so the GC has less live
+    data to copy. */
+    enum write_stream_t {
+        // Blocks that are new or were rewritten while their previous version was young.
+        HOT_WRITE_STREAM = 0,
+        // Blocks whose previous version survived long enough to become old, and blocks
+        // that are relocated by the GC.
+        COLD_WRITE_STREAM = 1,
+        NUM_WRITE_STREAMS = 2
+    };
+
+    write_stream_t choose_write_stream(block_id_t block_id);
+
+    /* Makes the extent at `offset`, which the metablock recorded as the active extent
+    for `stream`, active again on startup. */
+    void reconstruct_active_extent(int64_t offset, write_stream_t stream);
+
+    std::vector<counted_t<block_token_t> >
+    many_writes(const buf_write_info_t *writes,
+                size_t writes_count,
+                bool from_gc,
+                file_account_t *io_account,
+                iocallback_t *cb);
+
     std::vector<std::vector<counted_t<block_token_t> > >
     gimme_some_new_offsets(const buf_write_info_t *writes, size_t writes_count,
+                           write_stream_t stream,
                            uint64_t *cumulative_aligned_size_out);
 
-    bool is_gc_active() const;
-
-private:
     void actually_shutdown();
 
     struct gc_state_t : public intrusive_list_node_t<gc_state_t>{
@@ -141,6 +211,10 @@ private:
     // Returns a number between 1 and MAX_CONCURRENT_GCS
     size_t compute_gc_concurrency() const;
 
+    // Periodically updates `gc_pacer`, and starts GC if the serializer has become
+    // idle.
+    void on_gc_pacing_timer();
+
     // Picks an i/o account for GC to use, based on the current garbage rate
     file_account_t *choose_gc_io_account();
 
@@ -182,6 +256,11 @@ private:
 
     bool gc_enabled;
 
+    gc_mode_t gc_mode;
+
+    gc_pacer_t gc_pacer;
+    scoped_ptr_t<repeating_timer_t> gc_pacing_timer;
+
     const log_serializer_on_disk_static_config_t* const static_config;
 
     extent_manager_t *const extent_manager;
@@ -198,8 +277,10 @@ private:
     /* Contains every extent in the gc_entry_t::state_reconstructing state */
     intrusive_list_t<gc_entry_t> reconstructed_extents;
 
-    /* Contains the extent in the gc_entry_t::state_active state. */
-    gc_entry_t *active_extent;
+    /* Contains the extents in the gc_entry_t::state_active state, one per write stream.
+    Only the hot one is recorded in the metablock; on restart, the others are treated like
+    any other old extent. */
+    gc_entry_t *active_extents[NUM_WRITE_STREAMS];
 
     /* Contains every extent in the gc_entry_t::state_young state */
     intrusive_list_t<gc_entry_t> young_extent_queue;
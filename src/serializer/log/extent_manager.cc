@@ -1,9 +1,13 @@
 // Copyright 2010-2014 RethinkDB, all rights reserved.
 #include "serializer/log/extent_manager.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <queue>
 
 #include "arch/arch.hpp"
+#include "arch/timer.hpp"
+#include "containers/intrusive_list.hpp"
 #include "logger.hpp"
 #include "math.hpp"
 #include "perfmon/perfmon.hpp"
@@ -37,11 +41,33 @@ public:
     // object.
     intptr_t extent_use_refcount;
 
+    // True while the extent is free and waiting in the zone's `discard_queue`.  Gets
+    // cleared if the extent is handed out again before the discard has been issued.
+    bool discard_pending;
+
     extent_info_t() : state_(state_unreserved),
-                      extent_use_refcount(0) { }
+                      extent_use_refcount(0),
+                      discard_pending(false) { }
+};
+
+class extent_zone_t;
+
+class extent_discard_callback_t
+    : public linux_iocallback_t,
+      public intrusive_list_node_t<extent_discard_callback_t> {
+public:
+    extent_discard_callback_t(extent_zone_t *_zone, int64_t _length)
+        : zone(_zone), length(_length) { }
+
+    void on_io_complete();
+    void on_io_failure(int errsv, int64_t offset, int64_t count);
+
+    // Reset to `nullptr` if the zone goes away while the discard is in flight.
+    extent_zone_t *zone;
+    const int64_t length;
 };
 
-class extent_zone_t {
+class extent_zone_t : private timer_callback_t {
     const uint64_t extent_size;
 
     size_t offset_to_id(int64_t extent) const {
@@ -71,6 +97,79 @@ class extent_zone_t {
     // The number of free extents in the file.
     size_t held_extents_;
 
+    /* Freed extents whose space hasn't been handed back to the file system yet.  An
+    entry is stale if the extent's `discard_pending` flag has been cleared since, or if
+    it points past the end of `extents`.
+
+    Discards are issued in batches of adjacent extents at a low I/O priority, so that
+    they don't compete with real I/O.  A batch is only issued `EXTENT_DISCARD_INTERVAL_MS`
+    after the previous one has finished, which matters on startup, when every free extent
+    in the file gets queued.  It's fine for an extent to be reused while its discard is
+    in flight, because the disk manager orders later writes to the same range after the
+    discard. */
+    std::deque<size_t> discard_queue;
+    scoped_ptr_t<file_account_t> discard_account;
+    intrusive_list_t<extent_discard_callback_t> discards_in_flight;
+    // Non-null while we're waiting to issue the next batch.
+    timer_token_t *discard_timer;
+    // Set to false if the file system turns out not to support discarding.
+    bool discards_enabled;
+
+    void queue_discard(size_t id) {
+        extent_info_t *info = &extents[id];
+        if (discards_enabled && !info->discard_pending) {
+            info->discard_pending = true;
+            discard_queue.push_back(id);
+        }
+    }
+
+    void schedule_discards() {
+        if (discards_enabled && discard_timer == nullptr && discards_in_flight.empty()
+                && !discard_queue.empty()) {
+            discard_timer = fire_timer_once(EXTENT_DISCARD_INTERVAL_MS, this);
+        }
+    }
+
+    void on_timer(UNUSED ticks_t ticks) {
+        discard_timer = nullptr;
+        pump_discards();
+        // If every queued discard was stale, nothing is in flight to schedule the next
+        // batch for us.
+        schedule_discards();
+    }
+
+    void pump_discards() {
+        if (!discards_enabled || !discards_in_flight.empty()) {
+            return;
+        }
+
+        std::vector<size_t> batch;
+        while (!discard_queue.empty() && batch.size() < EXTENT_DISCARD_BATCH_SIZE) {
+            size_t id = discard_queue.front();
+            discard_queue.pop_front();
+            if (id < extents.size() && extents[id].discard_pending) {
+                rassert(extents[id].state() == extent_info_t::state_free);
+                extents[id].discard_pending = false;
+                batch.push_back(id);
+            }
+        }
+
+        // Runs of adjacent extents are discarded in one go.
+        std::sort(batch.begin(), batch.end());
+        for (size_t i = 0; i < batch.size();) {
+            size_t j = i + 1;
+            while (j < batch.size() && batch[j] == batch[j - 1] + 1) {
+                ++j;
+            }
+            const int64_t length = (j - i) * extent_size;
+            extent_discard_callback_t *cb = new extent_discard_callback_t(this, length);
+            discards_in_flight.push_back(cb);
+            dbfile->discard_async(batch[i] * extent_size, length,
+                                  discard_account.get(), cb);
+            i = j;
+        }
+    }
+
 public:
     size_t held_extents() const {
         return held_extents_;
@@ -78,13 +177,49 @@ public:
 
     extent_zone_t(file_t *_dbfile, uint64_t _extent_size,
                   log_serializer_stats_t *_stats)
-        : extent_size(_extent_size), dbfile(_dbfile), stats(_stats), held_extents_(0) {
+        : extent_size(_extent_size), dbfile(_dbfile), stats(_stats), held_extents_(0),
+          discard_account(new file_account_t(_dbfile, EXTENT_DISCARD_IO_PRIORITY)),
+          discard_timer(nullptr),
+          discards_enabled(true) {
         // (Avoid a bunch of reallocations by resize calls (avoiding O(n log n)
         // work on average).)
         extents.reserve(dbfile->get_file_size() / extent_size);
         stats->pm_file_size_bytes += dbfile->get_file_size();
     }
 
+    ~extent_zone_t() {
+        if (discard_timer != nullptr) {
+            cancel_timer(discard_timer);
+        }
+        // The file stays alive until in-flight discards are done; they just mustn't
+        // call back into us.
+        while (extent_discard_callback_t *cb = discards_in_flight.head()) {
+            discards_in_flight.remove(cb);
+            cb->zone = nullptr;
+        }
+    }
+
+    void on_discard_done(extent_discard_callback_t *cb, int errsv) {
+        discards_in_flight.remove(cb);
+        if (errsv == 0) {
+            stats->pm_serializer_discarded_bytes_total += cb->length;
+        } else if (discards_enabled) {
+            if (errsv != EOPNOTSUPP && errsv != ENOSYS) {
+                logWRN("Failed to discard freed space in the data file (%s). The space "
+                       "will be reused, but it won't be returned to the file system.",
+                       errno_string(errsv).c_str());
+            }
+            discards_enabled = false;
+            for (size_t id : discard_queue) {
+                if (id < extents.size()) {
+                    extents[id].discard_pending = false;
+                }
+            }
+            discard_queue.clear();
+        }
+        schedule_discards();
+    }
+
     extent_reference_t reserve_extent(int64_t extent) {
         size_t id = offset_to_id(extent);
 
@@ -108,8 +243,11 @@ public:
                 extents[extent_id].set_state(extent_info_t::state_free);
                 free_queue.push(extent_id);
                 ++held_extents_;
+                // Space that a previous run freed may not have been discarded yet.
+                queue_discard(extent_id);
             }
         }
+        schedule_discards();
     }
 
     extent_reference_t gen_extent() {
@@ -135,6 +273,8 @@ public:
 
         extent_info_t *info = &extents[offset_to_id(extent)];
         info->set_state(extent_info_t::state_in_use);
+        // No point in discarding an extent we're about to write to.
+        info->discard_pending = false;
 
         extent_reference_t extent_ref = make_extent_reference(extent);
 
@@ -161,7 +301,8 @@ public:
     }
 
     void try_shrink_file() {
-        // Now potentially shrink the file.
+        // Now potentially shrink the file.  Any queued discards for the extents that
+        // get cut off become stale.
         bool shrink_file = false;
         while (!extents.empty() && extents.back().state() == extent_info_t::state_free) {
             shrink_file = true;
@@ -213,11 +354,28 @@ public:
             info->set_state(extent_info_t::state_free);
             free_queue.push(offset_to_id(extent));
             ++held_extents_;
+            queue_discard(offset_to_id(extent));
             try_shrink_file();
+            schedule_discards();
         }
     }
 };
 
+void extent_discard_callback_t::on_io_complete() {
+    if (zone != nullptr) {
+        zone->on_discard_done(this, 0);
+    }
+    delete this;
+}
+
+void extent_discard_callback_t::on_io_failure(int errsv, UNUSED int64_t offset,
+                                              UNUSED int64_t count) {
+    if (zone != nullptr) {
+        zone->on_discard_done(this, errsv);
+    }
+    delete this;
+}
+
 extent_manager_t::extent_manager_t(file_t *file,
                                    const log_serializer_on_disk_static_config_t *static_config,
                                    log_serializer_stats_t *_stats)
@@ -239,10 +397,6 @@ extent_reference_t extent_manager_t::reserve_extent(int64_t extent) {
     return zone->reserve_extent(extent);
 }
 
-void extent_manager_t::prepare_initial_metablock(extent_manager_metablock_mixin_t *mb) {
-    mb->padding = 0;
-}
-
 void extent_manager_t::start_existing() {
     assert_thread();
     rassert(state == state_reserving_extents);
@@ -252,12 +406,6 @@ void extent_manager_t::start_existing() {
 
 }
 
-void extent_manager_t::prepare_metablock(extent_manager_metablock_mixin_t *metablock) {
-    assert_thread();
-    rassert(state == state_running);
-    metablock->padding = 0;
-}
-
 void extent_manager_t::shutdown() {
     assert_thread();
     rassert(state == state_running);
@@ -19,7 +19,6 @@
 class extent_zone_t;
 
 struct log_serializer_stats_t;
-struct extent_manager_metablock_mixin_t;
 
 // A reference to an extent in the extent manager.  An extent may not be freed until
 // all of the references go away (unless the server is shutting down).
@@ -104,9 +103,7 @@ public:
 
     MUST_USE extent_reference_t reserve_extent(int64_t extent);
 
-    static void prepare_initial_metablock(extent_manager_metablock_mixin_t *mb);
     void start_existing();
-    void prepare_metablock(extent_manager_metablock_mixin_t *metablock);
     void shutdown();
 
     /* The extent manager uses transactions to make sure that extents are not freed
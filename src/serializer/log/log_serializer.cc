@@ -119,9 +119,11 @@ void filepath_file_opener_t::unlink_serializer_file() {
 log_serializer_stats_t::log_serializer_stats_t(perfmon_collection_t *parent)
     : serializer_collection(),
       pm_serializer_block_reads(secs_to_ticks(1)),
+      pm_serializer_block_read_latency(secs_to_ticks(1)),
       pm_serializer_index_reads(),
       pm_serializer_block_writes(),
       pm_serializer_index_writes(secs_to_ticks(1)),
+      pm_serializer_index_write_latency(secs_to_ticks(1)),
       pm_serializer_index_writes_size(secs_to_ticks(1), false),
       pm_serializer_read_bytes_per_sec(secs_to_ticks(1)),
       pm_serializer_read_bytes_total(),
@@ -129,19 +131,26 @@ log_serializer_stats_t::log_serializer_stats_t(perfmon_collection_t *parent)
       pm_serializer_written_bytes_total(),
       pm_extents_in_use(),
       pm_file_size_bytes(),
+      pm_serializer_discarded_bytes_total(),
       pm_serializer_lba_extents(),
       pm_serializer_data_extents(),
       pm_serializer_data_extents_allocated(),
       pm_serializer_data_extents_gced(),
       pm_serializer_old_garbage_block_bytes(),
       pm_serializer_old_total_block_bytes(),
+      pm_serializer_block_written_bytes_total(),
+      pm_serializer_gc_written_bytes_total(),
+      pm_serializer_gc_write_amplification(&pm_serializer_gc_written_bytes_total,
+                                           &pm_serializer_block_written_bytes_total),
       pm_serializer_lba_gcs(),
       parent_collection_membership(parent, &serializer_collection, "serializer"),
       stats_membership(&serializer_collection,
           &pm_serializer_block_reads, "serializer_block_reads",
+          &pm_serializer_block_read_latency, "serializer_block_read_latency",
           &pm_serializer_index_reads, "serializer_index_reads",
           &pm_serializer_block_writes, "serializer_block_writes",
           &pm_serializer_index_writes, "serializer_index_writes",
+          &pm_serializer_index_write_latency, "serializer_index_write_latency",
           &pm_serializer_index_writes_size, "serializer_index_writes_size",
           &pm_serializer_read_bytes_per_sec, "serializer_read_bytes_per_sec",
           &pm_serializer_read_bytes_total, "serializer_read_bytes_total",
@@ -149,12 +158,16 @@ log_serializer_stats_t::log_serializer_stats_t(perfmon_collection_t *parent)
           &pm_serializer_written_bytes_total, "serializer_written_bytes_total",
           &pm_extents_in_use, "serializer_extents_in_use",
           &pm_file_size_bytes, "serializer_file_size_bytes",
+          &pm_serializer_discarded_bytes_total, "serializer_discarded_bytes_total",
           &pm_serializer_lba_extents, "serializer_lba_extents",
           &pm_serializer_data_extents, "serializer_data_extents",
           &pm_serializer_data_extents_allocated, "serializer_data_extents_allocated",
           &pm_serializer_data_extents_gced, "serializer_data_extents_gced",
           &pm_serializer_old_garbage_block_bytes, "serializer_old_garbage_block_bytes",
           &pm_serializer_old_total_block_bytes, "serializer_old_total_block_bytes",
+          &pm_serializer_block_written_bytes_total, "serializer_block_written_bytes_total",
+          &pm_serializer_gc_written_bytes_total, "serializer_gc_written_bytes_total",
+          &pm_serializer_gc_write_amplification, "serializer_gc_write_amplification",
           &pm_serializer_lba_gcs, "serializer_lba_gcs")
 { }
 
@@ -181,8 +194,9 @@ void log_serializer_t::create(serializer_file_opener_t *file_opener,
     crc_metablock_t *crc_mb = scoped_crc_mb.get();
     memset(crc_mb, 0, METABLOCK_SIZE);
 
-    extent_manager_t::prepare_initial_metablock(&crc_mb->metablock.extent_manager_part);
-    data_block_manager_t::prepare_initial_metablock(&crc_mb->metablock.data_block_manager_part);
+    data_block_manager_t::prepare_initial_metablock(
+        &crc_mb->metablock.data_block_manager_part,
+        &crc_mb->metablock.data_block_manager_cold_part);
     lba_list_t::prepare_initial_metablock(&crc_mb->metablock.lba_index_part);
 
     metablock_manager_t::create(file.get(), static_config.extent_size(),
@@ -330,7 +344,8 @@ struct ls_start_existing_fsm_t :
             }
             ser->data_block_manager->end_reconstruct();
             ser->data_block_manager->start_existing(
-                    ser->dbfile, &metablock_buffer.data_block_manager_part);
+                    ser->dbfile, &metablock_buffer.data_block_manager_part,
+                    &metablock_buffer.data_block_manager_cold_part);
 
             ser->extent_manager->start_existing();
 
@@ -461,11 +476,14 @@ buf_ptr_t log_serializer_t::block_read(const counted_t<block_token_t> &token,
 
     ticks_t pm_time;
     stats->pm_serializer_block_reads.begin(&pm_time);
+    ticks_t start_time = get_ticks();
 
     buf_ptr_t ret = data_block_manager->read(token->offset_, token->block_size(),
                                              io_account);
 
     stats->pm_serializer_block_reads.end(&pm_time);
+    stats->pm_serializer_block_read_latency.record(
+        ticks_t{get_ticks().nanos - start_time.nanos});
     return ret;
 }
 
@@ -475,6 +493,7 @@ void log_serializer_t::index_write(new_mutex_in_line_t *mutex_acq,
     assert_thread();
     ticks_t pm_time;
     stats->pm_serializer_index_writes.begin(&pm_time);
+    ticks_t start_time = get_ticks();
     stats->pm_serializer_index_writes_size.record(write_ops.size());
 
     extent_transaction_t txn;
@@ -567,6 +586,8 @@ void log_serializer_t::index_write(new_mutex_in_line_t *mutex_acq,
                        std::move(checksums));
 
     stats->pm_serializer_index_writes.end(&pm_time);
+    stats->pm_serializer_index_write_latency.record(
+        ticks_t{get_ticks().nanos - start_time.nanos});
 }
 
 void log_serializer_t::index_write_prepare(extent_transaction_t *txn) {
@@ -793,6 +814,15 @@ bool log_serializer_t::is_gc_active() const {
     return data_block_manager->is_gc_active() || lba_index->is_any_gc_active();
 }
 
+void log_serializer_t::set_gc_mode(gc_mode_t mode) {
+    on_thread_t thread_switcher(home_thread());
+    if (state != state_ready) {
+        return;
+    }
+    data_block_manager->set_gc_mode(mode);
+    consider_start_gc();
+}
+
 block_id_t log_serializer_t::end_block_id() {
     assert_thread();
     rassert(state == state_ready);
@@ -956,13 +986,12 @@ void log_serializer_t::prepare_metablock(log_serializer_metablock_t *mb_buffer)
     assert_thread();
     memset(mb_buffer, 0, sizeof(*mb_buffer));
 
-    extent_manager_metablock_mixin_t extent_manager_part;
-    extent_manager->prepare_metablock(&extent_manager_part);
-    mb_buffer->extent_manager_part = extent_manager_part;
-
     dbm_metablock_mixin_t data_block_manager_part;
-    data_block_manager->prepare_metablock(&data_block_manager_part);
+    dbm_cold_metablock_mixin_t data_block_manager_cold_part;
+    data_block_manager->prepare_metablock(&data_block_manager_part,
+                                          &data_block_manager_cold_part);
     mb_buffer->data_block_manager_part = data_block_manager_part;
+    mb_buffer->data_block_manager_cold_part = data_block_manager_cold_part;
 
     lba_metablock_mixin_t lba_index_part;
     lba_index->prepare_metablock(&lba_index_part);
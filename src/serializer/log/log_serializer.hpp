@@ -155,6 +155,8 @@ public:
 
     virtual bool is_gc_active() const;
 
+    virtual void set_gc_mode(gc_mode_t mode);
+
 private:
     void unregister_block_token(block_token_t *token);
     void remap_block_to_new_offset(int64_t current_offset, int64_t new_offset);
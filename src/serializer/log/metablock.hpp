@@ -36,6 +36,15 @@ ATTR_PACKED(struct dbm_metablock_mixin_t {
     int64_t active_extent;
 });
 
+/* The active extent of the data block manager's cold write stream, or 0 if there is
+none. This used to be the extent manager's part of the metablock, which was a padding
+field that was always 0, so metablocks written before there was a cold write stream read
+as not having a cold extent. Offset 0 holds the static header, so it can't be a data
+extent. */
+ATTR_PACKED(struct dbm_cold_metablock_mixin_t {
+    int64_t cold_active_extent;
+});
+
 ATTR_PACKED(struct lba_metablock_mixin_t {
     // LBA_SHARD_FACTOR is 4, sizeof(lba_shard_metablock_t) is 32.
     // Total size of shards: 128 bytes.
@@ -55,18 +64,14 @@ ATTR_PACKED(struct lba_metablock_mixin_t {
     // 3720 bytes total
 });
 
-ATTR_PACKED(struct extent_manager_metablock_mixin_t {
-    int64_t padding;
-});
-
 
 
 
 //  Data to be serialized to disk with each block.  Changing this changes the disk
 //  format!
 ATTR_PACKED(struct log_serializer_metablock_t {
-    // 8 bytes.  (A "padding" field set to 0.)
-    extent_manager_metablock_mixin_t extent_manager_part;
+    // 8 bytes.  (Formerly the extent manager's "padding" field, always set to 0.)
+    dbm_cold_metablock_mixin_t data_block_manager_cold_part;
     // offset: 8, size: 3720.
     lba_metablock_mixin_t lba_index_part;
     // offset: 3728, size: 8.
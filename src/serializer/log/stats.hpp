@@ -12,9 +12,11 @@ struct log_serializer_stats_t {
     void bytes_written(size_t count);
 
     perfmon_duration_sampler_t pm_serializer_block_reads;
+    perfmon_latency_histogram_t pm_serializer_block_read_latency;
     perfmon_counter_t pm_serializer_index_reads;
     perfmon_counter_t pm_serializer_block_writes;
     perfmon_duration_sampler_t pm_serializer_index_writes;
+    perfmon_latency_histogram_t pm_serializer_index_write_latency;
     perfmon_sampler_t pm_serializer_index_writes_size;
 
     perfmon_rate_monitor_t pm_serializer_read_bytes_per_sec;
@@ -25,6 +27,7 @@ struct log_serializer_stats_t {
     /* used in serializer/log/extent_manager.cc */
     perfmon_counter_t pm_extents_in_use;
     perfmon_counter_t pm_file_size_bytes;
+    perfmon_counter_t pm_serializer_discarded_bytes_total;
 
     /* used in serializer/log/lba/extent.cc */
     perfmon_counter_t pm_serializer_lba_extents;
@@ -35,6 +38,10 @@ struct log_serializer_stats_t {
     perfmon_counter_t pm_serializer_data_extents_gced;
     perfmon_counter_t pm_serializer_old_garbage_block_bytes;
     perfmon_counter_t pm_serializer_old_total_block_bytes;
+    perfmon_counter_t pm_serializer_block_written_bytes_total;
+    perfmon_counter_t pm_serializer_gc_written_bytes_total;
+    /* Bytes rewritten by the GC per byte of blocks written for the cache. */
+    perfmon_ratio_t pm_serializer_gc_write_amplification;
 
     /* used in serializer/log/lba/lba_list.cc */
     perfmon_counter_t pm_serializer_lba_gcs;
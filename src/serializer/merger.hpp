@@ -116,6 +116,10 @@ public:
         return inner->is_gc_active();
     }
 
+    void set_gc_mode(gc_mode_t mode) {
+        inner->set_gc_mode(mode);
+    }
+
 private:
     // Adds `op` to `outstanding_index_write_ops`, using `merge_index_write_op()` if
     // necessary
@@ -126,6 +126,11 @@ public:
     /* Return true if the garbage collector is active */
     virtual bool is_gc_active() const = 0;
 
+    /* Changes how eagerly the garbage collector runs. The serializer doesn't persist
+    the mode; it starts out as `gc_mode_t::AUTOMATIC`, and the table's
+    `compaction_manager_t` sets it again from the table config. May block. */
+    virtual void set_gc_mode(gc_mode_t mode) = 0;
+
 private:
     DISABLE_COPYING(serializer_t);
 };
@@ -287,6 +287,10 @@ bool translator_serializer_t::is_gc_active() const {
     return inner->is_gc_active();
 }
 
+void translator_serializer_t::set_gc_mode(gc_mode_t mode) {
+    inner->set_gc_mode(mode);
+}
+
 // A helper function for `end_block_id` and `end_aux_block_id`
 // `first_block_id` is the lowest block ID in the range, either 0 for regular block
 // IDs or FIRST_AUX_BLOCK_ID for aux blocks.
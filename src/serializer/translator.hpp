@@ -135,6 +135,8 @@ public:
 
     bool is_gc_active() const;
 
+    void set_gc_mode(gc_mode_t mode);
+
     block_id_t end_block_id();
     block_id_t end_aux_block_id();
 
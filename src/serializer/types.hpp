@@ -15,6 +15,16 @@
 #include "serializer/checksum.hpp"
 #include "valgrind.hpp"
 
+/* How eagerly the serializer's garbage collector ("disk compaction") runs. */
+enum class gc_mode_t {
+    // The GC paces itself, based on the garbage ratio and on how busy the disk is.
+    AUTOMATIC,
+    // The GC doesn't run at all, no matter how much garbage there is.
+    PAUSED,
+    // The GC compacts as much as it can right away, and then goes back to `AUTOMATIC`.
+    FORCED
+};
+
 // A relatively "lightweight" header file (we wish), in a sense.
 class buf_ptr_t;
 
@@ -93,6 +93,13 @@ public:
             new_metainfo, order_token, token, durability, interruptor);
     }
 
+    void sync(order_token_t order_token,
+              write_token_t *token,
+              signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
+        home_thread_mixin_t::assert_thread();
+        store_view->sync(order_token, token, interruptor);
+    }
+
     void read(
             DEBUG_ONLY(const metainfo_checker_t& metainfo_checker, )
             const read_t &_read,
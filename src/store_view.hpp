@@ -71,6 +71,14 @@ public:
             write_durability_t durability,
             signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) = 0;
 
+    /* Blocks until every write that got its write token before `token` has been
+    durably written to disk. This is used to make a group of soft-durability writes
+    hard-durable with a single flush. */
+    virtual void sync(
+            order_token_t order_token,
+            write_token_t *token,
+            signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) = 0;
+
     /* Performs a read. The read's region must be a subset of the store's region. */
     virtual void read(
             DEBUG_ONLY(const metainfo_checker_t& metainfo_expecter, )
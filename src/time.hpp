@@ -14,6 +14,10 @@ struct ticks_t {
 };
 ticks_t get_ticks();
 
+// get_coarse_ticks() is like get_ticks(), but is only accurate to a few milliseconds.
+// In exchange it's much cheaper on Linux.
+ticks_t get_coarse_ticks();
+
 // get_kiloticks() is get_ticks() / 1000.  Used in migrating from legacy wall-clock
 // current_microtime().
 struct kiloticks_t {
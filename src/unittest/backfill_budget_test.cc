@@ -0,0 +1,129 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/timing.hpp"
+#include "clustering/immediate_consistency/standard_backfill_throttler.hpp"
+#include "config/args.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+static ticks_t at_ms(int64_t ms) {
+    return ticks_t{ms * MILLION};
+}
+
+TEST(BackfillBudgetTest, Unlimited) {
+    backfill_budget_t budget(0, at_ms(0));
+    EXPECT_TRUE(budget.is_unlimited());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(0, budget.take(100 * MEGABYTE, at_ms(0)));
+    }
+    budget.report_latency(MEGABYTE, 10.0, at_ms(0));
+    EXPECT_EQ(0, budget.take(100 * MEGABYTE, at_ms(0)));
+}
+
+TEST(BackfillBudgetTest, WaitsForDebt) {
+    backfill_budget_t budget(10 * MEGABYTE, at_ms(0));
+
+    // The bucket starts out full.
+    EXPECT_EQ(0, budget.take(10 * MEGABYTE, at_ms(0)));
+
+    // Half a second's worth more puts it in debt by half a second.
+    int64_t wait_ms = budget.take(5 * MEGABYTE, at_ms(0));
+    EXPECT_GE(wait_ms, 500);
+    EXPECT_LE(wait_ms, 501);
+
+    // A second writer has to wait for the first one's debt as well as its own.
+    wait_ms = budget.take(5 * MEGABYTE, at_ms(0));
+    EXPECT_GE(wait_ms, 1000);
+    EXPECT_LE(wait_ms, 1001);
+
+    // Once the debt is paid off, writes can go ahead right away again.
+    EXPECT_EQ(0, budget.take(MEGABYTE, at_ms(1200)));
+}
+
+TEST(BackfillBudgetTest, IdleTimeDoesNotAccumulate) {
+    backfill_budget_t budget(10 * MEGABYTE, at_ms(0));
+    EXPECT_EQ(0, budget.take(10 * MEGABYTE, at_ms(0)));
+
+    // After a long idle period the bucket holds at most one second's worth, so a
+    // large burst still gets throttled.
+    int64_t wait_ms = budget.take(20 * MEGABYTE, at_ms(60 * THOUSAND));
+    EXPECT_GE(wait_ms, 1000);
+    EXPECT_LE(wait_ms, 1001);
+}
+
+TEST(BackfillBudgetTest, AdaptsToLatency) {
+    const double full_rate = 16 * MEGABYTE;
+    backfill_budget_t budget(16 * MEGABYTE, at_ms(0));
+    EXPECT_EQ(full_rate, budget.get_rate());
+
+    // Slow writes halve the rate, down to a sixteenth of the budget.
+    budget.report_latency(MEGABYTE, 1.0, at_ms(0));
+    EXPECT_EQ(full_rate / 2, budget.get_rate());
+    for (int i = 0; i < 10; ++i) {
+        budget.report_latency(MEGABYTE, 1.0, at_ms(0));
+    }
+    EXPECT_EQ(full_rate / 16, budget.get_rate());
+
+    // Small batches don't tell us much about the disk, so they're ignored.
+    budget.report_latency(KILOBYTE, 0.0, at_ms(0));
+    EXPECT_EQ(full_rate / 16, budget.get_rate());
+
+    // Fast writes make the rate climb back up, but never past the budget.
+    budget.report_latency(MEGABYTE, 0.001, at_ms(0));
+    EXPECT_EQ(full_rate / 8, budget.get_rate());
+    for (int i = 0; i < 20; ++i) {
+        budget.report_latency(MEGABYTE, 0.001, at_ms(0));
+    }
+    EXPECT_EQ(full_rate, budget.get_rate());
+}
+
+TEST(BackfillBudgetTest, SetBudget) {
+    backfill_budget_t budget(0, at_ms(0));
+
+    // A budget that's set later starts out with a full bucket.
+    budget.set_budget(10 * MEGABYTE, at_ms(0));
+    EXPECT_FALSE(budget.is_unlimited());
+    EXPECT_EQ(0, budget.take(10 * MEGABYTE, at_ms(0)));
+    EXPECT_GE(budget.take(MEGABYTE, at_ms(0)), 100);
+
+    // Lowering the budget keeps the debt, which is now paid off more slowly.
+    budget.set_budget(MEGABYTE, at_ms(0));
+    int64_t wait_ms = budget.take(MEGABYTE, at_ms(0));
+    EXPECT_GE(wait_ms, 2000);
+    EXPECT_LE(wait_ms, 2001);
+
+    // The rate starts over at the new budget, even after it was cut.
+    budget.report_latency(MEGABYTE, 1.0, at_ms(0));
+    budget.set_budget(2 * MEGABYTE, at_ms(0));
+    EXPECT_EQ(2.0 * MEGABYTE, budget.get_rate());
+
+    // Going back to no limit lets everything through.
+    budget.set_budget(0, at_ms(0));
+    EXPECT_TRUE(budget.is_unlimited());
+    EXPECT_EQ(0, budget.take(100 * MEGABYTE, at_ms(0)));
+}
+
+/* The throttler follows the budget that it's given, and charges reads to it. */
+TPTEST(BackfillBudgetTest, ThrottlerFollowsConfig) {
+    watchable_variable_t<uint64_t> config(0);
+    standard_backfill_throttler_t throttler(config.get_watchable());
+    cond_t non_interruptor;
+
+    ticks_t start = get_ticks();
+    throttler.consume_read_budget(100 * MEGABYTE, &non_interruptor);
+    EXPECT_LT(ticks_to_secs(ticks_t{get_ticks().nanos - start.nanos}), 0.05);
+
+    config.set_value(10 * MEGABYTE);
+    throttler.consume_read_budget(10 * MEGABYTE, &non_interruptor);
+    start = get_ticks();
+    throttler.consume_read_budget(MEGABYTE, &non_interruptor);
+    EXPECT_GE(ticks_to_secs(ticks_t{get_ticks().nanos - start.nanos}), 0.09);
+
+    config.set_value(0);
+    start = get_ticks();
+    throttler.consume_read_budget(100 * MEGABYTE, &non_interruptor);
+    EXPECT_LT(ticks_to_secs(ticks_t{get_ticks().nanos - start.nanos}), 0.05);
+}
+
+}  // namespace unittest
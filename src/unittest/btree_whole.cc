@@ -1,9 +1,17 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
 #include "arch/io/disk.hpp"
+#include "arch/runtime/coroutines.hpp"
 #include "arch/types.hpp"
+#include "btree/concurrent_traversal.hpp"
 #include "btree/reql_specific.hpp"
 #include "buffer_cache/cache_balancer.hpp"
+#include "concurrency/cond_var.hpp"
 #include "rdb_protocol/btree.hpp"
 #include "repli_timestamp.hpp"
 #include "serializer/log/log_serializer.hpp"
@@ -17,6 +25,9 @@ namespace unittest {
 class map_filler_callback_t : public depth_first_traversal_callback_t {
 public:
     explicit map_filler_callback_t(std::map<store_key_t, std::string> *m_out) : m_out_(m_out) { }
+    map_filler_callback_t(std::map<store_key_t, std::string> *m_out,
+                          const std::function<void(const store_key_t &)> &on_pair)
+        : m_out_(m_out), on_pair_(on_pair) { }
 
     continue_bool_t handle_pair(scoped_key_value_t &&keyvalue, UNUSED signal_t *interruptor) {
         store_key_t store_key(keyvalue.key());
@@ -28,14 +39,113 @@ public:
 
         const short_value_buffer_t *value_buf = static_cast<const short_value_buffer_t *>(keyvalue.value());
         (*m_out_)[store_key] = value_buf->as_str();
+        if (on_pair_) {
+            on_pair_(store_key);
+        }
         return continue_bool_t::CONTINUE;
     }
 
 private:
     std::map<store_key_t, std::string> *m_out_;
+    std::function<void(const store_key_t &)> on_pair_;
     scoped_ptr_t<store_key_t> last_key;
 };
 
+// Counts the pairs it sees and the prefetches that the traversal reports.
+class prefetch_counting_callback_t : public depth_first_traversal_callback_t {
+public:
+    explicit prefetch_counting_callback_t(size_t window)
+        : window_(window), pairs(0), issued(0), hits(0) { }
+
+    continue_bool_t handle_pair(scoped_key_value_t &&, UNUSED signal_t *interruptor) {
+        ++pairs;
+        return continue_bool_t::CONTINUE;
+    }
+
+    size_t get_prefetch_window() THROWS_NOTHING {
+        return window_;
+    }
+
+    void note_prefetches(size_t _issued, size_t _hits) THROWS_NOTHING {
+        issued += _issued;
+        hits += _hits;
+    }
+
+private:
+    size_t window_;
+
+public:
+    size_t pairs;
+    size_t issued;
+    size_t hits;
+};
+
+// Counts the internal nodes that the traversal visits.
+class internal_node_counting_callback_t : public depth_first_traversal_callback_t {
+public:
+    internal_node_counting_callback_t() : internal_nodes(0) { }
+
+    continue_bool_t handle_pre_internal(
+            const counted_t<counted_buf_lock_and_read_t> &,
+            const btree_key_t *,
+            const btree_key_t *,
+            signal_t *) {
+        ++internal_nodes;
+        return continue_bool_t::CONTINUE;
+    }
+
+    continue_bool_t handle_pair(scoped_key_value_t &&, UNUSED signal_t *interruptor) {
+        return continue_bool_t::CONTINUE;
+    }
+
+    size_t internal_nodes;
+};
+
+// Visits only the leaves holding one of a set of keys, the way `getAll` does.
+class key_set_callback_t : public concurrent_traversal_callback_t {
+public:
+    key_set_callback_t(const std::set<store_key_t> *keys, size_t window)
+        : keys_(keys), window_(window), found(0), issued(0), hits(0) { }
+
+    void filter_range(const btree_key_t *left_excl_or_null,
+                      const btree_key_t *right_incl,
+                      bool *skip_out) {
+        auto it = left_excl_or_null == nullptr
+            ? keys_->begin()
+            : keys_->upper_bound(store_key_t(left_excl_or_null));
+        *skip_out = it == keys_->end()
+            || btree_key_cmp(it->btree_key(), right_incl) > 0;
+    }
+
+    continue_bool_t handle_pair(scoped_key_value_t &&keyvalue,
+                                concurrent_traversal_fifo_enforcer_signal_t waiter)
+            THROWS_ONLY(interrupted_exc_t) {
+        waiter.wait_interruptible();
+        if (keys_->count(store_key_t(keyvalue.key())) != 0) {
+            ++found;
+        }
+        return continue_bool_t::CONTINUE;
+    }
+
+    size_t get_prefetch_window() THROWS_NOTHING {
+        return window_;
+    }
+
+    void note_prefetches(size_t _issued, size_t _hits) THROWS_NOTHING {
+        issued += _issued;
+        hits += _hits;
+    }
+
+private:
+    const std::set<store_key_t> *keys_;
+    size_t window_;
+
+public:
+    size_t found;
+    size_t issued;
+    size_t hits;
+};
+
 class BTreeTestContext {
 public:
     BTreeTestContext()
@@ -54,10 +164,7 @@ public:
                 std::move(inner_serializer),
                 MERGER_SERIALIZER_MAX_ACTIVE_WRITES);
 
-        cache = make_scoped<cache_t>(serializer.get(), &balancer, &get_global_perfmon_collection(),
-                                     which_cpu_shard_t{0, 1});
-        cache_conn = make_scoped<cache_conn_t>(cache.get());
-        sizer = make_scoped<short_value_sizer_t>(cache.get()->max_block_size());
+        start_cache();
 
         {
             txn_t txn(cache_conn.get(), write_durability_t::SOFT, 1);
@@ -71,6 +178,51 @@ public:
         }
     }
 
+    // Starts over with an empty cache, so that the next reads have to go to disk.
+    void restart_cache() {
+        sizer.reset();
+        cache_conn.reset();
+        cache.reset();
+        start_cache();
+    }
+
+    void traverse(depth_first_traversal_callback_t *cb) {
+        run_txn_fn(false, [&](scoped_ptr_t<real_superblock_t> &&superblock){
+            cond_t interruptor;
+            btree_depth_first_traversal(
+                superblock.get(),
+                key_range_t::universe(),
+                cb,
+                access_t::read,
+                direction_t::FORWARD,
+                release_superblock_t::RELEASE,
+                &interruptor);
+        });
+    }
+
+    size_t snapshot_node_count() {
+        return cache->snapshot_node_count();
+    }
+
+    int64_t key_filter_saved_reads() {
+        perfmon_counter_t *counter = &cache->key_filters()->pm_saved_reads;
+        void *stats = counter->begin_stats();
+        counter->visit_stats(stats);
+        return counter->end_stats(stats).as_int();
+    }
+
+    void concurrent_traverse(const key_range_t &range,
+                             concurrent_traversal_callback_t *cb) {
+        run_txn_fn(false, [&](scoped_ptr_t<real_superblock_t> &&superblock){
+            btree_concurrent_traversal(
+                superblock.get(),
+                range,
+                cb,
+                direction_t::FORWARD,
+                release_superblock_t::RELEASE);
+        });
+    }
+
     void run_txn_fn(bool readwrite,
         const std::function<void(scoped_ptr_t<real_superblock_t> &&)> &fn) {
 
@@ -102,6 +254,26 @@ public:
     }
 
     std::string get(const store_key_t &key) {
+        std::string bt_result = get_regular(key);
+
+        std::string kv_result;
+        auto kv_pair = kv.find(key);
+        if (kv_pair != kv.end()) {
+            kv_result = kv_pair->second;
+        }
+
+        EXPECT_EQ(kv_result, bt_result);
+
+        // The optimistic path must agree with the regular one whenever it works.
+        std::string optimistic_result;
+        if (get_without_acquiring(key, &optimistic_result)) {
+            EXPECT_EQ(kv_result, optimistic_result);
+        }
+
+        return bt_result;
+    }
+
+    std::string get_regular(const store_key_t &key) {
         std::string bt_result;
 
         run_txn_fn(false, [&](scoped_ptr_t<real_superblock_t> &&superblock){
@@ -123,17 +295,22 @@ public:
             }
         });
 
-        std::string kv_result;
-        auto kv_pair = kv.find(key);
-        if (kv_pair != kv.end()) {
-            kv_result = kv_pair->second;
-        }
-
-        EXPECT_EQ(kv_result, bt_result);
-
         return bt_result;
     }
 
+    bool get_without_acquiring(const store_key_t &key, std::string *value_out) {
+        scoped_malloc_t<void> value(sizer->max_possible_size());
+        bool found;
+        if (!find_value_without_acquiring(
+                cache.get(), sizer.get(), key.btree_key(), value.get(), &found)) {
+            return false;
+        }
+        *value_out = found
+            ? static_cast<short_value_buffer_t *>(value.get())->as_str()
+            : std::string();
+        return true;
+    }
+
     void set(const store_key_t &key, const std::string &value, repli_timestamp_t timestamp) {
         run_txn_fn(true, [&](scoped_ptr_t<real_superblock_t> &&superblock){
             profile::trace_t trace;
@@ -243,6 +420,34 @@ public:
         expect_maps_equal(bt_map, kv_map);
     }
 
+    // Traverses the whole tree in a snapshotted read txn, calling `on_pair` for every
+    // key that the traversal visits. `on_pair` may write to the tree.
+    std::map<store_key_t, std::string> snapshotted_traversal(
+            const std::function<void(const store_key_t &)> &on_pair) {
+        std::map<store_key_t, std::string> bt_map;
+
+        scoped_ptr_t<txn_t> txn;
+        scoped_ptr_t<real_superblock_t> superblock;
+        get_btree_superblock_and_txn_for_reading(
+            cache_conn.get(),
+            CACHE_SNAPSHOTTED_YES,
+            &superblock,
+            &txn);
+
+        cond_t interruptor;
+        map_filler_callback_t filler_cb(&bt_map, on_pair);
+        btree_depth_first_traversal(
+            superblock.get(),
+            key_range_t::universe(),
+            &filler_cb,
+            access_t::read,
+            direction_t::FORWARD,
+            release_superblock_t::RELEASE,
+            &interruptor);
+
+        return bt_map;
+    }
+
     bool should_have(const store_key_t &key) {
         return kv.find(key) != kv.end();
     }
@@ -312,6 +517,13 @@ public:
     }
 
 private:
+    void start_cache() {
+        cache = make_scoped<cache_t>(serializer.get(), &balancer, &get_global_perfmon_collection(),
+                                     which_cpu_shard_t{0, 1});
+        cache_conn = make_scoped<cache_conn_t>(cache.get());
+        sizer = make_scoped<short_value_sizer_t>(cache.get()->max_block_size());
+    }
+
     temp_file_t temp_file;
     io_backender_t io_backender;
     filepath_file_opener_t file_opener;
@@ -343,6 +555,252 @@ TPTEST(BTree, Basics) {
     ctx.verify();
 }
 
+TPTEST(BTree, GetWithoutAcquiring) {
+    BTreeTestContext ctx;
+
+    const int num_keys = 2000;
+    std::vector<store_key_t> keys;
+    for (int i = 0; i < num_keys; ++i) {
+        keys.push_back(store_key_t(strprintf("key%d", i)));
+        ctx.set(keys.back(), strprintf("%d", i));
+    }
+
+    // Everything is cached and nothing is being written, so the optimistic path
+    // always works.
+    for (int i = 0; i < num_keys; ++i) {
+        std::string value;
+        ASSERT_TRUE(ctx.get_without_acquiring(keys[i], &value));
+        EXPECT_EQ(strprintf("%d", i), value);
+    }
+    std::string missing;
+    ASSERT_TRUE(ctx.get_without_acquiring(store_key_t("missing"), &missing));
+    EXPECT_EQ("", missing);
+
+    // Blocks that aren't in memory have to be read the regular way first.
+    ctx.restart_cache();
+    std::string value;
+    EXPECT_FALSE(ctx.get_without_acquiring(keys[0], &value));
+    EXPECT_EQ("0", ctx.get_regular(keys[0]));
+    ASSERT_TRUE(ctx.get_without_acquiring(keys[0], &value));
+    EXPECT_EQ("0", value);
+}
+
+// While a write transaction holds the superblock, or is waiting to acquire it, the
+// optimistic path must give up, because the write may change what it would read.
+TPTEST(BTree, GetWithoutAcquiringDuringWrites) {
+    BTreeTestContext ctx;
+    const store_key_t key("key");
+    ctx.set(key, "old");
+    std::string value;
+
+    ctx.run_txn_fn(true, [&](scoped_ptr_t<real_superblock_t> &&) {
+        EXPECT_FALSE(ctx.get_without_acquiring(key, &value));
+    });
+    ASSERT_TRUE(ctx.get_without_acquiring(key, &value));
+    EXPECT_EQ("old", value);
+
+    cond_t write_done;
+    ctx.run_txn_fn(false, [&](scoped_ptr_t<real_superblock_t> &&) {
+        // The write queues up behind our read lock on the superblock.
+        coro_t::spawn_sometime([&]() {
+            ctx.set(key, "new");
+            write_done.pulse();
+        });
+        for (int i = 0; i < 100 && ctx.get_without_acquiring(key, &value); ++i) {
+            coro_t::yield();
+        }
+        EXPECT_FALSE(ctx.get_without_acquiring(key, &value));
+        EXPECT_FALSE(write_done.is_pulsed());
+    });
+    write_done.wait();
+
+    ASSERT_TRUE(ctx.get_without_acquiring(key, &value));
+    EXPECT_EQ("new", value);
+}
+
+TPTEST(BTree, KeyFilter) {
+    block_key_filter_t filter;
+    for (int i = 0; i < 100; ++i) {
+        std::string key = strprintf("present%d", i);
+        filter.add(reinterpret_cast<const uint8_t *>(key.data()), key.size());
+    }
+    for (int i = 0; i < 100; ++i) {
+        std::string key = strprintf("present%d", i);
+        EXPECT_TRUE(filter.may_contain(
+            reinterpret_cast<const uint8_t *>(key.data()), key.size()));
+    }
+    int false_positives = 0;
+    for (int i = 0; i < 10000; ++i) {
+        std::string key = strprintf("absent%d", i);
+        if (filter.may_contain(
+                reinterpret_cast<const uint8_t *>(key.data()), key.size())) {
+            ++false_positives;
+        }
+    }
+    EXPECT_LT(false_positives, 500);
+}
+
+TPTEST(BTree, LeafKeyFilters) {
+    BTreeTestContext ctx;
+    rng_t rng;
+
+    // Read every key once so that all leaves get a filter, then look up missing keys,
+    // most of which the filters should rule out.
+    for (int i = 0; i < 2000; ++i) {
+        ctx.set(store_key_t(strprintf("key%d", i * 2)), strprintf("%d", i));
+    }
+    for (int i = 0; i < 2000; ++i) {
+        ctx.get(store_key_t(strprintf("key%d", i * 2)));
+    }
+    const int64_t saved_before = ctx.key_filter_saved_reads();
+    for (int i = 0; i < 2000; ++i) {
+        ctx.get(store_key_t(strprintf("key%d", i * 2 + 1)));
+    }
+    EXPECT_GT(ctx.key_filter_saved_reads(), saved_before);
+
+    // Inserting, and merging or leveling leaves through removals, must keep the
+    // filters from hiding any key.
+    for (int i = 0; i < 4000; ++i) {
+        store_key_t key(strprintf("key%d", rng.randint(4000)));
+        if (ctx.should_have(key)) {
+            ctx.remove(key);
+        } else {
+            ctx.set(key, strprintf("%d", i));
+        }
+        ctx.get(store_key_t(strprintf("key%d", rng.randint(4000))));
+    }
+    ctx.verify();
+}
+
+// The traversal releases the snapshotted version of every child that it has moved past,
+// so that writes to those children stop being preserved for it. Writes behind the
+// traversal, and writes, removals and splits ahead of it, must all stay invisible to it.
+TPTEST(BTree, SnapshottedTraversalWithWrites) {
+    BTreeTestContext ctx;
+
+    // Long keys keep the internal nodes small, so that the tree has at least three
+    // levels. Writers then attach the internal nodes that the traversal is in to the
+    // root's snapshot, and the traversal must still release the leaves below them.
+    const int num_keys = 2000;
+    auto key = [](int i) {
+        return store_key_t(strprintf("key%05d", i) + std::string(60, 'k'));
+    };
+    std::map<store_key_t, std::string> expected;
+    for (int i = 0; i < num_keys; ++i) {
+        std::string value = strprintf("old%d", i) + std::string(100, 'x');
+        ctx.set(key(i), value);
+        expected[key(i)] = value;
+    }
+    internal_node_counting_callback_t counter;
+    ctx.traverse(&counter);
+    ASSERT_GT(counter.internal_nodes, 1u);
+
+    int visited = 0;
+    int writes_behind = 0;
+    int writes_behind_preserved = 0;
+    std::map<store_key_t, std::string> result =
+        ctx.snapshotted_traversal([&](const store_key_t &) {
+            ++visited;
+            if (visited % 50 != 0) {
+                return;
+            }
+            const int current = visited - 1;
+            // A write to a leaf that the traversal has released doesn't leave an old
+            // version behind for it. At most the first write below each internal node
+            // adds one, for the internal node itself.
+            const size_t snapshot_nodes = ctx.snapshot_node_count();
+            ctx.set(key(current - 25), "new behind");
+            ++writes_behind;
+            if (ctx.snapshot_node_count() > snapshot_nodes) {
+                ++writes_behind_preserved;
+            }
+            if (current + 25 < num_keys) {
+                ctx.set(key(current + 25), "new ahead");
+            }
+            if (current + 26 < num_keys && ctx.should_have(key(current + 26))) {
+                ctx.remove(key(current + 26));
+            }
+            // Inserting ahead of the traversal eventually splits the leaves it hasn't
+            // reached yet.
+            for (int i = 0; i < 10; ++i) {
+                ctx.set(store_key_t(strprintf("key%05d+%d", current + 30, i)),
+                        std::string(100, 'y'));
+            }
+        });
+
+    EXPECT_EQ(num_keys, visited);
+    ctx.expect_maps_equal(result, expected);
+    EXPECT_EQ(num_keys / 50, writes_behind);
+    EXPECT_LT(writes_behind_preserved, writes_behind / 4);
+
+    // Once the traversal is done, nothing is left over for it.
+    EXPECT_EQ(0u, ctx.snapshot_node_count());
+
+    // The writes themselves must have gone through.
+    ctx.verify();
+}
+
+// On a cold cache, the traversal keeps the next few leaves loading while it visits
+// one, and goes on to use every leaf that it prefetched.
+TPTEST(BTree, PrefetchWindow) {
+    BTreeTestContext ctx;
+
+    const size_t num_keys = 2000;
+    for (size_t i = 0; i < num_keys; ++i) {
+        ctx.set(store_key_t(strprintf("key%05zu", i)), std::string(100, 'x'));
+    }
+
+    // Without a window, nothing gets prefetched.
+    ctx.restart_cache();
+    prefetch_counting_callback_t no_window(0);
+    ctx.traverse(&no_window);
+    EXPECT_EQ(num_keys, no_window.pairs);
+    EXPECT_EQ(0u, no_window.issued);
+
+    ctx.restart_cache();
+    prefetch_counting_callback_t window(4);
+    ctx.traverse(&window);
+    EXPECT_EQ(num_keys, window.pairs);
+    // A couple of hundred kilobytes of values take up dozens of leaves. The
+    // traversal acquires the first child of a node anyway and prefetches the rest.
+    EXPECT_GT(window.issued, 10u);
+    EXPECT_EQ(window.issued, window.hits);
+
+    // Once the leaves are in memory, there's nothing left to prefetch.
+    prefetch_counting_callback_t warm(4);
+    ctx.traverse(&warm);
+    EXPECT_EQ(num_keys, warm.pairs);
+    EXPECT_EQ(0u, warm.issued);
+}
+
+// When the callback skips most of the children, the traversal must only prefetch the
+// ones that it's going to visit.
+TPTEST(BTree, PrefetchOnlyUnfilteredChildren) {
+    BTreeTestContext ctx;
+
+    const size_t num_keys = 2000;
+    for (size_t i = 0; i < num_keys; ++i) {
+        ctx.set(store_key_t(strprintf("key%05zu", i)), std::string(100, 'x'));
+    }
+
+    // A few keys a handful of leaves apart, plus one that doesn't exist.
+    std::set<store_key_t> keys;
+    for (size_t i = 100; i < num_keys; i += 400) {
+        keys.insert(store_key_t(strprintf("key%05zu", i)));
+    }
+    keys.insert(store_key_t("key00300x"));
+    const key_range_t range(key_range_t::closed, *keys.begin(),
+                            key_range_t::closed, *keys.rbegin());
+
+    ctx.restart_cache();
+    key_set_callback_t cb(&keys, 32);
+    ctx.concurrent_traverse(range, &cb);
+    EXPECT_EQ(keys.size() - 1, cb.found);
+    EXPECT_GT(cb.issued, 0u);
+    // Every prefetched leaf got used, so none of the skipped ones were loaded.
+    EXPECT_EQ(cb.issued, cb.hits);
+}
+
 key_range_t random_key_range(rng_t *rng) {
     key_range_t::bound_t lm = key_range_t::bound_t::none;
     if (rng->randint(8) != 0) {
@@ -93,7 +93,8 @@ TPTEST(ClusteringBackfill, BackfillTest) {
     backfiller_t backfiller(
         cluster.get_mailbox_manager(),
         &branch_history_manager,
-        &backfiller_store);
+        &backfiller_store,
+        nullptr);
 
     /* Run a backfill */
 
@@ -39,6 +39,7 @@ void run_with_primary(
         &primary_dispatcher,
         &initial_store,
         &branch_history_manager,
+        nullptr,
         &interruptor);
 
     fun(&cluster,
@@ -188,4 +189,88 @@ TPTEST(ClusteringBranch, Backfill) {
     run_with_primary(&run_backfill_test);
 }
 
+/* The `GroupCommit` test sends a burst of hard-durability writes to a primary with a
+remote replica, while holding back the replica's flushes. Every write that arrives while
+a flush is running must be covered by the next one, and the replica must acknowledge all
+of the writes that a flush covered with a single message. */
+
+void run_group_commit_test(
+        simple_mailbox_cluster_t *cluster,
+        primary_dispatcher_t *dispatcher,
+        UNUSED mock_store_t *store1,
+        local_replicator_t *local_replicator,
+        order_source_t *order_source) {
+    remote_replicator_server_t remote_replicator_server(
+        cluster->get_mailbox_manager(),
+        dispatcher);
+
+    standard_backfill_throttler_t backfill_throttler;
+    backfill_progress_tracker_t backfill_progress_tracker;
+
+    mock_store_t store2((binary_blob_t(version_t::zero())));
+    in_memory_branch_history_manager_t bhm2;
+    cond_t interruptor;
+    remote_replicator_client_t remote_replicator_client(
+        &backfill_throttler,
+        backfill_config_t(),
+        &backfill_progress_tracker,
+        cluster->get_mailbox_manager(),
+        server_id_t::generate_server_id(),
+        backfill_throttler_t::priority_t::critical_t::NO,
+        dispatcher->get_branch_id(),
+        remote_replicator_server.get_bcard(),
+        local_replicator->get_replica_bcard(),
+        server_id_t::generate_server_id(),
+        &store2,
+        &bhm2,
+        &interruptor);
+
+    cond_t sync_gate;
+    store2.set_sync_gate(&sync_gate);
+    const int syncs_before = store2.sync_count();
+    const int writes_before = store2.write_count();
+    const int64_t acks_before = remote_replicator_client.get_batched_ack_count();
+
+    const int num_writes = 20;
+    std::vector<scoped_ptr_t<simple_write_callback_t> > write_callbacks;
+    for (int i = 0; i < num_writes; ++i) {
+        write_t w = mock_overwrite(strprintf("key%d", i), strprintf("%d", i));
+        w.durability_requirement = DURABILITY_REQUIREMENT_HARD;
+        write_callbacks.push_back(make_scoped<simple_write_callback_t>());
+        dispatcher->spawn_write(
+            w,
+            order_source->check_in("run_group_commit_test(write)"),
+            write_callbacks.back().get());
+    }
+
+    /* A write waits for durability as soon as `write()` returns, so once the store has
+    seen all of them, they are all waiting behind the first flush. */
+    for (int attempt = 0;
+            attempt < 1000 && store2.write_count() - writes_before < num_writes;
+            ++attempt) {
+        nap(10);
+    }
+    ASSERT_EQ(num_writes, store2.write_count() - writes_before);
+    for (const auto &cb : write_callbacks) {
+        EXPECT_FALSE(cb->is_pulsed());
+    }
+
+    sync_gate.pulse();
+    for (const auto &cb : write_callbacks) {
+        cb->wait_lazily_unordered();
+        EXPECT_EQ(2, cb->acks);
+    }
+    store2.set_sync_gate(nullptr);
+
+    /* The flush that was running when the first write arrived, and one more for the
+    rest. */
+    EXPECT_GE(store2.sync_count() - syncs_before, 1);
+    EXPECT_LE(store2.sync_count() - syncs_before, 2);
+    EXPECT_GE(remote_replicator_client.get_batched_ack_count() - acks_before, 1);
+    EXPECT_LE(remote_replicator_client.get_batched_ack_count() - acks_before, 2);
+}
+TPTEST(ClusteringBranch, GroupCommit) {
+    run_with_primary(&run_group_commit_test);
+}
+
 }   /* namespace unittest */
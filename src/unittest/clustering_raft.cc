@@ -1,4 +1,8 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "unittest/gtest.hpp"
 
 #include "clustering/administration/metadata.hpp"
@@ -144,5 +148,265 @@ TPTEST(ClusteringRaft, Regression4234) {
     traffic_generator.check_changes_present();
 }
 
+/* The `CompactionCatchUp` test takes a member down, commits enough changes that the
+other members compact their logs past the point where it left off, and then brings it
+back. The entries it's missing are gone, so it has to catch up from a snapshot. */
+TPTEST(ClusteringRaft, CompactionCatchUp) {
+    cond_t non_interruptor;
+    std::vector<raft_member_id_t> member_ids;
+    dummy_raft_cluster_t cluster(3, dummy_raft_state_t(), &member_ids);
+    do_writes_raft(&cluster, 10, 60000);
+
+    raft_member_id_t leader = cluster.find_leader(60000);
+    raft_member_id_t lagging = (member_ids[0] == leader) ? member_ids[1] : member_ids[0];
+    raft_log_index_t lagging_index = 0;
+    cluster.run_on_member(lagging, [&](dummy_raft_member_t *member, signal_t *) {
+        guarantee(member != nullptr);
+        lagging_index = member->get_committed_state()->get().log_index;
+    });
+    cluster.set_live(lagging, dummy_raft_cluster_t::live_t::dead);
+
+    do_writes_raft(&cluster, 100, 60000);
+
+    auto get_log_prev_index = [&](const raft_member_id_t &member_id) {
+        raft_log_index_t prev_index = 0;
+        cluster.run_on_member(member_id, [&](dummy_raft_member_t *member, signal_t *) {
+            guarantee(member != nullptr);
+            raft_member_t<dummy_raft_state_t>::change_lock_t change_lock(
+                member, &non_interruptor);
+            prev_index = member->get_state_for_init(change_lock).log.prev_index;
+        });
+        return prev_index;
+    };
+    for (const raft_member_id_t &member_id : member_ids) {
+        if (member_id != lagging) {
+            ASSERT_GT(get_log_prev_index(member_id), lagging_index);
+        }
+    }
+
+    cluster.set_live(lagging, dummy_raft_cluster_t::live_t::alive);
+    do_writes_raft(&cluster, 10, 60000);
+
+    /* The lagging member must end up with every change that the leader has. */
+    leader = cluster.find_leader(60000);
+    dummy_raft_member_t::state_and_config_t leader_state(
+        0, dummy_raft_state_t(), raft_complex_config_t());
+    cluster.run_on_member(leader, [&](dummy_raft_member_t *member, signal_t *) {
+        guarantee(member != nullptr);
+        leader_state = member->get_committed_state()->get();
+    });
+    bool caught_up = false;
+    for (int attempt = 0; attempt < 6000 && !caught_up; ++attempt) {
+        cluster.run_on_member(lagging, [&](dummy_raft_member_t *member, signal_t *) {
+            guarantee(member != nullptr);
+            caught_up = member->get_committed_state()->get().log_index
+                >= leader_state.log_index;
+        });
+        if (!caught_up) {
+            nap(10);
+        }
+    }
+    ASSERT_TRUE(caught_up);
+    cluster.run_on_member(lagging, [&](dummy_raft_member_t *member, signal_t *) {
+        guarantee(member != nullptr);
+        const std::vector<uuid_u> &changes =
+            member->get_committed_state()->get().state.state;
+        const std::vector<uuid_u> &expected = leader_state.state.state;
+        ASSERT_LE(expected.size(), changes.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), changes.begin()));
+    });
+    EXPECT_GT(get_log_prev_index(lagging), lagging_index);
+}
+
+/* `direct_raft_member_t` is the storage and the network for one `dummy_raft_member_t`.
+It delivers RPCs by calling `on_rpc()` on the destination directly, so that a test can
+count them. */
+class direct_raft_member_t :
+    public raft_storage_interface_t<dummy_raft_state_t>,
+    public raft_network_interface_t<dummy_raft_state_t> {
+public:
+    direct_raft_member_t(
+            const raft_member_id_t &_member_id,
+            const raft_persistent_state_t<dummy_raft_state_t> &_stored_state,
+            std::map<raft_member_id_t, direct_raft_member_t *> *_peers) :
+        member_id(_member_id),
+        stored_state(_stored_state),
+        peers(_peers),
+        rpcs_received(0),
+        rpcs_at_first_log_write(-1),
+        snapshots_installed(0) {
+        peers->insert(std::make_pair(member_id, this));
+    }
+
+    ~direct_raft_member_t() {
+        member.reset();
+        peers->erase(member_id);
+    }
+
+    /* Every member that's in `peers` when this is called counts as connected. */
+    void start(raft_start_election_immediately_t start_election) {
+        for (const auto &pair : *peers) {
+            if (pair.first != member_id) {
+                connected.set_key(pair.first, optional<raft_term_t>());
+            }
+        }
+        member.init(new dummy_raft_member_t(
+            member_id, this, this, "", start_election));
+    }
+
+    const raft_persistent_state_t<dummy_raft_state_t> *get() {
+        return &stored_state;
+    }
+    void write_current_term_and_voted_for(
+            raft_term_t current_term, raft_member_id_t voted_for) {
+        stored_state.current_term = current_term;
+        stored_state.voted_for = voted_for;
+    }
+    void write_commit_index(raft_log_index_t commit_index) {
+        stored_state.commit_index = commit_index;
+    }
+    void write_log_replace_tail(
+            const raft_log_t<dummy_raft_state_t> &log,
+            raft_log_index_t first_replaced) {
+        if (rpcs_at_first_log_write == -1) {
+            rpcs_at_first_log_write = rpcs_received;
+        }
+        log_writes.push_back(first_replaced);
+        if (first_replaced != stored_state.log.get_latest_index() + 1) {
+            stored_state.log.delete_entries_from(first_replaced);
+        }
+        for (raft_log_index_t i = first_replaced; i <= log.get_latest_index(); ++i) {
+            stored_state.log.append(log.get_entry_ref(i));
+        }
+    }
+    void write_log_append_one(const raft_log_entry_t<dummy_raft_state_t> &entry) {
+        stored_state.log.append(entry);
+    }
+    void write_snapshot(
+            const dummy_raft_state_t &snapshot_state,
+            const raft_complex_config_t &snapshot_config,
+            bool clear_log,
+            raft_log_index_t log_prev_index,
+            raft_term_t log_prev_term,
+            raft_log_index_t commit_index) {
+        stored_state.snapshot_state = snapshot_state;
+        stored_state.snapshot_config = snapshot_config;
+        if (clear_log) {
+            ++snapshots_installed;
+            stored_state.log.entries.clear();
+            stored_state.log.prev_index = log_prev_index;
+            stored_state.log.prev_term = log_prev_term;
+        } else {
+            stored_state.log.delete_entries_to(log_prev_index, log_prev_term);
+        }
+        stored_state.commit_index = commit_index;
+    }
+
+    bool send_rpc(
+            const raft_member_id_t &dest,
+            const raft_rpc_request_t<dummy_raft_state_t> &request,
+            UNUSED signal_t *interruptor,
+            raft_rpc_reply_t *reply_out) {
+        auto it = peers->find(dest);
+        if (it == peers->end() || !it->second->member.has()) {
+            return false;
+        }
+        ++it->second->rpcs_received;
+        it->second->member->on_rpc(request, reply_out);
+        return true;
+    }
+    void send_virtual_heartbeats(const optional<raft_term_t> &term) {
+        for (const auto &pair : *peers) {
+            if (pair.first != member_id) {
+                pair.second->connected.set_key(member_id, term);
+            }
+        }
+    }
+    watchable_map_t<raft_member_id_t, optional<raft_term_t> > *get_connected_members() {
+        return &connected;
+    }
+
+    const raft_member_id_t member_id;
+    raft_persistent_state_t<dummy_raft_state_t> stored_state;
+    std::map<raft_member_id_t, direct_raft_member_t *> *const peers;
+    watchable_map_var_t<raft_member_id_t, optional<raft_term_t> > connected;
+    scoped_ptr_t<dummy_raft_member_t> member;
+
+    int rpcs_received;
+    /* The number of RPCs this member had received when its log was first written to. */
+    int rpcs_at_first_log_write;
+    /* The `first_replaced` argument of every `write_log_replace_tail()` call. */
+    std::vector<raft_log_index_t> log_writes;
+    int snapshots_installed;
+};
+
+/* The `CatchUpFromRetainedEntries` test starts a member that is missing the last few
+committed entries, fewer than the leader retains after its snapshot. The leader's first
+append-entries RPC gets rejected, and the reply tells it where the member's log ends, so
+the second one carries exactly the missing entries. No snapshot gets installed. */
+TPTEST(ClusteringRaft, CatchUpFromRetainedEntries) {
+    const raft_log_index_t retained = dummy_raft_member_t::snapshot_retained_entries;
+    const raft_log_index_t num_entries = 3 * retained;
+    const raft_log_index_t lag = retained - 2;
+
+    raft_member_id_t leader_id(generate_uuid());
+    raft_member_id_t lagging_id(generate_uuid());
+    /* The third member never comes up. It acknowledged the entries that the lagging
+    member is missing, so they could be committed without it. */
+    raft_member_id_t down_id(generate_uuid());
+    raft_config_t config;
+    config.voting_members = {leader_id, lagging_id, down_id};
+
+    raft_persistent_state_t<dummy_raft_state_t> leader_state =
+        raft_persistent_state_t<dummy_raft_state_t>::make_initial(
+            dummy_raft_state_t(), config);
+    leader_state.current_term = 1;
+    raft_persistent_state_t<dummy_raft_state_t> lagging_state = leader_state;
+    std::vector<raft_log_entry_t<dummy_raft_state_t> > entries;
+    dummy_raft_state_t snapshot_state;
+    for (raft_log_index_t i = 1; i <= num_entries; ++i) {
+        raft_log_entry_t<dummy_raft_state_t> entry;
+        entry.type = raft_log_entry_type_t::regular;
+        entry.term = 1;
+        entry.change = make_optional(generate_uuid());
+        entries.push_back(entry);
+        leader_state.log.append(entry);
+        if (i <= num_entries - lag) {
+            lagging_state.log.append(entry);
+        }
+        if (i <= num_entries - retained) {
+            snapshot_state.apply_change(*entry.change);
+        }
+    }
+    /* The leader has compacted everything but the retained entries. */
+    leader_state.log.delete_entries_to(num_entries - retained, 1);
+    leader_state.snapshot_state = snapshot_state;
+    leader_state.commit_index = num_entries;
+    lagging_state.commit_index = num_entries - lag;
+
+    std::map<raft_member_id_t, direct_raft_member_t *> peers;
+    direct_raft_member_t leader(leader_id, leader_state, &peers);
+    direct_raft_member_t lagging(lagging_id, lagging_state, &peers);
+    lagging.start(raft_start_election_immediately_t::NO);
+    leader.start(raft_start_election_immediately_t::YES);
+
+    for (int attempt = 0;
+            lagging.stored_state.log.get_latest_index() < num_entries;
+            ++attempt) {
+        ASSERT_LT(attempt, 6000);
+        nap(10);
+    }
+
+    EXPECT_EQ(0, lagging.snapshots_installed);
+    ASSERT_FALSE(lagging.log_writes.empty());
+    EXPECT_EQ(num_entries - lag + 1, lagging.log_writes[0]);
+    /* A vote request, the rejected append-entries RPC and the one that carried the
+    missing entries. Backing off one entry at a time would have taken `lag` more. */
+    EXPECT_LE(lagging.rpcs_at_first_log_write, 3);
+    for (raft_log_index_t i = num_entries - lag + 1; i <= num_entries; ++i) {
+        EXPECT_TRUE(entries[i - 1] == lagging.stored_state.log.get_entry_ref(i));
+    }
+}
+
 }   /* namespace unittest */
 
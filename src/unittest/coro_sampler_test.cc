@@ -0,0 +1,167 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <signal.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "arch/runtime/coro_sampler.hpp"
+#include "arch/timing.hpp"
+#include "clustering/administration/artificial_reql_cluster_interface.hpp"
+#include "clustering/administration/debug_coro_profiler.hpp"
+#include "clustering/administration/metadata.hpp"
+#include "clustering/administration/tables/name_resolver.hpp"
+#include "extproc/extproc_pool.hpp"
+#include "rdb_protocol/context.hpp"
+#include "unittest/dummy_metadata_controller.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+// Uses up about `ms` milliseconds of CPU time on the current thread.
+static void spin(int64_t ms) {
+    volatile uint64_t sink = 0;
+    const int64_t end = get_ticks().nanos + ms * MILLION;
+    while (get_ticks().nanos < end) {
+        for (int i = 0; i < 1000; ++i) {
+            sink = sink + i;
+        }
+    }
+}
+
+#ifdef __linux__
+static bool sigprof_is_blocked() {
+    sigset_t sigmask;
+    int res = pthread_sigmask(SIG_BLOCK, nullptr, &sigmask);
+    guarantee_xerr(res == 0, res, "Could not get the signal mask");
+    return sigismember(&sigmask, SIGPROF) == 1;
+}
+
+static uint64_t samples_on_this_thread(coro_sampler_t *sampler) {
+    std::vector<coro_sampler_t::thread_report_t> reports = sampler->get_report(10);
+    return reports.at(get_thread_id().threadnum).samples;
+}
+
+/* The pool's threads only let `SIGPROF` through while the sampler is enabled, and the
+samples end up in the report of the thread that used the CPU time. */
+TPTEST(CoroSamplerTest, SamplesWhileEnabled) {
+    coro_sampler_t sampler;
+    EXPECT_TRUE(sigprof_is_blocked());
+
+    std::string error;
+    ASSERT_TRUE(sampler.enable(1000, &error));
+    EXPECT_TRUE(sampler.is_enabled());
+    EXPECT_EQ(1000, sampler.frequency());
+    EXPECT_FALSE(sigprof_is_blocked());
+
+    spin(200);
+    sampler.disable();
+    EXPECT_FALSE(sampler.is_enabled());
+    EXPECT_TRUE(sigprof_is_blocked());
+
+    const uint64_t samples = samples_on_this_thread(&sampler);
+    EXPECT_GT(samples, 0u);
+    std::vector<coro_sampler_t::thread_report_t> reports = sampler.get_report(10);
+    const std::vector<coro_sampler_t::entry_t> &entries =
+        reports.at(get_thread_id().threadnum).entries;
+    ASSERT_FALSE(entries.empty());
+    // Samples are folded by their whole stack, not just by the function that was
+    // running. `spin()` was called from the test, so the stacks go deeper than that.
+    size_t deepest = 0;
+    for (const coro_sampler_t::entry_t &entry : entries) {
+        ASSERT_FALSE(entry.stack.empty());
+        EXPECT_EQ(entry.function, entry.stack[0]);
+        deepest = std::max(deepest, entry.stack.size());
+    }
+    EXPECT_GT(deepest, 1u);
+
+    // Nothing gets sampled once the sampler is disabled.
+    spin(50);
+    EXPECT_EQ(samples, samples_on_this_thread(&sampler));
+
+    // Enabling it again starts over.
+    ASSERT_TRUE(sampler.enable(1000, &error));
+    EXPECT_EQ(0u, samples_on_this_thread(&sampler));
+    sampler.disable();
+}
+#endif  // __linux__
+
+static ql::datum_t config_row(bool enabled, double samples_per_sec) {
+    ql::datum_object_builder_t builder;
+    builder.overwrite("id", ql::datum_t("config"));
+    builder.overwrite("enabled", ql::datum_t::boolean(enabled));
+    builder.overwrite("samples_per_sec", ql::datum_t(samples_per_sec));
+    return std::move(builder).to_datum();
+}
+
+TPTEST(CoroSamplerTest, DebugCoroProfilerTable) {
+    extproc_pool_t extproc_pool(2);
+    dummy_semilattice_controller_t<auth_semilattice_metadata_t> auth_manager;
+    rdb_context_t rdb_context(&extproc_pool, nullptr, auth_manager.get_view());
+    artificial_reql_cluster_interface_t artificial_reql_cluster_interface(
+        auth_manager.get_view(),
+        &rdb_context);
+    dummy_semilattice_controller_t<cluster_semilattice_metadata_t> cluster_manager;
+    name_resolver_t name_resolver(
+        cluster_manager.get_view(),
+        nullptr,
+        make_lifetime(artificial_reql_cluster_interface));
+    debug_coro_profiler_artificial_table_backend_t backend(
+        &rdb_context, make_lifetime(name_resolver));
+
+    auth::user_context_t user_context(auth::permissions_t(
+        tribool::True, tribool::True, tribool::True, tribool::True));
+    cond_t interruptor;
+    admin_err_t error;
+
+    std::vector<ql::datum_t> rows;
+    ASSERT_TRUE(backend.read_all_rows_as_vector(
+        user_context, &interruptor, &rows, &error));
+    ASSERT_EQ(2u, rows.size());
+    EXPECT_EQ(ql::datum_t("config"), rows[0].get_field("id"));
+    EXPECT_FALSE(rows[0].get_field("enabled").as_bool());
+    EXPECT_EQ(ql::datum_t::null(), rows[0].get_field("samples_per_sec"));
+    EXPECT_EQ(ql::datum_t("report"), rows[1].get_field("id"));
+
+    // Only valid updates of the config row are accepted.
+    ql::datum_t value = config_row(true, 0);
+    EXPECT_FALSE(backend.write_row(user_context, ql::datum_t("config"), false,
+                                   &value, &interruptor, &error));
+    value = config_row(true, 500);
+    EXPECT_FALSE(backend.write_row(user_context, ql::datum_t("report"), false,
+                                   &value, &interruptor, &error));
+
+    ql::datum_t row;
+    ASSERT_TRUE(backend.read_row(user_context, ql::datum_t("config"), &interruptor,
+                                 &row, &error));
+    EXPECT_FALSE(row.get_field("enabled").as_bool());
+
+#ifdef __linux__
+    value = config_row(true, 500);
+    ASSERT_TRUE(backend.write_row(user_context, ql::datum_t("config"), false,
+                                  &value, &interruptor, &error));
+    EXPECT_EQ(config_row(true, 500), value);
+    ASSERT_TRUE(backend.read_row(user_context, ql::datum_t("config"), &interruptor,
+                                 &row, &error));
+    EXPECT_EQ(config_row(true, 500), row);
+
+    spin(200);
+    value = config_row(false, 500);
+    ASSERT_TRUE(backend.write_row(user_context, ql::datum_t("config"), false,
+                                  &value, &interruptor, &error));
+    EXPECT_FALSE(value.get_field("enabled").as_bool());
+
+    // The report is still there after the profiler was turned off.
+    ASSERT_TRUE(backend.read_row(user_context, ql::datum_t("report"), &interruptor,
+                                 &row, &error));
+    ql::datum_t threads = row.get_field("threads");
+    ASSERT_GT(threads.arr_size(), 0u);
+    ql::datum_t thread = threads.get(0);
+    EXPECT_GT(thread.get_field("samples").as_num(), 0);
+    ASSERT_GT(thread.get_field("top").arr_size(), 0u);
+    EXPECT_GT(thread.get_field("top").get(0).get_field("stack").arr_size(), 0u);
+#endif  // __linux__
+}
+
+}  // namespace unittest
@@ -103,9 +103,9 @@ TEST(DiskFormatTest, DataBlockManagerMetablockMixinT) {
     EXPECT_EQ(8u, sizeof(dbm_metablock_mixin_t));
 }
 
-TEST(DiskFormatTest, ExtentManagerMetablockMixinT) {
-    EXPECT_EQ(0u, offsetof(extent_manager_metablock_mixin_t, padding));
-    EXPECT_EQ(8u, sizeof(extent_manager_metablock_mixin_t));
+TEST(DiskFormatTest, DataBlockManagerColdMetablockMixinT) {
+    EXPECT_EQ(0u, offsetof(dbm_cold_metablock_mixin_t, cold_active_extent));
+    EXPECT_EQ(8u, sizeof(dbm_cold_metablock_mixin_t));
 }
 
 TEST(DiskFormatTest, MetablockFilerangeChecksumListT) {
@@ -116,9 +116,9 @@ TEST(DiskFormatTest, MetablockFilerangeChecksumListT) {
 
 TEST(DiskFormatTest, LogSerializerMetablockT) {
     size_t n = 0;
-    EXPECT_EQ(n, offsetof(log_serializer_metablock_t, extent_manager_part));
+    EXPECT_EQ(n, offsetof(log_serializer_metablock_t, data_block_manager_cold_part));
 
-    n += sizeof(extent_manager_metablock_mixin_t);
+    n += sizeof(dbm_cold_metablock_mixin_t);
     EXPECT_EQ(n, offsetof(log_serializer_metablock_t, lba_index_part));
 
     n += sizeof(lba_metablock_mixin_t);
@@ -0,0 +1,80 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <vector>
+
+#include "arch/timing.hpp"
+#include "perfmon/perfmon.hpp"
+#include "serializer/log/config.hpp"
+#include "serializer/log/extent_manager.hpp"
+#include "serializer/log/stats.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/mock_file.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+static bool extent_is_discarded(const std::vector<char> &data, uint64_t extent_size,
+                                size_t extent) {
+    for (size_t i = extent * extent_size; i < (extent + 1) * extent_size; ++i) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The extents that are free when the serializer starts get discarded in the
+background, a batch at a time, rather than all at once on startup. An extent that gets
+reused before its turn comes up mustn't be discarded at all. */
+TPTEST(ExtentManagerTest, DiscardsFreeExtentsInBackground) {
+    log_serializer_static_config_t static_config;
+    const uint64_t extent_size = static_config.extent_size();
+    const size_t num_extents = 8;
+    std::vector<char> data(num_extents * extent_size, 'x');
+    mock_file_t file(mock_file_t::mode_rw, &data);
+    perfmon_collection_t perfmons;
+    log_serializer_stats_t stats(&perfmons);
+
+    extent_manager_t extent_manager(&file, &static_config, &stats);
+    // A previous run was using the first and the last extent.
+    extent_reference_t first = extent_manager.reserve_extent(0);
+    extent_reference_t last =
+        extent_manager.reserve_extent((num_extents - 1) * extent_size);
+    extent_manager.start_existing();
+
+    // Nothing gets discarded while we're starting up.
+    for (size_t i = 0; i < num_extents; ++i) {
+        EXPECT_FALSE(extent_is_discarded(data, extent_size, i)) << "extent " << i;
+    }
+
+    // The lowest free extent gets handed out first.
+    extent_reference_t reused = extent_manager.gen_extent();
+    ASSERT_EQ(static_cast<int64_t>(extent_size), reused.offset());
+
+    for (int tries = 0; ; ++tries) {
+        bool all_discarded = true;
+        for (size_t i = 2; i < num_extents - 1; ++i) {
+            all_discarded = all_discarded && extent_is_discarded(data, extent_size, i);
+        }
+        if (all_discarded) {
+            break;
+        }
+        ASSERT_LT(tries, 100);
+        nap(100);
+    }
+    EXPECT_FALSE(extent_is_discarded(data, extent_size, 0));
+    EXPECT_FALSE(extent_is_discarded(data, extent_size, 1));
+    EXPECT_FALSE(extent_is_discarded(data, extent_size, num_extents - 1));
+
+    // Once it's freed again, the reused extent gets discarded too.
+    extent_manager.release_extent(std::move(reused));
+    for (int tries = 0; !extent_is_discarded(data, extent_size, 1); ++tries) {
+        ASSERT_LT(tries, 100);
+        nap(100);
+    }
+
+    extent_manager.release_extent(std::move(first));
+    extent_manager.release_extent(std::move(last));
+    extent_manager.shutdown();
+}
+
+}  // namespace unittest
@@ -0,0 +1,76 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "serializer/log/data_block_manager.hpp"
+#include "unittest/gtest.hpp"
+
+namespace unittest {
+
+static ticks_t at_ms(int64_t ms) {
+    return ticks_t{ms * MILLION};
+}
+
+TEST(GcPacerTest, IdleAfterWritesStop) {
+    gc_pacer_t pacer(0.0, at_ms(0));
+    EXPECT_FALSE(pacer.is_idle(at_ms(1000)));
+    EXPECT_TRUE(pacer.is_idle(at_ms(60 * THOUSAND)));
+
+    // A write that is still in flight keeps the serializer from counting as idle.
+    pacer.on_foreground_write_started(at_ms(60 * THOUSAND));
+    EXPECT_FALSE(pacer.is_idle(at_ms(61 * THOUSAND)));
+    EXPECT_TRUE(pacer.is_idle(at_ms(120 * THOUSAND)));
+}
+
+TEST(GcPacerTest, DiskBusyWhenWritesSlowDown) {
+    gc_pacer_t pacer(0.0, at_ms(0));
+    EXPECT_FALSE(pacer.is_disk_busy());
+
+    // Writes that take as long as they always do aren't a sign of a busy disk.
+    int64_t now_ms = 0;
+    for (int i = 0; i < 200; ++i) {
+        pacer.on_foreground_write_started(at_ms(now_ms));
+        pacer.on_foreground_write_done(at_ms(now_ms), at_ms(now_ms + 1));
+        now_ms += 10;
+    }
+    EXPECT_FALSE(pacer.is_disk_busy());
+
+    // A few writes that take ten times as long are.
+    for (int i = 0; i < 5; ++i) {
+        pacer.on_foreground_write_started(at_ms(now_ms));
+        pacer.on_foreground_write_done(at_ms(now_ms), at_ms(now_ms + 10));
+        now_ms += 10;
+    }
+    EXPECT_TRUE(pacer.is_disk_busy());
+
+    // Once writes are fast again, the disk soon stops counting as busy.
+    for (int i = 0; i < 20; ++i) {
+        pacer.on_foreground_write_started(at_ms(now_ms));
+        pacer.on_foreground_write_done(at_ms(now_ms), at_ms(now_ms + 1));
+        now_ms += 10;
+    }
+    EXPECT_FALSE(pacer.is_disk_busy());
+}
+
+TEST(GcPacerTest, ProjectsGrowingGarbageRatio) {
+    gc_pacer_t pacer(0.05, at_ms(0));
+    EXPECT_EQ(0.05, pacer.projected_garbage_ratio(0.05));
+
+    // The garbage ratio grows by 1% a second, so the projection runs ahead of it.
+    for (int i = 1; i <= 20; ++i) {
+        pacer.on_pacing_timer(0.05 + 0.01 * i, at_ms(i * THOUSAND));
+    }
+    EXPECT_GT(pacer.projected_garbage_ratio(0.25), 0.5);
+
+    // A shrinking garbage ratio is never extrapolated downwards.
+    for (int i = 1; i <= 20; ++i) {
+        pacer.on_pacing_timer(0.25 - 0.01 * i, at_ms((20 + i) * THOUSAND));
+    }
+    EXPECT_EQ(0.05, pacer.projected_garbage_ratio(0.05));
+}
+
+TEST(GcPacerTest, IgnoresTimerWithoutElapsedTime) {
+    gc_pacer_t pacer(0.1, at_ms(1000));
+    // Two ticks at the same time must not divide by zero.
+    pacer.on_pacing_timer(0.2, at_ms(1000));
+    EXPECT_EQ(0.2, pacer.projected_garbage_ratio(0.2));
+}
+
+}  // namespace unittest
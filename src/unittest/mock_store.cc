@@ -57,7 +57,10 @@ std::string mock_lookup(store_view_t *store, std::string key) {
 
 mock_store_t::mock_store_t(binary_blob_t universe_metainfo)
     : store_view_t(region_t::universe()),
-      metainfo_(get_region(), universe_metainfo) { }
+      metainfo_(get_region(), universe_metainfo),
+      sync_gate_(nullptr),
+      sync_count_(0),
+      write_count_(0) { }
 mock_store_t::~mock_store_t() { }
 
 void mock_store_t::new_read_token(read_token_t *token_out) {
@@ -112,6 +115,29 @@ void mock_store_t::set_metainfo(const region_map_t<binary_blob_t> &new_metainfo,
     metainfo_.update(new_metainfo);
 }
 
+void mock_store_t::sync(order_token_t order_token,
+                        write_token_t *token,
+                        signal_t *interruptor) THROWS_ONLY(interrupted_exc_t) {
+    assert_thread();
+
+    object_buffer_t<fifo_enforcer_sink_t::exit_write_t>::destruction_sentinel_t destroyer(&token->main_write_token);
+
+    wait_interruptible(token->main_write_token.get(), interruptor);
+
+    order_sink_.check_out(order_token);
+
+    ++sync_count_;
+    if (sync_gate_ != nullptr) {
+        /* Like the real store, let later writes go ahead while we wait for the flush. */
+        token->main_write_token.reset();
+        wait_interruptible(sync_gate_, interruptor);
+    }
+
+    if (randint(2) == 0) {
+        nap(randint(10), interruptor);
+    }
+}
+
 
 
 void mock_store_t::read(
@@ -236,6 +262,7 @@ void mock_store_t::write(
     if (randint(2) == 0) {
         nap(randint(10), interruptor);
     }
+    ++write_count_;
 }
 
 continue_bool_t mock_store_t::send_backfill_pre(
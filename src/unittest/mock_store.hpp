@@ -47,6 +47,10 @@ public:
                       write_durability_t durability,
                       signal_t *interruptor) THROWS_ONLY(interrupted_exc_t);
 
+    void sync(order_token_t order_token,
+              write_token_t *token,
+              signal_t *interruptor) THROWS_ONLY(interrupted_exc_t);
+
     void read(
             DEBUG_ONLY(const metainfo_checker_t &metainfo_checker, )
             const read_t &read,
@@ -100,6 +104,13 @@ public:
     std::string values(std::string key);
     repli_timestamp_t timestamps(std::string key);
 
+    // `sync()` doesn't return until `gate` is pulsed. Pass `nullptr` to stop
+    // holding syncs back.
+    void set_sync_gate(signal_t *gate) { sync_gate_ = gate; }
+    int sync_count() const { return sync_count_; }
+    // The number of calls to `write()` that have returned.
+    int write_count() const { return write_count_; }
+
 private:
     fifo_enforcer_source_t token_source_;
     fifo_enforcer_sink_t token_sink_;
@@ -109,6 +120,10 @@ private:
     region_map_t<binary_blob_t> metainfo_;
     std::map<store_key_t, std::pair<repli_timestamp_t, ql::datum_t> > table_;
 
+    signal_t *sync_gate_;
+    int sync_count_;
+    int write_count_;
+
     DISABLE_COPYING(mock_store_t);
 };
 
@@ -0,0 +1,61 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <algorithm>
+#include <vector>
+
+#include "arch/timing.hpp"
+#include "clustering/table_manager/multi_table_manager.hpp"
+#include "config/args.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+/* When the server starts up, `multi_table_manager_t` loads its active tables through
+`load_tables_in_parallel()`. Every table must get its stores and then its table manager
+exactly once, and no more than `MAX_CONCURRENT_TABLE_LOADS` tables may be loading at a
+time, even though loading the stores blocks. */
+TPTEST(MultiTableManagerTest, StartupLoadsAreBounded) {
+    const size_t num_tables = 5 * MAX_CONCURRENT_TABLE_LOADS + 3;
+    std::vector<int> stores_loaded(num_tables, 0);
+    std::vector<int> managers_started(num_tables, 0);
+    int64_t loading = 0;
+    int64_t max_loading = 0;
+    table_load_times_t times = load_tables_in_parallel(
+        num_tables,
+        MAX_CONCURRENT_TABLE_LOADS,
+        [&](size_t i) {
+            ++loading;
+            max_loading = std::max(max_loading, loading);
+            EXPECT_EQ(0, managers_started[i]) << "table " << i;
+            ++stores_loaded[i];
+            nap(2 + i % 5);
+        },
+        [&](size_t i) {
+            EXPECT_EQ(1, stores_loaded[i]) << "table " << i;
+            ++managers_started[i];
+            --loading;
+        });
+
+    EXPECT_EQ(0, loading);
+    // The first `MAX_CONCURRENT_TABLE_LOADS` tables all start loading before any of
+    // them is done, so the bound is reached exactly.
+    EXPECT_EQ(MAX_CONCURRENT_TABLE_LOADS, max_loading);
+    for (size_t i = 0; i < num_tables; ++i) {
+        EXPECT_EQ(1, stores_loaded[i]) << "table " << i;
+        EXPECT_EQ(1, managers_started[i]) << "table " << i;
+    }
+    // Every table spent a couple of milliseconds loading its stores.
+    EXPECT_GE(times.store_load_nanos, static_cast<int64_t>(num_tables) * MILLION);
+    EXPECT_GE(times.table_manager_nanos, 0);
+}
+
+TPTEST(MultiTableManagerTest, NoTablesToLoad) {
+    table_load_times_t times = load_tables_in_parallel(
+        0, MAX_CONCURRENT_TABLE_LOADS,
+        [](size_t) { ADD_FAILURE(); },
+        [](size_t) { ADD_FAILURE(); });
+    EXPECT_EQ(0, times.store_load_nanos);
+    EXPECT_EQ(0, times.table_manager_nanos);
+}
+
+}  // namespace unittest
@@ -7,6 +7,7 @@
 
 #include "perfmon/perfmon.hpp"
 #include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
 
 namespace unittest {
 
@@ -57,4 +58,37 @@ TEST(PerfmonTest, StddevComputation) {
     }
 }
 
+TPTEST(PerfmonTest, LatencyHistogram) {
+    latency_histogram_t all, low, high;
+    for (uint64_t micros = 1; micros <= 1000; ++micros) {
+        all.record_micros(micros);
+        (micros <= 500 ? &low : &high)->record_micros(micros);
+    }
+    EXPECT_EQ(1000u, all.count());
+
+    // Estimates are upper bounds that are off by at most an eighth.
+    EXPECT_LE(0.0005, all.percentile(0.5));
+    EXPECT_GE(0.0005 * 9 / 8, all.percentile(0.5));
+    EXPECT_LE(0.00099, all.percentile(0.99));
+    EXPECT_EQ(0.001, all.percentile(1.0));
+    EXPECT_EQ(0.001, all.max());
+
+    // Small durations are exact.
+    latency_histogram_t small;
+    small.record_micros(3);
+    small.record_micros(7);
+    EXPECT_EQ(0.000003, small.percentile(0.5));
+    EXPECT_EQ(0.000007, small.percentile(0.9));
+
+    // Merging, directly or through a datum, is the same as recording everything in
+    // one histogram.
+    latency_histogram_t merged;
+    merged.merge(low);
+    merged.merge_datum(high.to_datum(true));
+    EXPECT_EQ(all.to_datum(true), merged.to_datum(true));
+
+    EXPECT_EQ(ql::datum_t::null(),
+              latency_histogram_t().to_datum(false).get_field("p99"));
+}
+
 }  // namespace unittest
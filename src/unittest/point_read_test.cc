@@ -0,0 +1,110 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/io/disk.hpp"
+#include "arch/runtime/coroutines.hpp"
+#include "btree/reql_specific.hpp"
+#include "buffer_cache/alt.hpp"
+#include "buffer_cache/cache_balancer.hpp"
+#include "concurrency/cond_var.hpp"
+#include "containers/uuid.hpp"
+#include "rdb_protocol/store.hpp"
+#include "serializer/log/log_serializer.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/mock_store.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+static void write_to_store(store_t *store, const std::string &key,
+                           const std::string &value) {
+#ifndef NDEBUG
+    metainfo_checker_t checker(region_t::universe(),
+        [](const region_t &, const binary_blob_t &) { });
+#endif
+    cond_t non_interruptor;
+    write_token_t token;
+    store->new_write_token(&token);
+    write_response_t response;
+    store->write(DEBUG_ONLY(checker, )
+                 region_map_t<binary_blob_t>(region_t::universe(), binary_blob_t()),
+                 mock_overwrite(key, value),
+                 &response,
+                 write_durability_t::SOFT,
+                 state_timestamp_t::zero().next(),
+                 order_token_t::ignore,
+                 &token,
+                 &non_interruptor);
+}
+
+/* Point reads first try to get their value out of the cache without acquiring any
+blocks. While a write holds the blocks that the read would look at, that must fail, and
+the read has to wait for the write on the regular path instead. */
+TPTEST(PointReadTest, FallsBackWhileWriting) {
+    recreate_temporary_directory(base_path_t("."));
+    temp_file_t data_file;
+    io_backender_t io_backender(file_direct_io_mode_t::buffered_desired);
+    dummy_cache_balancer_t balancer(GIGABYTE);
+    filepath_file_opener_t file_opener(data_file.name(), &io_backender);
+    log_serializer_t::create(&file_opener, log_serializer_t::static_config_t());
+    file_opener.move_serializer_file_to_permanent_location();
+    log_serializer_t serializer(
+        log_serializer_t::dynamic_config_t(),
+        &file_opener,
+        &get_global_perfmon_collection());
+    store_t store(
+        region_t::universe(),
+        &serializer,
+        &balancer,
+        "unit_test_store",
+        true,
+        &get_global_perfmon_collection(),
+        nullptr,
+        &io_backender,
+        base_path_t("."),
+        generate_uuid(),
+        update_sindexes_t::UPDATE,
+        which_cpu_shard_t{0, 1});
+    cond_t non_interruptor;
+
+    write_to_store(&store, "key", "value");
+    {
+        read_token_t token;
+        store.new_read_token(&token);
+        read_response_t response;
+        ASSERT_TRUE(store.try_read_without_acquiring(
+            mock_read("key"), &response, &token, &non_interruptor));
+        EXPECT_EQ("value", mock_parse_read_response(response));
+    }
+
+    write_token_t write_token;
+    store.new_write_token(&write_token);
+    scoped_ptr_t<txn_t> txn;
+    scoped_ptr_t<real_superblock_t> superblock;
+    store.acquire_superblock_for_write(1, write_durability_t::SOFT, &write_token,
+                                       &txn, &superblock, &non_interruptor);
+    {
+        read_token_t token;
+        store.new_read_token(&token);
+        read_response_t response;
+        EXPECT_FALSE(store.try_read_without_acquiring(
+            mock_read("key"), &response, &token, &non_interruptor));
+    }
+
+    std::string result;
+    cond_t read_done;
+    coro_t::spawn_sometime([&]() {
+        result = mock_lookup(&store, "key");
+        read_done.pulse();
+    });
+    for (int i = 0; i < 10; ++i) {
+        coro_t::yield();
+    }
+    EXPECT_FALSE(read_done.is_pulsed());
+
+    superblock.reset();
+    txn->commit();
+    txn.reset();
+    read_done.wait();
+    EXPECT_EQ("value", result);
+}
+
+}  // namespace unittest
@@ -0,0 +1,212 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <string.h>
+
+#include <atomic>
+#include <string>
+
+#include "arch/timing.hpp"
+#include "client_protocol/json.hpp"
+#include "client_protocol/query_dispatcher.hpp"
+#include "clustering/administration/metadata.hpp"
+#include "extproc/extproc_pool.hpp"
+#include "rdb_protocol/context.hpp"
+#include "rdb_protocol/pseudo_time.hpp"
+#include "unittest/dummy_metadata_controller.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+/* Stands in for `rdb_query_server_t`. A START only compiles its query, which leaves it
+in the query cache like an open cursor until a STOP comes along. While `hold` is set,
+queries wait before they do anything. */
+class cursor_handler_t : public query_handler_t {
+public:
+    cursor_handler_t() : last_thread(-1), hold(false) { }
+
+    void run_query(ql::query_params_t *query_params,
+                   ql::response_t *response_out,
+                   signal_t *interruptor) {
+        last_thread.store(get_thread_id().threadnum);
+        while (hold.load()) {
+            nap(1, interruptor);
+        }
+        switch (query_params->type) {
+        case Query::START:
+            query_params->query_cache->create(
+                query_params, ql::pseudo::time_now(), interruptor);
+            response_out->set_type(Response::SUCCESS_PARTIAL);
+            break;
+        case Query::CONTINUE:
+            query_params->query_cache->get(query_params, interruptor);
+            response_out->set_type(Response::SUCCESS_PARTIAL);
+            break;
+        case Query::STOP:
+            query_params->query_cache->stop_query(query_params, interruptor);
+            response_out->set_type(Response::SUCCESS_SEQUENCE);
+            break;
+        case Query::NOREPLY_WAIT:
+        case Query::SERVER_INFO:
+        default:
+            unreachable();
+        }
+    }
+
+    std::atomic<int> last_thread;
+    std::atomic<bool> hold;
+};
+
+static scoped_ptr_t<ql::query_params_t> make_query(ql::query_cache_t *query_cache,
+                                                   int64_t token,
+                                                   const std::string &json) {
+    scoped_array_t<char> buffer(json.size() + 1);
+    memcpy(buffer.data(), json.c_str(), json.size() + 1);
+    ql::response_t error;
+    scoped_ptr_t<ql::query_params_t> query = json_protocol_t::parse_query_from_buffer(
+        std::move(buffer), 0, query_cache, token, &error);
+    guarantee(query.has());
+    return query;
+}
+
+static std::string start_json(bool noreply) {
+    return strprintf("[%d,[%d,[]],{%s}]", Query::START, Term::RANGE,
+                     noreply ? "\"noreply\":true" : "");
+}
+
+static std::string query_json(Query::QueryType type) {
+    return strprintf("[%d]", type);
+}
+
+class dispatcher_env_t {
+public:
+    dispatcher_env_t()
+        : extproc_pool(2),
+          rdb_context(&extproc_pool, nullptr, auth_manager.get_view()),
+          home_cache(&rdb_context, ip_and_port_t(),
+                     ql::return_empty_normal_batches_t::NO,
+                     auth::user_context_t(auth::permissions_t(
+                         tribool::True, tribool::True, tribool::True, tribool::True))),
+          dispatcher(&rdb_context, home_cache),
+          home(get_thread_id()),
+          other((get_thread_id().threadnum + 1) % get_num_threads()) { }
+
+    extproc_pool_t extproc_pool;
+    dummy_semilattice_controller_t<auth_semilattice_metadata_t> auth_manager;
+    rdb_context_t rdb_context;
+    ql::query_cache_t home_cache;
+    query_dispatcher_t dispatcher;
+    cursor_handler_t handler;
+    cond_t non_interruptor;
+    const threadnum_t home;
+    const threadnum_t other;
+};
+
+/* A new query stays on the connection's thread unless others are running, in which case
+it moves to the thread that `pick_thread()` chose. */
+TPTEST(QueryDispatcherTest, PipelinedStartsMove, 4) {
+    dispatcher_env_t env;
+    auto pick_other = [&]() { return env.other; };
+    ASSERT_NE(env.home, env.other);
+
+    scoped_ptr_t<ql::query_params_t> query =
+        make_query(&env.home_cache, 1, start_json(false));
+    EXPECT_EQ(env.home, env.dispatcher.route(*query, false, pick_other));
+
+    query = make_query(&env.home_cache, 2, start_json(false));
+    threadnum_t thread = env.dispatcher.route(*query, true, pick_other);
+    ASSERT_EQ(env.other, thread);
+    rapidjson::StringBuffer message;
+    env.dispatcher.run<json_protocol_t>(
+        &env.handler, thread, query.get(), &message, &env.non_interruptor);
+    EXPECT_EQ(env.other.threadnum, env.handler.last_thread.load());
+    EXPECT_GT(message.GetSize(), 0u);
+
+    // If the connection's own thread gets picked, there's nothing to remember.
+    query = make_query(&env.home_cache, 3, start_json(false));
+    EXPECT_EQ(env.home, env.dispatcher.route(*query, true, [&]() { return env.home; }));
+    query = make_query(&env.home_cache, 3, query_json(Query::CONTINUE));
+    EXPECT_EQ(env.home, env.dispatcher.route(*query, true, pick_other));
+
+    // Other kinds of queries always stay.
+    query = make_query(&env.home_cache, 4, query_json(Query::NOREPLY_WAIT));
+    EXPECT_EQ(env.home, env.dispatcher.route(*query, true, pick_other));
+}
+
+/* A cursor stays on the thread that its START ran on, so its CONTINUEs and its STOP go
+there as well, even when nothing else is running. Once it's gone, the token is free. */
+TPTEST(QueryDispatcherTest, ContinueAndStopFollowToken, 4) {
+    dispatcher_env_t env;
+    auto pick_other = [&]() { return env.other; };
+    auto pick_none = [&]() -> threadnum_t { unreachable(); };
+    rapidjson::StringBuffer message;
+
+    scoped_ptr_t<ql::query_params_t> query =
+        make_query(&env.home_cache, 1, start_json(false));
+    threadnum_t thread = env.dispatcher.route(*query, true, pick_other);
+    ASSERT_EQ(env.other, thread);
+    env.dispatcher.run<json_protocol_t>(
+        &env.handler, thread, query.get(), &message, &env.non_interruptor);
+
+    for (int i = 0; i < 3; ++i) {
+        query = make_query(&env.home_cache, 1, query_json(Query::CONTINUE));
+        thread = env.dispatcher.route(*query, false, pick_none);
+        ASSERT_EQ(env.other, thread);
+        env.handler.last_thread.store(-1);
+        env.dispatcher.run<json_protocol_t>(
+            &env.handler, thread, query.get(), &message, &env.non_interruptor);
+        EXPECT_EQ(env.other.threadnum, env.handler.last_thread.load());
+    }
+
+    query = make_query(&env.home_cache, 1, query_json(Query::STOP));
+    thread = env.dispatcher.route(*query, false, pick_none);
+    ASSERT_EQ(env.other, thread);
+    env.handler.last_thread.store(-1);
+    env.dispatcher.run<json_protocol_t>(
+        &env.handler, thread, query.get(), &message, &env.non_interruptor);
+    EXPECT_EQ(env.other.threadnum, env.handler.last_thread.load());
+
+    query = make_query(&env.home_cache, 1, query_json(Query::CONTINUE));
+    EXPECT_EQ(env.home, env.dispatcher.route(*query, false, pick_none));
+}
+
+/* A noreply query that runs on another thread keeps its id outstanding on the
+connection's thread, so a NOREPLY_WAIT that comes after it can't finish before it. */
+TPTEST(QueryDispatcherTest, NoreplyWaitStaysOrdered, 4) {
+    dispatcher_env_t env;
+    auto pick_other = [&]() { return env.other; };
+
+    env.handler.hold.store(true);
+    scoped_ptr_t<ql::query_params_t> write =
+        make_query(&env.home_cache, 1, start_json(true));
+    ASSERT_TRUE(write->noreply);
+    threadnum_t thread = env.dispatcher.route(*write, true, pick_other);
+    ASSERT_EQ(env.other, thread);
+    cond_t write_done;
+    coro_t::spawn_sometime([&]() {
+        rapidjson::StringBuffer message;
+        env.dispatcher.run<json_protocol_t>(
+            &env.handler, thread, write.get(), &message, &env.non_interruptor);
+        EXPECT_EQ(0u, message.GetSize());
+        write_done.pulse();
+        write.reset();
+    });
+
+    scoped_ptr_t<ql::query_params_t> wait =
+        make_query(&env.home_cache, 2, query_json(Query::NOREPLY_WAIT));
+    EXPECT_EQ(env.home, env.dispatcher.route(*wait, true, pick_other));
+    cond_t wait_done;
+    coro_t::spawn_sometime([&]() {
+        env.home_cache.noreply_wait(*wait, &env.non_interruptor);
+        wait_done.pulse();
+    });
+
+    nap(100);
+    EXPECT_FALSE(write_done.is_pulsed());
+    EXPECT_FALSE(wait_done.is_pulsed());
+
+    env.handler.hold.store(false);
+    wait_done.wait();
+    EXPECT_TRUE(write_done.is_pulsed());
+}
+
+}  // namespace unittest
@@ -238,7 +238,7 @@ void run_backfill_test(const backfill_test_config_t &cfg) {
 
         local_replicator_t local_replicator(
             cluster.get_mailbox_manager(), server_id_t::generate_server_id(),
-            &dispatcher, &store1.store, &bhm, &non_interruptor);
+            &dispatcher, &store1.store, &bhm, nullptr, &non_interruptor);
 
         dispatcher_inserter_t inserter(
             &dispatcher, &order_source, cfg.value_padding_length, &first_inserter_state,
@@ -301,7 +301,7 @@ void run_backfill_test(const backfill_test_config_t &cfg) {
 
         local_replicator_t local_replicator(
             cluster.get_mailbox_manager(), server_id_t::generate_server_id(),
-            &dispatcher, &store2.store, &bhm, &non_interruptor);
+            &dispatcher, &store2.store, &bhm, nullptr, &non_interruptor);
 
         /* Find the subset of `first_inserter_state` that's actually present in `store2`
         */
@@ -357,7 +357,7 @@ void run_backfill_test(const backfill_test_config_t &cfg) {
 
         local_replicator_t local_replicator(
             cluster.get_mailbox_manager(), server_id_t::generate_server_id(),
-            &dispatcher, &store1.store, &bhm, &non_interruptor);
+            &dispatcher, &store1.store, &bhm, nullptr, &non_interruptor);
 
         /* Validate the state of `store1` to make sure
         that the backfill was completely correct */
@@ -402,7 +402,7 @@ void run_backfill_test(const backfill_test_config_t &cfg) {
 
         local_replicator_t local_replicator(
             cluster.get_mailbox_manager(), server_id_t::generate_server_id(),
-            &dispatcher, &store3.store, &bhm, &non_interruptor);
+            &dispatcher, &store3.store, &bhm, nullptr, &non_interruptor);
 
         /* Validate the state of `store3` to make sure that the backfill was completely
         correct */
@@ -1,5 +1,7 @@
 // Copyright 2010-2015 RethinkDB, all rights reserved.
 #include <functional>
+#include <map>
+#include <vector>
 
 #include "arch/io/disk.hpp"
 #include "arch/runtime/coroutines.hpp"
@@ -455,4 +457,177 @@ TPTEST(RDBBtree, SindexInterruptionViaStoreDelete) {
     store.reset();
 }
 
+static uint64_t count_rows(store_t *store, real_superblock_t *superblock) {
+    cond_t dummy_interruptor;
+    ql::env_t dummy_env(&dummy_interruptor,
+                        ql::return_empty_normal_batches_t::NO,
+                        reql_version_t::LATEST);
+    rget_read_response_t res;
+    rdb_rget_slice(
+        store->btree.get(),
+        region_t::universe(),
+        key_range_t::universe(),
+        r_nullopt,
+        superblock,
+        &dummy_env,
+        ql::batchspec_t::default_for(ql::batch_type_t::NORMAL),
+        std::vector<ql::transform_variant_t>(),
+        make_optional(ql::terminal_variant_t(ql::count_wire_func_t())),
+        sorting_t::UNORDERED,
+        &res,
+        release_superblock_t::RELEASE);
+
+    ql::grouped_t<uint64_t> *counts = boost::get<ql::grouped_t<uint64_t> >(&res.result);
+    guarantee(counts != nullptr);
+    uint64_t total = 0;
+    for (const auto &pair : *counts) {
+        total += pair.second;
+    }
+    return total;
+}
+
+/* `count()` must see the table as of the snapshot it reads from, no matter which
+writes have happened since. */
+TPTEST(RDBBtree, CountWithWrites) {
+    recreate_temporary_directory(base_path_t("."));
+    temp_file_t temp_file;
+
+    io_backender_t io_backender(file_direct_io_mode_t::buffered_desired);
+    dummy_cache_balancer_t balancer(GIGABYTE);
+
+    filepath_file_opener_t file_opener(temp_file.name(), &io_backender);
+    log_serializer_t::create(
+        &file_opener,
+        log_serializer_t::static_config_t());
+
+    log_serializer_t serializer(
+        log_serializer_t::dynamic_config_t(),
+        &file_opener,
+        &get_global_perfmon_collection());
+
+    store_t store(
+            region_t::universe(),
+            &serializer,
+            &balancer,
+            "unit_test_store",
+            true,
+            &get_global_perfmon_collection(),
+            nullptr,
+            &io_backender,
+            base_path_t("."),
+            generate_uuid(),
+            update_sindexes_t::UPDATE,
+            which_cpu_shard_t{0, 1});
+
+    cond_t dummy_interruptor;
+    const int batch = TOTAL_KEYS_TO_INSERT / 4;
+    for (int i = 0; i < 4; ++i) {
+        read_token_t token;
+        store.new_read_token(&token);
+        scoped_ptr_t<txn_t> txn;
+        scoped_ptr_t<real_superblock_t> superblock;
+        store.acquire_superblock_for_read(
+            &token, &txn, &superblock, &dummy_interruptor, true);
+
+        // These writes go ahead while we hold the snapshot.
+        insert_rows(i * batch, (i + 1) * batch, &store);
+        EXPECT_EQ(static_cast<uint64_t>(i * batch),
+                  count_rows(&store, superblock.get()));
+    }
+
+    read_token_t token;
+    store.new_read_token(&token);
+    scoped_ptr_t<txn_t> txn;
+    scoped_ptr_t<real_superblock_t> superblock;
+    store.acquire_superblock_for_read(
+        &token, &txn, &superblock, &dummy_interruptor, true);
+    EXPECT_EQ(static_cast<uint64_t>(4 * batch), count_rows(&store, superblock.get()));
+}
+
+/* `getAll` on the primary key looks up all of its keys in a single traversal that
+skips the leaves without any of them. Keys that were asked for more than once must
+come back that many times, and keys that don't exist mustn't come back at all. */
+TPTEST(RDBBtree, GetAllPrimaryKeys) {
+    recreate_temporary_directory(base_path_t("."));
+    temp_file_t temp_file;
+
+    io_backender_t io_backender(file_direct_io_mode_t::buffered_desired);
+    dummy_cache_balancer_t balancer(GIGABYTE);
+
+    filepath_file_opener_t file_opener(temp_file.name(), &io_backender);
+    log_serializer_t::create(
+        &file_opener,
+        log_serializer_t::static_config_t());
+
+    log_serializer_t serializer(
+        log_serializer_t::dynamic_config_t(),
+        &file_opener,
+        &get_global_perfmon_collection());
+
+    store_t store(
+            region_t::universe(),
+            &serializer,
+            &balancer,
+            "unit_test_store",
+            true,
+            &get_global_perfmon_collection(),
+            nullptr,
+            &io_backender,
+            base_path_t("."),
+            generate_uuid(),
+            update_sindexes_t::UPDATE,
+            which_cpu_shard_t{0, 1});
+
+    insert_rows(0, TOTAL_KEYS_TO_INSERT, &store);
+
+    auto pk = [](int i) {
+        return store_key_t(ql::datum_t(static_cast<double>(i)).print_primary());
+    };
+    std::map<store_key_t, uint64_t> primary_keys;
+    primary_keys[pk(3)] = 1;
+    primary_keys[pk(10)] = 2;
+    primary_keys[pk(500)] = 1;
+    primary_keys[pk(TOTAL_KEYS_TO_INSERT - 1)] = 1;
+    primary_keys[pk(TOTAL_KEYS_TO_INSERT + 5)] = 1;
+
+    cond_t dummy_interruptor;
+    read_token_t token;
+    store.new_read_token(&token);
+    scoped_ptr_t<txn_t> txn;
+    scoped_ptr_t<real_superblock_t> superblock;
+    store.acquire_superblock_for_read(
+        &token, &txn, &superblock, &dummy_interruptor, true);
+
+    ql::env_t dummy_env(&dummy_interruptor,
+                        ql::return_empty_normal_batches_t::NO,
+                        reql_version_t::LATEST);
+    rget_read_response_t res;
+    rdb_rget_slice(
+        store.btree.get(),
+        region_t::universe(),
+        key_range_t::universe(),
+        make_optional(primary_keys),
+        superblock.get(),
+        &dummy_env,
+        ql::batchspec_t::default_for(ql::batch_type_t::NORMAL),
+        std::vector<ql::transform_variant_t>(),
+        optional<ql::terminal_variant_t>(),
+        sorting_t::ASCENDING,
+        &res,
+        release_superblock_t::RELEASE);
+
+    ql::grouped_t<ql::stream_t> *groups =
+        boost::get<ql::grouped_t<ql::stream_t> >(&res.result);
+    ASSERT_TRUE(groups != nullptr);
+    ASSERT_EQ(1, groups->size());
+    ql::stream_t *stream = &groups->begin()->second;
+    ASSERT_EQ(1ul, stream->substreams.size());
+    std::vector<int> ids;
+    for (const auto &item : stream->substreams.begin()->second.stream) {
+        ids.push_back(static_cast<int>(
+            item.data.get_field("id").as_num()));
+    }
+    EXPECT_EQ((std::vector<int>{3, 10, 10, 500, TOTAL_KEYS_TO_INSERT - 1}), ids);
+}
+
 } //namespace unittest
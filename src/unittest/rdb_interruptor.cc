@@ -430,7 +430,7 @@ void tcp_interrupt_test(
     scoped_ptr_t<query_server_t> server(
         new query_server_t(env_instance->get_rdb_context(),
                            std::set<ip_address_t>({ip_address_t("127.0.0.1")}),
-                           0, &hanger, 2, nullptr));
+                           0, false, true, &hanger, 2, nullptr));
 
     scoped_ptr_t<tcp_conn_stream_t> conn = connect_client(server->get_port());
     send_query(test_token, r_uuid_json, conn.get());
@@ -541,7 +541,7 @@ void http_interrupt_test(test_rdb_env_t *test_env,
     scoped_ptr_t<query_server_t> server(
         new query_server_t(env_instance->get_rdb_context(),
                            std::set<ip_address_t>({ip_address_t("127.0.0.1")}),
-                           0, &hanger, 2, nullptr));
+                           0, false, true, &hanger, 2, nullptr));
 
     cond_t http_app_interruptor;
     http_res_t result;
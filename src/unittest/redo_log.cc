@@ -0,0 +1,296 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <stdio.h>
+
+#include <functional>
+
+#include "arch/io/disk.hpp"
+#include "buffer_cache/cache_balancer.hpp"
+#include "containers/uuid.hpp"
+#include "rdb_protocol/redo_log.hpp"
+#include "rdb_protocol/store.hpp"
+#include "serializer/log/log_serializer.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/mock_store.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+static region_map_t<binary_blob_t> redo_log_metainfo(uint64_t n) {
+    return region_map_t<binary_blob_t>(
+        region_t::universe(),
+        binary_blob_t(reinterpret_cast<const uint8_t *>(&n), sizeof(n)));
+}
+
+static void append_redo_log_record(redo_log_t *log, uint64_t n) {
+    log->append(redo_log_metainfo(n), redo_log_metainfo(n + 1),
+                mock_overwrite(strprintf("key%" PRIu64, n), "value"),
+                state_timestamp_t::zero().next());
+}
+
+static std::vector<uint64_t> read_redo_log(const std::string &path) {
+    redo_log_t log(path);
+    std::vector<uint64_t> res;
+    for (const redo_log_t::record_t &record : log.read_records()) {
+        for (uint64_t n = 0; n < 100; ++n) {
+            if (record.old_metainfo == redo_log_metainfo(n)) {
+                EXPECT_TRUE(redo_log_metainfo(n + 1) == record.new_metainfo);
+                res.push_back(n);
+            }
+        }
+    }
+    return res;
+}
+
+TPTEST(RedoLog, AppendAndRead) {
+    temp_directory_t dir;
+    std::string path = dir.path().path() + "/log";
+    cond_t non_interruptor;
+    {
+        redo_log_t log(path);
+        EXPECT_TRUE(log.read_records().empty());
+        log.clear();
+        append_redo_log_record(&log, 0);
+        append_redo_log_record(&log, 1);
+        log.flush(&non_interruptor);
+        append_redo_log_record(&log, 2);
+        log.flush(&non_interruptor);
+    }
+    EXPECT_EQ((std::vector<uint64_t>{0, 1, 2}), read_redo_log(path));
+
+    /* Appending after a restart continues the log from a clean slate. */
+    {
+        redo_log_t log(path);
+        EXPECT_EQ(3u, log.read_records().size());
+        log.clear();
+        append_redo_log_record(&log, 5);
+        log.flush(&non_interruptor);
+    }
+    EXPECT_EQ((std::vector<uint64_t>{5}), read_redo_log(path));
+}
+
+TPTEST(RedoLog, IgnoresTornRecord) {
+    temp_directory_t dir;
+    std::string path = dir.path().path() + "/log";
+    cond_t non_interruptor;
+    {
+        redo_log_t log(path);
+        log.read_records();
+        log.clear();
+        append_redo_log_record(&log, 0);
+        log.flush(&non_interruptor);
+    }
+
+    /* Simulate a crash in the middle of writing a second record. `clear()` starts
+    generation 1, which lives in slot 1. */
+    FILE *file = fopen((path + ".1").c_str(), "ab");
+    ASSERT_TRUE(file != nullptr);
+    const char garbage[] = "\x40\x00\x00\x00\x00\x00\x00\x00torn";
+    ASSERT_EQ(1u, fwrite(garbage, sizeof(garbage), 1, file));
+    fclose(file);
+
+    EXPECT_EQ((std::vector<uint64_t>{0}), read_redo_log(path));
+}
+
+TPTEST(RedoLog, Checkpoint) {
+    temp_directory_t dir;
+    std::string path = dir.path().path() + "/log";
+    cond_t non_interruptor;
+    redo_log_t log(path);
+    log.read_records();
+    log.clear();
+    append_redo_log_record(&log, 0);
+    log.flush(&non_interruptor);
+
+    log.begin_checkpoint(&non_interruptor);
+    append_redo_log_record(&log, 1);
+    log.flush(&non_interruptor);
+    /* Until the checkpoint finishes, both files are replayed, oldest first. */
+    EXPECT_EQ((std::vector<uint64_t>{0, 1}), read_redo_log(path));
+
+    log.finish_checkpoint(&non_interruptor);
+    EXPECT_EQ((std::vector<uint64_t>{1}), read_redo_log(path));
+}
+
+/* Opens the store in `file`, creating it if `create` is true, runs `fun` on it and
+shuts it down cleanly. */
+static void with_store(const serializer_filepath_t &file, bool create,
+                       const std::function<void(store_t *)> &fun) {
+    io_backender_t io_backender(file_direct_io_mode_t::buffered_desired);
+    dummy_cache_balancer_t balancer(GIGABYTE);
+    filepath_file_opener_t file_opener(file, &io_backender);
+    if (create) {
+        log_serializer_t::create(&file_opener, log_serializer_t::static_config_t());
+        file_opener.move_serializer_file_to_permanent_location();
+    }
+    log_serializer_t serializer(
+        log_serializer_t::dynamic_config_t(),
+        &file_opener,
+        &get_global_perfmon_collection());
+    store_t store(
+        region_t::universe(),
+        &serializer,
+        &balancer,
+        "unit_test_store",
+        create,
+        &get_global_perfmon_collection(),
+        nullptr,
+        &io_backender,
+        base_path_t("."),
+        generate_uuid(),
+        update_sindexes_t::UPDATE,
+        which_cpu_shard_t{0, 1});
+    fun(&store);
+}
+
+static void copy_file(const std::string &from, const std::string &to) {
+    FILE *in = fopen(from.c_str(), "rb");
+    guarantee(in != nullptr);
+    FILE *out = fopen(to.c_str(), "wb");
+    guarantee(out != nullptr);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        guarantee(fwrite(buf, 1, n, out) == n);
+    }
+    fclose(in);
+    guarantee(fclose(out) == 0);
+}
+
+static std::string redo_log_key(uint64_t n) {
+    return strprintf("key%" PRIu64, n);
+}
+
+/* `StoreReplaysAfterCrash` makes hard-durability writes through a store with a redo
+log, and then puts back a copy of the data file from before the writes. That is what the
+disk looks like if the server is killed after the log was synced but before the cache
+flushed the writes. Enabling the redo log again has to bring the writes back. */
+TPTEST(RedoLog, StoreReplaysAfterCrash) {
+    recreate_temporary_directory(base_path_t("."));
+    temp_file_t data_file;
+    temp_directory_t dir;
+    const std::string data_path = data_file.name().permanent_path();
+    const std::string log_path = dir.path().path() + "/log";
+    const std::string image_path = dir.path().path() + "/image";
+    const uint64_t num_writes = 3;
+    cond_t non_interruptor;
+
+    with_store(data_file.name(), true, [&](store_t *store) {
+        write_token_t token;
+        store->new_write_token(&token);
+        store->set_metainfo(redo_log_metainfo(0), order_token_t::ignore, &token,
+                            write_durability_t::HARD, &non_interruptor);
+    });
+    copy_file(data_path, image_path);
+
+    with_store(data_file.name(), false, [&](store_t *store) {
+        store->enable_redo_log(log_path, &non_interruptor);
+        state_timestamp_t timestamp = state_timestamp_t::zero();
+        for (uint64_t n = 0; n < num_writes; ++n) {
+            timestamp = timestamp.next();
+#ifndef NDEBUG
+            metainfo_checker_t checker(region_t::universe(),
+                [](const region_t &, const binary_blob_t &) { });
+#endif
+            write_token_t token;
+            store->new_write_token(&token);
+            write_response_t response;
+            store->write(DEBUG_ONLY(checker, )
+                         redo_log_metainfo(n + 1),
+                         mock_overwrite(redo_log_key(n), "value"),
+                         &response,
+                         write_durability_t::HARD,
+                         timestamp,
+                         order_token_t::ignore,
+                         &token,
+                         &non_interruptor);
+        }
+    });
+    EXPECT_EQ((std::vector<uint64_t>{0, 1, 2}), read_redo_log(log_path));
+
+    /* The "crash": the writes never reached the data file. */
+    copy_file(image_path, data_path);
+
+    with_store(data_file.name(), false, [&](store_t *store) {
+        EXPECT_EQ("", mock_lookup(store, redo_log_key(0)));
+        store->enable_redo_log(log_path, &non_interruptor);
+        for (uint64_t n = 0; n < num_writes; ++n) {
+            EXPECT_EQ("value", mock_lookup(store, redo_log_key(n)));
+        }
+        read_token_t token;
+        store->new_read_token(&token);
+        EXPECT_TRUE(redo_log_metainfo(num_writes) == store->get_metainfo(
+            order_token_t::ignore, &token, region_t::universe(), &non_interruptor));
+    });
+
+    /* The replayed writes were made durable before the log was reset, so a plain
+    restart still has them. */
+    EXPECT_TRUE(read_redo_log(log_path).empty());
+    with_store(data_file.name(), false, [&](store_t *store) {
+        for (uint64_t n = 0; n < num_writes; ++n) {
+            EXPECT_EQ("value", mock_lookup(store, redo_log_key(n)));
+        }
+    });
+}
+
+/* `HardWriteAfterUnloggedChange` changes the metainfo with soft durability, which
+doesn't go through the redo log, and then makes a hard-durability write. The log record
+for the write can only be replayed on top of the soft change, so the write has to make
+both durable in the data file itself. We take the "crash" image right after the write
+returns. */
+TPTEST(RedoLog, HardWriteAfterUnloggedChange) {
+    recreate_temporary_directory(base_path_t("."));
+    temp_file_t data_file;
+    temp_directory_t dir;
+    const std::string data_path = data_file.name().permanent_path();
+    const std::string log_path = dir.path().path() + "/log";
+    const std::string image_path = dir.path().path() + "/image";
+    cond_t non_interruptor;
+
+    with_store(data_file.name(), true, [&](store_t *store) {
+        write_token_t token;
+        store->new_write_token(&token);
+        store->set_metainfo(redo_log_metainfo(0), order_token_t::ignore, &token,
+                            write_durability_t::HARD, &non_interruptor);
+    });
+
+    with_store(data_file.name(), false, [&](store_t *store) {
+        store->enable_redo_log(log_path, &non_interruptor);
+        {
+            write_token_t token;
+            store->new_write_token(&token);
+            store->set_metainfo(redo_log_metainfo(1), order_token_t::ignore, &token,
+                                write_durability_t::SOFT, &non_interruptor);
+        }
+#ifndef NDEBUG
+        metainfo_checker_t checker(region_t::universe(),
+            [](const region_t &, const binary_blob_t &) { });
+#endif
+        write_token_t token;
+        store->new_write_token(&token);
+        write_response_t response;
+        store->write(DEBUG_ONLY(checker, )
+                     redo_log_metainfo(2),
+                     mock_overwrite(redo_log_key(1), "value"),
+                     &response,
+                     write_durability_t::HARD,
+                     state_timestamp_t::zero().next(),
+                     order_token_t::ignore,
+                     &token,
+                     &non_interruptor);
+        copy_file(data_path, image_path);
+    });
+
+    /* The "crash": nothing that happened after the write reached the data file. */
+    copy_file(image_path, data_path);
+
+    with_store(data_file.name(), false, [&](store_t *store) {
+        store->enable_redo_log(log_path, &non_interruptor);
+        EXPECT_EQ("value", mock_lookup(store, redo_log_key(1)));
+        read_token_t token;
+        store->new_read_token(&token);
+        EXPECT_TRUE(redo_log_metainfo(2) == store->get_metainfo(
+            order_token_t::ignore, &token, region_t::universe(), &non_interruptor));
+    });
+}
+
+}  // namespace unittest
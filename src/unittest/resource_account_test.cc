@@ -0,0 +1,108 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/runtime/coroutines.hpp"
+#include "arch/runtime/resource_account.hpp"
+#include "arch/timing.hpp"
+#include "concurrency/cond_var.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+TEST(ResourceAccountTest, AddsUp) {
+    resource_account_t account;
+    account.charge_cpu_nanos(50 * MILLION);
+    account.charge_block_from_cache();
+    account.charge_block_from_cache();
+    account.charge_block_from_disk();
+    account.charge_row_scanned();
+
+    resource_usage_t shard;
+    shard.cpu_nanos = 20 * MILLION;
+    shard.blocks_from_disk = 3;
+    shard.rows_scanned = 10;
+    resource_usage_t shards;
+    shards.add(shard);
+    shards.add(shard);
+    account.charge(shards);
+
+    resource_usage_t usage = account.get_usage();
+    EXPECT_EQ(90 * MILLION, usage.cpu_nanos);
+    EXPECT_EQ(2u, usage.blocks_from_cache);
+    EXPECT_EQ(7u, usage.blocks_from_disk);
+    EXPECT_EQ(21u, usage.rows_scanned);
+}
+
+/* The slow query log charges each batch with what the query's account went up by while
+the batch ran. */
+TEST(ResourceAccountTest, Since) {
+    resource_account_t account;
+    account.charge_cpu_nanos(10 * MILLION);
+    account.charge_row_scanned();
+    const resource_usage_t before = account.get_usage();
+
+    account.charge_cpu_nanos(5 * MILLION);
+    account.charge_block_from_disk();
+    account.charge_row_scanned();
+    account.charge_row_scanned();
+
+    resource_usage_t batch = account.get_usage().since(before);
+    EXPECT_EQ(5 * MILLION, batch.cpu_nanos);
+    EXPECT_EQ(0u, batch.blocks_from_cache);
+    EXPECT_EQ(1u, batch.blocks_from_disk);
+    EXPECT_EQ(2u, batch.rows_scanned);
+}
+
+TPTEST(ResourceAccountTest, NestedScopes) {
+    EXPECT_EQ(nullptr, resource_account_t::current());
+    resource_account_t outer, inner;
+    {
+        resource_account_scope_t outer_scope(&outer);
+        EXPECT_EQ(&outer, resource_account_t::current());
+        {
+            resource_account_scope_t inner_scope(&inner);
+            EXPECT_EQ(&inner, resource_account_t::current());
+            resource_account_t::current()->charge_row_scanned();
+        }
+        EXPECT_EQ(&outer, resource_account_t::current());
+        resource_account_t::current()->charge_block_from_disk();
+    }
+    EXPECT_EQ(nullptr, resource_account_t::current());
+
+    EXPECT_EQ(1u, inner.get_usage().rows_scanned);
+    EXPECT_EQ(0u, inner.get_usage().blocks_from_disk);
+    EXPECT_EQ(0u, outer.get_usage().rows_scanned);
+    EXPECT_EQ(1u, outer.get_usage().blocks_from_disk);
+}
+
+/* Coroutines that the charged coroutine spawns aren't charged to its account, and the
+time that it spends waiting for them isn't either. The charged time all falls inside
+the scope but outside the spawned coroutine's run, so it's bounded by the difference
+of the two, whatever the actual timings were. */
+TPTEST(ResourceAccountTest, OnlyChargesTheCoroutine) {
+    resource_account_t account;
+    resource_account_t *spawned_account = &account;
+    int64_t spawned_nanos = 0;
+    ticks_t start = get_ticks();
+    {
+        resource_account_scope_t scope(&account);
+        cond_t done;
+        coro_t::spawn_sometime([&]() {
+            ticks_t spawned_start = get_ticks();
+            spawned_account = resource_account_t::current();
+            nap(10);
+            spawned_nanos = get_ticks().nanos - spawned_start.nanos;
+            done.pulse();
+        });
+        done.wait();
+    }
+    int64_t elapsed = get_ticks().nanos - start.nanos;
+    EXPECT_EQ(nullptr, spawned_account);
+    EXPECT_GT(spawned_nanos, 0);
+
+    resource_usage_t usage = account.get_usage();
+    EXPECT_GE(usage.cpu_nanos, 0);
+    EXPECT_LE(usage.cpu_nanos, elapsed - spawned_nanos);
+    EXPECT_EQ(0u, usage.rows_scanned);
+}
+
+}  // namespace unittest
@@ -86,6 +86,103 @@ TPTEST(RPCDirectoryTest, Update) {
     EXPECT_EQ(151, rm3.get_root_view()->get().get_inner().find(c1.get_me())->second);
 }
 
+/* `CoalescedUpdates` tests that a burst of changes to a directory value reaches the
+other nodes as fewer updates than there were changes, and that every node ends up with
+the final value. It compares the messages and bytes that the writer sent with what
+sending every change to every peer would have cost. How many updates get through depends
+on scheduling, so we only check for a tenfold saving, not an exact number. */
+TPTEST(RPCDirectoryTest, CoalescedUpdates) {
+    const size_t num_nodes = 8;
+    std::vector<scoped_ptr_t<connectivity_cluster_t> > clusters;
+    std::vector<scoped_ptr_t<directory_read_manager_t<int> > > read_managers;
+    std::vector<scoped_ptr_t<watchable_variable_t<int> > > watchables;
+    std::vector<scoped_ptr_t<directory_write_manager_t<int> > > write_managers;
+    std::vector<scoped_ptr_t<test_cluster_run_t> > runs;
+    for (size_t i = 0; i < num_nodes; ++i) {
+        clusters.push_back(make_scoped<connectivity_cluster_t>());
+        read_managers.push_back(make_scoped<directory_read_manager_t<int> >(
+            clusters[i].get(), 'D'));
+        watchables.push_back(make_scoped<watchable_variable_t<int> >(0));
+        write_managers.push_back(make_scoped<directory_write_manager_t<int> >(
+            clusters[i].get(), 'D', watchables[i]->get_watchable()));
+    }
+    for (size_t i = 0; i < num_nodes; ++i) {
+        runs.push_back(make_scoped<test_cluster_run_t>(clusters[i].get()));
+        if (i != 0) {
+            runs[i]->join(get_cluster_local_address(clusters[0].get()), 0);
+        }
+    }
+    let_stuff_happen();
+
+    peer_id_t source = clusters[0]->get_me();
+    std::vector<size_t> updates_seen(num_nodes, 0);
+    std::vector<scoped_ptr_t<watchable_map_t<peer_id_t, int>::all_subs_t> > subs;
+    for (size_t i = 0; i < num_nodes; ++i) {
+        subs.push_back(make_scoped<watchable_map_t<peer_id_t, int>::all_subs_t>(
+            read_managers[i]->get_root_map_view(),
+            [&updates_seen, source, i](const peer_id_t &peer, const int *) {
+                if (peer == source) {
+                    ++updates_seen[i];
+                }
+            },
+            initial_call_t::NO));
+    }
+
+    const uint64_t serializations_before = write_managers[0]->get_serializations();
+    const uint64_t updates_before = write_managers[0]->get_updates_sent();
+    const uint64_t bytes_before = write_managers[0]->get_update_bytes_sent();
+
+    const int num_changes = 1000;
+    uint64_t uncoalesced_bytes = 0;
+    for (int i = 1; i <= num_changes; ++i) {
+        watchables[0]->set_value(i);
+
+        /* Without coalescing, this change would go to every peer as its own message. */
+        write_message_t wm;
+        serialize_universal(&wm, static_cast<uint8_t>('U'));
+        serialize<cluster_version_t::CLUSTER>(&wm, static_cast<uint64_t>(i));
+        serialize<cluster_version_t::CLUSTER>(&wm, i);
+        uncoalesced_bytes += wm.size() * (num_nodes - 1);
+    }
+    const uint64_t uncoalesced_updates = num_changes * (num_nodes - 1);
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+        /* Wait for the final value to arrive, however long that takes */
+        for (int tries = 0; ; ++tries) {
+            optional<int> value =
+                read_managers[i]->get_root_map_view()->get_key(source);
+            ASSERT_TRUE(static_cast<bool>(value));
+            if (*value == num_changes) {
+                break;
+            }
+            ASSERT_LT(tries, 1000) << "node " << i << " stuck at " << *value;
+            nap(10);
+        }
+        EXPECT_LT(updates_seen[i], static_cast<size_t>(num_changes)) << "node " << i;
+    }
+
+    /* Once everything has converged, no more updates should trickle in. */
+    std::vector<size_t> updates_after_convergence = updates_seen;
+    let_stuff_happen();
+    EXPECT_EQ(updates_after_convergence, updates_seen);
+
+    const uint64_t updates =
+        write_managers[0]->get_updates_sent() - updates_before;
+    const uint64_t bytes =
+        write_managers[0]->get_update_bytes_sent() - bytes_before;
+    const uint64_t serializations =
+        write_managers[0]->get_serializations() - serializations_before;
+    EXPECT_GE(updates, num_nodes - 1);
+    EXPECT_LT(updates * 10, uncoalesced_updates)
+        << updates << " updates instead of " << uncoalesced_updates;
+    EXPECT_LT(bytes * 10, uncoalesced_bytes)
+        << bytes << " bytes instead of " << uncoalesced_bytes;
+    /* Peers that send at the same time share one serialization of the value. */
+    EXPECT_GE(serializations, 1u);
+    EXPECT_LE(serializations, updates);
+    EXPECT_LT(serializations * 10, static_cast<uint64_t>(num_changes));
+}
+
 /* `MapUpdate` tests that directory nodes see updates from their peers when using
 `directory_map_*_manager_t`. */
 TPTEST(RPCDirectoryTest, MapUpdate) {
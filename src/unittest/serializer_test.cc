@@ -90,5 +90,88 @@ TEST(SerializerTest, AddDeleteRepeatedlyWithIndex) {
     run_in_thread_pool(std::bind(run_AddDeleteRepeatedly, true), 4);
 }
 
+/* Writes a fresh version of each block in `block_ids` and points the index at it.
+Returns the offsets that the new versions were written to. */
+static std::vector<int64_t> write_blocks(log_serializer_t *ser,
+                                         const std::vector<block_id_t> &block_ids) {
+    buf_ptr_t buf = buf_ptr_t::alloc_zeroed(ser->max_block_size());
+    scoped_ptr_t<file_account_t> account(ser->make_io_account(1));
+
+    std::vector<buf_write_info_t> infos;
+    for (block_id_t block_id : block_ids) {
+        infos.push_back(buf_write_info_t(buf.ser_buffer(), buf.block_size(), block_id));
+    }
+    struct : public iocallback_t, public cond_t {
+        void on_io_complete() {
+            pulse();
+        }
+    } cb;
+    std::vector<counted_t<block_token_t>> tokens
+        = ser->block_writes(infos.data(), infos.size(), account.get(), &cb);
+    cb.wait();
+
+    std::vector<index_write_op_t> write_ops;
+    std::vector<int64_t> offsets;
+    for (size_t i = 0; i < block_ids.size(); ++i) {
+        write_ops.push_back(index_write_op_t(block_ids[i], make_optional(tokens[i]),
+            make_optional(repli_timestamp_t::distant_past)));
+        offsets.push_back(tokens[i]->offset());
+    }
+    new_mutex_in_line_t dummy_acq;
+    ser->index_write(&dummy_acq, []{ }, write_ops);
+    return offsets;
+}
+
+/* Blocks are written to a hot or a cold extent depending on how old their previous
+version is. Both extents have to stay active across a restart, or every restart would
+leave two partially filled extents behind. */
+TPTEST(SerializerTest, WriteStreamsSurviveRestart) {
+    mock_file_opener_t file_opener;
+    log_serializer_t::create(&file_opener, log_serializer_t::static_config_t());
+    const uint64_t extent_size = log_serializer_t::static_config_t().extent_size();
+    const block_id_t blocks_per_extent =
+        log_serializer_t::static_config_t().blocks_per_extent();
+
+    // Fill more than one extent, so that the first extent is no longer active. After a
+    // restart it counts as old, which makes blocks 0 and 1 cold.
+    {
+        log_serializer_t ser(log_serializer_t::dynamic_config_t(),
+                             &file_opener,
+                             &get_global_perfmon_collection());
+        for (block_id_t i = 0; i < blocks_per_extent + 10; i += 10) {
+            std::vector<block_id_t> ids;
+            for (block_id_t j = i; j < i + 10; ++j) {
+                ids.push_back(j);
+            }
+            write_blocks(&ser, ids);
+        }
+    }
+
+    int64_t cold_offset, hot_offset;
+    {
+        log_serializer_t ser(log_serializer_t::dynamic_config_t(),
+                             &file_opener,
+                             &get_global_perfmon_collection());
+        // Block 0's previous version is in an old extent, and the new block isn't.
+        std::vector<int64_t> offsets = write_blocks(
+            &ser, std::vector<block_id_t>{0, 10 * blocks_per_extent});
+        cold_offset = offsets[0];
+        hot_offset = offsets[1];
+        EXPECT_NE(cold_offset / extent_size, hot_offset / extent_size);
+    }
+
+    {
+        log_serializer_t ser(log_serializer_t::dynamic_config_t(),
+                             &file_opener,
+                             &get_global_perfmon_collection());
+        std::vector<int64_t> offsets = write_blocks(
+            &ser, std::vector<block_id_t>{1, 10 * blocks_per_extent + 1});
+        // Each stream carries on in the extent it was using before the restart.
+        EXPECT_EQ(cold_offset / extent_size, offsets[0] / extent_size);
+        EXPECT_GT(offsets[0], cold_offset);
+        EXPECT_EQ(hot_offset / extent_size, offsets[1] / extent_size);
+        EXPECT_GT(offsets[1], hot_offset);
+    }
+}
 
 }  // namespace unittest
@@ -0,0 +1,51 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <atomic>
+
+#include "arch/io/network.hpp"
+#include "arch/timing.hpp"
+#include "containers/archive/tcp_conn_stream.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+TPTEST_MULTITHREAD(ShardedTcpListenerTest, SpreadsConnections, 4) {
+    const int num_conns = 64;
+    scoped_array_t<std::atomic<int> > accepted(get_num_threads());
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        accepted[i].store(0);
+    }
+
+    sharded_tcp_listener_t listener(
+        std::set<ip_address_t>({ip_address_t("127.0.0.1")}), 0, true,
+        [&](UNUSED scoped_ptr_t<tcp_conn_descriptor_t> &nconn) {
+            accepted[get_thread_id().threadnum].fetch_add(1);
+        });
+
+    cond_t interruptor;
+    std::vector<scoped_ptr_t<tcp_conn_stream_t> > conns;
+    for (int i = 0; i < num_conns; ++i) {
+        conns.push_back(make_scoped<tcp_conn_stream_t>(
+            nullptr, ip_address_t("127.0.0.1"), listener.get_port(), &interruptor));
+    }
+
+    int total = 0;
+    for (int attempt = 0; attempt < 1000 && total < num_conns; ++attempt) {
+        nap(10);
+        total = 0;
+        for (size_t i = 0; i < accepted.size(); ++i) {
+            total += accepted[i].load();
+        }
+    }
+    ASSERT_EQ(num_conns, total);
+
+#if defined(__linux__) && defined(SO_REUSEPORT)
+    // The kernel picks a socket by hashing the connection's addresses, so with this
+    // many connections every thread gets some.
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        EXPECT_GT(accepted[i].load(), 0) << "thread " << i;
+    }
+#endif
+}
+
+}  // namespace unittest
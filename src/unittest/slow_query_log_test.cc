@@ -0,0 +1,76 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "rdb_protocol/slow_query_log.hpp"
+#include "threading.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+static slow_query_log_t::entry_t make_entry(microtime_t started_at) {
+    slow_query_log_t::entry_t entry;
+    entry.id = generate_uuid();
+    entry.job_id = generate_uuid();
+    entry.started_at = started_at;
+    entry.duration = ticks_t{BILLION};
+    entry.continuation = false;
+    entry.rows_returned = 0;
+    return entry;
+}
+
+static void record_on_thread(slow_query_log_t *log, int thread,
+                             microtime_t started_at) {
+    on_thread_t thread_switcher((threadnum_t(thread)));
+    log->record(make_entry(started_at));
+}
+
+TPTEST(SlowQueryLogTest, Threshold) {
+    slow_query_log_t log;
+    log.set_config(100 * MILLION, 10);
+    EXPECT_FALSE(log.should_record(ticks_t{99 * MILLION}));
+    EXPECT_TRUE(log.should_record(ticks_t{100 * MILLION}));
+
+    // A negative threshold turns the log off.
+    log.set_config(-1, 10);
+    EXPECT_FALSE(log.should_record(ticks_t{100 * BILLION}));
+}
+
+TPTEST(SlowQueryLogTest, KeepsMostRecent) {
+    slow_query_log_t log;
+    log.set_config(0, 3);
+    for (microtime_t i = 1; i <= 5; ++i) {
+        log.record(make_entry(i));
+    }
+    std::vector<slow_query_log_t::entry_t> entries = log.get_entries();
+    ASSERT_EQ(3u, entries.size());
+    EXPECT_EQ(3u, entries[0].started_at);
+    EXPECT_EQ(5u, entries[2].started_at);
+
+    EXPECT_TRUE(log.erase_entry(entries[1].id));
+    EXPECT_FALSE(log.erase_entry(entries[1].id));
+    entries = log.get_entries();
+    ASSERT_EQ(2u, entries.size());
+    EXPECT_EQ(3u, entries[0].started_at);
+    EXPECT_EQ(5u, entries[1].started_at);
+}
+
+/* The capacity applies to the log as a whole, no matter how the slow queries are spread
+over the threads, even if there are fewer entries than threads. */
+TPTEST(SlowQueryLogTest, CapacityAcrossThreads, 4) {
+    slow_query_log_t log;
+    log.set_config(0, 3);
+    for (microtime_t i = 1; i <= 8; ++i) {
+        record_on_thread(&log, i % 4, i);
+    }
+    std::vector<slow_query_log_t::entry_t> entries = log.get_entries();
+    ASSERT_EQ(3u, entries.size());
+    EXPECT_EQ(6u, entries[0].started_at);
+    EXPECT_EQ(7u, entries[1].started_at);
+    EXPECT_EQ(8u, entries[2].started_at);
+
+    log.set_config(0, 1);
+    entries = log.get_entries();
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(8u, entries[0].started_at);
+}
+
+}  // namespace unittest
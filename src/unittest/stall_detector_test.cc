@@ -0,0 +1,65 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "arch/runtime/stall_detector.hpp"
+#include "config/args.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+/* A segment start of 0 means that the thread is waiting, so the tests don't start the
+clock at 0. */
+static ticks_t at_ms(int64_t ms) {
+    return ticks_t{(1000 + ms) * MILLION};
+}
+
+TPTEST(StallDetectorTest, CountsStalls) {
+    stall_detector_t detector;
+    detector.on_thread_start(at_ms(0));
+
+    // Hogging the thread for less than the threshold is fine.
+    int64_t now = EVENT_LOOP_STALL_THRESHOLD_MS - 1;
+    detector.on_message(at_ms(now));
+    EXPECT_EQ(0u, detector.get_stats(at_ms(now)).stalls);
+
+    // The stall is only counted once the segment ends.
+    now += 2 * EVENT_LOOP_STALL_THRESHOLD_MS;
+    EXPECT_EQ(0u, detector.get_stats(at_ms(now)).stalls);
+    detector.on_message(at_ms(now));
+    EXPECT_EQ(1u, detector.get_stats(at_ms(now)).stalls);
+
+    // Waiting for events for a long time isn't a stall, and neither is waking up.
+    detector.on_wait_start(at_ms(now));
+    now += 10 * EVENT_LOOP_STALL_THRESHOLD_MS;
+    detector.on_wait_end(at_ms(now));
+    detector.on_message(at_ms(now + 1));
+    EXPECT_EQ(1u, detector.get_stats(at_ms(now + 1)).stalls);
+
+    // But whatever runs after we wake up can stall, even before the first message.
+    now += 1 + EVENT_LOOP_STALL_THRESHOLD_MS;
+    detector.on_wait_start(at_ms(now));
+    EXPECT_EQ(2u, detector.get_stats(at_ms(now)).stalls);
+    detector.on_wait_end(at_ms(now));
+}
+
+TPTEST(StallDetectorTest, BusyRatio) {
+    stall_detector_t detector;
+    detector.on_thread_start(at_ms(0));
+
+    // Idle for the first window.
+    detector.on_wait_start(at_ms(0));
+    detector.on_wait_end(at_ms(1000));
+    EXPECT_EQ(0.0, detector.get_stats(at_ms(1000)).busy_ratio);
+
+    // Busy for a quarter of the second one.
+    detector.on_message(at_ms(1250));
+    detector.on_wait_start(at_ms(1250));
+    detector.on_wait_end(at_ms(2000));
+    EXPECT_EQ(0.25, detector.get_stats(at_ms(2000)).busy_ratio);
+
+    // The ratio only changes once a window is complete.
+    detector.on_message(at_ms(2900));
+    EXPECT_EQ(0.25, detector.get_stats(at_ms(2900)).busy_ratio);
+    EXPECT_EQ(1.0, detector.get_stats(at_ms(3000)).busy_ratio);
+}
+
+}  // namespace unittest
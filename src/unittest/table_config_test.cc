@@ -0,0 +1,80 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "clustering/administration/tables/table_config.hpp"
+#include "clustering/administration/tables/table_metadata.hpp"
+#include "containers/archive/string_stream.hpp"
+#include "unittest/gtest.hpp"
+
+namespace unittest {
+
+TEST(TableConfigTest, CompactionRoundTrip) {
+    for (gc_mode_t mode : {gc_mode_t::AUTOMATIC, gc_mode_t::PAUSED}) {
+        compaction_config_t old_compaction(mode);
+        old_compaction.forced_generation = 3;
+        ql::datum_t datum = convert_compaction_to_datum(old_compaction);
+        compaction_config_t compaction;
+        admin_err_t error;
+        ASSERT_TRUE(convert_compaction_from_datum(
+            datum, old_compaction, &compaction, &error)) << error.msg;
+        EXPECT_EQ(mode, compaction.mode) << datum.print();
+        EXPECT_EQ(3u, compaction.forced_generation);
+    }
+}
+
+// "forced" requests one forced compaction. It isn't stored as a mode, so that
+// restarts don't start it again, and so that asking again starts another one.
+TEST(TableConfigTest, CompactionForcedIsOneShot) {
+    compaction_config_t compaction(gc_mode_t::PAUSED);
+    admin_err_t error;
+    ASSERT_TRUE(convert_compaction_from_datum(
+        ql::datum_t("forced"), compaction, &compaction, &error)) << error.msg;
+    EXPECT_EQ(gc_mode_t::AUTOMATIC, compaction.mode);
+    EXPECT_EQ(1u, compaction.forced_generation);
+    EXPECT_EQ(ql::datum_t("auto"), convert_compaction_to_datum(compaction));
+
+    ASSERT_TRUE(convert_compaction_from_datum(
+        ql::datum_t("forced"), compaction, &compaction, &error)) << error.msg;
+    EXPECT_EQ(2u, compaction.forced_generation);
+
+    // Writing back what we read doesn't start another one.
+    ASSERT_TRUE(convert_compaction_from_datum(
+        convert_compaction_to_datum(compaction), compaction, &compaction, &error))
+        << error.msg;
+    EXPECT_EQ(2u, compaction.forced_generation);
+}
+
+TEST(TableConfigTest, CompactionRejectsUnknownMode) {
+    compaction_config_t compaction(gc_mode_t::PAUSED);
+    admin_err_t error;
+    EXPECT_FALSE(convert_compaction_from_datum(
+        ql::datum_t("start"), compaction, &compaction, &error));
+    EXPECT_FALSE(convert_compaction_from_datum(
+        ql::datum_t(1.0), compaction, &compaction, &error));
+    EXPECT_EQ(gc_mode_t::PAUSED, compaction.mode);
+}
+
+// New tables, and tables from before the `compaction` field existed, compact
+// automatically. The setting has to survive the trip through the table's Raft log.
+TEST(TableConfigTest, CompactionSerialization) {
+    table_config_and_shards_t config;
+    EXPECT_EQ(gc_mode_t::AUTOMATIC, config.config.compaction.mode);
+    config.config.write_ack_config = write_ack_config_t::MAJORITY;
+    config.config.durability = write_durability_t::HARD;
+    config.config.user_data = default_user_data();
+    config.config.compaction.mode = gc_mode_t::PAUSED;
+    config.config.compaction.forced_generation = 5;
+
+    string_stream_t write_stream;
+    write_message_t wm;
+    serialize<cluster_version_t::LATEST_DISK>(&wm, config);
+    ASSERT_EQ(0, send_write_message(&write_stream, &wm));
+
+    string_read_stream_t read_stream(std::move(write_stream.str()), 0);
+    table_config_and_shards_t deserialized;
+    ASSERT_EQ(archive_result_t::SUCCESS,
+              deserialize<cluster_version_t::LATEST_DISK>(&read_stream, &deserialized));
+    EXPECT_EQ(gc_mode_t::PAUSED, deserialized.config.compaction.mode);
+    EXPECT_EQ(5u, deserialized.config.compaction.forced_generation);
+    EXPECT_TRUE(config == deserialized);
+}
+
+}  // namespace unittest
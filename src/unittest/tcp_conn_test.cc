@@ -0,0 +1,64 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "arch/io/network.hpp"
+#include "arch/runtime/coroutines.hpp"
+#include "concurrency/cond_var.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+// The write coroutine sends whatever has queued up with a single `writev()`, and the
+// reader asks for more at a time once the data keeps coming. Neither may reorder or
+// drop anything.
+TPTEST(TcpConnTest, GatheredWritesArriveInOrder) {
+    scoped_ptr_t<tcp_conn_t> client, server;
+    make_loopback_tcp_conns(&client, &server);
+    cond_t non_closer;
+
+    // Small buffered writes of odd sizes, with a large unbuffered write every so
+    // often. The large ones are more than the socket takes at once, so they get
+    // written in parts.
+    std::vector<std::string> pieces;
+    std::string expected;
+    for (int i = 0; i < 3000; ++i) {
+        size_t size = (i % 100 == 99) ? 300 * KILOBYTE : (i * 37) % 300 + 1;
+        pieces.push_back(std::string(size, static_cast<char>('a' + i % 26)));
+        expected += pieces.back();
+    }
+
+    std::string received(expected.size(), '\0');
+    cond_t reader_done;
+    coro_t::spawn_sometime([&]() {
+        // Vary the read sizes, so that we go through both the connection's own
+        // buffer and reads straight into ours.
+        size_t offset = 0;
+        for (size_t size = 1; offset < received.size(); size = size * 3 % 100003) {
+            size_t to_read = std::min(size, received.size() - offset);
+            server->read_buffered(&received[offset], to_read, &non_closer);
+            offset += to_read;
+        }
+        reader_done.pulse();
+    });
+
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        if (pieces[i].size() > KILOBYTE) {
+            client->write(pieces[i].data(), pieces[i].size(), &non_closer);
+        } else {
+            client->write_buffered(pieces[i].data(), pieces[i].size(), &non_closer);
+            if (i % 7 == 0) {
+                client->flush_buffer_eventually(&non_closer);
+            }
+        }
+    }
+    client->flush_buffer(&non_closer);
+    reader_done.wait();
+
+    ASSERT_EQ(expected.size(), received.size());
+    EXPECT_TRUE(expected == received);
+}
+
+}  // namespace unittest
@@ -0,0 +1,50 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include <algorithm>
+#include <vector>
+
+#include "arch/timing.hpp"
+#include "concurrency/pmap.hpp"
+#include "config/args.hpp"
+#include "unittest/gtest.hpp"
+#include "unittest/unittest_utils.hpp"
+
+namespace unittest {
+
+// `multi_table_manager_t` loads tables on startup with `throttled_pmap()`. Every load
+// must run exactly once, and no more than `MAX_CONCURRENT_TABLE_LOADS` at a time, even
+// though each one blocks.
+TPTEST(ThrottledPmapTest, ConcurrencyBound) {
+    const int64_t num_tables = 5 * MAX_CONCURRENT_TABLE_LOADS + 3;
+    std::vector<int> runs(num_tables, 0);
+    int64_t running = 0;
+    int64_t max_running = 0;
+    throttled_pmap(num_tables, [&](int64_t i) {
+        ++running;
+        max_running = std::max(max_running, running);
+        ++runs[i];
+        nap(1 + i % 5);
+        --running;
+    }, MAX_CONCURRENT_TABLE_LOADS);
+
+    EXPECT_EQ(0, running);
+    // The first `MAX_CONCURRENT_TABLE_LOADS` loads all start before any of them
+    // finishes its nap, so the bound is reached exactly.
+    EXPECT_EQ(MAX_CONCURRENT_TABLE_LOADS, max_running);
+    for (int64_t i = 0; i < num_tables; ++i) {
+        EXPECT_EQ(1, runs[i]) << "table " << i;
+    }
+}
+
+TPTEST(ThrottledPmapTest, FewerThanBound) {
+    int64_t running = 0;
+    int64_t max_running = 0;
+    throttled_pmap(3, [&](int64_t) {
+        ++running;
+        max_running = std::max(max_running, running);
+        nap(1);
+        --running;
+    }, MAX_CONCURRENT_TABLE_LOADS);
+    EXPECT_EQ(3, max_running);
+}
+
+}  // namespace unittest
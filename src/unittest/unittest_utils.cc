@@ -5,6 +5,7 @@
 
 #include <functional>
 
+#include "arch/io/network.hpp"
 #include "arch/timing.hpp"
 #include "arch/runtime/starter.hpp"
 #include "rdb_protocol/datum.hpp"
@@ -170,6 +171,23 @@ void run_in_thread_pool(const std::function<void()> &fun, int num_workers) {
     ::run_in_thread_pool(fun, num_workers);
 }
 
+void make_loopback_tcp_conns(scoped_ptr_t<tcp_conn_t> *client_out,
+                             scoped_ptr_t<tcp_conn_t> *server_out) {
+    cond_t non_interruptor;
+    cond_t accepted;
+    tcp_listener_t listener(
+        std::set<ip_address_t>({ip_address_t("127.0.0.1")}), 0,
+        [&](scoped_ptr_t<tcp_conn_descriptor_t> &nconn) {
+            if (!accepted.is_pulsed()) {
+                nconn->make_server_connection(nullptr, server_out, &non_interruptor);
+                accepted.pulse();
+            }
+        });
+    client_out->init(new tcp_conn_t(
+        ip_address_t("127.0.0.1"), listener.get_port(), &non_interruptor));
+    accepted.wait();
+}
+
 key_range_t quick_range(const char *bounds) {
     guarantee(strlen(bounds) == 3);
     char left = bounds[0];
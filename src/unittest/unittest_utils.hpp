@@ -7,6 +7,7 @@
 #include <string>
 
 #include "arch/address.hpp"
+#include "arch/types.hpp"
 #include "containers/scoped.hpp"
 #include "paths.hpp"
 #include "rdb_protocol/protocol.hpp"
@@ -49,6 +50,11 @@ std::set<ip_address_t> get_unittest_addresses();
 
 void run_in_thread_pool(const std::function<void()> &fun, int num_workers = 1);
 
+// Connects two `tcp_conn_t`s to each other over the loopback interface. Both end up
+// on the calling thread, which must be in a thread pool.
+void make_loopback_tcp_conns(scoped_ptr_t<tcp_conn_t> *client_out,
+                             scoped_ptr_t<tcp_conn_t> *server_out);
+
 read_t make_sindex_read(
     ql::datum_t key, const std::string &id);
 
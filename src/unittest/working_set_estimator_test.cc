@@ -0,0 +1,121 @@
+// Copyright 2010-2016 RethinkDB, all rights reserved.
+#include "buffer_cache/working_set_estimator.hpp"
+#include "config/args.hpp"
+#include "unittest/gtest.hpp"
+
+namespace unittest {
+
+static const uint64_t block_bytes = 4 * KILOBYTE;
+
+TEST(WorkingSetEstimatorTest, ExtraBytesForHitRatio) {
+    alt::working_set_estimator_t estimator;
+    estimator.set_ghost_capacity(1000);
+    EXPECT_FALSE(estimator.hit_ratio().has_value());
+
+    for (block_id_t i = 0; i < 100; ++i) {
+        estimator.note_evicted(i, block_bytes);
+    }
+    for (int i = 0; i < 50; ++i) {
+        estimator.note_access(true);
+    }
+    // Forty of the misses reload evicted blocks, ten are cold.
+    for (block_id_t i = 0; i < 40; ++i) {
+        estimator.note_access(false);
+        EXPECT_TRUE(estimator.note_loaded(i, block_bytes));
+    }
+    for (block_id_t i = 1000; i < 1010; ++i) {
+        estimator.note_access(false);
+        EXPECT_FALSE(estimator.note_loaded(i, block_bytes));
+    }
+    // A ghost is only used once.
+    EXPECT_FALSE(estimator.note_loaded(0, block_bytes));
+
+    ASSERT_TRUE(estimator.hit_ratio().has_value());
+    EXPECT_EQ(0.5, *estimator.hit_ratio());
+
+    // Already there.
+    optional<uint64_t> extra = estimator.extra_bytes_for_hit_ratio(0.5);
+    ASSERT_TRUE(extra.has_value());
+    EXPECT_EQ(0u, *extra);
+
+    // Block `i` was reloaded after `101 - i` blocks' worth of evictions, so keeping
+    // blocks 0 through 39 takes less than 512 KB more.
+    extra = estimator.extra_bytes_for_hit_ratio(0.85);
+    ASSERT_TRUE(extra.has_value());
+    EXPECT_EQ(static_cast<uint64_t>(512 * KILOBYTE), *extra);
+
+    // The cold misses make 95% unreachable.
+    EXPECT_FALSE(estimator.extra_bytes_for_hit_ratio(0.95).has_value());
+
+    // Only the two reloads of blocks 38 and 39 had reuse distances below 256 KB.
+    const alt::working_set_estimator_t::reuse_histogram_t &histogram
+        = estimator.reuse_histogram();
+    EXPECT_EQ(0.0, histogram.fraction_within(0));
+    EXPECT_EQ(0.05, histogram.fraction_within(256 * KILOBYTE));
+    EXPECT_EQ(1.0, histogram.fraction_within(512 * KILOBYTE));
+    EXPECT_EQ(0.0, alt::working_set_estimator_t::reuse_histogram_t().fraction_within(
+        512 * KILOBYTE));
+}
+
+TEST(WorkingSetEstimatorTest, GhostCapacity) {
+    alt::working_set_estimator_t estimator;
+    estimator.set_ghost_capacity(10);
+    for (block_id_t i = 0; i < 20; ++i) {
+        estimator.note_evicted(i, block_bytes);
+    }
+    EXPECT_FALSE(estimator.note_loaded(0, block_bytes));
+    EXPECT_TRUE(estimator.note_loaded(19, block_bytes));
+
+    // Evicting a block again replaces its old ghost.
+    estimator.note_evicted(5, block_bytes);
+    estimator.note_evicted(5, block_bytes);
+    EXPECT_TRUE(estimator.note_loaded(5, block_bytes));
+    EXPECT_FALSE(estimator.note_loaded(5, block_bytes));
+}
+
+/* Ghosts that were loaded again don't take up any of the capacity. */
+TEST(WorkingSetEstimatorTest, ReloadedGhostsAreForgotten) {
+    alt::working_set_estimator_t estimator;
+    estimator.set_ghost_capacity(10);
+    for (block_id_t i = 0; i < 10; ++i) {
+        estimator.note_evicted(i, block_bytes);
+    }
+    for (block_id_t i = 5; i < 10; ++i) {
+        EXPECT_TRUE(estimator.note_loaded(i, block_bytes));
+    }
+    for (block_id_t i = 10; i < 15; ++i) {
+        estimator.note_evicted(i, block_bytes);
+    }
+    // That's ten ghosts, so they all fit.
+    for (block_id_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(estimator.note_loaded(i, block_bytes));
+    }
+    for (block_id_t i = 10; i < 15; ++i) {
+        EXPECT_TRUE(estimator.note_loaded(i, block_bytes));
+    }
+
+    // Blocks come and go many times over without the ghost list growing past its
+    // capacity, and the ghosts that weren't reloaded are still there.
+    for (block_id_t i = 20; i < 25; ++i) {
+        estimator.note_evicted(i, block_bytes);
+    }
+    for (int round = 0; round < 1000; ++round) {
+        estimator.note_evicted(100, block_bytes);
+        EXPECT_TRUE(estimator.note_loaded(100, block_bytes));
+    }
+    for (block_id_t i = 20; i < 25; ++i) {
+        EXPECT_TRUE(estimator.note_loaded(i, block_bytes));
+    }
+}
+
+TEST(WorkingSetEstimatorTest, Decay) {
+    alt::working_set_estimator_t estimator;
+    for (uint64_t i = 0; i < alt::working_set_estimator_t::decay_access_count; ++i) {
+        estimator.note_access(i % 4 != 0);
+    }
+    EXPECT_EQ(alt::working_set_estimator_t::decay_access_count / 2,
+              estimator.hits() + estimator.misses());
+    EXPECT_EQ(0.75, *estimator.hit_ratio());
+}
+
+}  // namespace unittest